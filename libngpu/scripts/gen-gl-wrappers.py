@@ -69,6 +69,10 @@ cmds_optional = [
     "glEGLImageTargetTexStorageEXT",
     # GL_ARB_viewport_array
     "glViewportIndexedf",
+    # GL_ARB_get_program_binary
+    "glGetProgramBinary",
+    "glProgramBinary",
+    "glProgramParameteri",
 ]
 
 cmds = [
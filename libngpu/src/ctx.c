@@ -20,6 +20,7 @@
  * under the License.
  */
 
+#include <inttypes.h>
 #include <string.h>
 
 #include "ctx.h"
@@ -28,6 +29,7 @@
 #include "utils/memory.h"
 #include "utils/log.h"
 #include "utils/refcount.h"
+#include "utils/string.h"
 
 #if defined(BACKEND_GL) || defined(BACKEND_GLES)
 #include "opengl/ctx_gl.h"
@@ -122,6 +124,12 @@ int ngpu_ctx_params_copy(struct ngpu_ctx_params *dst, const struct ngpu_ctx_para
 {
     struct ngpu_ctx_params tmp = *src;
 
+    if (src->program_cache_dir) {
+        tmp.program_cache_dir = ngpu_strdup(src->program_cache_dir);
+        if (!tmp.program_cache_dir)
+            return NGPU_ERROR_MEMORY;
+    }
+
     if (src->backend_params) {
 #if defined(BACKEND_GL) || defined(BACKEND_GLES)
         if (src->backend == NGPU_BACKEND_OPENGL ||
@@ -129,6 +137,7 @@ int ngpu_ctx_params_copy(struct ngpu_ctx_params *dst, const struct ngpu_ctx_para
             const size_t size = sizeof(struct ngpu_ctx_params_gl);
             tmp.backend_params = ngpu_memdup(src->backend_params, size);
             if (!tmp.backend_params) {
+                ngpu_freep(&tmp.program_cache_dir);
                 return NGPU_ERROR_MEMORY;
             }
             goto done;
@@ -137,6 +146,7 @@ int ngpu_ctx_params_copy(struct ngpu_ctx_params *dst, const struct ngpu_ctx_para
 
         LOG(ERROR, "backend_params %p is not supported by backend %u",
             src->backend_params, src->backend);
+        ngpu_freep(&tmp.program_cache_dir);
         return NGPU_ERROR_UNSUPPORTED;
     }
 
@@ -149,6 +159,7 @@ int ngpu_ctx_params_copy(struct ngpu_ctx_params *dst, const struct ngpu_ctx_para
 void ngpu_ctx_params_reset(struct ngpu_ctx_params *params)
 {
     ngpu_freep(&params->backend_params);
+    ngpu_freep(&params->program_cache_dir);
     memset(params, 0, sizeof(*params));
 }
 
@@ -162,6 +173,13 @@ static void ctx_freep(void **sp)
     ngpu_pgcache_freep(&s->program_cache);
     s->cls->destroy(s);
 
+    if (s->disk_cache) {
+        uint64_t hits, misses;
+        ngpu_diskcache_get_stats(s->disk_cache, &hits, &misses);
+        LOG(DEBUG, "program cache: %" PRIu64 " hit(s), %" PRIu64 " miss(es)", hits, misses);
+        ngpu_diskcache_freep(&s->disk_cache);
+    }
+
     /*
      * Drop our ref on shared_ctx (if any) after cls->destroy so the backend
      * can safely access shared resources during teardown.
@@ -222,6 +240,17 @@ struct ngpu_ctx *ngpu_ctx_create(const struct ngpu_ctx_params *params)
 
 int ngpu_ctx_init(struct ngpu_ctx *s)
 {
+    /*
+     * The disk cache is created before the backend initialization so the
+     * latter can restore its persistent state (such as the Vulkan pipeline
+     * cache) from it.
+     */
+    if (s->params.program_cache_dir) {
+        s->disk_cache = ngpu_diskcache_create(s->params.program_cache_dir);
+        if (!s->disk_cache)
+            return NGPU_ERROR_MEMORY;
+    }
+
     int ret = s->cls->init(s);
     if (ret < 0)
         return ret;
@@ -245,6 +274,22 @@ int ngpu_ctx_set_capture_buffer(struct ngpu_ctx *s, void *capture_buffer)
     return cls->set_capture_buffer(s, capture_buffer);
 }
 
+int ngpu_ctx_read_capture(struct ngpu_ctx *s, uint32_t frame_index, void *data, int wait)
+{
+    if (!s->params.async_capture) {
+        LOG(ERROR, "asynchronous capture is not enabled");
+        return NGPU_ERROR_INVALID_USAGE;
+    }
+
+    if (frame_index >= s->nb_in_flight_frames) {
+        LOG(ERROR, "invalid frame index %u", frame_index);
+        return NGPU_ERROR_INVALID_ARG;
+    }
+
+    const struct ngpu_ctx_class *cls = s->cls;
+    return cls->read_capture(s, frame_index, data, wait);
+}
+
 uint32_t ngpu_ctx_advance_frame(struct ngpu_ctx *s)
 {
     s->current_frame_index = (s->current_frame_index + 1) % s->nb_in_flight_frames;
@@ -271,8 +316,21 @@ int ngpu_ctx_end_update(struct ngpu_ctx *s, struct ngpu_fence *wait_fence)
     return s->cls->end_update(s, wait_fence);
 }
 
+int ngpu_ctx_begin_program_batch(struct ngpu_ctx *s, const struct ngpu_program_batch_params *params)
+{
+    s->program_batch_failed = 0;
+    return ngpu_pgcache_begin_batch(s->program_cache, params);
+}
+
+int ngpu_ctx_end_program_batch(struct ngpu_ctx *s)
+{
+    s->program_batch_failed = 0;
+    return ngpu_pgcache_end_batch(s->program_cache);
+}
+
 int ngpu_ctx_begin_draw(struct ngpu_ctx *s)
 {
+    s->nb_render_pass_times = 0;
     return s->cls->begin_draw(s);
 }
 
@@ -286,6 +344,12 @@ int ngpu_ctx_query_draw_time(struct ngpu_ctx *s, int64_t *time)
     return s->cls->query_draw_time(s, time);
 }
 
+size_t ngpu_ctx_get_render_pass_times(const struct ngpu_ctx *s, const struct ngpu_render_pass_time **timesp)
+{
+    *timesp = s->render_pass_times;
+    return s->nb_render_pass_times;
+}
+
 void ngpu_ctx_wait_idle(struct ngpu_ctx *s)
 {
     s->cls->wait_idle(s);
@@ -336,6 +400,20 @@ const struct ngpu_limits *ngpu_ctx_get_limits(const struct ngpu_ctx *s)
     return &s->limits;
 }
 
+void ngpu_ctx_get_program_cache_stats(const struct ngpu_ctx *s, struct ngpu_program_cache_stats *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    if (s->disk_cache)
+        ngpu_diskcache_get_stats(s->disk_cache, &stats->hits, &stats->misses);
+}
+
+void ngpu_ctx_get_memory_stats(struct ngpu_ctx *s, struct ngpu_memory_stats *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    if (s->cls->get_memory_stats)
+        s->cls->get_memory_stats(s, stats);
+}
+
 enum ngpu_cull_mode ngpu_ctx_get_cull_mode(struct ngpu_ctx *s, enum ngpu_cull_mode cull_mode)
 {
     return s->cls->get_cull_mode(s, cull_mode);
@@ -427,6 +505,24 @@ void ngpu_ctx_generate_texture_mipmap(struct ngpu_ctx *s, struct ngpu_texture *t
 void ngpu_ctx_set_pipeline(struct ngpu_ctx *s, struct ngpu_pipeline *pipeline)
 {
     s->pipeline = pipeline;
+
+    if (pipeline->pending) {
+        /*
+         * The pipeline is used before the end of the program batch (typically
+         * by a node rendering during its prepare stage): wait for the pending
+         * programs and initialize the deferred pipelines now. On failure, the
+         * commands are dropped until the batch ends and reports the error.
+         */
+        int ret = ngpu_pgcache_flush_batch(s->program_cache);
+        if (ret < 0) {
+            s->program_batch_failed = 1;
+            return;
+        }
+    }
+
+    if (s->program_batch_failed)
+        return;
+
     s->cls->set_pipeline(s, pipeline);
 }
 
@@ -460,6 +556,9 @@ void ngpu_ctx_draw(struct ngpu_ctx *s, uint32_t nb_vertices, uint32_t nb_instanc
     const struct ngpu_bindgroup_layout *b_layout = s->bindgroup->layout;
     ngpu_assert(ngpu_bindgroup_layout_is_compatible(p_layout, b_layout));
 
+    if (s->program_batch_failed)
+        return;
+
     s->cls->draw(s, nb_vertices, nb_instances, first_vertex);
 }
 
@@ -472,6 +571,9 @@ void ngpu_ctx_draw_indexed(struct ngpu_ctx *s, uint32_t nb_indices, uint32_t nb_
     const struct ngpu_bindgroup_layout *b_layout = s->bindgroup->layout;
     ngpu_assert(ngpu_bindgroup_layout_is_compatible(p_layout, b_layout));
 
+    if (s->program_batch_failed)
+        return;
+
     s->cls->draw_indexed(s, nb_indices, nb_instances, first_index);
 }
 
@@ -483,6 +585,9 @@ void ngpu_ctx_dispatch(struct ngpu_ctx *s, uint32_t nb_group_x, uint32_t nb_grou
     const struct ngpu_bindgroup_layout *b_layout = s->bindgroup->layout;
     ngpu_assert(ngpu_bindgroup_layout_is_compatible(p_layout, b_layout));
 
+    if (s->program_batch_failed)
+        return;
+
     s->cls->dispatch(s, nb_group_x, nb_group_y, nb_group_z);
 }
 
@@ -30,6 +30,7 @@
 
 #include "bindgroup.h"
 #include "buffer.h"
+#include "diskcache.h"
 #include "pgcache.h"
 #include "pipeline.h"
 #include "rendertarget.h"
@@ -38,17 +39,20 @@
 
 struct ngpu_ctx_class {
     enum ngpu_backend_type id;
+    bool concurrent_program_init;
 
     struct ngpu_ctx *(*create)(const struct ngpu_ctx_params *params);
     int (*init)(struct ngpu_ctx *s);
     int (*resize)(struct ngpu_ctx *s, uint32_t width, uint32_t height);
     int (*set_capture_buffer)(struct ngpu_ctx *s, void *capture_buffer);
+    int (*read_capture)(struct ngpu_ctx *s, uint32_t frame_index, void *data, int wait);
     int (*begin_update)(struct ngpu_ctx *s);
     int (*end_update)(struct ngpu_ctx *s, struct ngpu_fence *wait_fence);
     int (*begin_draw)(struct ngpu_ctx *s);
     int (*end_draw)(struct ngpu_ctx *s, double t, struct ngpu_fence *wait_fence, struct ngpu_fence **signal_fencep);
     int (*query_draw_time)(struct ngpu_ctx *s, int64_t *time);
     void (*wait_idle)(struct ngpu_ctx *s);
+    void (*get_memory_stats)(struct ngpu_ctx *s, struct ngpu_memory_stats *stats);
     void (*destroy)(struct ngpu_ctx *s);
 
     enum ngpu_cull_mode (*get_cull_mode)(struct ngpu_ctx *s, enum ngpu_cull_mode cull_mode);
@@ -141,10 +145,16 @@ struct ngpu_ctx {
     uint32_t current_frame_index;
 
     struct ngpu_pgcache *program_cache;
+    struct ngpu_diskcache *disk_cache;
+    int program_batch_failed;
 
     struct ngpu_capture_ctx *gpu_capture_ctx;
     int gpu_capture;
 
+    /* Render pass timings of the last queried draw, filled by the backends */
+    struct ngpu_render_pass_time render_pass_times[NGPU_MAX_TIMED_RENDER_PASSES];
+    size_t nb_render_pass_times;
+
     /* State */
     struct ngpu_rendertarget *rendertarget;
     struct ngpu_pipeline *pipeline;
@@ -0,0 +1,275 @@
+/*
+ * Copyright 2025 Matthieu Bouron <matthieu.bouron@gmail.com>
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "diskcache.h"
+#include "utils/crc32.h"
+#include "utils/log.h"
+#include "utils/memory.h"
+#include "utils/pthread_compat.h"
+#include "utils/string.h"
+#include "utils/time.h"
+#include "utils/utils.h"
+
+/* Bump this whenever the on-disk layout of an entry changes */
+#define DISKCACHE_VERSION 1
+
+struct entry_header {
+    char magic[4];
+    uint32_t version;
+    uint64_t key_size;
+    uint64_t data_size;
+    uint32_t key_crc;
+    uint32_t data_crc;
+};
+
+struct ngpu_diskcache {
+    char *dir;
+    pthread_mutex_t lock;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t tmp_counter;
+    int store_failed;
+};
+
+static uint64_t hash_key(const uint8_t *key, size_t size)
+{
+    /* 64-bit FNV-1a */
+    uint64_t hash = 0xcbf29ce484222325;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= key[i];
+        hash *= 0x100000001b3;
+    }
+    return hash;
+}
+
+static char *get_entry_path(const struct ngpu_diskcache *s, const char *name, const void *key, size_t key_size)
+{
+    return ngpu_asprintf("%s/%s-%016" PRIx64 ".bin", s->dir, name, hash_key(key, key_size));
+}
+
+struct ngpu_diskcache *ngpu_diskcache_create(const char *dir)
+{
+    struct ngpu_diskcache *s = ngpu_calloc(1, sizeof(*s));
+    if (!s)
+        return NULL;
+
+    s->dir = ngpu_strdup(dir);
+    if (!s->dir) {
+        ngpu_freep(&s);
+        return NULL;
+    }
+
+    /* Strip trailing separators to keep entry paths canonical */
+    size_t len = strlen(s->dir);
+    while (len > 1 && strchr("/\\", s->dir[len - 1]))
+        s->dir[--len] = 0;
+
+    if (pthread_mutex_init(&s->lock, NULL)) {
+        ngpu_freep(&s->dir);
+        ngpu_freep(&s);
+        return NULL;
+    }
+
+    return s;
+}
+
+static void update_stats(struct ngpu_diskcache *s, int hit)
+{
+    pthread_mutex_lock(&s->lock);
+    if (hit)
+        s->hits++;
+    else
+        s->misses++;
+    pthread_mutex_unlock(&s->lock);
+}
+
+static int read_entry(FILE *fp, const void *key, size_t key_size, void **datap, size_t *sizep)
+{
+    struct entry_header header;
+    if (fread(&header, sizeof(header), 1, fp) != 1)
+        return NGPU_ERROR_IO;
+
+    if (memcmp(header.magic, "NGPC", sizeof(header.magic)) ||
+        header.version != DISKCACHE_VERSION ||
+        header.key_size != key_size ||
+        header.data_size == 0 || header.data_size > SIZE_MAX)
+        return NGPU_ERROR_INVALID_DATA;
+
+    if (header.key_crc != ngpu_crc32_mem(key, key_size))
+        return NGPU_ERROR_INVALID_DATA;
+
+    uint8_t *stored_key = ngpu_malloc(key_size);
+    if (!stored_key)
+        return NGPU_ERROR_MEMORY;
+    if (fread(stored_key, 1, key_size, fp) != key_size) {
+        ngpu_free(stored_key);
+        return NGPU_ERROR_IO;
+    }
+    const int key_match = !memcmp(stored_key, key, key_size);
+    ngpu_free(stored_key);
+    if (!key_match)
+        return NGPU_ERROR_INVALID_DATA;
+
+    const size_t size = (size_t)header.data_size;
+    uint8_t *data = ngpu_malloc(size);
+    if (!data)
+        return NGPU_ERROR_MEMORY;
+    if (fread(data, 1, size, fp) != size) {
+        ngpu_free(data);
+        return NGPU_ERROR_IO;
+    }
+    if (header.data_crc != ngpu_crc32_mem(data, size)) {
+        ngpu_free(data);
+        return NGPU_ERROR_INVALID_DATA;
+    }
+
+    *datap = data;
+    *sizep = size;
+    return 0;
+}
+
+int ngpu_diskcache_load(struct ngpu_diskcache *s, const char *name,
+                        const void *key, size_t key_size,
+                        void **datap, size_t *sizep)
+{
+    char *path = get_entry_path(s, name, key, key_size);
+    if (!path)
+        return NGPU_ERROR_MEMORY;
+
+    int ret = NGPU_ERROR_NOT_FOUND;
+    FILE *fp = fopen(path, "rb");
+    if (fp) {
+        ret = read_entry(fp, key, key_size, datap, sizep);
+        if (ret == NGPU_ERROR_INVALID_DATA || ret == NGPU_ERROR_IO) {
+            LOG(DEBUG, "ignoring stale or corrupted cache entry %s", path);
+            ret = NGPU_ERROR_NOT_FOUND;
+        }
+        fclose(fp);
+    }
+    ngpu_free(path);
+
+    if (ret == 0 || ret == NGPU_ERROR_NOT_FOUND)
+        update_stats(s, ret == 0);
+    return ret;
+}
+
+static int write_entry(FILE *fp, const void *key, size_t key_size, const void *data, size_t size)
+{
+    const struct entry_header header = {
+        .magic     = {'N', 'G', 'P', 'C'},
+        .version   = DISKCACHE_VERSION,
+        .key_size  = key_size,
+        .data_size = size,
+        .key_crc   = ngpu_crc32_mem(key, key_size),
+        .data_crc  = ngpu_crc32_mem(data, size),
+    };
+
+    if (fwrite(&header, sizeof(header), 1, fp) != 1 ||
+        fwrite(key, 1, key_size, fp) != key_size ||
+        fwrite(data, 1, size, fp) != size)
+        return NGPU_ERROR_IO;
+    return 0;
+}
+
+int ngpu_diskcache_store(struct ngpu_diskcache *s, const char *name,
+                         const void *key, size_t key_size,
+                         const void *data, size_t size)
+{
+    if (!size)
+        return NGPU_ERROR_INVALID_ARG;
+
+    char *path = get_entry_path(s, name, key, key_size);
+    if (!path)
+        return NGPU_ERROR_MEMORY;
+
+    pthread_mutex_lock(&s->lock);
+    const uint64_t tmp_id = s->tmp_counter++;
+    pthread_mutex_unlock(&s->lock);
+
+    char *tmp_path = ngpu_asprintf("%s.%p-%" PRId64 "-%" PRIu64 ".tmp",
+                                   path, (void *)s, ngpu_gettime_relative(), tmp_id);
+    if (!tmp_path) {
+        ngpu_free(path);
+        return NGPU_ERROR_MEMORY;
+    }
+
+    int ret = NGPU_ERROR_IO;
+    FILE *fp = fopen(tmp_path, "wb");
+    if (fp) {
+        ret = write_entry(fp, key, key_size, data, size);
+        if (fclose(fp) && ret == 0)
+            ret = NGPU_ERROR_IO;
+        if (ret == 0) {
+#ifdef _WIN32
+            /* rename() does not overwrite existing files on Windows */
+            remove(path);
+#endif
+            if (rename(tmp_path, path))
+                ret = NGPU_ERROR_IO;
+        }
+        if (ret < 0)
+            remove(tmp_path);
+    }
+
+    if (ret < 0) {
+        pthread_mutex_lock(&s->lock);
+        const int warn = !s->store_failed;
+        s->store_failed = 1;
+        pthread_mutex_unlock(&s->lock);
+        if (warn)
+            LOG(WARNING, "could not write cache entry %s, make sure the cache directory exists and is writable", path);
+    }
+
+    ngpu_free(tmp_path);
+    ngpu_free(path);
+    return ret;
+}
+
+void ngpu_diskcache_reject(struct ngpu_diskcache *s)
+{
+    pthread_mutex_lock(&s->lock);
+    ngpu_assert(s->hits > 0);
+    s->hits--;
+    s->misses++;
+    pthread_mutex_unlock(&s->lock);
+}
+
+void ngpu_diskcache_get_stats(struct ngpu_diskcache *s, uint64_t *hits, uint64_t *misses)
+{
+    pthread_mutex_lock(&s->lock);
+    *hits = s->hits;
+    *misses = s->misses;
+    pthread_mutex_unlock(&s->lock);
+}
+
+void ngpu_diskcache_freep(struct ngpu_diskcache **sp)
+{
+    struct ngpu_diskcache *s = *sp;
+    if (!s)
+        return;
+    pthread_mutex_destroy(&s->lock);
+    ngpu_freep(&s->dir);
+    ngpu_freep(sp);
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright 2025 Matthieu Bouron <matthieu.bouron@gmail.com>
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef NGPU_DISKCACHE_H
+#define NGPU_DISKCACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Persistent key/value store backed by a user provided directory, used to
+ * keep compiled programs and pipeline caches across process restarts.
+ *
+ * Each entry is stored in its own file named after the entry namespace and
+ * a hash of the key. The full key is stored along the data and compared on
+ * load so hash collisions and stale entries are reported as misses. Writes
+ * go through a temporary file which is then renamed so that concurrent
+ * processes sharing the same directory never observe partial entries.
+ */
+
+struct ngpu_diskcache;
+
+struct ngpu_diskcache *ngpu_diskcache_create(const char *dir);
+int ngpu_diskcache_load(struct ngpu_diskcache *s, const char *name,
+                        const void *key, size_t key_size,
+                        void **datap, size_t *sizep);
+int ngpu_diskcache_store(struct ngpu_diskcache *s, const char *name,
+                         const void *key, size_t key_size,
+                         const void *data, size_t size);
+/* Account a successfully loaded entry which turned out unusable as a miss */
+void ngpu_diskcache_reject(struct ngpu_diskcache *s);
+void ngpu_diskcache_get_stats(struct ngpu_diskcache *s, uint64_t *hits, uint64_t *misses);
+void ngpu_diskcache_freep(struct ngpu_diskcache **sp);
+
+#endif
@@ -61,6 +61,7 @@ struct ngpu_fence;
 #define NGPU_ERROR_GENERIC                  -1                             /* Generic error */
 #define NGPU_ERROR_ACCESS                   NGPU_ERROR('E','a','c','c')    /* Operation not allowed */
 #define NGPU_ERROR_BUG                      NGPU_ERROR('E','b','u','g')    /* A buggy code path was triggered, please report if it happens */
+#define NGPU_ERROR_BUSY                     NGPU_ERROR('E','b','s','y')    /* Resource temporarily unavailable, retry later */
 #define NGPU_ERROR_EXTERNAL                 NGPU_ERROR('E','e','x','t')    /* An error occurred in an external dependency */
 #define NGPU_ERROR_INVALID_ARG              NGPU_ERROR('E','a','r','g')    /* Invalid user argument specified */
 #define NGPU_ERROR_INVALID_DATA             NGPU_ERROR('E','d','a','t')    /* Invalid input data */
@@ -171,6 +172,8 @@ struct ngpu_limits {
     size_t min_uniform_block_offset_alignment;
     uint32_t max_storage_block_size;
     size_t min_storage_block_offset_alignment;
+    uint32_t max_vertex_storage_blocks;
+    uint32_t max_fragment_storage_blocks;
     uint32_t max_samples;
     uint32_t max_texture_dimension_1d;
     uint32_t max_texture_dimension_2d;
@@ -967,15 +970,46 @@ struct ngpu_ctx_params {
 
     enum ngpu_capture_buffer_type capture_buffer_type;
 
+    int async_capture; /* Read back the rendered frames asynchronously (offscreen
+                          with CPU capture buffer type only). Each frame is
+                          copied to one of nb_in_flight_frames readback
+                          buffers instead of capture_buffer and can be
+                          retrieved with ngpu_ctx_read_capture() */
+
     int debug; /* Enable graphics context debugging */
 
     int timer_queries; /* Enable graphics context timer queries */
 
+    const char *program_cache_dir; /* Optional path to an existing directory where
+                                      compiled programs (SPIR-V modules, OpenGL
+                                      program binaries) and the Vulkan pipeline
+                                      cache are persisted across process restarts.
+                                      The cache is disabled if NULL. */
+
     ngpu_log_callback_type log_callback;
 
     struct ngpu_ctx *shared_ctx; /* Optional shared context */
 };
 
+struct ngpu_program_cache_stats {
+    uint64_t hits;   /* Number of entries successfully loaded from the on-disk cache */
+    uint64_t misses; /* Number of entries not found (or invalid) in the on-disk cache */
+};
+
+struct ngpu_memory_stats {
+    uint64_t nb_device_allocations; /* Number of live device memory allocations (blocks and dedicated allocations) */
+    uint64_t nb_allocations;        /* Number of live buffer and texture allocations */
+    uint64_t allocated_size;        /* Total size of the device memory allocations in bytes */
+    uint64_t used_size;             /* Total size of the device memory used by the buffers and textures in bytes */
+};
+
+#define NGPU_MAX_TIMED_RENDER_PASSES 64
+
+struct ngpu_render_pass_time {
+    int64_t start; /* Start of the render pass in nanoseconds, relative to the start of the first timed render pass */
+    int64_t end;   /* End of the render pass in nanoseconds, relative to the start of the first timed render pass */
+};
+
 NGPU_API void ngpu_ctx_params_init_from_shared_ctx(struct ngpu_ctx_params *params, struct ngpu_ctx *parent);
 NGPU_API int ngpu_ctx_params_copy(struct ngpu_ctx_params *dst, const struct ngpu_ctx_params *src);
 NGPU_API void ngpu_ctx_params_reset(struct ngpu_ctx_params *params);
@@ -998,14 +1032,57 @@ NGPU_API struct ngpu_ctx *ngpu_ctx_create(const struct ngpu_ctx_params *params);
 NGPU_API int ngpu_ctx_init(struct ngpu_ctx *s);
 NGPU_API int ngpu_ctx_resize(struct ngpu_ctx *s, uint32_t width, uint32_t height);
 NGPU_API int ngpu_ctx_set_capture_buffer(struct ngpu_ctx *s, void *capture_buffer);
+
+/*
+ * Copy the pixels of the frame rendered at frame_index to data (width *
+ * height * 4 bytes, RGBA) when async_capture is enabled. If wait is 0 and the
+ * readback is still in progress, NGPU_ERROR_BUSY is returned. The readback
+ * buffer of a frame index is overwritten by the next frame rendered at the
+ * same index.
+ */
+NGPU_API int ngpu_ctx_read_capture(struct ngpu_ctx *s, uint32_t frame_index, void *data, int wait);
 NGPU_API uint32_t ngpu_ctx_advance_frame(struct ngpu_ctx *s);
 NGPU_API uint32_t ngpu_ctx_get_current_frame_index(struct ngpu_ctx *s);
 NGPU_API uint32_t ngpu_ctx_get_nb_in_flight_frames(struct ngpu_ctx *s);
 NGPU_API int ngpu_ctx_begin_update(struct ngpu_ctx *s);
 NGPU_API int ngpu_ctx_end_update(struct ngpu_ctx *s, struct ngpu_fence *wait_fence);
+
+typedef void (*ngpu_program_batch_func_type)(void *arg, size_t index);
+
+struct ngpu_program_batch_params {
+    /*
+     * Call func(arg, index) for every index in [0, count) and return once
+     * all the calls have returned. The calls are expected to be distributed
+     * on the threads of the caller: ngpu does not spawn threads of its own.
+     */
+    void (*parallel_for)(void *user_arg, size_t count, ngpu_program_batch_func_type func, void *arg);
+    void *user_arg;
+};
+
+/*
+ * Program batches allow the programs requested between begin and end to be
+ * compiled in parallel through the parallel_for callback of the batch
+ * parameters. Programs and pipelines created within a batch are usable right
+ * away from the API point of view: the pending work is flushed on the first
+ * use of a pending pipeline and at the latest when the batch ends.
+ * ngpu_ctx_end_program_batch() returns the first error encountered during the
+ * batch. Without parallel_for, or on backends without support for concurrent
+ * program compilation, this is a no-op.
+ */
+NGPU_API int ngpu_ctx_begin_program_batch(struct ngpu_ctx *s, const struct ngpu_program_batch_params *params);
+NGPU_API int ngpu_ctx_end_program_batch(struct ngpu_ctx *s);
 NGPU_API int ngpu_ctx_begin_draw(struct ngpu_ctx *s);
 NGPU_API int ngpu_ctx_end_draw(struct ngpu_ctx *s, double t, struct ngpu_fence *wait_fence, struct ngpu_fence **signal_fencep);
 NGPU_API int ngpu_ctx_query_draw_time(struct ngpu_ctx *s, int64_t *time);
+
+/*
+ * Return the GPU time spans of the render passes recorded during the current
+ * draw, in the order they were begun (at most NGPU_MAX_TIMED_RENDER_PASSES).
+ * The spans are only available with timer queries enabled, after a
+ * successful call to ngpu_ctx_query_draw_time(). The OpenGL backend does not
+ * time the render passes on Darwin.
+ */
+NGPU_API size_t ngpu_ctx_get_render_pass_times(const struct ngpu_ctx *s, const struct ngpu_render_pass_time **timesp);
 NGPU_API void ngpu_ctx_wait_idle(struct ngpu_ctx *s);
 NGPU_API void ngpu_ctx_freep(struct ngpu_ctx **sp);
 
@@ -1017,6 +1094,13 @@ NGPU_API int ngpu_ctx_get_version(const struct ngpu_ctx *s);
 NGPU_API int ngpu_ctx_get_language_version(const struct ngpu_ctx *s);
 NGPU_API uint64_t ngpu_ctx_get_features(const struct ngpu_ctx *s);
 NGPU_API const struct ngpu_limits *ngpu_ctx_get_limits(const struct ngpu_ctx *s);
+NGPU_API void ngpu_ctx_get_program_cache_stats(const struct ngpu_ctx *s, struct ngpu_program_cache_stats *stats);
+
+/*
+ * Retrieve the device memory sub-allocator statistics. Only the Vulkan backend
+ * manages its own device memory, the statistics are zeroed otherwise.
+ */
+NGPU_API void ngpu_ctx_get_memory_stats(struct ngpu_ctx *s, struct ngpu_memory_stats *stats);
 
 NGPU_API enum ngpu_cull_mode ngpu_ctx_get_cull_mode(struct ngpu_ctx *s, enum ngpu_cull_mode cull_mode);
 NGPU_API void ngpu_ctx_get_projection_matrix(struct ngpu_ctx *s, float *dst);
@@ -193,12 +193,16 @@ int ngpu_cmd_buffer_gl_submit(struct ngpu_cmd_buffer_gl *s, struct ngpu_fence *w
         }
         case NGPU_CMD_TYPE_GL_BEGIN_RENDER_PASS: {
             cur_rendertarget = cmd->begin_render_pass.rendertarget;
+            if (cmd->begin_render_pass.query)
+                gl->timer_funcs.QueryCounter(cmd->begin_render_pass.query, GL_TIMESTAMP);
             ngpu_rendertarget_gl_begin_pass(cmd->begin_render_pass.rendertarget);
             break;
         }
         case NGPU_CMD_TYPE_GL_END_RENDER_PASS: {
             ngpu_assert(cur_rendertarget != NULL);
             ngpu_rendertarget_gl_end_pass(cur_rendertarget);
+            if (cmd->end_render_pass.query)
+                gl->timer_funcs.QueryCounter(cmd->end_render_pass.query, GL_TIMESTAMP);
             cur_rendertarget = NULL;
             break;
         }
@@ -51,8 +51,13 @@ struct ngpu_cmd_gl {
     union {
         struct {
             struct ngpu_rendertarget *rendertarget;
+            uint32_t query; /* timestamp query object, 0 if the pass is not timed */
         } begin_render_pass;
 
+        struct {
+            uint32_t query; /* timestamp query object, 0 if the pass is not timed */
+        } end_render_pass;
+
         struct {
             struct ngpu_pipeline *pipeline;
         } set_pipeline;
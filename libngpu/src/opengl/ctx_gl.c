@@ -63,6 +63,70 @@ static void capture_cpu(struct ngpu_ctx *s)
     gl->funcs.ReadPixels(0, 0, w, h, GL_RGBA, GL_UNSIGNED_BYTE, params->capture_buffer);
 }
 
+static void capture_cpu_async(struct ngpu_ctx *s)
+{
+    struct ngpu_ctx_gl *s_priv = NGPU_PRIV_GL(s);
+    struct glcontext *gl = s_priv->glcontext;
+    struct ngpu_rendertarget *rt = s_priv->capture_rt;
+    struct ngpu_rendertarget_gl *rt_gl = NGPU_PRIV_GL(rt);
+    const uint32_t index = s->current_frame_index;
+
+    /*
+     * Reading into a pixel pack buffer only queues the transfer: the pixels
+     * are mapped later on by gl_read_capture() once the fence is signaled.
+     */
+    gl->funcs.BindFramebuffer(GL_FRAMEBUFFER, rt_gl->fbo);
+    gl->funcs.BindBuffer(GL_PIXEL_PACK_BUFFER, s_priv->capture_pbos[index]);
+    const GLint w = (GLint)rt->width, h = (GLint)rt->height;
+    gl->funcs.ReadPixels(0, 0, w, h, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    gl->funcs.BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    if (s_priv->capture_syncs[index])
+        gl->funcs.DeleteSync(s_priv->capture_syncs[index]);
+    s_priv->capture_syncs[index] = gl->funcs.FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    gl->funcs.Flush();
+}
+
+static int capture_async_init(struct ngpu_ctx *s)
+{
+    struct ngpu_ctx_gl *s_priv = NGPU_PRIV_GL(s);
+    struct glcontext *gl = s_priv->glcontext;
+    const struct ngpu_ctx_params *ctx_params = &s->params;
+
+    const uint32_t nb_frames = s->nb_in_flight_frames;
+    s_priv->capture_pbos = ngpu_calloc(nb_frames, sizeof(*s_priv->capture_pbos));
+    s_priv->capture_syncs = ngpu_calloc(nb_frames, sizeof(*s_priv->capture_syncs));
+    if (!s_priv->capture_pbos || !s_priv->capture_syncs)
+        return NGPU_ERROR_MEMORY;
+
+    const GLsizeiptr size = (GLsizeiptr)ctx_params->width * (GLsizeiptr)ctx_params->height * 4;
+    gl->funcs.GenBuffers((GLsizei)nb_frames, s_priv->capture_pbos);
+    for (uint32_t i = 0; i < nb_frames; i++) {
+        gl->funcs.BindBuffer(GL_PIXEL_PACK_BUFFER, s_priv->capture_pbos[i]);
+        gl->funcs.BufferData(GL_PIXEL_PACK_BUFFER, size, NULL, GL_STREAM_READ);
+    }
+    gl->funcs.BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    return 0;
+}
+
+static void capture_async_reset(struct ngpu_ctx *s)
+{
+    struct ngpu_ctx_gl *s_priv = NGPU_PRIV_GL(s);
+    struct glcontext *gl = s_priv->glcontext;
+
+    if (s_priv->capture_syncs) {
+        for (uint32_t i = 0; i < s->nb_in_flight_frames; i++) {
+            if (s_priv->capture_syncs[i])
+                gl->funcs.DeleteSync(s_priv->capture_syncs[i]);
+        }
+    }
+    if (s_priv->capture_pbos)
+        gl->funcs.DeleteBuffers((GLsizei)s->nb_in_flight_frames, s_priv->capture_pbos);
+    ngpu_freep(&s_priv->capture_syncs);
+    ngpu_freep(&s_priv->capture_pbos);
+}
+
 static void capture_corevideo(struct ngpu_ctx *s)
 {
     struct ngpu_ctx_gl *s_priv = NGPU_PRIV_GL(s);
@@ -234,6 +298,12 @@ static int offscreen_rendertarget_init(struct ngpu_ctx *s)
         int ret = create_texture(s, NGPU_FORMAT_R8G8B8A8_UNORM, 0, COLOR_USAGE, &s_priv->capture_texture);
         if (ret < 0)
             return ret;
+
+        if (ctx_params->async_capture) {
+            ret = capture_async_init(s);
+            if (ret < 0)
+                return ret;
+        }
     } else {
         LOG(ERROR, "unsupported capture buffer type: %u", ctx_params->capture_buffer_type);
         return NGPU_ERROR_UNSUPPORTED;
@@ -280,7 +350,8 @@ static int offscreen_rendertarget_init(struct ngpu_ctx *s)
         [NGPU_CAPTURE_BUFFER_TYPE_CPU]       = capture_cpu,
         [NGPU_CAPTURE_BUFFER_TYPE_COREVIDEO] = capture_corevideo,
     };
-    s_priv->capture_func = capture_func_map[ctx_params->capture_buffer_type];
+    s_priv->capture_func = ctx_params->async_capture ? capture_cpu_async
+                                                     : capture_func_map[ctx_params->capture_buffer_type];
 
     return 0;
 }
@@ -313,6 +384,7 @@ static void rendertarget_reset(struct ngpu_ctx *s)
 
     ngpu_rendertarget_freep(&s_priv->capture_rt);
     ngpu_texture_freep(&s_priv->capture_texture);
+    capture_async_reset(s);
 #if defined(TARGET_IPHONE)
     reset_capture_cvpixelbuffer(s);
 #endif
@@ -324,7 +396,7 @@ static int timer_init(struct ngpu_ctx *s)
     struct ngpu_ctx_gl *s_priv = NGPU_PRIV_GL(s);
     struct glcontext *gl = s_priv->glcontext;
 
-    gl->timer_funcs.GenQueries(2, s_priv->queries);
+    gl->timer_funcs.GenQueries(NGPU_ARRAY_NB(s_priv->queries), s_priv->queries);
 
     return 0;
 }
@@ -336,7 +408,7 @@ static void timer_reset(struct ngpu_ctx *s)
     if (!gl)
         return;
 
-    gl->timer_funcs.DeleteQueries(2, s_priv->queries);
+    gl->timer_funcs.DeleteQueries(NGPU_ARRAY_NB(s_priv->queries), s_priv->queries);
 }
 
 static struct ngpu_ctx *gl_create(const struct ngpu_ctx_params *params)
@@ -530,8 +602,8 @@ static int gl_init(struct ngpu_ctx *s)
                 ctx_params->width, ctx_params->height);
             return NGPU_ERROR_INVALID_ARG;
         }
-        if (ctx_params->capture_buffer) {
-            LOG(ERROR, "capture_buffer is not supported by external context");
+        if (ctx_params->capture_buffer || ctx_params->async_capture) {
+            LOG(ERROR, "capture is not supported by external context");
             return NGPU_ERROR_INVALID_ARG;
         }
     } else if (ctx_params->offscreen) {
@@ -540,9 +612,13 @@ static int gl_init(struct ngpu_ctx *s)
                 ctx_params->width, ctx_params->height);
             return NGPU_ERROR_INVALID_ARG;
         }
+        if (ctx_params->async_capture && ctx_params->capture_buffer_type != NGPU_CAPTURE_BUFFER_TYPE_CPU) {
+            LOG(ERROR, "async_capture is only supported with the CPU capture buffer type");
+            return NGPU_ERROR_UNSUPPORTED;
+        }
     } else {
-        if (ctx_params->capture_buffer) {
-            LOG(ERROR, "capture_buffer is not supported by onscreen context");
+        if (ctx_params->capture_buffer || ctx_params->async_capture) {
+            LOG(ERROR, "capture is not supported by onscreen context");
             return NGPU_ERROR_INVALID_ARG;
         }
     }
@@ -640,6 +716,10 @@ static int gl_init(struct ngpu_ctx *s)
     if (ret < 0)
         return ret;
 
+    ret = ngpu_texture_gl_init_upload_ring(s);
+    if (ret < 0)
+        return ret;
+
     return 0;
 }
 
@@ -747,6 +827,44 @@ static int gl_set_capture_buffer(struct ngpu_ctx *s, void *capture_buffer)
     return 0;
 }
 
+static int gl_read_capture(struct ngpu_ctx *s, uint32_t frame_index, void *data, int wait)
+{
+    struct ngpu_ctx_gl *s_priv = NGPU_PRIV_GL(s);
+    struct glcontext *gl = s_priv->glcontext;
+
+    const GLsync sync = s_priv->capture_syncs[frame_index];
+    if (!sync) {
+        LOG(ERROR, "no frame has been captured at index %u", frame_index);
+        return NGPU_ERROR_INVALID_USAGE;
+    }
+
+    const GLuint64 timeout = wait ? UINT64_MAX : 0;
+    const GLenum status = gl->funcs.ClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+    if (status == GL_TIMEOUT_EXPIRED) {
+        return wait ? NGPU_ERROR_GRAPHICS_GENERIC : NGPU_ERROR_BUSY;
+    } else if (status == GL_WAIT_FAILED) {
+        LOG(ERROR, "capture fence wait failed");
+        return NGPU_ERROR_GRAPHICS_GENERIC;
+    }
+
+    const struct ngpu_rendertarget *rt = s_priv->capture_rt;
+    const GLsizeiptr size = (GLsizeiptr)rt->width * (GLsizeiptr)rt->height * 4;
+
+    int ret = 0;
+    gl->funcs.BindBuffer(GL_PIXEL_PACK_BUFFER, s_priv->capture_pbos[frame_index]);
+    const void *ptr = gl->funcs.MapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+    if (ptr) {
+        memcpy(data, ptr, (size_t)size);
+        gl->funcs.UnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    } else {
+        LOG(ERROR, "could not map capture buffer");
+        ret = NGPU_ERROR_GRAPHICS_GENERIC;
+    }
+    gl->funcs.BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    return ret;
+}
+
 int ngpu_ctx_gl_make_current(struct ngpu_ctx *s)
 {
     struct ngpu_ctx_gl *s_priv = NGPU_PRIV_GL(s);
@@ -868,12 +986,20 @@ static int gl_begin_draw(struct ngpu_ctx *s)
     const struct glcontext *gl = s_priv->glcontext;
     const struct ngpu_ctx_params *ctx_params = &s->params;
 
-    if (ctx_params->timer_queries)
+    if (ctx_params->timer_queries) {
+        s_priv->nb_timed_render_passes = 0;
 #if defined(TARGET_DARWIN)
+        /*
+         * GL_TIMESTAMP is not usable on Darwin and GL_TIME_ELAPSED queries
+         * cannot be nested in the draw query: the render passes are not
+         * timed.
+         */
         gl->timer_funcs.BeginQuery(GL_TIME_ELAPSED, s_priv->queries[0]);
 #else
         gl->timer_funcs.QueryCounter(s_priv->queries[0], GL_TIMESTAMP);
+        s_priv->time_render_passes = 1;
 #endif
+    }
 
     if (ctx_params->offscreen && s_priv->rts)
         s_priv->default_rt = s_priv->rts[s->current_frame_index];
@@ -929,13 +1055,19 @@ static int gl_end_draw(struct ngpu_ctx *s, double t, struct ngpu_fence *wait_fen
             return NGPU_ERROR_MEMORY;
     }
 
+    s_priv->time_render_passes = 0;
+
     struct ngpu_fence *signal_fence = signal_fencep ? *signal_fencep : NULL;
 
     int ret = ngpu_cmd_buffer_gl_submit(s_priv->cur_cmd_buffer, wait_fence, signal_fence);
     if (ret < 0)
         goto fail;
 
-    if (s_priv->capture_func && ctx_params->capture_buffer) {
+    ret = ngpu_texture_gl_end_upload_frame(s);
+    if (ret < 0)
+        goto fail;
+
+    if (s_priv->capture_func && (ctx_params->capture_buffer || ctx_params->async_capture)) {
         blit_vflip(s, s_priv->default_rt, s_priv->capture_rt);
         s_priv->capture_func(s);
     }
@@ -987,6 +1119,25 @@ static int gl_query_draw_time(struct ngpu_ctx *s, int64_t *time)
 
     *time = (int64_t)(end_time - start_time);
 #endif
+
+    /* The queries have been consumed, the remaining render passes of the draw are not timed */
+    s_priv->time_render_passes = 0;
+
+    const uint32_t nb_passes = s_priv->nb_timed_render_passes;
+    GLuint64 origin = 0;
+    for (uint32_t i = 0; i < nb_passes; i++) {
+        GLuint64 pass_start = 0, pass_end = 0;
+        gl->timer_funcs.GetQueryObjectui64v(s_priv->queries[2 + 2 * i], GL_QUERY_RESULT, &pass_start);
+        gl->timer_funcs.GetQueryObjectui64v(s_priv->queries[3 + 2 * i], GL_QUERY_RESULT, &pass_end);
+        if (i == 0)
+            origin = pass_start;
+        s->render_pass_times[i] = (struct ngpu_render_pass_time){
+            .start = (int64_t)(pass_start - origin),
+            .end   = (int64_t)(pass_end - origin),
+        };
+    }
+    s->nb_render_pass_times = nb_passes;
+
     ret = ngpu_cmd_buffer_gl_begin(cmd_buffer);
     if (ret < 0)
         return ret;
@@ -1012,6 +1163,7 @@ static void gl_destroy(struct ngpu_ctx *s)
     timer_reset(s);
     rendertarget_reset(s);
     destroy_command_buffers(s);
+    ngpu_texture_gl_reset_upload_ring(s);
 #if DEBUG_GPU_CAPTURE
     if (s->gpu_capture)
         ngpu_capture_end(s->gpu_capture_ctx);
@@ -1083,9 +1235,16 @@ static void gl_begin_render_pass(struct ngpu_ctx *s, struct ngpu_rendertarget *r
 
     NGPU_CMD_BUFFER_GL_REF(cmd_buffer, rt);
 
+    GLuint query = 0;
+#if !defined(TARGET_DARWIN)
+    if (s_priv->time_render_passes && s_priv->nb_timed_render_passes < NGPU_MAX_TIMED_RENDER_PASSES)
+        query = s_priv->queries[2 + 2 * s_priv->nb_timed_render_passes];
+#endif
+
     ngpu_cmd_buffer_gl_push(cmd_buffer, &(struct ngpu_cmd_gl){
                                             .type = NGPU_CMD_TYPE_GL_BEGIN_RENDER_PASS,
                                             .begin_render_pass.rendertarget = rt,
+                                            .begin_render_pass.query = query,
                                         });
 }
 
@@ -1094,8 +1253,15 @@ static void gl_end_render_pass(struct ngpu_ctx *s)
     struct ngpu_ctx_gl *s_priv = NGPU_PRIV_GL(s);
     struct ngpu_cmd_buffer_gl *cmd_buffer = s_priv->cur_cmd_buffer;
 
+    GLuint query = 0;
+#if !defined(TARGET_DARWIN)
+    if (s_priv->time_render_passes && s_priv->nb_timed_render_passes < NGPU_MAX_TIMED_RENDER_PASSES)
+        query = s_priv->queries[3 + 2 * s_priv->nb_timed_render_passes++];
+#endif
+
     ngpu_cmd_buffer_gl_push(cmd_buffer, &(struct ngpu_cmd_gl){
                                             .type = NGPU_CMD_TYPE_GL_END_RENDER_PASS,
+                                            .end_render_pass.query = query,
                                         });
 }
 
@@ -1261,6 +1427,7 @@ const struct ngpu_ctx_class ngpu_ctx_##cls_suffix = {
     .init                               = gl_init,                               \
     .resize                             = gl_resize,                             \
     .set_capture_buffer                 = gl_set_capture_buffer,                 \
+    .read_capture                       = gl_read_capture,                       \
     .begin_update                       = gl_begin_update,                       \
     .end_update                         = gl_end_update,                         \
     .begin_draw                         = gl_begin_draw,                         \
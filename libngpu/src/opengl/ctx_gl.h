@@ -37,6 +37,7 @@
 
 struct ngl_ctx;
 struct ngpu_rendertarget;
+struct ngpu_texture_upload_gl;
 
 typedef void (*capture_func_type)(struct ngpu_ctx *s);
 
@@ -64,13 +65,20 @@ struct ngpu_ctx_gl {
     capture_func_type capture_func;
     struct ngpu_rendertarget *capture_rt;
     struct ngpu_texture *capture_texture;
+    GLuint *capture_pbos;   /* asynchronous capture readback ring (one per in-flight frame) */
+    GLsync *capture_syncs;
+
+    /* Texture upload ring (one pixel unpack buffer per in-flight frame) */
+    struct ngpu_texture_upload_gl *uploads;
 #if defined(TARGET_IPHONE)
     CVPixelBufferRef capture_cvbuffer;
     CVOpenGLESTextureRef capture_cvtexture;
 #endif
 
-    /* Timer */
-    GLuint queries[2];
+    /* Timer: draw start and end, followed by the start and end of each timed render pass */
+    GLuint queries[2 + 2 * NGPU_MAX_TIMED_RENDER_PASSES];
+    int time_render_passes;
+    uint32_t nb_timed_render_passes;
 };
 
 #endif
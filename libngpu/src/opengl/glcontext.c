@@ -291,6 +291,16 @@ static const struct glfeature {
         .extensions     = (const char*[]){"GL_ARB_viewport_array", NULL},
         .funcs_offsets  = (const size_t[]){OFFSET(ViewportIndexedf),
                                            SIZE_MAX}
+    }, {
+        .name           = "get_program_binary",
+        .flag           = NGPU_FEATURE_GL_GET_PROGRAM_BINARY,
+        .version        = 410,
+        .es_version     = 300,
+        .extensions     = (const char*[]){"GL_ARB_get_program_binary", NULL},
+        .funcs_offsets  = (const size_t[]){OFFSET(GetProgramBinary),
+                                           OFFSET(ProgramBinary),
+                                           OFFSET(ProgramParameteri),
+                                           SIZE_MAX}
     },
 };
 
@@ -541,6 +551,8 @@ static int glcontext_probe_limits(struct glcontext *glcontext)
     if (glcontext->features & NGPU_FEATURE_GL_SHADER_STORAGE_BUFFER_OBJECT) {
         GET(GL_MAX_SHADER_STORAGE_BLOCK_SIZE, &limits->max_storage_block_size);
         GET(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &limits->min_storage_block_offset_alignment);
+        GET(GL_MAX_VERTEX_SHADER_STORAGE_BLOCKS, &limits->max_vertex_storage_blocks);
+        GET(GL_MAX_FRAGMENT_SHADER_STORAGE_BLOCKS, &limits->max_fragment_storage_blocks);
     }
 
     if (glcontext->features & NGPU_FEATURE_GL_SHADER_IMAGE_LOAD_STORE) {
@@ -98,6 +98,7 @@ struct glfunctions {
     void (NGPU_GL_APIENTRY *GetIntegeri_v)(GLenum target, GLuint index, GLint * data);
     void (NGPU_GL_APIENTRY *GetIntegerv)(GLenum pname, GLint * data);
     void (NGPU_GL_APIENTRY *GetInternalformativ)(GLenum target, GLenum internalformat, GLenum pname, GLsizei count, GLint * params);
+    void (NGPU_GL_APIENTRY *GetProgramBinary)(GLuint program, GLsizei bufSize, GLsizei * length, GLenum * binaryFormat, void * binary);
     void (NGPU_GL_APIENTRY *GetProgramInfoLog)(GLuint program, GLsizei bufSize, GLsizei * length, GLchar * infoLog);
     void (NGPU_GL_APIENTRY *GetProgramInterfaceiv)(GLuint program, GLenum programInterface, GLenum pname, GLint * params);
     GLuint (NGPU_GL_APIENTRY *GetProgramResourceIndex)(GLuint program, GLenum programInterface, const GLchar * name);
@@ -121,6 +122,8 @@ struct glfunctions {
     void * (NGPU_GL_APIENTRY *MapBufferRange)(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
     void (NGPU_GL_APIENTRY *MemoryBarrier)(GLbitfield barriers);
     void (NGPU_GL_APIENTRY *PixelStorei)(GLenum pname, GLint param);
+    void (NGPU_GL_APIENTRY *ProgramBinary)(GLuint program, GLenum binaryFormat, const void * binary, GLsizei length);
+    void (NGPU_GL_APIENTRY *ProgramParameteri)(GLuint program, GLenum pname, GLint value);
     void (NGPU_GL_APIENTRY *QueryCounter)(GLuint id, GLenum target);
     void (NGPU_GL_APIENTRY *QueryCounterEXT)(GLuint id, GLenum target);
     void (NGPU_GL_APIENTRY *ReadBuffer)(GLenum src);
@@ -265,6 +268,7 @@ static const struct glfunction_load_info {
     {"glGetIntegeri_v", offsetof(struct glfunctions, GetIntegeri_v), false},
     {"glGetIntegerv", offsetof(struct glfunctions, GetIntegerv), false},
     {"glGetInternalformativ", offsetof(struct glfunctions, GetInternalformativ), true},
+    {"glGetProgramBinary", offsetof(struct glfunctions, GetProgramBinary), true},
     {"glGetProgramInfoLog", offsetof(struct glfunctions, GetProgramInfoLog), false},
     {"glGetProgramInterfaceiv", offsetof(struct glfunctions, GetProgramInterfaceiv), true},
     {"glGetProgramResourceIndex", offsetof(struct glfunctions, GetProgramResourceIndex), true},
@@ -288,6 +292,8 @@ static const struct glfunction_load_info {
     {"glMapBufferRange", offsetof(struct glfunctions, MapBufferRange), false},
     {"glMemoryBarrier", offsetof(struct glfunctions, MemoryBarrier), true},
     {"glPixelStorei", offsetof(struct glfunctions, PixelStorei), false},
+    {"glProgramBinary", offsetof(struct glfunctions, ProgramBinary), true},
+    {"glProgramParameteri", offsetof(struct glfunctions, ProgramParameteri), true},
     {"glQueryCounter", offsetof(struct glfunctions, QueryCounter), true},
     {"glQueryCounterEXT", offsetof(struct glfunctions, QueryCounterEXT), true},
     {"glReadBuffer", offsetof(struct glfunctions, ReadBuffer), false},
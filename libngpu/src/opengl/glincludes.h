@@ -128,6 +128,8 @@ typedef void (NGPU_GL_APIENTRY *GLDEBUGPROC)(GLenum source, GLenum type, GLuint
 # define GL_SHADER_STORAGE_BUFFER_START        0x90D4
 # define GL_SHADER_STORAGE_BUFFER_SIZE         0x90D5
 # define GL_MAX_SHADER_STORAGE_BLOCK_SIZE      0x90DE
+# define GL_MAX_VERTEX_SHADER_STORAGE_BLOCKS   0x90D6
+# define GL_MAX_FRAGMENT_SHADER_STORAGE_BLOCKS 0x90DA
 # define GL_UNIFORM_BLOCK                      0x92E2
 # define GL_SHADER_STORAGE_BLOCK               0x92E6
 # define GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT 0x90DF
@@ -20,6 +20,7 @@
  * under the License.
  */
 
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -76,6 +77,97 @@ static int program_check_status(const struct glcontext *gl, GLuint shader, GLenu
     return NGPU_ERROR_INVALID_DATA;
 }
 
+static int use_binary_cache(const struct ngpu_ctx *gpu_ctx, const struct glcontext *gl)
+{
+    if (!gpu_ctx->disk_cache || !(gl->features & NGPU_FEATURE_GL_GET_PROGRAM_BINARY))
+        return 0;
+
+    GLint nb_formats = 0;
+    gl->funcs.GetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &nb_formats);
+    return nb_formats > 0;
+}
+
+static char *get_binary_cache_key(const struct glcontext *gl, const struct ngpu_program_params *params)
+{
+    /*
+     * Program binaries are only guaranteed to be loadable by the exact same
+     * driver, so the driver identification strings are part of the key.
+     */
+    return ngpu_asprintf("vendor:%s\nrenderer:%s\nversion:%s\n"
+                         "vertex:\n%s\nfragment:\n%s\ncompute:\n%s",
+                         (const char *)gl->funcs.GetString(GL_VENDOR),
+                         (const char *)gl->funcs.GetString(GL_RENDERER),
+                         (const char *)gl->funcs.GetString(GL_VERSION),
+                         params->vertex   ? params->vertex   : "",
+                         params->fragment ? params->fragment : "",
+                         params->compute  ? params->compute  : "");
+}
+
+static int load_program_binary(struct ngpu_program *s, const char *key)
+{
+    struct ngpu_program_gl *s_priv = NGPU_PRIV_GL(s);
+    struct ngpu_ctx_gl *gpu_ctx_gl = NGPU_PRIV_GL(s->gpu_ctx);
+    struct glcontext *gl = gpu_ctx_gl->glcontext;
+
+    void *data = NULL;
+    size_t size = 0;
+    int ret = ngpu_diskcache_load(s->gpu_ctx->disk_cache, "glprogram", key, strlen(key), &data, &size);
+    if (ret < 0)
+        return ret;
+
+    /* Entries are stored as the binary format followed by the binary itself */
+    if (size <= sizeof(GLenum) || size - sizeof(GLenum) > INT_MAX) {
+        ngpu_free(data);
+        ngpu_diskcache_reject(s->gpu_ctx->disk_cache);
+        return NGPU_ERROR_INVALID_DATA;
+    }
+
+    GLenum format;
+    memcpy(&format, data, sizeof(format));
+    const uint8_t *binary = (const uint8_t *)data + sizeof(format);
+    gl->funcs.ProgramBinary(s_priv->program, format, binary, (GLsizei)(size - sizeof(format)));
+    ngpu_free(data);
+
+    /* The driver is allowed to reject a binary at any time (driver update, etc) */
+    GLint status = GL_FALSE;
+    gl->funcs.GetProgramiv(s_priv->program, GL_LINK_STATUS, &status);
+    if (status != GL_TRUE) {
+        LOG(DEBUG, "program binary rejected by the driver, recompiling");
+        ngpu_diskcache_reject(s->gpu_ctx->disk_cache);
+        return NGPU_ERROR_INVALID_DATA;
+    }
+    return 0;
+}
+
+static int store_program_binary(struct ngpu_program *s, const char *key)
+{
+    struct ngpu_program_gl *s_priv = NGPU_PRIV_GL(s);
+    struct ngpu_ctx_gl *gpu_ctx_gl = NGPU_PRIV_GL(s->gpu_ctx);
+    struct glcontext *gl = gpu_ctx_gl->glcontext;
+
+    GLint length = 0;
+    gl->funcs.GetProgramiv(s_priv->program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return NGPU_ERROR_UNSUPPORTED;
+
+    const size_t size = sizeof(GLenum) + (size_t)length;
+    uint8_t *data = ngpu_malloc(size);
+    if (!data)
+        return NGPU_ERROR_MEMORY;
+
+    GLenum format = 0;
+    GLsizei written = 0;
+    gl->funcs.GetProgramBinary(s_priv->program, length, &written, &format, data + sizeof(format));
+    memcpy(data, &format, sizeof(format));
+
+    int ret = NGPU_ERROR_EXTERNAL;
+    if (written > 0)
+        ret = ngpu_diskcache_store(s->gpu_ctx->disk_cache, "glprogram", key, strlen(key),
+                                   data, sizeof(format) + (size_t)written);
+    ngpu_free(data);
+    return ret;
+}
+
 struct ngpu_program *ngpu_program_gl_create(struct ngpu_ctx *gpu_ctx)
 {
     struct ngpu_program_gl *s = ngpu_calloc(1, sizeof(*s));
@@ -112,6 +204,20 @@ int ngpu_program_gl_init(struct ngpu_program *s, const struct ngpu_program_param
 
     s_priv->program = gl->funcs.CreateProgram();
 
+    char *cache_key = NULL;
+    if (use_binary_cache(s->gpu_ctx, gl)) {
+        cache_key = get_binary_cache_key(gl, params);
+        if (!cache_key)
+            return NGPU_ERROR_MEMORY;
+
+        if (load_program_binary(s, cache_key) == 0) {
+            ngpu_free(cache_key);
+            return 0;
+        }
+
+        gl->funcs.ProgramParameteri(s_priv->program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
     for (size_t i = 0; i < NGPU_ARRAY_NB(shaders); i++) {
         if (!shaders[i].src)
             continue;
@@ -158,11 +264,18 @@ int ngpu_program_gl_init(struct ngpu_program *s, const struct ngpu_program_param
         if (shaders[i].shader != 0)
             gl->funcs.DeleteShader(shaders[i].shader);
 
+    if (cache_key) {
+        /* Failing to persist the program is not fatal */
+        store_program_binary(s, cache_key);
+        ngpu_free(cache_key);
+    }
+
     return 0;
 
 fail:
     for (size_t i = 0; i < NGPU_ARRAY_NB(shaders); i++)
         gl->funcs.DeleteShader(shaders[i].shader);
+    ngpu_free(cache_key);
 
     return ret;
 }
@@ -58,6 +58,7 @@
 
 #include "utils/log.h"
 #include "opengl/ctx_gl.h"
+#include "opengl/fence_gl.h"
 #include "opengl/format_gl.h"
 #include "opengl/glcontext.h"
 #include "opengl/glincludes.h"
@@ -188,12 +189,213 @@ static void texture_allocate_storage(struct ngpu_texture *s)
     }
 }
 
+/*
+ * Uploads smaller than this are not worth the staging overhead (buffer
+ * mapping, extra bind calls) and go straight from client memory.
+ */
+#define UPLOAD_MIN_SIZE (64 * 1024)
+#define UPLOAD_ALIGNMENT 64
+
+int ngpu_texture_gl_init_upload_ring(struct ngpu_ctx *gpu_ctx)
+{
+    struct ngpu_ctx_gl *gpu_ctx_gl = NGPU_PRIV_GL(gpu_ctx);
+
+    gpu_ctx_gl->uploads = ngpu_calloc(gpu_ctx->nb_in_flight_frames, sizeof(*gpu_ctx_gl->uploads));
+    if (!gpu_ctx_gl->uploads)
+        return NGPU_ERROR_MEMORY;
+
+    for (uint32_t i = 0; i < gpu_ctx->nb_in_flight_frames; i++) {
+        struct ngpu_texture_upload_gl *upload = &gpu_ctx_gl->uploads[i];
+        upload->fence = ngpu_fence_gl_create(gpu_ctx);
+        if (!upload->fence)
+            return NGPU_ERROR_MEMORY;
+    }
+
+    return 0;
+}
+
+int ngpu_texture_gl_end_upload_frame(struct ngpu_ctx *gpu_ctx)
+{
+    struct ngpu_ctx_gl *gpu_ctx_gl = NGPU_PRIV_GL(gpu_ctx);
+
+    if (!gpu_ctx_gl->uploads)
+        return 0;
+
+    struct ngpu_texture_upload_gl *upload = &gpu_ctx_gl->uploads[gpu_ctx->current_frame_index];
+    if (upload->pending || !upload->offset)
+        return 0;
+
+    int ret = ngpu_fence_gl_insert(upload->fence);
+    if (ret < 0)
+        return ret;
+    upload->pending = 1;
+
+    return 0;
+}
+
+void ngpu_texture_gl_reset_upload_ring(struct ngpu_ctx *gpu_ctx)
+{
+    struct ngpu_ctx_gl *gpu_ctx_gl = NGPU_PRIV_GL(gpu_ctx);
+    struct glcontext *gl = gpu_ctx_gl->glcontext;
+
+    if (!gpu_ctx_gl->uploads)
+        return;
+
+    for (uint32_t i = 0; i < gpu_ctx->nb_in_flight_frames; i++) {
+        struct ngpu_texture_upload_gl *upload = &gpu_ctx_gl->uploads[i];
+        if (upload->pbo)
+            gl->funcs.DeleteBuffers(1, &upload->pbo);
+        ngpu_fence_gl_freep(&upload->fence);
+    }
+    ngpu_freep(&gpu_ctx_gl->uploads);
+}
+
+static int upload_buffer_alloc(struct ngpu_ctx *gpu_ctx, struct ngpu_texture_upload_gl *upload, size_t size)
+{
+    struct ngpu_ctx_gl *gpu_ctx_gl = NGPU_PRIV_GL(gpu_ctx);
+    struct glcontext *gl = gpu_ctx_gl->glcontext;
+
+    /*
+     * The previous buffer may still be read by the pending transfers of the
+     * current frame: its deletion is deferred by the driver until they
+     * complete.
+     */
+    if (upload->pbo)
+        gl->funcs.DeleteBuffers(1, &upload->pbo);
+    upload->pbo = 0;
+    upload->size = 0;
+    upload->offset = 0;
+    upload->mapped = NULL;
+
+    gl->funcs.GenBuffers(1, &upload->pbo);
+    gl->funcs.BindBuffer(GL_PIXEL_UNPACK_BUFFER, upload->pbo);
+
+    const GLsizeiptr buffer_size = (GLsizeiptr)size;
+    const GLbitfield map_flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    if (gl->features & NGPU_FEATURE_GL_BUFFER_STORAGE) {
+        gl->funcs.BufferStorage(GL_PIXEL_UNPACK_BUFFER, buffer_size, NULL, map_flags);
+        upload->mapped = gl->funcs.MapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, buffer_size, map_flags);
+    } else if (gl->features & NGPU_FEATURE_GL_EXT_BUFFER_STORAGE) {
+        gl->funcs.BufferStorageEXT(GL_PIXEL_UNPACK_BUFFER, buffer_size, NULL, map_flags);
+        upload->mapped = gl->funcs.MapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, buffer_size, map_flags);
+    } else {
+        gl->funcs.BufferData(GL_PIXEL_UNPACK_BUFFER, buffer_size, NULL, GL_STREAM_DRAW);
+    }
+
+    if ((gl->features & (NGPU_FEATURE_GL_BUFFER_STORAGE | NGPU_FEATURE_GL_EXT_BUFFER_STORAGE)) && !upload->mapped) {
+        LOG(ERROR, "could not map texture upload buffer");
+        gl->funcs.DeleteBuffers(1, &upload->pbo);
+        upload->pbo = 0;
+        return NGPU_ERROR_GRAPHICS_GENERIC;
+    }
+
+    upload->size = size;
+
+    return 0;
+}
+
+/*
+ * Copy the data to the upload buffer of the current frame and leave it bound
+ * to GL_PIXEL_UNPACK_BUFFER. The returned offset is meant to be used in place
+ * of the client pointer by the glTexSubImage*() calls, which then become
+ * asynchronous transfers.
+ */
+static int upload_stage(struct ngpu_ctx *gpu_ctx, const uint8_t *data, size_t size, size_t *offsetp)
+{
+    struct ngpu_ctx_gl *gpu_ctx_gl = NGPU_PRIV_GL(gpu_ctx);
+    struct glcontext *gl = gpu_ctx_gl->glcontext;
+    struct ngpu_texture_upload_gl *upload = &gpu_ctx_gl->uploads[gpu_ctx->current_frame_index];
+
+    if (upload->pending) {
+        /* Wait for the transfers of the frame previously using this buffer */
+        int ret = ngpu_fence_gl_wait(upload->fence);
+        if (ret < 0)
+            return ret;
+        ngpu_fence_gl_reset(upload->fence);
+        upload->pending = 0;
+        upload->offset = 0;
+    }
+
+    size_t offset = NGPU_ALIGN(upload->offset, UPLOAD_ALIGNMENT);
+    if (offset + size > upload->size) {
+        const size_t new_size = NGPU_ALIGN(NGPU_MAX(upload->size * 2, size), UPLOAD_ALIGNMENT);
+        int ret = upload_buffer_alloc(gpu_ctx, upload, new_size);
+        if (ret < 0) {
+            gl->funcs.BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            return ret;
+        }
+        offset = 0;
+    } else {
+        gl->funcs.BindBuffer(GL_PIXEL_UNPACK_BUFFER, upload->pbo);
+    }
+
+    if (upload->mapped) {
+        memcpy(upload->mapped + offset, data, size);
+    } else {
+        /*
+         * The range has not been used since the fence of the previous frame
+         * using this buffer signaled, so it can be written without implicit
+         * synchronization.
+         */
+        const GLbitfield map_flags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+        void *dst = gl->funcs.MapBufferRange(GL_PIXEL_UNPACK_BUFFER, (GLintptr)offset, (GLsizeiptr)size, map_flags);
+        if (!dst) {
+            LOG(ERROR, "could not map texture upload buffer");
+            gl->funcs.BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            return NGPU_ERROR_GRAPHICS_GENERIC;
+        }
+        memcpy(dst, data, size);
+        gl->funcs.UnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    }
+
+    upload->offset = offset + size;
+    *offsetp = offset;
+
+    return 0;
+}
+
+static size_t get_upload_size(const struct ngpu_texture *s, const struct ngpu_texture_transfer_params *transfer_params)
+{
+    const struct ngpu_texture_gl *s_priv = NGPU_PRIV_GL(s);
+
+    size_t nb_slices = 1;
+    switch (s_priv->target) {
+    case GL_TEXTURE_2D:       nb_slices = 1;                              break;
+    case GL_TEXTURE_2D_ARRAY: nb_slices = transfer_params->layer_count;   break;
+    case GL_TEXTURE_3D:       nb_slices = transfer_params->depth;         break;
+    default:                  return 0;
+    }
+
+    const size_t nb_rows = (size_t)transfer_params->height * nb_slices;
+    if (!nb_rows || !transfer_params->width)
+        return 0;
+
+    /* The last row is only read up to the transfer width */
+    const size_t bytes_per_row = (size_t)transfer_params->pixels_per_row * s_priv->bytes_per_pixel;
+    return bytes_per_row * (nb_rows - 1) + (size_t)transfer_params->width * s_priv->bytes_per_pixel;
+}
+
 static void texture_upload(struct ngpu_texture *s, const uint8_t *data, const struct ngpu_texture_transfer_params *transfer_params)
 {
     struct ngpu_texture_gl *s_priv = NGPU_PRIV_GL(s);
     struct ngpu_ctx_gl *gpu_ctx_gl = NGPU_PRIV_GL(s->gpu_ctx);
     struct glcontext *gl = gpu_ctx_gl->glcontext;
 
+    /*
+     * Stage large uploads in the pixel unpack buffer of the current frame so
+     * the driver does not have to copy the client memory synchronously.
+     * Cube maps and failures to stage fall back on a direct upload.
+     */
+    int staged = 0;
+    const size_t upload_size = gpu_ctx_gl->uploads ? get_upload_size(s, transfer_params) : 0;
+    if (upload_size >= UPLOAD_MIN_SIZE) {
+        size_t offset;
+        if (upload_stage(s->gpu_ctx, data, upload_size, &offset) >= 0) {
+            data = (const uint8_t *)(uintptr_t)offset;
+            staged = 1;
+        }
+    }
+
     const size_t pixels_per_row = (size_t)transfer_params->pixels_per_row;
     const size_t bytes_per_row = pixels_per_row * s_priv->bytes_per_pixel;
     const size_t alignment = NGPU_MIN(NGPU_ALIGNMENT(bytes_per_row), 8);
@@ -238,6 +440,9 @@ static void texture_upload(struct ngpu_texture *s, const uint8_t *data, const st
 
     gl->funcs.PixelStorei(GL_UNPACK_ALIGNMENT, 4);
     gl->funcs.PixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
+    if (staged)
+        gl->funcs.BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 }
 
 static int renderbuffer_check_samples(struct ngpu_texture *s)
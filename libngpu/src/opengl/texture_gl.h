@@ -40,6 +40,22 @@ GLint ngpu_texture_get_gl_min_filter(enum ngpu_filter min_filter, enum ngpu_mipm
 GLint ngpu_texture_get_gl_mag_filter(enum ngpu_filter mag_filter);
 GLint ngpu_texture_get_gl_wrap(enum ngpu_wrap wrap);
 
+struct ngpu_fence;
+
+/*
+ * Pixel unpack buffer used to stage the texture uploads of one in-flight
+ * frame. The fence is inserted at the end of the frame and waited before the
+ * buffer is reused.
+ */
+struct ngpu_texture_upload_gl {
+    GLuint pbo;
+    size_t size;
+    size_t offset;
+    uint8_t *mapped; /* persistent mapping, NULL if buffer storage is not supported */
+    struct ngpu_fence *fence;
+    int pending;
+};
+
 struct ngpu_texture_gl {
     struct ngpu_texture parent;
     GLenum target;
@@ -76,4 +92,8 @@ int ngpu_texture_gl_read_pixels(struct ngpu_texture *s, uint8_t *data);
 int ngpu_texture_gl_generate_mipmap(struct ngpu_texture *s);
 void ngpu_texture_gl_freep(struct ngpu_texture **sp);
 
+int ngpu_texture_gl_init_upload_ring(struct ngpu_ctx *gpu_ctx);
+int ngpu_texture_gl_end_upload_frame(struct ngpu_ctx *gpu_ctx);
+void ngpu_texture_gl_reset_upload_ring(struct ngpu_ctx *gpu_ctx);
+
 #endif
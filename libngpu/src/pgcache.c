@@ -22,17 +22,47 @@
 
 #include <string.h>
 
+#include "ctx.h"
 #include "pgcache.h"
+#include "utils/darray.h"
 #include "utils/hmap.h"
 #include "utils/memory.h"
+#include "utils/string.h"
 #include "utils/utils.h"
 
+struct program_job {
+    struct ngpu_program *program;
+    struct ngpu_program_params params;
+    struct hmap *cache;
+    const char *cache_key;
+    int ret;
+};
+
 struct ngpu_pgcache {
     struct ngpu_ctx *gpu_ctx;
     struct hmap *graphics_cache;
     struct hmap *compute_cache;
+
+    /* Batch mode state */
+    int batch;
+    int batch_ret;
+    int parallel;
+    struct ngpu_program_batch_params batch_params;
+    NGPU_DARRAY(struct program_job *) jobs;
+    NGPU_DARRAY(struct ngpu_pipeline *) pending_pipelines;
 };
 
+static void free_program_job(void *user_arg, void *data)
+{
+    struct program_job **jobp = data;
+    struct program_job *job = *jobp;
+    ngpu_freep(&job->params.label);
+    ngpu_freep(&job->params.vertex);
+    ngpu_freep(&job->params.fragment);
+    ngpu_freep(&job->params.compute);
+    ngpu_freep(jobp);
+}
+
 static void reset_cached_program(void *user_arg, void *data)
 {
     struct ngpu_program *p = data;
@@ -57,6 +87,7 @@ struct ngpu_pgcache *ngpu_pgcache_create(struct ngpu_ctx *ctx)
         goto fail;
     ngpu_hmap_set_free_func(s->graphics_cache, reset_cached_frag_map, s);
     ngpu_hmap_set_free_func(s->compute_cache, reset_cached_program, s);
+    ngpu_darray_set_free_func(&s->jobs, free_program_job, NULL);
     return s;
 
 fail:
@@ -64,6 +95,40 @@ fail:
     return NULL;
 }
 
+static void init_program_job(void *arg, size_t index)
+{
+    struct ngpu_pgcache *s = arg;
+    struct program_job *job = *ngpu_darray_get(&s->jobs, index);
+    job->ret = ngpu_program_init(job->program, &job->params);
+}
+
+static int submit_program_job(struct ngpu_pgcache *s, struct ngpu_program *program,
+                              struct hmap *cache, const struct ngpu_program_params *params)
+{
+    struct program_job *job = ngpu_calloc(1, sizeof(*job));
+    if (!job)
+        return NGPU_ERROR_MEMORY;
+
+    /*
+     * The sources are owned by the caller and may be released as soon as we
+     * return, so the job operates on its own copies.
+     */
+    job->program = program;
+    job->cache = cache;
+    if ((params->label    && !(job->params.label    = ngpu_strdup(params->label)))    ||
+        (params->vertex   && !(job->params.vertex   = ngpu_strdup(params->vertex)))   ||
+        (params->fragment && !(job->params.fragment = ngpu_strdup(params->fragment))) ||
+        (params->compute  && !(job->params.compute  = ngpu_strdup(params->compute)))  ||
+        ngpu_darray_push(&s->jobs, job) < 0) {
+        free_program_job(NULL, &job);
+        return NGPU_ERROR_MEMORY;
+    }
+    job->cache_key = job->params.compute ? job->params.compute : job->params.fragment;
+
+    program->pending = 1;
+    return 0;
+}
+
 static int query_cache(struct ngpu_pgcache *s, struct ngpu_program **dstp,
                        struct hmap *cache, const char *cache_key,
                        const struct ngpu_program_params *params)
@@ -84,6 +149,29 @@ static int query_cache(struct ngpu_pgcache *s, struct ngpu_program **dstp,
     if (!new_program)
         return NGPU_ERROR_MEMORY;
 
+    if (s->parallel) {
+        /*
+         * In batch mode, the program is registered in the cache right away
+         * so that identical requests share the same pending program. It is
+         * removed from the cache by ngpu_pgcache_flush_batch() if its
+         * initialization fails.
+         */
+        int ret = ngpu_hmap_set_str(cache, cache_key, new_program);
+        if (ret < 0) {
+            ngpu_program_freep(&new_program);
+            return ret;
+        }
+
+        ret = submit_program_job(s, new_program, cache, params);
+        if (ret < 0) {
+            ngpu_hmap_set_str(cache, cache_key, NULL);
+            return ret;
+        }
+
+        *dstp = new_program;
+        return 0;
+    }
+
     int ret = ngpu_program_init(new_program, params);
     if (ret < 0) {
         ngpu_program_freep(&new_program);
@@ -129,11 +217,106 @@ int ngpu_pgcache_get_compute_program(struct ngpu_pgcache *s, struct ngpu_program
     return query_cache(s, dstp, s->compute_cache, params->compute, params);
 }
 
+int ngpu_pgcache_begin_batch(struct ngpu_pgcache *s, const struct ngpu_program_batch_params *params)
+{
+    ngpu_assert(!s->batch);
+    s->batch = 1;
+    s->batch_ret = 0;
+
+    /*
+     * Only backends for which the program initialization is free of any
+     * graphics context thread affinity can compile on other threads.
+     */
+    const struct ngpu_ctx_class *cls = s->gpu_ctx->cls;
+    if (!cls->concurrent_program_init || !params || !params->parallel_for)
+        return 0;
+
+    s->parallel = 1;
+    s->batch_params = *params;
+
+    return 0;
+}
+
+int ngpu_pgcache_defer_pipeline(struct ngpu_pgcache *s, struct ngpu_pipeline *pipeline)
+{
+    ngpu_assert(s->parallel && pipeline->program->pending);
+    if (ngpu_darray_push(&s->pending_pipelines, pipeline) < 0)
+        return NGPU_ERROR_MEMORY;
+    pipeline->pending = 1;
+    return 0;
+}
+
+void ngpu_pgcache_cancel_pipeline(struct ngpu_pgcache *s, struct ngpu_pipeline *pipeline)
+{
+    for (size_t i = 0; i < s->pending_pipelines.count; i++) {
+        if (*ngpu_darray_get(&s->pending_pipelines, i) == pipeline) {
+            ngpu_darray_remove(&s->pending_pipelines, i);
+            break;
+        }
+    }
+    pipeline->pending = 0;
+}
+
+int ngpu_pgcache_flush_batch(struct ngpu_pgcache *s)
+{
+    if (!s->parallel)
+        return s->batch_ret;
+
+    if (s->jobs.count)
+        s->batch_params.parallel_for(s->batch_params.user_arg, s->jobs.count, init_program_job, s);
+
+    ngpu_darray_foreach(jobp, &s->jobs) {
+        struct program_job *job = *jobp;
+        job->program->pending = 0;
+        if (job->ret < 0) {
+            if (s->batch_ret >= 0)
+                s->batch_ret = job->ret;
+            /* Pipelines still hold a reference on the failed program */
+            ngpu_hmap_set_str(job->cache, job->cache_key, NULL);
+        }
+    }
+    ngpu_darray_clear(&s->jobs);
+
+    /*
+     * The pipelines are initialized on the calling thread since this is
+     * where the backend expects them to be created.
+     */
+    ngpu_darray_foreach(pipelinep, &s->pending_pipelines) {
+        struct ngpu_pipeline *pipeline = *pipelinep;
+        pipeline->pending = 0;
+        if (s->batch_ret < 0)
+            continue;
+        int ret = pipeline->gpu_ctx->cls->pipeline_init(pipeline);
+        if (ret < 0)
+            s->batch_ret = ret;
+    }
+    ngpu_darray_clear(&s->pending_pipelines);
+
+    return s->batch_ret;
+}
+
+int ngpu_pgcache_end_batch(struct ngpu_pgcache *s)
+{
+    ngpu_assert(s->batch);
+
+    const int ret = ngpu_pgcache_flush_batch(s);
+    s->parallel = 0;
+    s->batch = 0;
+    s->batch_ret = 0;
+
+    return ret;
+}
+
 void ngpu_pgcache_freep(struct ngpu_pgcache **sp)
 {
     struct ngpu_pgcache *s = *sp;
     if (!s)
         return;
+
+    ngpu_darray_reset(&s->jobs);
+    ngpu_darray_foreach(pipelinep, &s->pending_pipelines)
+        (*pipelinep)->pending = 0;
+    ngpu_darray_reset(&s->pending_pipelines);
     ngpu_hmap_freep(&s->compute_cache);
     ngpu_hmap_freep(&s->graphics_cache);
     ngpu_freep(sp);
@@ -30,6 +30,19 @@ struct ngpu_pgcache;
 struct ngpu_pgcache *ngpu_pgcache_create(struct ngpu_ctx *ctx);
 int ngpu_pgcache_get_graphics_program(struct ngpu_pgcache *s, struct ngpu_program **dstp, const struct ngpu_program_params *params);
 int ngpu_pgcache_get_compute_program(struct ngpu_pgcache *s, struct ngpu_program **dstp, const struct ngpu_program_params *params);
+
+/*
+ * Batch mode: while a batch is active, programs missing from the cache are
+ * returned in a pending state (if the backend supports it) and compiled in
+ * parallel with the executor of the batch when it is flushed. Pipelines
+ * created from pending programs are deferred until then, and initialized on
+ * the calling thread.
+ */
+int ngpu_pgcache_begin_batch(struct ngpu_pgcache *s, const struct ngpu_program_batch_params *params);
+int ngpu_pgcache_defer_pipeline(struct ngpu_pgcache *s, struct ngpu_pipeline *pipeline);
+void ngpu_pgcache_cancel_pipeline(struct ngpu_pgcache *s, struct ngpu_pipeline *pipeline);
+int ngpu_pgcache_flush_batch(struct ngpu_pgcache *s);
+int ngpu_pgcache_end_batch(struct ngpu_pgcache *s);
 void ngpu_pgcache_freep(struct ngpu_pgcache **sp);
 
 #endif
@@ -51,6 +51,8 @@ static void pipeline_freep(void **pipelinep)
         return;
 
     struct ngpu_pipeline *s = *sp;
+    if (s->pending)
+        ngpu_pgcache_cancel_pipeline(s->gpu_ctx->program_cache, s);
     ngpu_pipeline_graphics_reset(&s->graphics);
     NGPU_RC_UNREFP(&s->program);
 
@@ -77,6 +79,9 @@ int ngpu_pipeline_init(struct ngpu_pipeline *s, const struct ngpu_pipeline_param
     s->program  = NGPU_RC_REF(params->program);
     s->layout = params->layout;
 
+    if (s->program->pending)
+        return ngpu_pgcache_defer_pipeline(s->gpu_ctx->program_cache, s);
+
     return s->gpu_ctx->cls->pipeline_init(s);
 }
 
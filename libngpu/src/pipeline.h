@@ -41,6 +41,7 @@ struct ngpu_pipeline {
     struct ngpu_pipeline_graphics graphics;
     const struct ngpu_program *program;
     struct ngpu_pipeline_layout layout;
+    int pending; /* backend initialization deferred until the pgcache batch is flushed */
 };
 
 NGPU_RC_CHECK_STRUCT(ngpu_pipeline);
@@ -30,6 +30,7 @@ struct ngpu_ctx;
 struct ngpu_program {
     struct ngpu_rc rc;
     struct ngpu_ctx *gpu_ctx;
+    int pending; /* initialization in progress on a pgcache worker */
 };
 
 NGPU_RC_CHECK_STRUCT(ngpu_program);
@@ -0,0 +1,207 @@
+/*
+ * Copyright 2025 Matthieu Bouron <matthieu.bouron@gmail.com>
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils/utils.h"
+#include "vulkan/allocator_vk.h"
+
+#define HEAP_SIZE (1ULL << 30)
+#define BLOCK_SIZE (64 * 1024 * 1024)
+#define GRANULARITY 4096
+#define NB_ALLOCATIONS 512
+
+static int nb_device_allocations;
+
+static VKAPI_ATTR VkResult VKAPI_CALL fake_allocate_memory(VkDevice device, const VkMemoryAllocateInfo *info,
+                                                            const VkAllocationCallbacks *allocator, VkDeviceMemory *memory)
+{
+    void *data = calloc(1, (size_t)info->allocationSize);
+    if (!data)
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+    *memory = (VkDeviceMemory)(uintptr_t)data;
+    nb_device_allocations++;
+    return VK_SUCCESS;
+}
+
+static VKAPI_ATTR void VKAPI_CALL fake_free_memory(VkDevice device, VkDeviceMemory memory,
+                                                   const VkAllocationCallbacks *allocator)
+{
+    if (memory == VK_NULL_HANDLE)
+        return;
+    free((void *)(uintptr_t)memory);
+    nb_device_allocations--;
+}
+
+static VKAPI_ATTR VkResult VKAPI_CALL fake_map_memory(VkDevice device, VkDeviceMemory memory, VkDeviceSize offset,
+                                                      VkDeviceSize size, VkMemoryMapFlags flags, void **data)
+{
+    *data = (uint8_t *)(uintptr_t)memory + offset;
+    return VK_SUCCESS;
+}
+
+static VKAPI_ATTR void VKAPI_CALL fake_unmap_memory(VkDevice device, VkDeviceMemory memory)
+{
+}
+
+static void init_vkcontext(struct vkcontext *vk)
+{
+    memset(vk, 0, sizeof(*vk));
+    vk->funcs.AllocateMemory = fake_allocate_memory;
+    vk->funcs.FreeMemory     = fake_free_memory;
+    vk->funcs.MapMemory      = fake_map_memory;
+    vk->funcs.UnmapMemory    = fake_unmap_memory;
+    vk->phy_device_props.limits.bufferImageGranularity = GRANULARITY;
+    vk->phydev_mem_props.memoryHeapCount = 1;
+    vk->phydev_mem_props.memoryHeaps[0].size = HEAP_SIZE;
+    vk->phydev_mem_props.memoryTypeCount = 2;
+    vk->phydev_mem_props.memoryTypes[0].propertyFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    vk->phydev_mem_props.memoryTypes[1].propertyFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                                        VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+}
+
+static void check_no_overlap(const struct ngpu_allocation_vk *allocations, size_t nb_allocations)
+{
+    for (size_t i = 0; i < nb_allocations; i++) {
+        const struct ngpu_allocation_vk *a = &allocations[i];
+        for (size_t j = i + 1; j < nb_allocations; j++) {
+            const struct ngpu_allocation_vk *b = &allocations[j];
+            if (a->memory != b->memory)
+                continue;
+            ngpu_assert(a->offset + a->size <= b->offset || b->offset + b->size <= a->offset);
+        }
+    }
+}
+
+static void test_sub_allocation(void)
+{
+    struct vkcontext vk;
+    init_vkcontext(&vk);
+    struct ngpu_allocator_vk *allocator = ngpu_allocator_vk_create(&vk);
+    ngpu_assert(allocator);
+
+    struct ngpu_allocation_vk allocations[NB_ALLOCATIONS];
+    uint32_t seed = 0x1234;
+    for (size_t round = 0; round < 4; round++) {
+        for (size_t i = 0; i < NB_ALLOCATIONS; i++) {
+            seed = seed * 1664525 + 1013904223;
+            const VkMemoryRequirements mem_reqs = {
+                .size      = 1 + (seed >> 8) % 65536,
+                .alignment = 1ULL << (seed % 9),
+            };
+            const int is_image = (seed >> 4) & 1;
+            VkResult res = ngpu_allocator_vk_alloc(allocator, &mem_reqs, 0, is_image,
+                                                   NGPU_MEMORY_POOL_VK_DEFAULT, &allocations[i]);
+            ngpu_assert(res == VK_SUCCESS);
+            ngpu_assert(allocations[i].offset % mem_reqs.alignment == 0);
+            ngpu_assert(!is_image || allocations[i].offset % GRANULARITY == 0);
+            ngpu_assert(!allocations[i].mapped_data);
+        }
+        check_no_overlap(allocations, NB_ALLOCATIONS);
+
+        /* small allocations share a single device memory block */
+        struct ngpu_memory_stats stats;
+        ngpu_allocator_vk_get_stats(allocator, &stats);
+        ngpu_assert(stats.nb_device_allocations == 1);
+        ngpu_assert(stats.nb_allocations == NB_ALLOCATIONS);
+        ngpu_assert(stats.allocated_size == BLOCK_SIZE);
+
+        /* release in an interleaved order to exercise the free ranges merging */
+        for (size_t i = 0; i < NB_ALLOCATIONS; i += 2)
+            ngpu_allocator_vk_free(allocator, &allocations[i]);
+        for (size_t i = 1; i < NB_ALLOCATIONS; i += 2)
+            ngpu_allocator_vk_free(allocator, &allocations[i]);
+
+        /* the last empty block is kept around */
+        ngpu_allocator_vk_get_stats(allocator, &stats);
+        ngpu_assert(stats.nb_device_allocations == 1);
+        ngpu_assert(stats.nb_allocations == 0);
+        ngpu_assert(stats.used_size == 0);
+    }
+
+    ngpu_allocator_vk_freep(&allocator);
+    ngpu_assert(!allocator);
+    ngpu_assert(nb_device_allocations == 0);
+}
+
+static void test_dedicated(void)
+{
+    struct vkcontext vk;
+    init_vkcontext(&vk);
+    struct ngpu_allocator_vk *allocator = ngpu_allocator_vk_create(&vk);
+    ngpu_assert(allocator);
+
+    const VkMemoryRequirements mem_reqs = {.size = BLOCK_SIZE, .alignment = 256};
+    struct ngpu_allocation_vk allocation;
+    VkResult res = ngpu_allocator_vk_alloc(allocator, &mem_reqs, 1, 0, NGPU_MEMORY_POOL_VK_DEFAULT, &allocation);
+    ngpu_assert(res == VK_SUCCESS);
+    ngpu_assert(allocation.offset == 0);
+    ngpu_assert(allocation.mapped_data);
+
+    struct ngpu_memory_stats stats;
+    ngpu_allocator_vk_get_stats(allocator, &stats);
+    ngpu_assert(stats.nb_device_allocations == 1);
+    ngpu_assert(stats.allocated_size == BLOCK_SIZE);
+
+    /* dedicated allocations are released immediately */
+    ngpu_allocator_vk_free(allocator, &allocation);
+    ngpu_assert(nb_device_allocations == 0);
+
+    ngpu_allocator_vk_freep(&allocator);
+}
+
+static void test_linear(void)
+{
+    struct vkcontext vk;
+    init_vkcontext(&vk);
+    struct ngpu_allocator_vk *allocator = ngpu_allocator_vk_create(&vk);
+    ngpu_assert(allocator);
+
+    const VkMemoryRequirements mem_reqs = {.size = 1000, .alignment = 64};
+    for (size_t round = 0; round < 4; round++) {
+        struct ngpu_allocation_vk a, b;
+        ngpu_assert(ngpu_allocator_vk_alloc(allocator, &mem_reqs, 1, 0, NGPU_MEMORY_POOL_VK_LINEAR, &a) == VK_SUCCESS);
+        ngpu_assert(ngpu_allocator_vk_alloc(allocator, &mem_reqs, 1, 0, NGPU_MEMORY_POOL_VK_LINEAR, &b) == VK_SUCCESS);
+        ngpu_assert(a.offset == 0);
+        ngpu_assert(b.offset == NGPU_ALIGN(mem_reqs.size, mem_reqs.alignment));
+        ngpu_assert(b.mapped_data == a.mapped_data + b.offset);
+        memset(a.mapped_data, 0xff, (size_t)a.size);
+        memset(b.mapped_data, 0xff, (size_t)b.size);
+
+        /* the block rewinds once all its allocations are released */
+        ngpu_allocator_vk_free(allocator, &a);
+        ngpu_allocator_vk_free(allocator, &b);
+        ngpu_assert(nb_device_allocations == 1);
+    }
+
+    ngpu_allocator_vk_freep(&allocator);
+    ngpu_assert(nb_device_allocations == 0);
+}
+
+int main(void)
+{
+    test_sub_allocation();
+    test_dedicated();
+    test_linear();
+    return 0;
+}
@@ -0,0 +1,168 @@
+/*
+ * Copyright 2025 Matthieu Bouron <matthieu.bouron@gmail.com>
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#include <process.h>
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "diskcache.h"
+#include "utils/memory.h"
+#include "utils/string.h"
+#include "utils/utils.h"
+
+static char *create_tmp_dir(void)
+{
+#ifdef _WIN32
+    const char *tmp = getenv("TEMP");
+    char *dir = ngpu_asprintf("%s\\ngpu-diskcache-%d", tmp ? tmp : ".", _getpid());
+    if (dir && _mkdir(dir))
+        ngpu_freep(&dir);
+    return dir;
+#else
+    const char *tmp = getenv("TMPDIR");
+    char *dir = ngpu_asprintf("%s/ngpu-diskcache-XXXXXX", tmp ? tmp : "/tmp");
+    if (dir && !mkdtemp(dir))
+        ngpu_freep(&dir);
+    return dir;
+#endif
+}
+
+static void remove_tmp_dir(const char *dir)
+{
+#ifdef _WIN32
+    char *pattern = ngpu_asprintf("%s\\*", dir);
+    ngpu_assert(pattern);
+    WIN32_FIND_DATAA entry;
+    HANDLE handle = FindFirstFileA(pattern, &entry);
+    ngpu_free(pattern);
+    if (handle != INVALID_HANDLE_VALUE) {
+        do {
+            if (entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+                continue;
+            char *path = ngpu_asprintf("%s\\%s", dir, entry.cFileName);
+            ngpu_assert(path);
+            ngpu_assert(remove(path) == 0);
+            ngpu_free(path);
+        } while (FindNextFileA(handle, &entry));
+        FindClose(handle);
+    }
+    ngpu_assert(_rmdir(dir) == 0);
+#else
+    DIR *d = opendir(dir);
+    ngpu_assert(d);
+    const struct dirent *entry;
+    while ((entry = readdir(d))) {
+        if (!strcmp(entry->d_name, ".") || !strcmp(entry->d_name, ".."))
+            continue;
+        char *path = ngpu_asprintf("%s/%s", dir, entry->d_name);
+        ngpu_assert(path);
+        ngpu_assert(remove(path) == 0);
+        ngpu_free(path);
+    }
+    closedir(d);
+    ngpu_assert(rmdir(dir) == 0);
+#endif
+}
+
+static void check_stats(struct ngpu_diskcache *s, uint64_t exp_hits, uint64_t exp_misses)
+{
+    uint64_t hits, misses;
+    ngpu_diskcache_get_stats(s, &hits, &misses);
+    ngpu_assert(hits == exp_hits);
+    ngpu_assert(misses == exp_misses);
+}
+
+int main(void)
+{
+
+    static const char missing_key[] = "missing shader source";
+    static const char key0[] = "vertex shader source";
+    static const char key1[] = "fragment shader source";
+    static const char data0[] = "compiled vertex shader";
+    static const char data1[] = "compiled fragment shader";
+
+    char *dir = create_tmp_dir();
+    ngpu_assert(dir);
+
+    struct ngpu_diskcache *s = ngpu_diskcache_create(dir);
+    ngpu_assert(s);
+
+    void *data = NULL;
+    size_t size = 0;
+
+    /* Unknown entry */
+    int ret = ngpu_diskcache_load(s, "test", missing_key, sizeof(missing_key), &data, &size);
+    ngpu_assert(ret == NGPU_ERROR_NOT_FOUND);
+    check_stats(s, 0, 1);
+
+    ngpu_assert(ngpu_diskcache_store(s, "test", key0, sizeof(key0), data0, sizeof(data0)) == 0);
+    ngpu_assert(ngpu_diskcache_store(s, "test", key1, sizeof(key1), data1, sizeof(data1)) == 0);
+
+    /* Round trip */
+    ret = ngpu_diskcache_load(s, "test", key0, sizeof(key0), &data, &size);
+    ngpu_assert(ret == 0);
+    ngpu_assert(size == sizeof(data0) && !memcmp(data, data0, size));
+    ngpu_freep(&data);
+    check_stats(s, 1, 1);
+
+    /* Same key in a different namespace */
+    ret = ngpu_diskcache_load(s, "other", key0, sizeof(key0), &data, &size);
+    ngpu_assert(ret == NGPU_ERROR_NOT_FOUND);
+    check_stats(s, 1, 2);
+
+    /* Overwrite an existing entry */
+    ngpu_assert(ngpu_diskcache_store(s, "test", key0, sizeof(key0), data1, sizeof(data1)) == 0);
+    ngpu_diskcache_freep(&s);
+    ngpu_assert(!s);
+
+    /* Entries persist across cache instances */
+    s = ngpu_diskcache_create(dir);
+    ngpu_assert(s);
+    ret = ngpu_diskcache_load(s, "test", key0, sizeof(key0), &data, &size);
+    ngpu_assert(ret == 0);
+    ngpu_assert(size == sizeof(data1) && !memcmp(data, data1, size));
+    ngpu_freep(&data);
+    ret = ngpu_diskcache_load(s, "test", key1, sizeof(key1), &data, &size);
+    ngpu_assert(ret == 0);
+    ngpu_assert(size == sizeof(data1) && !memcmp(data, data1, size));
+    ngpu_freep(&data);
+    check_stats(s, 2, 0);
+
+    /* Entries rejected by their consumer are accounted as misses */
+    ngpu_diskcache_reject(s);
+    check_stats(s, 1, 1);
+    ngpu_diskcache_freep(&s);
+
+    remove_tmp_dir(dir);
+    ngpu_free(dir);
+
+    return 0;
+}
@@ -137,6 +137,9 @@ char *ngpu_log_ret_str(char *buf, size_t buf_size, int ret)
         case NGPU_ERROR_BUG:
             snprintf(buf, buf_size, "a buggy code path was triggered, please report");
             break;
+        case NGPU_ERROR_BUSY:
+            snprintf(buf, buf_size, "resource temporarily unavailable");
+            break;
         case NGPU_ERROR_EXTERNAL:
             snprintf(buf, buf_size, "an error occurred in an external dependency");
             break;
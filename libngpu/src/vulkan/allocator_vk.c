@@ -0,0 +1,426 @@
+/*
+ * Copyright 2025 Matthieu Bouron <matthieu.bouron@gmail.com>
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <inttypes.h>
+#include <string.h>
+
+#include "utils/darray.h"
+#include "utils/log.h"
+#include "utils/memory.h"
+#include "utils/pthread_compat.h"
+#include "utils/utils.h"
+#include "vulkan/allocator_vk.h"
+
+#define MAX_BLOCK_SIZE (64 * 1024 * 1024)
+
+struct free_range {
+    VkDeviceSize offset;
+    VkDeviceSize size;
+};
+
+struct ngpu_memory_block_vk {
+    VkDeviceMemory memory;
+    VkDeviceSize size;
+    uint8_t *mapped_data;
+    uint32_t mem_type_index;
+    enum ngpu_memory_pool_vk pool;
+    int dedicated;
+    size_t nb_allocations;
+    VkDeviceSize head;                        /* linear pool only */
+    NGPU_DARRAY(struct free_range) free_list; /* default pool only, sorted by offset */
+};
+
+NGPU_DECLARE_DARRAY_WITH_NAME(block_darray, struct ngpu_memory_block_vk *);
+
+struct ngpu_allocator_vk {
+    struct vkcontext *vk;
+    pthread_mutex_t lock;
+    VkDeviceSize block_sizes[VK_MAX_MEMORY_TYPES];
+    struct block_darray blocks[VK_MAX_MEMORY_TYPES][NGPU_MEMORY_POOL_VK_NB];
+    struct ngpu_memory_stats stats;
+};
+
+static void block_freep(struct ngpu_allocator_vk *s, struct ngpu_memory_block_vk **blockp)
+{
+    struct ngpu_memory_block_vk *block = *blockp;
+    if (!block)
+        return;
+
+    struct vkcontext *vk = s->vk;
+    if (block->mapped_data)
+        vk->funcs.UnmapMemory(vk->device, block->memory);
+    vk->funcs.FreeMemory(vk->device, block->memory, NULL);
+    ngpu_darray_reset(&block->free_list);
+
+    s->stats.nb_device_allocations--;
+    s->stats.allocated_size -= block->size;
+
+    ngpu_freep(blockp);
+}
+
+static void free_block(void *user_arg, void *data)
+{
+    struct ngpu_allocator_vk *s = user_arg;
+    struct ngpu_memory_block_vk **blockp = data;
+    block_freep(s, blockp);
+}
+
+struct ngpu_allocator_vk *ngpu_allocator_vk_create(struct vkcontext *vk)
+{
+    struct ngpu_allocator_vk *s = ngpu_calloc(1, sizeof(*s));
+    if (!s)
+        return NULL;
+
+    s->vk = vk;
+
+    if (pthread_mutex_init(&s->lock, NULL)) {
+        ngpu_freep(&s);
+        return NULL;
+    }
+
+    /*
+     * Small heaps (typically the host-visible device-local memory of discrete
+     * GPUs) get smaller blocks so a single block does not exhaust them.
+     */
+    const VkPhysicalDeviceMemoryProperties *props = &vk->phydev_mem_props;
+    for (uint32_t i = 0; i < props->memoryTypeCount; i++) {
+        const VkDeviceSize heap_size = props->memoryHeaps[props->memoryTypes[i].heapIndex].size;
+        s->block_sizes[i] = NGPU_MIN(heap_size / 8, MAX_BLOCK_SIZE);
+    }
+
+    for (size_t i = 0; i < VK_MAX_MEMORY_TYPES; i++)
+        for (size_t j = 0; j < NGPU_MEMORY_POOL_VK_NB; j++)
+            ngpu_darray_set_free_func(&s->blocks[i][j], free_block, s);
+
+    return s;
+}
+
+static VkResult block_create(struct ngpu_allocator_vk *s, VkDeviceSize size, uint32_t mem_type_index,
+                             enum ngpu_memory_pool_vk pool, int dedicated,
+                             struct ngpu_memory_block_vk **blockp)
+{
+    struct vkcontext *vk = s->vk;
+
+    struct ngpu_memory_block_vk *block = ngpu_calloc(1, sizeof(*block));
+    if (!block)
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+
+    const VkMemoryAllocateInfo allocate_info = {
+        .sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+        .allocationSize  = size,
+        .memoryTypeIndex = mem_type_index,
+    };
+    VkResult res = vk->funcs.AllocateMemory(vk->device, &allocate_info, NULL, &block->memory);
+    if (res != VK_SUCCESS) {
+        ngpu_freep(&block);
+        return res;
+    }
+
+    block->size = size;
+    block->mem_type_index = mem_type_index;
+    block->pool = pool;
+    block->dedicated = dedicated;
+
+    s->stats.nb_device_allocations++;
+    s->stats.allocated_size += size;
+
+    const VkMemoryPropertyFlags flags = vk->phydev_mem_props.memoryTypes[mem_type_index].propertyFlags;
+    if (flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+        res = vk->funcs.MapMemory(vk->device, block->memory, 0, VK_WHOLE_SIZE, 0, (void **)&block->mapped_data);
+        if (res != VK_SUCCESS) {
+            block_freep(s, &block);
+            return res;
+        }
+    }
+
+    if (!dedicated && pool == NGPU_MEMORY_POOL_VK_DEFAULT) {
+        const struct free_range range = {.offset = 0, .size = size};
+        if (ngpu_darray_push(&block->free_list, range) < 0) {
+            block_freep(s, &block);
+            return VK_ERROR_OUT_OF_HOST_MEMORY;
+        }
+    }
+
+    if (ngpu_darray_push(&s->blocks[mem_type_index][pool], block) < 0) {
+        block_freep(s, &block);
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    *blockp = block;
+    return VK_SUCCESS;
+}
+
+static int insert_free_range(struct ngpu_memory_block_vk *block, size_t index, struct free_range range)
+{
+    if (ngpu_darray_push(&block->free_list, range) < 0)
+        return NGPU_ERROR_MEMORY;
+    struct free_range *ranges = block->free_list.data;
+    memmove(&ranges[index + 1], &ranges[index], (block->free_list.count - 1 - index) * sizeof(*ranges));
+    ranges[index] = range;
+    return 0;
+}
+
+static int block_alloc_free_list(struct ngpu_memory_block_vk *block, VkDeviceSize size, VkDeviceSize alignment,
+                                 VkDeviceSize *offsetp)
+{
+    for (size_t i = 0; i < block->free_list.count; i++) {
+        struct free_range *range = &block->free_list.data[i];
+        const VkDeviceSize offset = NGPU_ALIGN(range->offset, alignment);
+        const VkDeviceSize end = range->offset + range->size;
+        if (offset >= end || size > end - offset)
+            continue;
+
+        /* The alignment padding stays in the free list */
+        const VkDeviceSize head_size = offset - range->offset;
+        const VkDeviceSize tail_size = end - offset - size;
+        if (head_size && tail_size) {
+            const struct free_range tail = {.offset = offset + size, .size = tail_size};
+            if (insert_free_range(block, i + 1, tail) < 0)
+                return NGPU_ERROR_MEMORY;
+            block->free_list.data[i].size = head_size;
+        } else if (head_size) {
+            range->size = head_size;
+        } else if (tail_size) {
+            range->offset = offset + size;
+            range->size = tail_size;
+        } else {
+            ngpu_darray_remove(&block->free_list, i);
+        }
+
+        *offsetp = offset;
+        return 0;
+    }
+    return NGPU_ERROR_GRAPHICS_MEMORY;
+}
+
+static int block_alloc_linear(struct ngpu_memory_block_vk *block, VkDeviceSize size, VkDeviceSize alignment,
+                              VkDeviceSize *offsetp)
+{
+    const VkDeviceSize offset = NGPU_ALIGN(block->head, alignment);
+    if (offset > block->size || size > block->size - offset)
+        return NGPU_ERROR_GRAPHICS_MEMORY;
+    block->head = offset + size;
+    *offsetp = offset;
+    return 0;
+}
+
+static int block_alloc(struct ngpu_memory_block_vk *block, VkDeviceSize size, VkDeviceSize alignment,
+                       VkDeviceSize *offsetp)
+{
+    if (block->pool == NGPU_MEMORY_POOL_VK_LINEAR)
+        return block_alloc_linear(block, size, alignment, offsetp);
+    return block_alloc_free_list(block, size, alignment, offsetp);
+}
+
+static void block_free_range(struct ngpu_memory_block_vk *block, VkDeviceSize offset, VkDeviceSize size)
+{
+    struct free_range *ranges = block->free_list.data;
+    const size_t count = block->free_list.count;
+
+    size_t i = 0;
+    while (i < count && ranges[i].offset < offset)
+        i++;
+
+    const int merge_prev = i > 0 && ranges[i - 1].offset + ranges[i - 1].size == offset;
+    const int merge_next = i < count && offset + size == ranges[i].offset;
+    if (merge_prev && merge_next) {
+        ranges[i - 1].size += size + ranges[i].size;
+        ngpu_darray_remove(&block->free_list, i);
+    } else if (merge_prev) {
+        ranges[i - 1].size += size;
+    } else if (merge_next) {
+        ranges[i].offset = offset;
+        ranges[i].size += size;
+    } else {
+        /*
+         * On allocation failure, the range is lost until the block becomes
+         * empty again and its free list is reset.
+         */
+        const struct free_range range = {.offset = offset, .size = size};
+        insert_free_range(block, i, range);
+    }
+}
+
+static void set_allocation(struct ngpu_allocator_vk *s, struct ngpu_memory_block_vk *block,
+                           VkDeviceSize offset, VkDeviceSize size, struct ngpu_allocation_vk *allocation)
+{
+    block->nb_allocations++;
+    s->stats.nb_allocations++;
+    s->stats.used_size += size;
+
+    *allocation = (struct ngpu_allocation_vk){
+        .memory      = block->memory,
+        .offset      = offset,
+        .size        = size,
+        .mapped_data = block->mapped_data ? block->mapped_data + offset : NULL,
+        .block       = block,
+    };
+}
+
+static VkResult allocator_alloc(struct ngpu_allocator_vk *s,
+                                const VkMemoryRequirements *mem_reqs,
+                                uint32_t mem_type_index,
+                                int is_image,
+                                enum ngpu_memory_pool_vk pool,
+                                struct ngpu_allocation_vk *allocation)
+{
+    VkDeviceSize size = mem_reqs->size;
+    VkDeviceSize alignment = NGPU_MAX(mem_reqs->alignment, 1);
+
+    /*
+     * Keep images away from the buffers (linear resources) sharing the same
+     * block by aligning both their start and end on the granularity page
+     * size.
+     */
+    if (is_image) {
+        const VkDeviceSize granularity = s->vk->phy_device_props.limits.bufferImageGranularity;
+        alignment = NGPU_MAX(alignment, granularity);
+        size = NGPU_ALIGN(size, granularity);
+    }
+
+    const VkDeviceSize block_size = s->block_sizes[mem_type_index];
+    struct ngpu_memory_block_vk *block = NULL;
+    VkDeviceSize offset = 0;
+
+    if (size <= block_size / 2) {
+        ngpu_darray_foreach(it, &s->blocks[mem_type_index][pool]) {
+            if (!(*it)->dedicated && block_alloc(*it, size, alignment, &offset) == 0) {
+                set_allocation(s, *it, offset, size, allocation);
+                return VK_SUCCESS;
+            }
+        }
+
+        VkResult res = block_create(s, block_size, mem_type_index, pool, 0, &block);
+        if (res == VK_SUCCESS) {
+            int ret = block_alloc(block, size, alignment, &offset);
+            ngpu_assert(ret == 0);
+            set_allocation(s, block, offset, size, allocation);
+            return VK_SUCCESS;
+        } else if (res != VK_ERROR_OUT_OF_DEVICE_MEMORY) {
+            return res;
+        }
+        /* The heap might still have room for the exact allocation size */
+    }
+
+    VkResult res = block_create(s, size, mem_type_index, pool, 1, &block);
+    if (res != VK_SUCCESS)
+        return res;
+    set_allocation(s, block, 0, size, allocation);
+    return VK_SUCCESS;
+}
+
+VkResult ngpu_allocator_vk_alloc(struct ngpu_allocator_vk *s,
+                                 const VkMemoryRequirements *mem_reqs,
+                                 uint32_t mem_type_index,
+                                 int is_image,
+                                 enum ngpu_memory_pool_vk pool,
+                                 struct ngpu_allocation_vk *allocation)
+{
+    pthread_mutex_lock(&s->lock);
+    VkResult res = allocator_alloc(s, mem_reqs, mem_type_index, is_image, pool, allocation);
+    pthread_mutex_unlock(&s->lock);
+    return res;
+}
+
+static size_t count_shared_blocks(const struct ngpu_allocator_vk *s, uint32_t mem_type_index,
+                                  enum ngpu_memory_pool_vk pool)
+{
+    size_t count = 0;
+    ngpu_darray_foreach(it, &s->blocks[mem_type_index][pool])
+        count += !(*it)->dedicated;
+    return count;
+}
+
+static void remove_block(struct ngpu_allocator_vk *s, struct ngpu_memory_block_vk *block)
+{
+    struct block_darray *blocks = &s->blocks[block->mem_type_index][block->pool];
+    for (size_t i = 0; i < blocks->count; i++) {
+        if (blocks->data[i] == block) {
+            ngpu_darray_remove(blocks, i);
+            return;
+        }
+    }
+    ngpu_assert(0);
+}
+
+void ngpu_allocator_vk_free(struct ngpu_allocator_vk *s, struct ngpu_allocation_vk *allocation)
+{
+    struct ngpu_memory_block_vk *block = allocation->block;
+    if (!block)
+        return;
+
+    pthread_mutex_lock(&s->lock);
+
+    ngpu_assert(block->nb_allocations > 0);
+    block->nb_allocations--;
+    s->stats.nb_allocations--;
+    s->stats.used_size -= allocation->size;
+
+    if (block->dedicated) {
+        remove_block(s, block);
+    } else if (!block->nb_allocations) {
+        /*
+         * Keep one empty block around per memory type and pool to avoid
+         * allocating and releasing device memory repeatedly when a resource
+         * is recreated.
+         */
+        if (count_shared_blocks(s, block->mem_type_index, block->pool) > 1) {
+            remove_block(s, block);
+        } else {
+            block->head = 0;
+            if (block->pool == NGPU_MEMORY_POOL_VK_DEFAULT) {
+                ngpu_darray_clear(&block->free_list);
+                const struct free_range range = {.offset = 0, .size = block->size};
+                ngpu_darray_push(&block->free_list, range);
+            }
+        }
+    } else if (block->pool == NGPU_MEMORY_POOL_VK_DEFAULT) {
+        block_free_range(block, allocation->offset, allocation->size);
+    }
+
+    pthread_mutex_unlock(&s->lock);
+
+    memset(allocation, 0, sizeof(*allocation));
+}
+
+void ngpu_allocator_vk_get_stats(struct ngpu_allocator_vk *s, struct ngpu_memory_stats *stats)
+{
+    pthread_mutex_lock(&s->lock);
+    *stats = s->stats;
+    pthread_mutex_unlock(&s->lock);
+}
+
+void ngpu_allocator_vk_freep(struct ngpu_allocator_vk **sp)
+{
+    struct ngpu_allocator_vk *s = *sp;
+    if (!s)
+        return;
+
+    if (s->stats.nb_allocations)
+        LOG(WARNING, "%" PRIu64 " memory allocation(s) still alive", s->stats.nb_allocations);
+
+    for (size_t i = 0; i < VK_MAX_MEMORY_TYPES; i++)
+        for (size_t j = 0; j < NGPU_MEMORY_POOL_VK_NB; j++)
+            ngpu_darray_reset(&s->blocks[i][j]);
+
+    pthread_mutex_destroy(&s->lock);
+    ngpu_freep(sp);
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2025 Matthieu Bouron <matthieu.bouron@gmail.com>
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef NGPU_ALLOCATOR_VK_H
+#define NGPU_ALLOCATOR_VK_H
+
+#include <stdint.h>
+#include <vulkan/vulkan.h>
+
+#include "ngpu/ngpu.h"
+#include "vulkan/vkcontext.h"
+
+/*
+ * Sub-allocator of Vulkan device memory.
+ *
+ * Device memory is allocated in large blocks (one set of blocks per memory
+ * type and pool) which are then split between the buffers and textures,
+ * instead of calling vkAllocateMemory() for every resource. Host-visible
+ * blocks are persistently mapped.
+ */
+
+enum ngpu_memory_pool_vk {
+    NGPU_MEMORY_POOL_VK_DEFAULT, /* free-list blocks, for long-lived resources */
+    NGPU_MEMORY_POOL_VK_LINEAR,  /* bump-allocated blocks, rewound once empty, for transient staging memory */
+    NGPU_MEMORY_POOL_VK_NB
+};
+
+struct ngpu_memory_block_vk;
+
+struct ngpu_allocation_vk {
+    VkDeviceMemory memory;
+    VkDeviceSize offset;
+    VkDeviceSize size;
+    uint8_t *mapped_data; /* host pointer to the allocation, NULL if not host-visible */
+    struct ngpu_memory_block_vk *block;
+};
+
+struct ngpu_allocator_vk;
+
+struct ngpu_allocator_vk *ngpu_allocator_vk_create(struct vkcontext *vk);
+VkResult ngpu_allocator_vk_alloc(struct ngpu_allocator_vk *s,
+                                 const VkMemoryRequirements *mem_reqs,
+                                 uint32_t mem_type_index,
+                                 int is_image,
+                                 enum ngpu_memory_pool_vk pool,
+                                 struct ngpu_allocation_vk *allocation);
+void ngpu_allocator_vk_free(struct ngpu_allocator_vk *s, struct ngpu_allocation_vk *allocation);
+void ngpu_allocator_vk_get_stats(struct ngpu_allocator_vk *s, struct ngpu_memory_stats *stats);
+void ngpu_allocator_vk_freep(struct ngpu_allocator_vk **sp);
+
+#endif
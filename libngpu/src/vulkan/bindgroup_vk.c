@@ -239,6 +239,12 @@ static VkResult ngpu_bindgroup_layout_vk_allocate_set(struct ngpu_bindgroup_layo
 
     *desc_set = VK_NULL_HANDLE;
 
+    /* Recycle a descriptor set released by a previous bindgroup update */
+    if (!ngpu_darray_is_empty(&s_priv->free_desc_sets)) {
+        *desc_set = *ngpu_darray_pop(&s_priv->free_desc_sets);
+        return VK_SUCCESS;
+    }
+
     for (size_t i = 0; i < s_priv->desc_pools.count; i++) {
         const size_t pool_index = (i + s_priv->desc_pool_index) % s_priv->desc_pools.count;
 
@@ -300,6 +306,7 @@ void ngpu_bindgroup_layout_vk_freep(struct ngpu_bindgroup_layout **sp)
 
     ngpu_darray_reset(&s_priv->desc_set_layout_bindings);
     ngpu_darray_reset(&s_priv->immutable_samplers);
+    ngpu_darray_reset(&s_priv->free_desc_sets);
     ngpu_darray_reset(&s_priv->desc_pools);
 
     vk->funcs.DestroyDescriptorSetLayout(vk->device, s_priv->desc_set_layout, NULL);
@@ -307,6 +314,61 @@ void ngpu_bindgroup_layout_vk_freep(struct ngpu_bindgroup_layout **sp)
     ngpu_freep(sp);
 }
 
+static void desc_set_vk_freep(void **desc_setp)
+{
+    struct desc_set_vk **sp = (struct desc_set_vk **)desc_setp;
+    if (!*sp)
+        return;
+
+    struct desc_set_vk *s = *sp;
+    struct ngpu_bindgroup_layout *layout = s->layout;
+    struct ngpu_bindgroup_layout_vk *layout_vk = NGPU_PRIV_VK(layout);
+
+    if (s->textures) {
+        for (size_t i = 0; i < layout->nb_textures; i++)
+            NGPU_RC_UNREFP(&s->textures[i]);
+        ngpu_freep(&s->textures);
+    }
+
+    /*
+     * The set is not referenced by any command buffer anymore, give it back
+     * to the layout so it can be reused by the next bindgroup update. If this
+     * fails, the set remains allocated until its pool is destroyed.
+     */
+    if (s->desc_set && ngpu_darray_push(&layout_vk->free_desc_sets, s->desc_set) < 0)
+        LOG(WARNING, "unable to recycle descriptor set");
+
+    NGPU_RC_UNREFP(&s->layout);
+    ngpu_freep(sp);
+}
+
+static VkResult desc_set_vk_create(struct ngpu_bindgroup_layout *layout, struct desc_set_vk **desc_setp)
+{
+    struct desc_set_vk *s = ngpu_calloc(1, sizeof(*s));
+    if (!s)
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+    s->rc = NGPU_RC_CREATE(desc_set_vk_freep);
+    s->layout = NGPU_RC_REF(layout);
+
+    if (layout->nb_textures) {
+        s->textures = ngpu_calloc(layout->nb_textures, sizeof(*s->textures));
+        if (!s->textures) {
+            NGPU_RC_UNREFP(&s);
+            return VK_ERROR_OUT_OF_HOST_MEMORY;
+        }
+    }
+
+    VkResult res = ngpu_bindgroup_layout_vk_allocate_set(layout, &s->desc_set);
+    if (res != VK_SUCCESS) {
+        NGPU_RC_UNREFP(&s);
+        return res;
+    }
+
+    *desc_setp = s;
+
+    return VK_SUCCESS;
+}
+
 struct ngpu_bindgroup *ngpu_bindgroup_vk_create(struct ngpu_ctx *gpu_ctx)
 {
     struct ngpu_bindgroup_vk *s = ngpu_calloc(1, sizeof(*s));
@@ -343,12 +405,17 @@ int ngpu_bindgroup_vk_init(struct ngpu_bindgroup *s, const struct ngpu_bindgroup
     ngpu_darray_set_free_func(&s_priv->texture_bindings, unref_texture_binding, NULL);
     ngpu_darray_set_free_func(&s_priv->buffer_bindings, unref_buffer_binding, NULL);
 
-    VkResult res = ngpu_bindgroup_layout_vk_allocate_set(s->layout, &s_priv->desc_set);
-    if (res != VK_SUCCESS) {
-        return res;
-    }
-
     const struct ngpu_bindgroup_layout *layout = s->layout;
+
+    /*
+     * Reserve the descriptor write arrays upfront so that pointers to the
+     * image and buffer infos remain valid while the writes are collected
+     */
+    if (ngpu_darray_reserve(&s_priv->image_infos, layout->nb_textures) < 0 ||
+        ngpu_darray_reserve(&s_priv->buffer_infos, layout->nb_buffers) < 0 ||
+        ngpu_darray_reserve(&s_priv->write_desc_sets, layout->nb_textures + layout->nb_buffers) < 0)
+        return NGPU_ERROR_MEMORY;
+
     for (size_t i = 0; i < layout->nb_buffers; i++) {
         const struct ngpu_bindgroup_layout_entry *entry = &layout->buffers[i];
         if (ngpu_darray_push(&s_priv->buffer_bindings, (struct buffer_binding_vk){.layout_entry = *entry}) < 0)
@@ -393,6 +460,7 @@ int ngpu_bindgroup_vk_update_texture(struct ngpu_bindgroup *s, uint32_t index, c
 
     binding_vk->texture = NGPU_RC_REF(texture);
     binding_vk->update_desc = 1;
+    s_priv->update_desc = 1;
 
     return 0;
 }
@@ -413,65 +481,133 @@ int ngpu_bindgroup_vk_update_buffer(struct ngpu_bindgroup *s, uint32_t index, co
     binding_vk->offset = binding->offset;
     binding_vk->size   = binding->size;
     binding_vk->update_desc = 1;
+    s_priv->update_desc = 1;
 
     return 0;
 }
 
+static VkResult rotate_desc_set(struct ngpu_bindgroup *s)
+{
+    struct ngpu_bindgroup_vk *s_priv = NGPU_PRIV_VK(s);
+
+    struct desc_set_vk *desc_set = NULL;
+    VkResult res = desc_set_vk_create(s->layout, &desc_set);
+    if (res != VK_SUCCESS)
+        return res;
+
+    NGPU_RC_UNREFP(&s_priv->desc_set);
+    s_priv->desc_set = desc_set;
+
+    /* The new set content is undefined: every bound resource must be written */
+    ngpu_darray_foreach(binding, &s_priv->texture_bindings)
+        binding->update_desc = binding->texture ? 1 : 0;
+    ngpu_darray_foreach(binding, &s_priv->buffer_bindings)
+        binding->update_desc = binding->buffer ? 1 : 0;
+    s_priv->update_desc = 1;
+
+    return VK_SUCCESS;
+}
+
 int ngpu_bindgroup_vk_update_descriptor_set(struct ngpu_bindgroup *s)
 {
     struct ngpu_bindgroup_vk *s_priv = NGPU_PRIV_VK(s);
     struct ngpu_ctx_vk *gpu_ctx_vk = NGPU_PRIV_VK(s->gpu_ctx);
     struct vkcontext *vk = gpu_ctx_vk->vkcontext;
 
-    ngpu_darray_foreach(binding, &s_priv->texture_bindings) {
-        if (binding->update_desc) {
-            const struct ngpu_texture_vk *texture_vk = NGPU_PRIV_VK(binding->texture);
-            const VkDescriptorImageInfo image_info = {
-                .imageLayout = texture_vk->default_image_layout,
-                .imageView   = texture_vk->image_view,
-                .sampler     = texture_vk->sampler,
-            };
-            const struct ngpu_bindgroup_layout_entry *desc = &binding->layout_entry;
-            const VkWriteDescriptorSet write_descriptor_set = {
-                .sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-                .dstSet           = s_priv->desc_set,
-                .dstBinding       = desc->binding,
-                .dstArrayElement  = 0,
-                .descriptorType   = get_vk_descriptor_type(desc->type),
-                .descriptorCount  = 1,
-                .pImageInfo       = &image_info,
-            };
-            vk->funcs.UpdateDescriptorSets(vk->device, 1, &write_descriptor_set, 0, NULL);
-            binding->update_desc = 0;
-        }
+    /*
+     * If the current set is referenced by a command buffer (being recorded or
+     * in flight), it cannot be updated without waiting for the GPU: switch to
+     * a recycled (or newly allocated) set instead. The old set is given back
+     * to the layout free list once all command buffers referencing it have
+     * completed.
+     */
+    if (!s_priv->desc_set || (s_priv->update_desc && s_priv->desc_set->rc.count > 1)) {
+        VkResult res = rotate_desc_set(s);
+        if (res != VK_SUCCESS)
+            return ngpu_vk_res2ret(res);
+    }
+
+    if (!s_priv->update_desc)
+        return 0;
+
+    struct desc_set_vk *desc_set = s_priv->desc_set;
+
+    ngpu_darray_clear(&s_priv->write_desc_sets);
+    ngpu_darray_clear(&s_priv->image_infos);
+    ngpu_darray_clear(&s_priv->buffer_infos);
+
+    for (size_t i = 0; i < s_priv->texture_bindings.count; i++) {
+        struct texture_binding_vk *binding = &s_priv->texture_bindings.data[i];
+        if (!binding->update_desc)
+            continue;
+
+        const struct ngpu_texture_vk *texture_vk = NGPU_PRIV_VK(binding->texture);
+        const VkDescriptorImageInfo image_info = {
+            .imageLayout = texture_vk->default_image_layout,
+            .imageView   = texture_vk->image_view,
+            .sampler     = texture_vk->sampler,
+        };
+        if (ngpu_darray_push(&s_priv->image_infos, image_info) < 0)
+            return NGPU_ERROR_MEMORY;
+
+        const struct ngpu_bindgroup_layout_entry *desc = &binding->layout_entry;
+        const VkWriteDescriptorSet write_descriptor_set = {
+            .sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet           = desc_set->desc_set,
+            .dstBinding       = desc->binding,
+            .dstArrayElement  = 0,
+            .descriptorType   = get_vk_descriptor_type(desc->type),
+            .descriptorCount  = 1,
+            .pImageInfo       = ngpu_darray_tail(&s_priv->image_infos),
+        };
+        if (ngpu_darray_push(&s_priv->write_desc_sets, write_descriptor_set) < 0)
+            return NGPU_ERROR_MEMORY;
+
+        /* Keep the texture alive as long as the set is in use */
+        NGPU_RC_UNREFP(&desc_set->textures[i]);
+        desc_set->textures[i] = NGPU_RC_REF(binding->texture);
+
+        binding->update_desc = 0;
     }
 
     ngpu_darray_foreach(binding, &s_priv->buffer_bindings) {
-        if (binding->update_desc) {
-            ngpu_assert(binding->buffer);
-            const struct ngpu_bindgroup_layout_entry *desc = &binding->layout_entry;
-            const struct ngpu_buffer_vk *buffer_vk = NGPU_PRIV_VK(binding->buffer);
-            const VkDescriptorBufferInfo descriptor_buffer_info = {
-                .buffer = buffer_vk->buffer,
-                .offset = binding->offset,
-                .range  = binding->size,
-            };
-            const VkWriteDescriptorSet write_descriptor_set = {
-                .sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-                .dstSet           = s_priv->desc_set,
-                .dstBinding       = desc->binding,
-                .dstArrayElement  = 0,
-                .descriptorType   = get_vk_descriptor_type(desc->type),
-                .descriptorCount  = 1,
-                .pBufferInfo      = &descriptor_buffer_info,
-                .pImageInfo       = NULL,
-                .pTexelBufferView = NULL,
-            };
-            vk->funcs.UpdateDescriptorSets(vk->device, 1, &write_descriptor_set, 0, NULL);
-            binding->update_desc = 0;
-        }
+        if (!binding->update_desc)
+            continue;
+
+        ngpu_assert(binding->buffer);
+        const struct ngpu_bindgroup_layout_entry *desc = &binding->layout_entry;
+        const struct ngpu_buffer_vk *buffer_vk = NGPU_PRIV_VK(binding->buffer);
+        const VkDescriptorBufferInfo descriptor_buffer_info = {
+            .buffer = buffer_vk->buffer,
+            .offset = binding->offset,
+            .range  = binding->size,
+        };
+        if (ngpu_darray_push(&s_priv->buffer_infos, descriptor_buffer_info) < 0)
+            return NGPU_ERROR_MEMORY;
+
+        const VkWriteDescriptorSet write_descriptor_set = {
+            .sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet           = desc_set->desc_set,
+            .dstBinding       = desc->binding,
+            .dstArrayElement  = 0,
+            .descriptorType   = get_vk_descriptor_type(desc->type),
+            .descriptorCount  = 1,
+            .pBufferInfo      = ngpu_darray_tail(&s_priv->buffer_infos),
+            .pImageInfo       = NULL,
+            .pTexelBufferView = NULL,
+        };
+        if (ngpu_darray_push(&s_priv->write_desc_sets, write_descriptor_set) < 0)
+            return NGPU_ERROR_MEMORY;
+
+        binding->update_desc = 0;
     }
 
+    if (!ngpu_darray_is_empty(&s_priv->write_desc_sets))
+        vk->funcs.UpdateDescriptorSets(vk->device, (uint32_t)s_priv->write_desc_sets.count,
+                                       s_priv->write_desc_sets.data, 0, NULL);
+
+    s_priv->update_desc = 0;
+
     return 0;
 }
 
@@ -483,9 +619,13 @@ void ngpu_bindgroup_vk_freep(struct ngpu_bindgroup **sp)
     struct ngpu_bindgroup *s = *sp;
     struct ngpu_bindgroup_vk *s_priv = NGPU_PRIV_VK(s);
 
+    NGPU_RC_UNREFP(&s_priv->desc_set);
     NGPU_RC_UNREFP(&s->layout);
     ngpu_darray_reset(&s_priv->texture_bindings);
     ngpu_darray_reset(&s_priv->buffer_bindings);
+    ngpu_darray_reset(&s_priv->write_desc_sets);
+    ngpu_darray_reset(&s_priv->image_infos);
+    ngpu_darray_reset(&s_priv->buffer_infos);
 
     ngpu_freep(sp);
 }
@@ -27,6 +27,7 @@
 
 #include "bindgroup.h"
 #include "utils/darray.h"
+#include "utils/refcount.h"
 
 struct ngpu_ctx;
 struct ngpu_ycbcr_sampler_vk;
@@ -57,14 +58,34 @@ struct ngpu_bindgroup_layout_vk {
     uint32_t max_desc_sets;
     NGPU_DARRAY(VkDescriptorPool) desc_pools;
     size_t desc_pool_index;
+    NGPU_DARRAY(VkDescriptorSet) free_desc_sets;
 };
 
+/*
+ * Reference counted descriptor set: command buffers hold a reference on the
+ * set they bind (instead of the bindgroup itself) along with the textures
+ * written into it, so a bindgroup can be updated while a previous version of
+ * its set is still in flight. Once released, the set goes back to the layout
+ * free list.
+ */
+struct desc_set_vk {
+    struct ngpu_rc rc;
+    struct ngpu_bindgroup_layout *layout;
+    VkDescriptorSet desc_set;
+    const struct ngpu_texture **textures;
+};
+
+NGPU_RC_CHECK_STRUCT(desc_set_vk);
+
 struct ngpu_bindgroup_vk {
     struct ngpu_bindgroup parent;
     NGPU_DARRAY(struct texture_binding_vk) texture_bindings;
     NGPU_DARRAY(struct buffer_binding_vk) buffer_bindings;
-    VkDescriptorSet desc_set;
+    struct desc_set_vk *desc_set;
+    uint32_t update_desc;
     NGPU_DARRAY(VkWriteDescriptorSet) write_desc_sets;
+    NGPU_DARRAY(VkDescriptorImageInfo) image_infos;
+    NGPU_DARRAY(VkDescriptorBufferInfo) buffer_infos;
 };
 
 struct ngpu_bindgroup_layout *ngpu_bindgroup_layout_vk_create(struct ngpu_ctx *gpu_ctx);
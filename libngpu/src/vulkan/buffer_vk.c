@@ -28,19 +28,23 @@
 #include "vulkan/buffer_vk.h"
 #include "vulkan/ctx_vk.h"
 #include "vulkan/priv_vk.h"
+#include "vulkan/upload_vk.h"
 #include "vulkan/vkcontext.h"
 #include "vulkan/vkutils.h"
 #include "utils/memory.h"
 
-static VkResult create_vk_buffer(struct vkcontext *vk,
+static VkResult create_vk_buffer(struct ngpu_ctx *gpu_ctx,
                                  VkDeviceSize size,
                                  VkBufferUsageFlags usage,
                                  VkMemoryPropertyFlags mem_props,
+                                 enum ngpu_memory_pool_vk pool,
                                  VkBuffer *bufferp,
-                                 VkDeviceMemory *memoryp)
+                                 struct ngpu_allocation_vk *memoryp)
 {
+    struct ngpu_ctx_vk *gpu_ctx_vk = NGPU_PRIV_VK(gpu_ctx);
+    struct vkcontext *vk = gpu_ctx_vk->vkcontext;
     VkBuffer buffer = VK_NULL_HANDLE;
-    VkDeviceMemory memory = VK_NULL_HANDLE;
+    struct ngpu_allocation_vk memory = {0};
 
     const VkBufferCreateInfo buffer_create_info = {
         .sType       = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
@@ -66,16 +70,11 @@ static VkResult create_vk_buffer(struct vkcontext *vk,
         }
     }
 
-    const VkMemoryAllocateInfo memory_allocate_info = {
-        .sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-        .allocationSize  = mem_reqs.size,
-        .memoryTypeIndex = mem_type_index,
-    };
-    res = vk->funcs.AllocateMemory(vk->device, &memory_allocate_info, NULL, &memory);
+    res = ngpu_allocator_vk_alloc(gpu_ctx_vk->allocator, &mem_reqs, mem_type_index, 0, pool, &memory);
     if (res != VK_SUCCESS)
         goto fail;
 
-    res = vk->funcs.BindBufferMemory(vk->device, buffer, memory, 0);
+    res = vk->funcs.BindBufferMemory(vk->device, buffer, memory.memory, memory.offset);
     if (res != VK_SUCCESS)
         goto fail;
 
@@ -86,7 +85,7 @@ static VkResult create_vk_buffer(struct vkcontext *vk,
 
 fail:
     vk->funcs.DestroyBuffer(vk->device, buffer, NULL);
-    vk->funcs.FreeMemory(vk->device, memory, NULL);
+    ngpu_allocator_vk_free(gpu_ctx_vk->allocator, &memory);
     return res;
 }
 
@@ -117,8 +116,6 @@ static void unref_cmd_buffer(void *user_arg, void *data)
 
 static VkResult buffer_vk_init(struct ngpu_buffer *s)
 {
-    struct ngpu_ctx_vk *gpu_ctx_vk = NGPU_PRIV_VK(s->gpu_ctx);
-    struct vkcontext *vk = gpu_ctx_vk->vkcontext;
     struct ngpu_buffer_vk *s_priv = NGPU_PRIV_VK(s);
 
     ngpu_darray_set_free_func(&s_priv->cmd_buffers, unref_cmd_buffer, NULL);
@@ -137,7 +134,8 @@ static VkResult buffer_vk_init(struct ngpu_buffer *s)
     }
 
     const VkBufferUsageFlags flags = get_vk_buffer_usage_flags(s->usage);
-    return create_vk_buffer(vk, s->size, flags, mem_props, &s_priv->buffer, &s_priv->memory);
+    return create_vk_buffer(s->gpu_ctx, s->size, flags, mem_props, NGPU_MEMORY_POOL_VK_DEFAULT,
+                            &s_priv->buffer, &s_priv->memory);
 }
 
 int ngpu_buffer_vk_init(struct ngpu_buffer *s)
@@ -159,6 +157,18 @@ int ngpu_buffer_vk_wait(struct ngpu_buffer *s)
     return 0;
 }
 
+static void record_barrier(struct vkcontext *vk, VkCommandBuffer cmd_buf,
+                           VkPipelineStageFlags src_stage, VkAccessFlags src_access,
+                           VkPipelineStageFlags dst_stage, VkAccessFlags dst_access)
+{
+    const VkMemoryBarrier barrier = {
+        .sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = src_access,
+        .dstAccessMask = dst_access,
+    };
+    vk->funcs.CmdPipelineBarrier(cmd_buf, src_stage, dst_stage, 0, 1, &barrier, 0, NULL, 0, NULL);
+}
+
 static VkResult buffer_vk_upload(struct ngpu_buffer *s, const void *data, size_t offset, size_t size)
 {
     struct ngpu_ctx_vk *gpu_ctx_vk = NGPU_PRIV_VK(s->gpu_ctx);
@@ -168,50 +178,57 @@ static VkResult buffer_vk_upload(struct ngpu_buffer *s, const void *data, size_t
     if (s->usage & NGPU_BUFFER_USAGE_MAP_READ ||
         s->usage & NGPU_BUFFER_USAGE_MAP_WRITE ||
         s->usage & NGPU_BUFFER_USAGE_DYNAMIC_BIT) {
-        void *mapped_data;
-        VkResult res = vk->funcs.MapMemory(vk->device, s_priv->memory, offset, size, 0, &mapped_data);
-        if (res != VK_SUCCESS)
-            return res;
-        memcpy(mapped_data, data, size);
-        vk->funcs.UnmapMemory(vk->device, s_priv->memory);
+        memcpy(s_priv->memory.mapped_data + offset, data, size);
         return VK_SUCCESS;
     }
 
-    const VkBufferUsageFlags usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-    const VkMemoryPropertyFlags mem_props = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                                            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-    VkResult res = create_vk_buffer(vk, s->size, usage, mem_props,
-                                    &s_priv->staging_buffer, &s_priv->staging_memory);
+    /*
+     * The data is staged in the frame upload ring and the copy is recorded
+     * in the frame command buffer, so that it is ordered with the commands
+     * recorded so far, instead of being waited for here.
+     */
+    struct ngpu_upload_alloc_vk alloc;
+    VkResult res = ngpu_upload_vk_alloc(gpu_ctx_vk->upload, size, 4, &alloc);
     if (res != VK_SUCCESS)
         return res;
 
-    uint8_t *mapped_data;
-    res = vk->funcs.MapMemory(vk->device, s_priv->staging_memory, 0, s->size, 0, (void *)&mapped_data);
-    if (res != VK_SUCCESS)
-        return res;
-    memcpy(mapped_data + offset, data, size);
-    vk->funcs.UnmapMemory(vk->device, s_priv->staging_memory);
+    memcpy(alloc.data, data, size);
+
+    /*
+     * Copies cannot be recorded inside a render pass: they go to the upload
+     * command buffer instead, which is submitted before the current one
+     * (and records its own barriers).
+     */
+    struct ngpu_cmd_buffer_vk *cmd_buffer_vk = gpu_ctx_vk->cur_cmd_buffer;
+    const bool in_frame = cmd_buffer_vk && !ngpu_ctx_is_render_pass_active(s->gpu_ctx);
+    if (!in_frame) {
+        res = ngpu_upload_vk_get_cmd_buffer(gpu_ctx_vk->upload, &cmd_buffer_vk);
+        if (res != VK_SUCCESS)
+            return res;
+    }
 
-    struct ngpu_cmd_buffer_vk *cmd_buffer_vk;
-    res = ngpu_cmd_buffer_vk_begin_transient(s->gpu_ctx, 0, &cmd_buffer_vk);
+    res = NGPU_CMD_BUFFER_VK_REF(cmd_buffer_vk, s);
     if (res != VK_SUCCESS)
         return res;
 
+    /* The buffer may still be accessed by the commands previously recorded */
+    if (in_frame)
+        record_barrier(vk, cmd_buffer_vk->cmd_buf,
+                       VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_ACCESS_MEMORY_WRITE_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+
     const VkBufferCopy region = {
-        .srcOffset = 0,
+        .srcOffset = alloc.offset,
         .dstOffset = offset,
         .size      = size,
     };
-    vk->funcs.CmdCopyBuffer(cmd_buffer_vk->cmd_buf, s_priv->staging_buffer, s_priv->buffer, 1, &region);
-
-    res = ngpu_cmd_buffer_vk_execute_transient(&cmd_buffer_vk);
-    if (res != VK_SUCCESS)
-        return res;
+    vk->funcs.CmdCopyBuffer(cmd_buffer_vk->cmd_buf, alloc.buffer, s_priv->buffer, 1, &region);
 
-    vk->funcs.DestroyBuffer(vk->device, s_priv->staging_buffer, NULL);
-    s_priv->staging_buffer = VK_NULL_HANDLE;
-    vk->funcs.FreeMemory(vk->device, s_priv->staging_memory, NULL);
-    s_priv->staging_memory = VK_NULL_HANDLE;
+    /* Make the copy visible to the commands recorded next */
+    if (in_frame)
+        record_barrier(vk, cmd_buffer_vk->cmd_buf,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                       VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT);
 
     return VK_SUCCESS;
 }
@@ -224,30 +241,21 @@ int ngpu_buffer_vk_upload(struct ngpu_buffer *s, const void *data, size_t offset
     return ngpu_vk_res2ret(res);
 }
 
-static VkResult buffer_vk_map(struct ngpu_buffer *s, size_t offset, size_t size, void **data)
+int ngpu_buffer_vk_map(struct ngpu_buffer *s, size_t offset, size_t size, void **data)
 {
-    struct ngpu_ctx_vk *gpu_ctx_vk = NGPU_PRIV_VK(s->gpu_ctx);
-    struct vkcontext *vk = gpu_ctx_vk->vkcontext;
     struct ngpu_buffer_vk *s_priv = NGPU_PRIV_VK(s);
 
-    return vk->funcs.MapMemory(vk->device, s_priv->memory, offset, size, 0, data);
-}
-
-int ngpu_buffer_vk_map(struct ngpu_buffer *s, size_t offset, size_t size, void **data)
-{
-    VkResult res = buffer_vk_map(s, offset, size, data);
-    if (res != VK_SUCCESS)
-        LOG(ERROR, "unable to map buffer: %s", ngpu_vk_res2str(res));
-    return ngpu_vk_res2ret(res);
+    /* Host-visible memory blocks are persistently mapped by the allocator */
+    if (!s_priv->memory.mapped_data) {
+        LOG(ERROR, "unable to map buffer: memory is not host-visible");
+        return NGPU_ERROR_GRAPHICS_GENERIC;
+    }
+    *data = s_priv->memory.mapped_data + offset;
+    return 0;
 }
 
 void ngpu_buffer_vk_unmap(struct ngpu_buffer *s)
 {
-    struct ngpu_ctx_vk *gpu_ctx_vk = NGPU_PRIV_VK(s->gpu_ctx);
-    struct vkcontext *vk = gpu_ctx_vk->vkcontext;
-    struct ngpu_buffer_vk *s_priv = NGPU_PRIV_VK(s);
-
-    vk->funcs.UnmapMemory(vk->device, s_priv->memory);
 }
 
 static size_t buffer_vk_find_cmd_buffer(struct ngpu_buffer *s, struct ngpu_cmd_buffer_vk *cmd_buffer)
@@ -304,8 +312,6 @@ void ngpu_buffer_vk_freep(struct ngpu_buffer **sp)
     ngpu_darray_reset(&s_priv->cmd_buffers);
 
     vk->funcs.DestroyBuffer(vk->device, s_priv->buffer, NULL);
-    vk->funcs.FreeMemory(vk->device, s_priv->memory, NULL);
-    vk->funcs.DestroyBuffer(vk->device, s_priv->staging_buffer, NULL);
-    vk->funcs.FreeMemory(vk->device, s_priv->staging_memory, NULL);
+    ngpu_allocator_vk_free(gpu_ctx_vk->allocator, &s_priv->memory);
     ngpu_freep(sp);
 }
@@ -26,15 +26,14 @@
 #include <vulkan/vulkan.h>
 
 #include "buffer.h"
+#include "vulkan/allocator_vk.h"
 #include "vulkan/cmd_buffer_vk.h"
 #include "utils/darray.h"
 
 struct ngpu_buffer_vk {
     struct ngpu_buffer parent;
     VkBuffer buffer;
-    VkDeviceMemory memory;
-    VkBuffer staging_buffer;
-    VkDeviceMemory staging_memory;
+    struct ngpu_allocation_vk memory;
     NGPU_DARRAY(struct ngpu_cmd_buffer_vk *) cmd_buffers;
 };
 
@@ -25,6 +25,7 @@
 #include "vulkan/ctx_vk.h"
 #include "vulkan/fence_vk.h"
 #include "vulkan/priv_vk.h"
+#include "vulkan/upload_vk.h"
 #include "utils/darray.h"
 #include "utils/memory.h"
 
@@ -198,6 +199,13 @@ VkResult ngpu_cmd_buffer_vk_submit(struct ngpu_cmd_buffer_vk *s, struct ngpu_fen
     struct ngpu_ctx_vk *gpu_ctx_vk = NGPU_PRIV_VK(s->gpu_ctx);
     struct vkcontext *vk = gpu_ctx_vk->vkcontext;
 
+    /* Pending uploads must be executed before any subsequent work */
+    if (gpu_ctx_vk->upload) {
+        VkResult res = ngpu_upload_vk_flush(gpu_ctx_vk->upload);
+        if (res != VK_SUCCESS)
+            return res;
+    }
+
     VkResult res = vk->funcs.EndCommandBuffer(s->cmd_buf);
     if (res != VK_SUCCESS)
         return res;
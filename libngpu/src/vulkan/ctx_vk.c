@@ -31,9 +31,11 @@
 #include "utils/darray.h"
 #include "utils/log.h"
 #include "utils/memory.h"
+#include "utils/string.h"
 #include "utils/time.h"
 
 #include "ngpu/ngpu_vulkan.h"
+#include "vulkan/allocator_vk.h"
 #include "vulkan/bindgroup_vk.h"
 #include "vulkan/buffer_vk.h"
 #include "vulkan/ctx_vk.h"
@@ -45,6 +47,7 @@
 #include "vulkan/rendertarget_vk.h"
 #include "vulkan/fence_vk.h"
 #include "vulkan/texture_vk.h"
+#include "vulkan/upload_vk.h"
 #include "vulkan/vkcontext.h"
 #include "vulkan/vkutils.h"
 
@@ -174,6 +177,38 @@ static void free_rendertarget(void *user_arg, void *data)
     ngpu_rendertarget_freep(rtp);
 }
 
+static void free_capture_slot(void *user_arg, void *data)
+{
+    struct ngpu_capture_slot_vk *slot = data;
+    if (slot->data)
+        ngpu_buffer_unmap(slot->buffer);
+    ngpu_buffer_freep(&slot->buffer);
+}
+
+static VkResult create_capture_slot(struct ngpu_ctx *s)
+{
+    struct ngpu_ctx_vk *s_priv = NGPU_PRIV_VK(s);
+    const struct ngpu_ctx_params *ctx_params = &s->params;
+
+    struct ngpu_capture_slot_vk slot = {0};
+    slot.buffer = ngpu_buffer_create(s);
+    if (!slot.buffer)
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+
+    /* MAP_READ buffers are allocated in host cached memory when available */
+    const size_t size = (size_t)ctx_params->width * (size_t)ctx_params->height * 4;
+    const uint32_t usage = NGPU_BUFFER_USAGE_MAP_READ | NGPU_BUFFER_USAGE_TRANSFER_DST_BIT;
+    int ret = ngpu_buffer_init(slot.buffer, size, usage);
+    if (ret == 0)
+        ret = ngpu_buffer_map(slot.buffer, 0, size, &slot.data);
+    if (ret < 0 || ngpu_darray_push(&s_priv->capture_slots, slot) < 0) {
+        free_capture_slot(NULL, &slot);
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
+
+    return VK_SUCCESS;
+}
+
 #define COLOR_USAGE (NGPU_TEXTURE_USAGE_COLOR_ATTACHMENT_BIT | NGPU_TEXTURE_USAGE_TRANSFER_SRC_BIT)
 #define DEPTH_USAGE NGPU_TEXTURE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT
 
@@ -187,6 +222,7 @@ static VkResult create_render_resources(struct ngpu_ctx *s)
     ngpu_darray_set_free_func(&s_priv->ms_colors, free_texture, NULL);
     ngpu_darray_set_free_func(&s_priv->depth_stencils, free_texture, NULL);
     ngpu_darray_set_free_func(&s_priv->rts, free_rendertarget, NULL);
+    ngpu_darray_set_free_func(&s_priv->capture_slots, free_capture_slot, NULL);
 
     const enum ngpu_format color_format = ctx_params->offscreen
                            ? NGPU_FORMAT_R8G8B8A8_UNORM
@@ -265,6 +301,12 @@ static VkResult create_render_resources(struct ngpu_ctx *s)
             ngpu_rendertarget_freep(&rt);
             return VK_ERROR_OUT_OF_HOST_MEMORY;
         }
+
+        if (ctx_params->async_capture) {
+            res = create_capture_slot(s);
+            if (res != VK_SUCCESS)
+                return res;
+        }
     }
 
     return VK_SUCCESS;
@@ -278,8 +320,12 @@ static void destroy_render_resources(struct ngpu_ctx *s)
     ngpu_darray_reset(&s_priv->ms_colors);
     ngpu_darray_reset(&s_priv->depth_stencils);
     ngpu_darray_reset(&s_priv->rts);
+    ngpu_darray_reset(&s_priv->capture_slots);
 }
 
+/* Draw start and end, followed by the start and end of each timed render pass */
+#define NB_QUERIES (2 + 2 * NGPU_MAX_TIMED_RENDER_PASSES)
+
 static VkResult create_query_pool(struct ngpu_ctx *s)
 {
     struct ngpu_ctx_vk *s_priv = NGPU_PRIV_VK(s);
@@ -288,7 +334,7 @@ static VkResult create_query_pool(struct ngpu_ctx *s)
     const VkQueryPoolCreateInfo create_info = {
         .sType      = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
         .queryType  = VK_QUERY_TYPE_TIMESTAMP,
-        .queryCount = 2,
+        .queryCount = NB_QUERIES,
     };
 
     return vk->funcs.CreateQueryPool(vk->device, &create_info, NULL, &s_priv->query_pool);
@@ -302,6 +348,98 @@ static void destroy_query_pool(struct ngpu_ctx *s)
     vk->funcs.DestroyQueryPool(vk->device, s_priv->query_pool, NULL);
 }
 
+static char *get_pipeline_cache_key(const struct vkcontext *vk)
+{
+    /*
+     * The driver validates the pipeline cache header on its own, but keying
+     * the entry on the device identity allows multiple devices (or driver
+     * versions) to share the same cache directory without evicting each
+     * other.
+     */
+    const VkPhysicalDeviceProperties *props = &vk->phy_device_props;
+    const uint8_t *uuid = props->pipelineCacheUUID;
+    return ngpu_asprintf("vendor:%08x device:%08x driver:%08x uuid:"
+                         "%02x%02x%02x%02x%02x%02x%02x%02x"
+                         "%02x%02x%02x%02x%02x%02x%02x%02x",
+                         props->vendorID, props->deviceID, props->driverVersion,
+                         uuid[0], uuid[1], uuid[2],  uuid[3],  uuid[4],  uuid[5],  uuid[6],  uuid[7],
+                         uuid[8], uuid[9], uuid[10], uuid[11], uuid[12], uuid[13], uuid[14], uuid[15]);
+}
+
+static VkResult create_pipeline_cache(struct ngpu_ctx *s)
+{
+    struct ngpu_ctx_vk *s_priv = NGPU_PRIV_VK(s);
+    struct vkcontext *vk = s_priv->vkcontext;
+
+    void *data = NULL;
+    size_t size = 0;
+    if (s->disk_cache) {
+        char *key = get_pipeline_cache_key(vk);
+        if (!key)
+            return VK_ERROR_OUT_OF_HOST_MEMORY;
+        ngpu_diskcache_load(s->disk_cache, "vkpipelinecache", key, strlen(key), &data, &size);
+        ngpu_free(key);
+    }
+
+    VkPipelineCacheCreateInfo create_info = {
+        .sType           = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+        .initialDataSize = size,
+        .pInitialData    = data,
+    };
+
+    VkResult res = vk->funcs.CreatePipelineCache(vk->device, &create_info, NULL, &s_priv->pipeline_cache);
+    if (res != VK_SUCCESS && data) {
+        /* Retry without the initial data in case the driver rejected it */
+        LOG(WARNING, "could not restore pipeline cache: %s", ngpu_vk_res2str(res));
+        create_info.initialDataSize = 0;
+        create_info.pInitialData = NULL;
+        res = vk->funcs.CreatePipelineCache(vk->device, &create_info, NULL, &s_priv->pipeline_cache);
+    }
+    ngpu_free(data);
+
+    return res;
+}
+
+static void store_pipeline_cache(struct ngpu_ctx *s)
+{
+    struct ngpu_ctx_vk *s_priv = NGPU_PRIV_VK(s);
+    struct vkcontext *vk = s_priv->vkcontext;
+
+    size_t size = 0;
+    VkResult res = vk->funcs.GetPipelineCacheData(vk->device, s_priv->pipeline_cache, &size, NULL);
+    if (res != VK_SUCCESS || !size)
+        return;
+
+    void *data = ngpu_malloc(size);
+    if (!data)
+        return;
+
+    res = vk->funcs.GetPipelineCacheData(vk->device, s_priv->pipeline_cache, &size, data);
+    if (res == VK_SUCCESS) {
+        char *key = get_pipeline_cache_key(vk);
+        if (key) {
+            ngpu_diskcache_store(s->disk_cache, "vkpipelinecache", key, strlen(key), data, size);
+            ngpu_free(key);
+        }
+    }
+    ngpu_free(data);
+}
+
+static void destroy_pipeline_cache(struct ngpu_ctx *s)
+{
+    struct ngpu_ctx_vk *s_priv = NGPU_PRIV_VK(s);
+    struct vkcontext *vk = s_priv->vkcontext;
+
+    if (!s_priv->pipeline_cache)
+        return;
+
+    if (s->disk_cache)
+        store_pipeline_cache(s);
+
+    vk->funcs.DestroyPipelineCache(vk->device, s_priv->pipeline_cache, NULL);
+    s_priv->pipeline_cache = VK_NULL_HANDLE;
+}
+
 static VkResult create_command_pool_and_buffers(struct ngpu_ctx *s)
 {
     struct ngpu_ctx_vk *s_priv = NGPU_PRIV_VK(s);
@@ -805,6 +943,10 @@ static int vk_init(struct ngpu_ctx *s)
             LOG(ERROR, "capture_buffer is not supported by onscreen context");
             return NGPU_ERROR_INVALID_ARG;
         }
+        if (ctx_params->async_capture) {
+            LOG(ERROR, "async_capture is not supported by onscreen context");
+            return NGPU_ERROR_INVALID_ARG;
+        }
     }
 
 #if DEBUG_GPU_CAPTURE
@@ -923,6 +1065,8 @@ static int vk_init(struct ngpu_ctx *s)
     s->limits.max_storage_block_size             = limits->maxStorageBufferRange;
     s->limits.min_uniform_block_offset_alignment = limits->minUniformBufferOffsetAlignment;
     s->limits.min_storage_block_offset_alignment = limits->minStorageBufferOffsetAlignment;
+    s->limits.max_vertex_storage_blocks          = limits->maxPerStageDescriptorStorageBuffers;
+    s->limits.max_fragment_storage_blocks        = limits->maxPerStageDescriptorStorageBuffers;
 
     if (ctx_params->set_surface_pts &&
         !ngpu_vkcontext_has_extension(vk, VK_GOOGLE_DISPLAY_TIMING_EXTENSION_NAME, 1)) {
@@ -937,10 +1081,18 @@ static int vk_init(struct ngpu_ctx *s)
     if (ret < 0)
         return ret;
 
+    s_priv->allocator = ngpu_allocator_vk_create(vk);
+    if (!s_priv->allocator)
+        return NGPU_ERROR_MEMORY;
+
     res = create_query_pool(s);
     if (res != VK_SUCCESS)
         return ngpu_vk_res2ret(res);
 
+    res = create_pipeline_cache(s);
+    if (res != VK_SUCCESS)
+        return ngpu_vk_res2ret(res);
+
     res = create_timeline_semaphore(s);
     if (res != VK_SUCCESS)
         return ngpu_vk_res2ret(res);
@@ -949,6 +1101,14 @@ static int vk_init(struct ngpu_ctx *s)
     if (res != VK_SUCCESS)
         return ngpu_vk_res2ret(res);
 
+    s_priv->upload = ngpu_upload_vk_create(s);
+    if (!s_priv->upload)
+        return NGPU_ERROR_MEMORY;
+
+    res = ngpu_upload_vk_init(s_priv->upload);
+    if (res != VK_SUCCESS)
+        return ngpu_vk_res2ret(res);
+
     res = create_dummy_texture(s);
     if (res != VK_SUCCESS)
         return ngpu_vk_res2ret(res);
@@ -1034,6 +1194,54 @@ static int vk_set_capture_buffer(struct ngpu_ctx *s, void *capture_buffer)
     return 0;
 }
 
+static void record_capture_readback(struct ngpu_ctx *s)
+{
+    struct ngpu_ctx_vk *s_priv = NGPU_PRIV_VK(s);
+    struct vkcontext *vk = s_priv->vkcontext;
+
+    struct ngpu_texture *color = s_priv->colors.data[s->current_frame_index];
+    struct ngpu_capture_slot_vk *slot = ngpu_darray_get(&s_priv->capture_slots, s->current_frame_index);
+    ngpu_texture_vk_copy_to_buffer(color, slot->buffer);
+
+    /* Make the transfer visible to the host once the timeline value is signaled */
+    const VkMemoryBarrier barrier = {
+        .sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_HOST_READ_BIT,
+    };
+    const VkPipelineStageFlags src_stage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    const VkPipelineStageFlags dst_stage = VK_PIPELINE_STAGE_HOST_BIT;
+    vk->funcs.CmdPipelineBarrier(s_priv->cur_cmd_buffer->cmd_buf, src_stage, dst_stage, 0, 1, &barrier, 0, NULL, 0, NULL);
+}
+
+static int vk_read_capture(struct ngpu_ctx *s, uint32_t frame_index, void *data, int wait)
+{
+    struct ngpu_ctx_vk *s_priv = NGPU_PRIV_VK(s);
+    struct vkcontext *vk = s_priv->vkcontext;
+
+    const struct ngpu_capture_slot_vk *slot = ngpu_darray_get(&s_priv->capture_slots, frame_index);
+    if (!slot->signal_value) {
+        LOG(ERROR, "no frame has been captured at index %u", frame_index);
+        return NGPU_ERROR_INVALID_USAGE;
+    }
+
+    const VkSemaphoreWaitInfo wait_info = {
+        .sType          = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+        .semaphoreCount = 1,
+        .pSemaphores    = &s_priv->timeline_sem,
+        .pValues        = &slot->signal_value,
+    };
+    VkResult res = vk->funcs.WaitSemaphores(vk->device, &wait_info, wait ? UINT64_MAX : 0);
+    if (res == VK_TIMEOUT)
+        return NGPU_ERROR_BUSY;
+    if (res != VK_SUCCESS)
+        return ngpu_vk_res2ret(res);
+
+    memcpy(data, slot->data, ngpu_buffer_get_size(slot->buffer));
+
+    return 0;
+}
+
 static VkResult vk_add_pending_wait_value(struct ngpu_ctx *s)
 {
     struct ngpu_ctx_vk *s_priv = NGPU_PRIV_VK(s);
@@ -1129,8 +1337,10 @@ static int vk_begin_draw(struct ngpu_ctx *s)
 
     if (ctx_params->timer_queries) {
         struct vkcontext *vk = s_priv->vkcontext;
-        vk->funcs.CmdResetQueryPool(s_priv->cur_cmd_buffer->cmd_buf, s_priv->query_pool, 0, 2);
+        vk->funcs.CmdResetQueryPool(s_priv->cur_cmd_buffer->cmd_buf, s_priv->query_pool, 0, NB_QUERIES);
         vk->funcs.CmdWriteTimestamp(s_priv->cur_cmd_buffer->cmd_buf, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, s_priv->query_pool, 0);
+        s_priv->time_render_passes = 1;
+        s_priv->nb_timed_render_passes = 0;
     }
 
     return 0;
@@ -1157,13 +1367,29 @@ static int vk_query_draw_time(struct ngpu_ctx *s, int64_t *time)
     if (res != VK_SUCCESS)
         return ngpu_vk_res2ret(res);
 
-    uint64_t results[2];
+    const uint32_t nb_passes = s_priv->nb_timed_render_passes;
+    const uint32_t nb_queries = 2 + 2 * nb_passes;
+    uint64_t results[NB_QUERIES];
     vk->funcs.GetQueryPoolResults(vk->device,
-                          s_priv->query_pool, 0, 2,
-                          sizeof(results), results, sizeof(results[0]),
+                          s_priv->query_pool, 0, nb_queries,
+                          nb_queries * sizeof(results[0]), results, sizeof(results[0]),
                           VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
 
-    *time = (int64_t)(results[1] - results[0]);
+    /* Timestamps are expressed in ticks of timestampPeriod nanoseconds */
+    const double period = vk->phy_device_props.limits.timestampPeriod;
+    *time = (int64_t)((double)(results[1] - results[0]) * period);
+
+    /* The queries have been consumed, the remaining render passes of the draw are not timed */
+    s_priv->time_render_passes = 0;
+
+    const uint64_t origin = results[2];
+    for (uint32_t i = 0; i < nb_passes; i++) {
+        s->render_pass_times[i] = (struct ngpu_render_pass_time){
+            .start = (int64_t)((double)(results[2 + 2 * i] - origin) * period),
+            .end   = (int64_t)((double)(results[3 + 2 * i] - origin) * period),
+        };
+    }
+    s->nb_render_pass_times = nb_passes;
 
     res = ngpu_cmd_buffer_vk_begin(s_priv->cur_cmd_buffer);
     if (res != VK_SUCCESS)
@@ -1185,15 +1411,28 @@ static int vk_end_draw(struct ngpu_ctx *s, double t, struct ngpu_fence *wait_fen
 
     struct ngpu_fence *signal_fence = signal_fencep ? *signal_fencep : NULL;
 
+    s_priv->time_render_passes = 0;
+
     int ret = 0;
     if (ctx_params->offscreen) {
+        if (ctx_params->async_capture)
+            record_capture_readback(s);
+
         VkResult res = ngpu_cmd_buffer_vk_submit(s_priv->cur_cmd_buffer, wait_fence, signal_fence);
         if (res != VK_SUCCESS) {
             ret = ngpu_vk_res2ret(res);
             goto fail;
         }
 
-        if (ctx_params->capture_buffer) {
+        if (ctx_params->async_capture) {
+            /*
+             * The pixels are retrieved later on with ngpu_ctx_read_capture(),
+             * the readback of this frame overlapping with the rendering of the
+             * next ones.
+             */
+            struct ngpu_capture_slot_vk *slot = ngpu_darray_get(&s_priv->capture_slots, s->current_frame_index);
+            slot->signal_value = s_priv->cur_cmd_buffer->signal_value;
+        } else if (ctx_params->capture_buffer) {
             res = ngpu_cmd_buffer_vk_wait(s_priv->cur_cmd_buffer);
             if (res != VK_SUCCESS) {
                 ret = ngpu_vk_res2ret(res);
@@ -1220,6 +1459,8 @@ static int vk_end_draw(struct ngpu_ctx *s, double t, struct ngpu_fence *wait_fen
         }
     }
 
+    ngpu_upload_vk_end_frame(s_priv->upload);
+
     s_priv->cur_cmd_buffer = NULL;
 
     return 0;
@@ -1263,12 +1504,15 @@ static void vk_destroy(struct ngpu_ctx *s)
     ngpu_capture_freep(&s->gpu_capture_ctx);
 #endif
 
+    ngpu_upload_vk_freep(&s_priv->upload);
     destroy_command_pool_and_buffers(s);
     destroy_timeline_semaphore(s);
     destroy_dummy_texture(s);
     destroy_render_resources(s);
     destroy_swapchain(s);
     destroy_query_pool(s);
+    destroy_pipeline_cache(s);
+    ngpu_allocator_vk_freep(&s_priv->allocator);
 
     ngpu_glslang_uninit();
 
@@ -1283,6 +1527,13 @@ static void vk_destroy(struct ngpu_ctx *s)
         s_priv->vkcontext = NULL;
 }
 
+static void vk_get_memory_stats(struct ngpu_ctx *s, struct ngpu_memory_stats *stats)
+{
+    struct ngpu_ctx_vk *s_priv = NGPU_PRIV_VK(s);
+    if (s_priv->allocator)
+        ngpu_allocator_vk_get_stats(s_priv->allocator, stats);
+}
+
 static void vk_wait_idle(struct ngpu_ctx *s)
 {
     struct ngpu_ctx_vk *s_priv = NGPU_PRIV_VK(s);
@@ -1397,6 +1648,10 @@ static void vk_begin_render_pass(struct ngpu_ctx *s, struct ngpu_rendertarget *r
         .pClearValues    = rt_vk->clear_values,
     };
     struct vkcontext *vk = s_priv->vkcontext;
+    if (s_priv->time_render_passes && s_priv->nb_timed_render_passes < NGPU_MAX_TIMED_RENDER_PASSES) {
+        const uint32_t query = 2 + 2 * s_priv->nb_timed_render_passes;
+        vk->funcs.CmdWriteTimestamp(cmd_buf, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, s_priv->query_pool, query);
+    }
     vk->funcs.CmdBeginRenderPass(cmd_buf, &render_pass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
 
     const VkViewport viewport = {
@@ -1428,6 +1683,12 @@ static void vk_end_render_pass(struct ngpu_ctx *s)
     VkCommandBuffer cmd_buf = s_priv->cur_cmd_buffer->cmd_buf;
     vk->funcs.CmdEndRenderPass(cmd_buf);
 
+    if (s_priv->time_render_passes && s_priv->nb_timed_render_passes < NGPU_MAX_TIMED_RENDER_PASSES) {
+        const uint32_t query = 3 + 2 * s_priv->nb_timed_render_passes;
+        vk->funcs.CmdWriteTimestamp(cmd_buf, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, s_priv->query_pool, query);
+        s_priv->nb_timed_render_passes++;
+    }
+
     const struct ngpu_rendertarget *rt = s->rendertarget;
     const struct ngpu_rendertarget_params *params = &rt->params;
 
@@ -1625,16 +1886,19 @@ void *ngpu_ctx_vk_get_mtl_device(struct ngpu_ctx *s)
 
 const struct ngpu_ctx_class ngpu_ctx_vk = {
     .id                                 = NGPU_BACKEND_VULKAN,
+    .concurrent_program_init            = true,
     .create                             = vk_create,
     .init                               = vk_init,
     .resize                             = vk_resize,
     .set_capture_buffer                 = vk_set_capture_buffer,
+    .read_capture                       = vk_read_capture,
     .begin_update                       = vk_begin_update,
     .end_update                         = vk_end_update,
     .begin_draw                         = vk_begin_draw,
     .query_draw_time                    = vk_query_draw_time,
     .end_draw                           = vk_end_draw,
     .wait_idle                          = vk_wait_idle,
+    .get_memory_stats                   = vk_get_memory_stats,
     .destroy                            = vk_destroy,
 
     .get_cull_mode                      = vk_get_cull_mode,
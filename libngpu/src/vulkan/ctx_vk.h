@@ -27,9 +27,17 @@
 
 #include "ctx.h"
 #include "utils/darray.h"
+#include "vulkan/allocator_vk.h"
 #include "vulkan/cmd_buffer_vk.h"
+#include "vulkan/upload_vk.h"
 #include "vulkan/vkcontext.h"
 
+struct ngpu_capture_slot_vk {
+    struct ngpu_buffer *buffer;
+    void *data;
+    uint64_t signal_value; /* timeline value signaled once the readback is complete, 0 if none */
+};
+
 struct ngpu_ctx_vk {
     struct ngpu_ctx parent;
     struct vkcontext *vkcontext;
@@ -53,7 +61,15 @@ struct ngpu_ctx_vk {
     struct ngpu_cmd_buffer_vk *cur_cmd_buffer;
     int cur_cmd_buffer_is_transient;
 
+    struct ngpu_upload_vk *upload;
+
     VkQueryPool query_pool;
+    int time_render_passes;
+    uint32_t nb_timed_render_passes;
+
+    VkPipelineCache pipeline_cache;
+
+    struct ngpu_allocator_vk *allocator;
 
     VkSurfaceCapabilitiesKHR surface_caps;
     VkSurfaceFormatKHR surface_format;
@@ -71,6 +87,7 @@ struct ngpu_ctx_vk {
     NGPU_DARRAY(struct ngpu_texture *) ms_colors;
     NGPU_DARRAY(struct ngpu_texture *) depth_stencils;
     NGPU_DARRAY(struct ngpu_rendertarget *) rts;
+    NGPU_DARRAY(struct ngpu_capture_slot_vk) capture_slots;
 
     struct ngpu_rendertarget *default_rt;
     struct ngpu_rendertarget_layout default_rt_layout;
@@ -331,7 +331,7 @@ static VkResult pipeline_graphics_init(struct ngpu_pipeline *s)
         .renderPass          = render_pass,
         .subpass             = 0,
     };
-    res = vk->funcs.CreateGraphicsPipelines(vk->device, VK_NULL_HANDLE, 1, &pipeline_create_info, NULL, &s_priv->pipeline);
+    res = vk->funcs.CreateGraphicsPipelines(vk->device, gpu_ctx_vk->pipeline_cache, 1, &pipeline_create_info, NULL, &s_priv->pipeline);
 
     vk->funcs.DestroyRenderPass(vk->device, render_pass, NULL);
 
@@ -360,7 +360,7 @@ static VkResult pipeline_compute_init(struct ngpu_pipeline *s)
         .layout = s_priv->pipeline_layout,
     };
 
-    return vk->funcs.CreateComputePipelines(vk->device, VK_NULL_HANDLE, 1, &pipeline_create_info, NULL, &s_priv->pipeline);
+    return vk->funcs.CreateComputePipelines(vk->device, gpu_ctx_vk->pipeline_cache, 1, &pipeline_create_info, NULL, &s_priv->pipeline);
 }
 
 static VkResult create_pipeline_layout(struct ngpu_pipeline *s)
@@ -434,16 +434,23 @@ static int prepare_and_bind_descriptor_set(struct ngpu_pipeline *s, VkCommandBuf
     if (!gpu_ctx->bindgroup)
         return 0;
 
-    ngpu_bindgroup_vk_update_descriptor_set(gpu_ctx->bindgroup);
+    int ret = ngpu_bindgroup_vk_update_descriptor_set(gpu_ctx->bindgroup);
+    if (ret < 0)
+        return ret;
 
-    NGPU_CMD_BUFFER_VK_REF(cmd_buffer_vk, gpu_ctx->bindgroup);
+    /*
+     * Reference the descriptor set rather than the bindgroup: this lets the
+     * bindgroup rotate to another set if it is updated while this command
+     * buffer is still in flight
+     */
     struct ngpu_bindgroup_vk *bindgroup_vk = NGPU_PRIV_VK(gpu_ctx->bindgroup);
     if (bindgroup_vk->desc_set) {
+        NGPU_CMD_BUFFER_VK_REF(cmd_buffer_vk, bindgroup_vk->desc_set);
         ngpu_darray_foreach(binding, &bindgroup_vk->buffer_bindings)
             ngpu_cmd_buffer_vk_ref_buffer(cmd_buffer_vk, (struct ngpu_buffer *)binding->buffer);
         struct vkcontext *vk = gpu_ctx_vk->vkcontext;
         vk->funcs.CmdBindDescriptorSets(cmd_buf, s_priv->pipeline_bind_point, s_priv->pipeline_layout, 0,
-                                1, &bindgroup_vk->desc_set,
+                                1, &bindgroup_vk->desc_set->desc_set,
                                 (uint32_t)gpu_ctx->nb_dynamic_offsets, gpu_ctx->dynamic_offsets);
     }
 
@@ -37,6 +37,41 @@
 #define VK_KHR_SHADER_RELAXED_EXTENDED_INSTRUCTION_EXTENSION_NAME "VK_KHR_shader_relaxed_extended_instruction"
 #endif
 
+static char *get_spirv_cache_key(enum ngpu_program_stage stage, const char *src, int debug, int emit_nonsemantic_info)
+{
+    /* The glslang version is part of the key since the generated SPIR-V may differ between releases */
+    return ngpu_asprintf("glslang:%d.%d.%d stage:%d debug:%d nonsemantic:%d\n%s",
+                         GLSLANG_VERSION_MAJOR, GLSLANG_VERSION_MINOR, GLSLANG_VERSION_PATCH,
+                         stage, debug, emit_nonsemantic_info, src);
+}
+
+static int compile_shader(struct ngpu_ctx *gpu_ctx, enum ngpu_program_stage stage, const char *src,
+                          int emit_nonsemantic_info, void **datap, size_t *sizep)
+{
+    const int debug = gpu_ctx->params.debug;
+    if (!gpu_ctx->disk_cache)
+        return ngpu_glslang_compile(stage, src, debug, emit_nonsemantic_info, datap, sizep);
+
+    char *key = get_spirv_cache_key(stage, src, debug, emit_nonsemantic_info);
+    if (!key)
+        return NGPU_ERROR_MEMORY;
+    const size_t key_size = strlen(key);
+
+    int ret = ngpu_diskcache_load(gpu_ctx->disk_cache, "spirv", key, key_size, datap, sizep);
+    if (ret == 0 && (*sizep % sizeof(uint32_t))) {
+        ngpu_freep(datap);
+        ret = NGPU_ERROR_INVALID_DATA;
+    }
+    if (ret < 0) {
+        ret = ngpu_glslang_compile(stage, src, debug, emit_nonsemantic_info, datap, sizep);
+        if (ret == 0)
+            ngpu_diskcache_store(gpu_ctx->disk_cache, "spirv", key, key_size, *datap, *sizep);
+    }
+    ngpu_free(key);
+
+    return ret;
+}
+
 struct ngpu_program *ngpu_program_vk_create(struct ngpu_ctx *gpu_ctx)
 {
     struct ngpu_program_vk *s = ngpu_calloc(1, sizeof(*s));
@@ -71,7 +106,7 @@ int ngpu_program_vk_init(struct ngpu_program *s, const struct ngpu_program_param
 
         void *data = NULL;
         size_t size = 0;
-        int ret = ngpu_glslang_compile(shaders[i].stage, shaders[i].src, s->gpu_ctx->params.debug, emit_nonsemantic_info, &data, &size);
+        int ret = compile_shader(gpu_ctx, shaders[i].stage, shaders[i].src, emit_nonsemantic_info, &data, &size);
         if (ret < 0) {
             char *s_with_numbers = ngpu_numbered_lines(shaders[i].src);
             if (s_with_numbers) {
@@ -33,6 +33,7 @@
 #include "vulkan/format_vk.h"
 #include "vulkan/priv_vk.h"
 #include "vulkan/texture_vk.h"
+#include "vulkan/upload_vk.h"
 #include "vulkan/vkutils.h"
 #include "vulkan/ycbcr_sampler_vk.h"
 #include "utils/bits.h"
@@ -431,21 +432,26 @@ static VkResult texture_vk_init(struct ngpu_texture *s, const struct ngpu_textur
             return VK_ERROR_FORMAT_NOT_SUPPORTED;
     }
 
-    const VkMemoryAllocateInfo alloc_info = {
-        .sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-        .allocationSize  = mem_reqs.size,
-        .memoryTypeIndex = mem_type_index,
-    };
-    res = vk->funcs.AllocateMemory(vk->device, &alloc_info, NULL, &s_priv->image_memory);
+    res = ngpu_allocator_vk_alloc(gpu_ctx_vk->allocator, &mem_reqs, mem_type_index, 1,
+                                  NGPU_MEMORY_POOL_VK_DEFAULT, &s_priv->image_allocation);
     if (res != VK_SUCCESS)
         return res;
 
-    res = vk->funcs.BindImageMemory(vk->device, s_priv->image, s_priv->image_memory, 0);
+    res = vk->funcs.BindImageMemory(vk->device, s_priv->image, s_priv->image_allocation.memory,
+                                    s_priv->image_allocation.offset);
     if (res != VK_SUCCESS)
         return res;
 
+    /*
+     * The initial layout transition is queued with the pending uploads,
+     * which are always submitted before any work using the texture.
+     */
     struct ngpu_cmd_buffer_vk *cmd_buffer_vk;
-    res = ngpu_cmd_buffer_vk_begin_transient(s->gpu_ctx, 0, &cmd_buffer_vk);
+    res = ngpu_upload_vk_get_cmd_buffer(gpu_ctx_vk->upload, &cmd_buffer_vk);
+    if (res != VK_SUCCESS)
+        return res;
+
+    res = NGPU_CMD_BUFFER_VK_REF(cmd_buffer_vk, s);
     if (res != VK_SUCCESS)
         return res;
 
@@ -463,10 +469,6 @@ static VkResult texture_vk_init(struct ngpu_texture *s, const struct ngpu_textur
                             s_priv->default_image_layout,
                             &subres_range);
 
-    res = ngpu_cmd_buffer_vk_execute_transient(&cmd_buffer_vk);
-    if (res != VK_SUCCESS)
-        return res;
-
     s_priv->image_layout = s_priv->default_image_layout;
 
     res = create_image_view(s);
@@ -1094,52 +1096,6 @@ int ngpu_texture_vk_read_pixels(struct ngpu_texture *s, uint8_t *data)
     return 0;
 }
 
-static void destroy_staging_buffer(struct ngpu_texture *s)
-{
-    struct ngpu_texture_vk *s_priv = NGPU_PRIV_VK(s);
-
-    if (s_priv->staging_buffer_ptr) {
-        ngpu_buffer_unmap(s_priv->staging_buffer);
-        s_priv->staging_buffer_ptr = NULL;
-    }
-    ngpu_buffer_freep(&s_priv->staging_buffer);
-}
-
-static int create_staging_buffer(struct ngpu_texture *s, size_t size)
-{
-    struct ngpu_texture_vk *s_priv = NGPU_PRIV_VK(s);
-
-    s_priv->staging_buffer = ngpu_buffer_create(s->gpu_ctx);
-    if (!s_priv->staging_buffer)
-        return NGPU_ERROR_MEMORY;
-
-    const uint32_t usage = NGPU_BUFFER_USAGE_DYNAMIC_BIT |
-                           NGPU_BUFFER_USAGE_TRANSFER_SRC_BIT |
-                           NGPU_BUFFER_USAGE_MAP_WRITE;
-    int ret = ngpu_buffer_init(s_priv->staging_buffer, size, usage);
-    if (ret < 0)
-        return ret;
-
-    ret = ngpu_buffer_map(s_priv->staging_buffer, 0, size, &s_priv->staging_buffer_ptr);
-    if (ret < 0)
-        return ret;
-
-    return 0;
-}
-
-static int texture_transfer_params_are_equal(const struct ngpu_texture_transfer_params *a, const struct ngpu_texture_transfer_params *b)
-{
-    return a->x              == b->x              &&
-           a->y              == b->y              &&
-           a->z              == b->z              &&
-           a->width          == b->width          &&
-           a->height         == b->height         &&
-           a->depth          == b->depth          &&
-           a->pixels_per_row == b->pixels_per_row &&
-           a->base_layer     == b->base_layer     &&
-           a->layer_count    == b->layer_count;
-}
-
 static VkResult texture_vk_upload(struct ngpu_texture *s, const uint8_t *data, const struct ngpu_texture_transfer_params *transfer_params)
 {
     struct ngpu_ctx_vk *gpu_ctx_vk = NGPU_PRIV_VK(s->gpu_ctx);
@@ -1159,34 +1115,32 @@ static VkResult texture_vk_upload(struct ngpu_texture *s, const uint8_t *data, c
                                      * s_priv->bytes_per_pixel;
     const size_t transfer_size = transfer_layer_size * transfer_params->layer_count;
 
-    if (s_priv->staging_buffer)
-        ngpu_buffer_wait(s_priv->staging_buffer);
-
-    if (!s_priv->staging_buffer ||
-        !texture_transfer_params_are_equal(&s_priv->last_transfer_params, transfer_params)) {
-        destroy_staging_buffer(s);
-
-        int ret = create_staging_buffer(s, transfer_size);
-        if (ret < 0)
-            return VK_ERROR_UNKNOWN;
-
-        s_priv->last_transfer_params = *transfer_params;
-    }
+    /*
+     * Copy offsets must be a multiple of both the texel size and 4, which is
+     * guaranteed by a multiple of their product.
+     */
+    const size_t alignment = s_priv->bytes_per_pixel * 4;
+    struct ngpu_upload_alloc_vk alloc;
+    VkResult res = ngpu_upload_vk_alloc(gpu_ctx_vk->upload, transfer_size, alignment, &alloc);
+    if (res != VK_SUCCESS)
+        return res;
 
-    memcpy(s_priv->staging_buffer_ptr, data, transfer_size);
+    memcpy(alloc.data, data, transfer_size);
 
+    /*
+     * Copies cannot be recorded inside a render pass: they go to the upload
+     * command buffer instead, which is submitted before the current one.
+     */
     struct ngpu_cmd_buffer_vk *cmd_buffer_vk = gpu_ctx_vk->cur_cmd_buffer;
-    const int cmd_is_transient = !cmd_buffer_vk || ngpu_ctx_is_render_pass_active(s->gpu_ctx);
-    if (cmd_is_transient) {
-        struct ngpu_cmd_buffer_vk *transient_cmd_buffer_vk;
-        VkResult res = ngpu_cmd_buffer_vk_begin_transient(s->gpu_ctx, 0, &transient_cmd_buffer_vk);
+    if (!cmd_buffer_vk || ngpu_ctx_is_render_pass_active(s->gpu_ctx)) {
+        res = ngpu_upload_vk_get_cmd_buffer(gpu_ctx_vk->upload, &cmd_buffer_vk);
         if (res != VK_SUCCESS)
             return res;
-        cmd_buffer_vk = transient_cmd_buffer_vk;
     }
     VkCommandBuffer cmd_buf = cmd_buffer_vk->cmd_buf;
-    NGPU_CMD_BUFFER_VK_REF(cmd_buffer_vk, s);
-    ngpu_cmd_buffer_vk_ref_buffer(cmd_buffer_vk, s_priv->staging_buffer);
+    res = NGPU_CMD_BUFFER_VK_REF(cmd_buffer_vk, s);
+    if (res != VK_SUCCESS)
+        return res;
 
     const VkImageSubresourceRange subres_range = {
         .aspectMask     = get_vk_image_aspect_flags(s_priv->format),
@@ -1205,7 +1159,7 @@ static VkResult texture_vk_upload(struct ngpu_texture *s, const uint8_t *data, c
     NGPU_DARRAY(VkBufferImageCopy) copy_regions = {0};
 
     for (uint32_t i = transfer_params->base_layer; i < transfer_params->layer_count; i++) {
-        const VkDeviceSize offset = i * transfer_layer_size;
+        const VkDeviceSize offset = alloc.offset + i * transfer_layer_size;
         const VkBufferImageCopy region = {
             .bufferOffset      = offset,
             .bufferRowLength   = transfer_params->pixels_per_row,
@@ -1230,16 +1184,12 @@ static VkResult texture_vk_upload(struct ngpu_texture *s, const uint8_t *data, c
 
         if (ngpu_darray_push(&copy_regions, region) < 0) {
             ngpu_darray_reset(&copy_regions);
-            if (cmd_is_transient) {
-                ngpu_cmd_buffer_vk_freep(&cmd_buffer_vk);
-            }
             return VK_ERROR_OUT_OF_HOST_MEMORY;
         }
     }
 
-    struct ngpu_buffer_vk *staging_buffer_vk = NGPU_PRIV_VK(s_priv->staging_buffer);
     vk->funcs.CmdCopyBufferToImage(cmd_buf,
-                           staging_buffer_vk->buffer,
+                           alloc.buffer,
                            s_priv->image,
                            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
                            (uint32_t)copy_regions.count,
@@ -1253,12 +1203,6 @@ static VkResult texture_vk_upload(struct ngpu_texture *s, const uint8_t *data, c
                             s_priv->image_layout,
                             &subres_range);
 
-    if (cmd_is_transient) {
-        VkResult res = ngpu_cmd_buffer_vk_execute_transient(&cmd_buffer_vk);
-        if (res != VK_SUCCESS)
-            return res;
-    }
-
     if (params->mipmap_filter != NGPU_MIPMAP_FILTER_NONE)
         ngpu_texture_generate_mipmap(s);
 
@@ -1298,13 +1242,10 @@ static VkResult texture_vk_generate_mipmap(struct ngpu_texture *s)
     ngpu_assert(params->usage & NGPU_TEXTURE_USAGE_TRANSFER_DST_BIT);
 
     struct ngpu_cmd_buffer_vk *cmd_buffer_vk = gpu_ctx_vk->cur_cmd_buffer;
-    const int cmd_is_transient = !cmd_buffer_vk || ngpu_ctx_is_render_pass_active(s->gpu_ctx);
-    if (cmd_is_transient) {
-        struct ngpu_cmd_buffer_vk *transient_cmd_buffer_vk;
-        VkResult res = ngpu_cmd_buffer_vk_begin_transient(s->gpu_ctx, 0, &transient_cmd_buffer_vk);
+    if (!cmd_buffer_vk || ngpu_ctx_is_render_pass_active(s->gpu_ctx)) {
+        VkResult res = ngpu_upload_vk_get_cmd_buffer(gpu_ctx_vk->upload, &cmd_buffer_vk);
         if (res != VK_SUCCESS)
             return res;
-        cmd_buffer_vk = transient_cmd_buffer_vk;
     }
     VkCommandBuffer cmd_buf = cmd_buffer_vk->cmd_buf;
     NGPU_CMD_BUFFER_VK_REF(cmd_buffer_vk, s);
@@ -1413,12 +1354,6 @@ static VkResult texture_vk_generate_mipmap(struct ngpu_texture *s)
                          0, NULL,
                          1, &barrier);
 
-    if (cmd_is_transient) {
-        VkResult res = ngpu_cmd_buffer_vk_execute_transient(&cmd_buffer_vk);
-        if (res != VK_SUCCESS)
-            return res;
-    }
-
     return VK_SUCCESS;
 }
 
@@ -1450,8 +1385,7 @@ void ngpu_texture_vk_freep(struct ngpu_texture **sp)
     if (s_priv->acquire_sem != VK_NULL_HANDLE)
         vk->funcs.DestroySemaphore(vk->device, s_priv->acquire_sem, NULL);
     vk->funcs.FreeMemory(vk->device, s_priv->image_memory, NULL);
-
-    destroy_staging_buffer(s);
+    ngpu_allocator_vk_free(gpu_ctx_vk->allocator, &s_priv->image_allocation);
 
     if (s_priv->readback_buffer_ptr) {
         ngpu_buffer_unmap(s_priv->readback_buffer);
@@ -26,6 +26,7 @@
 
 #include "buffer.h"
 #include "texture.h"
+#include "vulkan/allocator_vk.h"
 #include "vulkan/vkcontext.h"
 #include "vulkan/ycbcr_sampler_vk.h"
 
@@ -48,16 +49,14 @@ struct ngpu_texture_vk {
     int wrapped_image;
     VkImageLayout default_image_layout;
     VkImageLayout image_layout;
-    VkDeviceMemory image_memory;
+    VkDeviceMemory image_memory; /* imported memory only */
+    struct ngpu_allocation_vk image_allocation;
     VkImageView image_view;
     int wrapped_image_view;
     VkSampler sampler;
     int wrapped_sampler;
     int use_ycbcr_sampler;
     struct ngpu_ycbcr_sampler_vk *ycbcr_sampler;
-    struct ngpu_buffer *staging_buffer;
-    void *staging_buffer_ptr;
-    struct ngpu_texture_transfer_params last_transfer_params;
     struct ngpu_buffer *readback_buffer;
     void *readback_buffer_ptr;
     int fd;
@@ -0,0 +1,323 @@
+/*
+ * Copyright 2026 Matthieu Bouron <matthieu.bouron@gmail.com>
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdint.h>
+
+#include "buffer.h"
+#include "ctx.h"
+#include "utils/darray.h"
+#include "utils/memory.h"
+#include "utils/utils.h"
+#include "vulkan/buffer_vk.h"
+#include "vulkan/ctx_vk.h"
+#include "vulkan/upload_vk.h"
+
+#define CHUNK_MIN_SIZE (4 * 1024 * 1024)
+
+struct chunk {
+    struct ngpu_buffer *buffer;
+    uint8_t *data;
+    size_t size;
+};
+
+struct segment {
+    NGPU_DARRAY(struct chunk) chunks;
+    size_t cur_chunk;
+    size_t offset;
+    NGPU_DARRAY(struct ngpu_cmd_buffer_vk *) cmd_buffers;
+    size_t nb_used_cmd_buffers;
+    uint64_t retire_value; /* timeline value signaled once the segment is no longer in use, 0 if none */
+};
+
+struct ngpu_upload_vk {
+    struct ngpu_ctx *gpu_ctx;
+    struct segment *segments;
+    uint32_t nb_segments;
+    struct ngpu_cmd_buffer_vk *pending_cmd_buffer;
+};
+
+static void free_chunk(void *user_arg, void *data)
+{
+    struct chunk *chunk = data;
+    ngpu_buffer_freep(&chunk->buffer);
+}
+
+static void free_cmd_buffer(void *user_arg, void *data)
+{
+    struct ngpu_cmd_buffer_vk **cmd_bufferp = data;
+    ngpu_cmd_buffer_vk_wait(*cmd_bufferp);
+    ngpu_cmd_buffer_vk_freep(cmd_bufferp);
+}
+
+struct ngpu_upload_vk *ngpu_upload_vk_create(struct ngpu_ctx *gpu_ctx)
+{
+    struct ngpu_upload_vk *s = ngpu_calloc(1, sizeof(*s));
+    if (!s)
+        return NULL;
+    s->gpu_ctx = gpu_ctx;
+    return s;
+}
+
+VkResult ngpu_upload_vk_init(struct ngpu_upload_vk *s)
+{
+    s->nb_segments = s->gpu_ctx->nb_in_flight_frames;
+    s->segments = ngpu_calloc(s->nb_segments, sizeof(*s->segments));
+    if (!s->segments)
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+
+    for (uint32_t i = 0; i < s->nb_segments; i++) {
+        struct segment *segment = &s->segments[i];
+        ngpu_darray_set_free_func(&segment->chunks, free_chunk, NULL);
+        ngpu_darray_set_free_func(&segment->cmd_buffers, free_cmd_buffer, NULL);
+    }
+
+    return VK_SUCCESS;
+}
+
+static VkResult retire_segment(struct ngpu_upload_vk *s, struct segment *segment)
+{
+    if (!segment->retire_value)
+        return VK_SUCCESS;
+
+    struct ngpu_ctx_vk *gpu_ctx_vk = NGPU_PRIV_VK(s->gpu_ctx);
+    struct vkcontext *vk = gpu_ctx_vk->vkcontext;
+
+    const VkSemaphoreWaitInfo wait_info = {
+        .sType          = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+        .semaphoreCount = 1,
+        .pSemaphores    = &gpu_ctx_vk->timeline_sem,
+        .pValues        = &segment->retire_value,
+    };
+    VkResult res = vk->funcs.WaitSemaphores(vk->device, &wait_info, UINT64_MAX);
+    if (res != VK_SUCCESS)
+        return res;
+
+    /* Release the resources referenced by the upload command buffers */
+    for (size_t i = 0; i < segment->nb_used_cmd_buffers; i++) {
+        res = ngpu_cmd_buffer_vk_wait(segment->cmd_buffers.data[i]);
+        if (res != VK_SUCCESS)
+            return res;
+    }
+
+    segment->nb_used_cmd_buffers = 0;
+    segment->cur_chunk = 0;
+    segment->offset = 0;
+    segment->retire_value = 0;
+
+    return VK_SUCCESS;
+}
+
+static VkResult get_segment(struct ngpu_upload_vk *s, struct segment **segmentp)
+{
+    struct segment *segment = &s->segments[s->gpu_ctx->current_frame_index];
+
+    VkResult res = retire_segment(s, segment);
+    if (res != VK_SUCCESS)
+        return res;
+
+    *segmentp = segment;
+    return VK_SUCCESS;
+}
+
+static VkResult add_chunk(struct ngpu_upload_vk *s, struct segment *segment, size_t size)
+{
+    struct chunk chunk = {
+        .buffer = ngpu_buffer_create(s->gpu_ctx),
+        .size   = NGPU_MAX(size, CHUNK_MIN_SIZE),
+    };
+    if (!chunk.buffer)
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+
+    const uint32_t usage = NGPU_BUFFER_USAGE_DYNAMIC_BIT |
+                           NGPU_BUFFER_USAGE_TRANSFER_SRC_BIT |
+                           NGPU_BUFFER_USAGE_MAP_WRITE;
+    int ret = ngpu_buffer_init(chunk.buffer, chunk.size, usage);
+    if (ret < 0)
+        goto fail;
+
+    /* Host-visible buffers are persistently mapped */
+    void *data;
+    ret = ngpu_buffer_map(chunk.buffer, 0, chunk.size, &data);
+    if (ret < 0)
+        goto fail;
+    chunk.data = data;
+
+    if (ngpu_darray_push(&segment->chunks, chunk) < 0) {
+        ret = NGPU_ERROR_MEMORY;
+        goto fail;
+    }
+
+    return VK_SUCCESS;
+
+fail:
+    ngpu_buffer_freep(&chunk.buffer);
+    return ret == NGPU_ERROR_MEMORY ? VK_ERROR_OUT_OF_HOST_MEMORY : VK_ERROR_OUT_OF_DEVICE_MEMORY;
+}
+
+VkResult ngpu_upload_vk_alloc(struct ngpu_upload_vk *s, size_t size, size_t alignment, struct ngpu_upload_alloc_vk *alloc)
+{
+    struct segment *segment;
+    VkResult res = get_segment(s, &segment);
+    if (res != VK_SUCCESS)
+        return res;
+
+    /* The alignment is not necessarily a power of two (3-component texel formats) */
+    while (segment->cur_chunk < segment->chunks.count) {
+        const struct chunk *chunk = ngpu_darray_get(&segment->chunks, segment->cur_chunk);
+        const size_t offset = (segment->offset + alignment - 1) / alignment * alignment;
+        if (offset + size <= chunk->size) {
+            *alloc = (struct ngpu_upload_alloc_vk){
+                .buffer = NGPU_PRIV_VK(chunk->buffer)->buffer,
+                .offset = offset,
+                .data   = chunk->data + offset,
+            };
+            segment->offset = offset + size;
+            return VK_SUCCESS;
+        }
+        segment->cur_chunk++;
+        segment->offset = 0;
+    }
+
+    res = add_chunk(s, segment, size);
+    if (res != VK_SUCCESS)
+        return res;
+
+    const struct chunk *chunk = ngpu_darray_tail(&segment->chunks);
+    *alloc = (struct ngpu_upload_alloc_vk){
+        .buffer = NGPU_PRIV_VK(chunk->buffer)->buffer,
+        .offset = 0,
+        .data   = chunk->data,
+    };
+    segment->cur_chunk = segment->chunks.count - 1;
+    segment->offset = size;
+
+    return VK_SUCCESS;
+}
+
+static void record_barrier(struct ngpu_upload_vk *s, VkCommandBuffer cmd_buf,
+                           VkPipelineStageFlags src_stage, VkAccessFlags src_access,
+                           VkPipelineStageFlags dst_stage, VkAccessFlags dst_access)
+{
+    struct ngpu_ctx_vk *gpu_ctx_vk = NGPU_PRIV_VK(s->gpu_ctx);
+    struct vkcontext *vk = gpu_ctx_vk->vkcontext;
+
+    const VkMemoryBarrier barrier = {
+        .sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = src_access,
+        .dstAccessMask = dst_access,
+    };
+    vk->funcs.CmdPipelineBarrier(cmd_buf, src_stage, dst_stage, 0, 1, &barrier, 0, NULL, 0, NULL);
+}
+
+VkResult ngpu_upload_vk_get_cmd_buffer(struct ngpu_upload_vk *s, struct ngpu_cmd_buffer_vk **cmd_bufferp)
+{
+    if (s->pending_cmd_buffer) {
+        *cmd_bufferp = s->pending_cmd_buffer;
+        return VK_SUCCESS;
+    }
+
+    struct segment *segment;
+    VkResult res = get_segment(s, &segment);
+    if (res != VK_SUCCESS)
+        return res;
+
+    if (segment->nb_used_cmd_buffers == segment->cmd_buffers.count) {
+        struct ngpu_cmd_buffer_vk *cmd_buffer = ngpu_cmd_buffer_vk_create(s->gpu_ctx);
+        if (!cmd_buffer)
+            return VK_ERROR_OUT_OF_HOST_MEMORY;
+
+        res = ngpu_cmd_buffer_vk_init(cmd_buffer, 0);
+        if (res != VK_SUCCESS) {
+            ngpu_cmd_buffer_vk_freep(&cmd_buffer);
+            return res;
+        }
+
+        if (ngpu_darray_push(&segment->cmd_buffers, cmd_buffer) < 0) {
+            ngpu_cmd_buffer_vk_freep(&cmd_buffer);
+            return VK_ERROR_OUT_OF_HOST_MEMORY;
+        }
+    }
+
+    struct ngpu_cmd_buffer_vk *cmd_buffer = segment->cmd_buffers.data[segment->nb_used_cmd_buffers];
+    res = ngpu_cmd_buffer_vk_begin(cmd_buffer);
+    if (res != VK_SUCCESS)
+        return res;
+    segment->nb_used_cmd_buffers++;
+
+    /*
+     * The destination resources may still be accessed by previously
+     * submitted work, the copies must not start before it completes.
+     */
+    record_barrier(s, cmd_buffer->cmd_buf,
+                   VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_ACCESS_MEMORY_WRITE_BIT,
+                   VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT);
+
+    s->pending_cmd_buffer = cmd_buffer;
+    *cmd_bufferp = cmd_buffer;
+    return VK_SUCCESS;
+}
+
+VkResult ngpu_upload_vk_flush(struct ngpu_upload_vk *s)
+{
+    struct ngpu_cmd_buffer_vk *cmd_buffer = s->pending_cmd_buffer;
+    if (!cmd_buffer)
+        return VK_SUCCESS;
+
+    /* Make the copies visible to any subsequent submission */
+    record_barrier(s, cmd_buffer->cmd_buf,
+                   VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                   VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT);
+
+    /* Reset first as submitting flushes the upload queue */
+    s->pending_cmd_buffer = NULL;
+
+    return ngpu_cmd_buffer_vk_submit(cmd_buffer, NULL, NULL);
+}
+
+void ngpu_upload_vk_end_frame(struct ngpu_upload_vk *s)
+{
+    struct ngpu_ctx_vk *gpu_ctx_vk = NGPU_PRIV_VK(s->gpu_ctx);
+
+    /*
+     * The frame command buffer has just been submitted (flushing the pending
+     * uploads beforehand), so the segment can be recycled as soon as the
+     * timeline semaphore reaches the last signaled value.
+     */
+    ngpu_assert(!s->pending_cmd_buffer);
+    struct segment *segment = &s->segments[s->gpu_ctx->current_frame_index];
+    segment->retire_value = gpu_ctx_vk->timeline_value;
+}
+
+void ngpu_upload_vk_freep(struct ngpu_upload_vk **sp)
+{
+    struct ngpu_upload_vk *s = *sp;
+    if (!s)
+        return;
+
+    for (uint32_t i = 0; i < s->nb_segments; i++) {
+        struct segment *segment = &s->segments[i];
+        ngpu_darray_reset(&segment->cmd_buffers);
+        ngpu_darray_reset(&segment->chunks);
+    }
+    ngpu_freep(&s->segments);
+
+    ngpu_freep(sp);
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2026 Matthieu Bouron <matthieu.bouron@gmail.com>
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef NGPU_UPLOAD_VK_H
+#define NGPU_UPLOAD_VK_H
+
+#include <stddef.h>
+
+#include <vulkan/vulkan.h>
+
+#include "vulkan/cmd_buffer_vk.h"
+
+struct ngpu_ctx;
+
+/*
+ * Frame-scoped upload queue.
+ *
+ * Staging memory is sub-allocated from large persistently mapped buffers,
+ * one set per in-flight frame, which are recycled once the timeline
+ * semaphore reports that the frame using them has completed. Copies issued
+ * outside of a recordable command buffer are coalesced into a single upload
+ * command buffer which is submitted, without waiting on it, right before the
+ * next submission of the context.
+ */
+
+struct ngpu_upload_vk;
+
+struct ngpu_upload_alloc_vk {
+    VkBuffer buffer;
+    VkDeviceSize offset;
+    void *data;
+};
+
+struct ngpu_upload_vk *ngpu_upload_vk_create(struct ngpu_ctx *gpu_ctx);
+VkResult ngpu_upload_vk_init(struct ngpu_upload_vk *s);
+VkResult ngpu_upload_vk_alloc(struct ngpu_upload_vk *s, size_t size, size_t alignment, struct ngpu_upload_alloc_vk *alloc);
+VkResult ngpu_upload_vk_get_cmd_buffer(struct ngpu_upload_vk *s, struct ngpu_cmd_buffer_vk **cmd_bufferp);
+VkResult ngpu_upload_vk_flush(struct ngpu_upload_vk *s);
+void ngpu_upload_vk_end_frame(struct ngpu_upload_vk *s);
+void ngpu_upload_vk_freep(struct ngpu_upload_vk **sp);
+
+#endif
@@ -106,6 +106,9 @@
     MACRO(true, true, false, DestroyShaderModule)                            \
     MACRO(true, true, false, CreatePipelineLayout)                           \
     MACRO(true, true, false, DestroyPipelineLayout)                          \
+    MACRO(true, true, false, CreatePipelineCache)                            \
+    MACRO(true, true, false, DestroyPipelineCache)                           \
+    MACRO(true, true, false, GetPipelineCacheData)                           \
     MACRO(true, true, false, CreateGraphicsPipelines)                        \
     MACRO(true, true, false, CreateComputePipelines)                         \
     MACRO(true, true, false, DestroyPipeline)                                \
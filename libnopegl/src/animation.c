@@ -27,27 +27,35 @@
 #include "math_utils.h"
 #include "node_animkeyframe.h"
 #include "nopegl/nopegl.h"
+#include "utils/search.h"
 
-static size_t get_kf_id(struct ngl_node * const *animkf, size_t nb_animkf, size_t start, double t)
+struct kf_search {
+    struct ngl_node * const *animkf;
+    double t;
+};
+
+static bool kf_le(const void *arg, size_t i)
 {
-    size_t ret = SIZE_MAX;
+    const struct kf_search *search = arg;
+    const struct animkeyframe_opts *kf = search->animkf[i]->opts;
+    return kf->time <= search->t;
+}
 
-    for (size_t i = start; i < nb_animkf; i++) {
-        const struct animkeyframe_opts *kf = animkf[i]->opts;
-        if (kf->time > t)
-            break;
-        ret = i;
-    }
-    return ret;
+/*
+ * Return the index of the last key frame at or before t, or SIZE_MAX if t is
+ * before the first key frame.
+ */
+static size_t get_kf_id(struct ngl_node * const *animkf, size_t nb_animkf, size_t current, double t)
+{
+    const struct kf_search search = {.animkf = animkf, .t = t};
+    return ngli_search_sorted(nb_animkf, current, kf_le, &search);
 }
 
 int ngli_animation_evaluate(struct animation *s, void *dst, double t)
 {
     struct ngl_node * const *animkf = s->kfs;
     const size_t nb_animkf = s->nb_kfs;
-    size_t kf_id = get_kf_id(animkf, nb_animkf, s->current_kf, t);
-    if (kf_id == SIZE_MAX)
-        kf_id = get_kf_id(animkf, nb_animkf, 0, t);
+    const size_t kf_id = get_kf_id(animkf, nb_animkf, s->current_kf, t);
     if (kf_id != SIZE_MAX && kf_id < nb_animkf - 1) {
         const struct animkeyframe_priv *kf1_priv = animkf[kf_id + 1]->priv_data;
         const struct animkeyframe_opts *kf0 = animkf[kf_id    ]->opts;
@@ -77,9 +85,7 @@ int ngli_animation_derivate(struct animation *s, void *dst, double t)
 {
     struct ngl_node * const *animkf = s->kfs;
     const size_t nb_animkf = s->nb_kfs;
-    size_t kf_id = get_kf_id(animkf, nb_animkf, s->current_kf, t);
-    if (kf_id == SIZE_MAX)
-        kf_id = get_kf_id(animkf, nb_animkf, 0, t);
+    const size_t kf_id = get_kf_id(animkf, nb_animkf, s->current_kf, t);
     if (kf_id != SIZE_MAX && kf_id < nb_animkf - 1) {
         const struct animkeyframe_priv *kf1_priv = animkf[kf_id + 1]->priv_data;
         const struct animkeyframe_opts *kf0 = animkf[kf_id    ]->opts;
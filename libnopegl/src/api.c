@@ -21,6 +21,7 @@
  * under the License.
  */
 
+#include <float.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdint.h>
@@ -39,9 +40,12 @@
 #include <ngpu/ngpu.h>
 #include "nopegl/nopegl.h"
 #include "nopegl/nopegl_opengl.h"
+#include "parallel_update.h"
 #include "utils/darray.h"
 #include "utils/hmap.h"
 #include "utils/memory.h"
+#include "utils/scheduler.h"
+#include "utils/thread.h"
 #include "utils/utils.h"
 
 #if defined(BACKEND_GL) || defined(BACKEND_GLES)
@@ -168,8 +172,10 @@ static struct ngpu_ctx *gpu_ctx_create_from_config(const struct ngl_config *conf
         .set_surface_pts      = config->set_surface_pts,
         .capture_buffer       = config->capture_buffer,
         .capture_buffer_type  = ngl_capture_buffer_type_to_ngpu(config->capture_buffer_type),
+        .async_capture        = config->async_capture,
         .debug                = config->debug,
-        .timer_queries        = config->hud,
+        .timer_queries        = config->hud || config->trace_filename,
+        .program_cache_dir    = config->program_cache_dir,
         .shared_ctx           = config->shared_gpu_ctx,
     };
     memcpy(params.clear_color, config->clear_color, sizeof(params.clear_color));
@@ -339,6 +345,25 @@ static struct ngpu_viewport compute_scene_viewport(const struct ngl_scene *scene
     return vp;
 }
 
+struct program_batch_tasks {
+    ngpu_program_batch_func_type func;
+    void *arg;
+};
+
+static void run_program_batch_range(void *arg, size_t start, size_t end, uint32_t thread_index)
+{
+    const struct program_batch_tasks *tasks = arg;
+    for (size_t i = start; i < end; i++)
+        tasks->func(tasks->arg, i);
+}
+
+static void program_batch_parallel_for(void *user_arg, size_t count, ngpu_program_batch_func_type func, void *arg)
+{
+    struct ngli_scheduler *scheduler = user_arg;
+    struct program_batch_tasks tasks = {.func = func, .arg = arg};
+    ngli_parallel_for(scheduler, count, 1, run_program_batch_range, &tasks);
+}
+
 int ngli_ctx_set_scene(struct ngl_ctx *s, struct ngl_scene *scene)
 {
     ngpu_ctx_wait_idle(s->gpu_ctx);
@@ -351,6 +376,22 @@ int ngli_ctx_set_scene(struct ngl_ctx *s, struct ngl_scene *scene)
     if (ret < 0)
         return ret;
 
+    /*
+     * The programs crafted while preparing the graph are compiled in parallel
+     * on the context scheduler and bound back to their pipelines when the
+     * batch ends (or whenever a node needs to render during its prepare
+     * stage).
+     */
+    const struct ngpu_program_batch_params batch_params = {
+        .parallel_for = program_batch_parallel_for,
+        .user_arg     = s->scheduler,
+    };
+    ret = ngpu_ctx_begin_program_batch(s->gpu_ctx, &batch_params);
+    if (ret < 0) {
+        ngpu_ctx_end_update(s->gpu_ctx, NULL);
+        return ret;
+    }
+
     if (scene) {
         if (!scene->params.root) {
             LOG(ERROR, "specified scene doesn't contain a graph");
@@ -392,10 +433,19 @@ int ngli_ctx_set_scene(struct ngl_ctx *s, struct ngl_scene *scene)
             goto fail;
     }
 
+    ret = ngpu_ctx_end_program_batch(s->gpu_ctx);
+    if (ret < 0) {
+        LOG(ERROR, "failed to initialize scene programs");
+        ngpu_ctx_end_update(s->gpu_ctx, NULL);
+        reset_scene(s, NGLI_ACTION_UNREF_SCENE);
+        return ret;
+    }
+
     ngpu_ctx_end_update(s->gpu_ctx, NULL);
     return 0;
 
 fail:
+    ngpu_ctx_end_program_batch(s->gpu_ctx);
     ngpu_ctx_end_update(s->gpu_ctx, NULL);
     reset_scene(s, NGLI_ACTION_UNREF_SCENE);
     return ret;
@@ -447,6 +497,7 @@ void ngli_ctx_reset(struct ngl_ctx *s, int action)
     ngli_freep(&s->draw_staging_buffers);
     ngli_freep(&s->update_staging_buffers);
     s->current_staging_buffer = NULL;
+    ngli_trace_freep(&s->trace);
     ngli_hmap_freep(&s->text_builtin_atlasses);
 #if HAVE_TEXT_LIBRARIES
     FT_Done_FreeType(s->ft_library);
@@ -487,6 +538,18 @@ int ngli_ctx_configure(struct ngl_ctx *s, const struct ngl_config *config)
         return ret;
     }
 
+    if (s->config.trace_filename) {
+        s->trace = ngli_trace_create();
+        if (!s->trace) {
+            ret = NGL_ERROR_MEMORY;
+            goto fail;
+        }
+
+        ret = ngli_trace_init(s->trace, s->config.trace_filename);
+        if (ret < 0)
+            goto fail;
+    }
+
     s->text_builtin_atlasses = ngli_hmap_create(NGLI_HMAP_TYPE_STR);
     if (!s->text_builtin_atlasses) {
         ret = NGL_ERROR_MEMORY;
@@ -631,6 +694,12 @@ int ngli_ctx_prepare_draw(struct ngl_ctx *s, double t)
     if (ret < 0)
         return ret;
 
+    s->distmap_update_time = 0;
+
+    ret = ngli_parallel_update_run(s->parallel_update, t);
+    if (ret < 0)
+        return ret;
+
     ret = ngli_node_update(root, t);
     if (ret < 0)
         return ret;
@@ -658,7 +727,7 @@ int ngli_ctx_draw(struct ngl_ctx *s, double t, struct ngpu_fence *wait_fence, st
     if (ret < 0)
         return ret;
 
-    const int64_t cpu_start_time = s->hud ? ngli_gettime_relative() : 0;
+    const int64_t cpu_start_time = s->hud || s->trace ? ngli_gettime_relative() : 0;
 
     s->current_rendertarget = ngpu_ctx_get_default_rendertarget(s->gpu_ctx);
 
@@ -667,6 +736,7 @@ int ngli_ctx_draw(struct ngl_ctx *s, double t, struct ngpu_fence *wait_fence, st
     ngpu_staging_buffer_reset(s->current_staging_buffer);
 
     ngli_darray_clear(&s->bounding_box_nodes);
+    s->bounding_box_grid_dirty = true;
 
     struct ngl_scene *scene = s->scene;
     if (scene) {
@@ -688,10 +758,17 @@ int ngli_ctx_draw(struct ngl_ctx *s, double t, struct ngpu_fence *wait_fence, st
         ngpu_ctx_end_render_pass(s->gpu_ctx);
     }
 
-    if (s->hud) {
+    if (s->hud || s->trace) {
         ngpu_ctx_query_draw_time(s->gpu_ctx, &s->gpu_draw_time);
     }
 
+    if (s->trace) {
+        ngli_trace_add_gpu_spans(s->trace, s->gpu_ctx, cpu_start_time, s->gpu_draw_time);
+        ret = ngli_trace_flush(s->trace);
+        if (ret < 0)
+            return ret;
+    }
+
     ret = ngpu_staging_buffer_flush(s->current_staging_buffer);
     if (ret < 0)
         return ret;
@@ -800,6 +877,10 @@ struct ngl_ctx *ngl_create(void)
     if (ret < 0)
         goto fail;
 
+    s->parallel_update = ngli_parallel_update_create(s);
+    if (!s->parallel_update)
+        goto fail;
+
     if (pthread_mutex_init(&s->frame_slots_lock, NULL) != 0)
         goto fail;
 
@@ -815,6 +896,10 @@ struct ngl_ctx *ngl_create(void)
     if (ngli_darray_push(&s->opacity_2d_stack, 1.f) < 0)
         goto fail;
 
+    s->bounding_box_grid = ngli_spatial_grid_create();
+    if (!s->bounding_box_grid)
+        goto fail;
+
     LOG(INFO, "context create in nope.gl v%d.%d.%d",
         NGL_VERSION_MAJOR, NGL_VERSION_MINOR, NGL_VERSION_MICRO);
 
@@ -825,6 +910,27 @@ fail:
     return NULL;
 }
 
+static int configure_scheduler(struct ngl_ctx *s, const struct ngl_config *config)
+{
+    if (config->nb_threads < 0) {
+        LOG(ERROR, "invalid number of threads: %d", config->nb_threads);
+        return NGL_ERROR_INVALID_ARG;
+    }
+
+    const uint32_t nb_threads = config->nb_threads ? (uint32_t)config->nb_threads : ngli_thread_get_cpu_count();
+    if (s->scheduler && ngli_scheduler_get_nb_threads(s->scheduler) == nb_threads)
+        return 0;
+
+    ngli_scheduler_freep(&s->scheduler);
+    s->scheduler = ngli_scheduler_create("ngl-worker", nb_threads);
+    if (!s->scheduler)
+        return NGL_ERROR_MEMORY;
+
+    LOG(DEBUG, "CPU work dispatched on %u threads", nb_threads);
+
+    return 0;
+}
+
 int ngl_configure(struct ngl_ctx *s, const struct ngl_config *user_config)
 {
     if (s->configured) {
@@ -862,7 +968,11 @@ int ngl_configure(struct ngl_ctx *s, const struct ngl_config *user_config)
         return NGL_ERROR_UNSUPPORTED;
     }
 
-    int ret = s->api_impl->configure(s, &config);
+    int ret = configure_scheduler(s, &config);
+    if (ret < 0)
+        return ret;
+
+    ret = s->api_impl->configure(s, &config);
     if (ret < 0)
         return ret;
 
@@ -913,6 +1023,22 @@ int ngl_get_viewport(struct ngl_ctx *s, int32_t *viewport)
     return s->api_impl->get_viewport(s, viewport);
 }
 
+int ngl_get_program_cache_stats(struct ngl_ctx *s, struct ngl_program_cache_stats *stats)
+{
+    if (!s->configured) {
+        LOG(ERROR, "context must be configured to get the program cache statistics");
+        return NGL_ERROR_INVALID_USAGE;
+    }
+
+    struct ngpu_program_cache_stats gpu_stats = {0};
+    ngpu_ctx_get_program_cache_stats(s->gpu_ctx, &gpu_stats);
+    *stats = (struct ngl_program_cache_stats){
+        .hits   = gpu_stats.hits,
+        .misses = gpu_stats.misses,
+    };
+    return 0;
+}
+
 int ngl_set_capture_buffer(struct ngl_ctx *s, void *capture_buffer)
 {
     if (!s->configured) {
@@ -963,6 +1089,25 @@ struct ngpu_fence *ngl_frame_get_signal_fence(const struct ngl_frame *f)
     return f->signal_fence;
 }
 
+struct read_capture_arg {
+    struct ngl_frame *frame;
+    void *data;
+    int wait;
+};
+
+static int read_capture_cb(struct ngl_ctx *s, void *arg)
+{
+    const struct read_capture_arg *a = arg;
+    return ngpu_ctx_read_capture(s->gpu_ctx, a->frame->index, a->data, a->wait);
+}
+
+int ngl_frame_read_capture(struct ngl_frame *f, void *data, int wait)
+{
+    struct ngl_ctx *s = f->ctx;
+    struct read_capture_arg arg = {.frame = f, .data = data, .wait = wait};
+    return s->api_impl->dispatch(s, read_capture_cb, &arg);
+}
+
 void ngl_frame_release(struct ngl_frame *f, struct ngpu_fence *fence)
 {
     if (!f)
@@ -1056,32 +1201,63 @@ int ngl_draw(struct ngl_ctx *s, double t, struct ngl_draw_output *output)
     return 0;
 }
 
-NGL_API int ngl_get_nodes_at_point(struct ngl_ctx *s, const float *point, size_t *nb_nodesp, struct ngl_node ***nodesp)
+/*
+ * Index the screen bounding boxes of the nodes recorded by the last draw and
+ * cache their inverse transform. Containers are registered with an empty box
+ * so that the grid indices map directly to the bounding_box_nodes entries.
+ */
+static int update_bounding_box_grid(struct ngl_ctx *s)
 {
-    *nb_nodesp = 0;
-    *nodesp = NULL;
-
-    ngli_darray_clear(&s->intersecting_nodes);
+    if (!s->bounding_box_grid_dirty)
+        return 0;
 
-    const NGLI_ALIGNED_VEC(pixel_point) = {point[0], point[1], 0.f, 1.f};
+    ngli_darray_clear(&s->bounding_box_grid_boxes);
+    int ret = ngli_darray_reserve(&s->bounding_box_grid_boxes, s->bounding_box_nodes.count * 4);
+    if (ret < 0)
+        return ret;
 
     for (size_t i = 0; i < s->bounding_box_nodes.count; i++) {
         struct ngl_node *bounding_box_node = s->bounding_box_nodes.data[i];
+        struct ngli_node2d_info *node2d_info = bounding_box_node->priv_data;
+
+        NGLI_ALIGNED_VEC(min) = {1.f, 1.f, 0.f, 1.f};
+        NGLI_ALIGNED_VEC(max) = {0.f, 0.f, 0.f, 1.f};
         /* Only test leaf draw nodes, not containers */
-        if (bounding_box_node->cls->category != NGLI_NODE_CATEGORY_DRAW)
-            continue;
+        if (bounding_box_node->cls->category == NGLI_NODE_CATEGORY_DRAW) {
+            ngli_aabb_get_min_max(&node2d_info->screen_aabb, min, max);
+            ngli_mat4_inverse(node2d_info->inv_transform_matrix.m, node2d_info->transform_matrix.m);
+        }
+        const float box[] = {min[0], min[1], max[0], max[1]};
+        for (size_t j = 0; j < NGLI_ARRAY_NB(box); j++)
+            ngli_darray_push(&s->bounding_box_grid_boxes, box[j]);
+    }
 
-        const struct ngli_node2d_info *node2d_info = bounding_box_node->priv_data;
+    ret = ngli_spatial_grid_build(s->bounding_box_grid, s->bounding_box_grid_boxes.data,
+                                  s->bounding_box_nodes.count);
+    if (ret < 0)
+        return ret;
 
-        /* Broadphase: pixel-space AABB */
-        if (!ngli_aabb_intersect_point(&node2d_info->screen_aabb, pixel_point))
-            continue;
+    s->bounding_box_grid_dirty = false;
+    return 0;
+}
+
+static int push_nodes_at_point(struct ngl_ctx *s, const float *point)
+{
+    const uint32_t *indices;
+    size_t nb_indices;
+    int ret = ngli_spatial_grid_query_point(s->bounding_box_grid, point[0], point[1], &indices, &nb_indices);
+    if (ret < 0)
+        return ret;
+
+    const NGLI_ALIGNED_VEC(pixel_point) = {point[0], point[1], 0.f, 1.f};
+
+    for (size_t i = 0; i < nb_indices; i++) {
+        struct ngl_node *bounding_box_node = s->bounding_box_nodes.data[indices[i]];
+        const struct ngli_node2d_info *node2d_info = bounding_box_node->priv_data;
 
         /* Narrow phase: inverse-transform point into local space */
-        struct ngli_mat4 inv;
-        ngli_mat4_inverse(inv.m, node2d_info->transform_matrix.m);
         NGLI_ALIGNED_VEC(local_point);
-        ngli_mat4_mul_vec4(local_point, inv.m, pixel_point);
+        ngli_mat4_mul_vec4(local_point, node2d_info->inv_transform_matrix.m, pixel_point);
 
         if (ngli_aabb_intersect_point(&node2d_info->aabb, local_point)) {
             if (ngli_darray_push(&s->intersecting_nodes, bounding_box_node) < 0)
@@ -1089,6 +1265,122 @@ NGL_API int ngl_get_nodes_at_point(struct ngl_ctx *s, const float *point, size_t
         }
     }
 
+    return 0;
+}
+
+NGL_API int ngl_get_nodes_at_point(struct ngl_ctx *s, const float *point, size_t *nb_nodesp, struct ngl_node ***nodesp)
+{
+    *nb_nodesp = 0;
+    *nodesp = NULL;
+
+    ngli_darray_clear(&s->intersecting_nodes);
+
+    int ret = update_bounding_box_grid(s);
+    if (ret < 0)
+        return ret;
+
+    ret = push_nodes_at_point(s, point);
+    if (ret < 0)
+        return ret;
+
+    *nodesp = s->intersecting_nodes.data;
+    *nb_nodesp = s->intersecting_nodes.count;
+
+    return 0;
+}
+
+NGL_API int ngl_get_nodes_at_points(struct ngl_ctx *s, const float *points, size_t nb_points,
+                                    const size_t **offsetsp, struct ngl_node ***nodesp)
+{
+    *offsetsp = NULL;
+    *nodesp = NULL;
+
+    ngli_darray_clear(&s->intersecting_nodes);
+    ngli_darray_clear(&s->intersecting_offsets);
+
+    int ret = update_bounding_box_grid(s);
+    if (ret < 0)
+        return ret;
+
+    ret = ngli_darray_reserve(&s->intersecting_offsets, nb_points + 1);
+    if (ret < 0)
+        return ret;
+
+    ngli_darray_push(&s->intersecting_offsets, 0);
+    for (size_t i = 0; i < nb_points; i++) {
+        ret = push_nodes_at_point(s, &points[i * 2]);
+        if (ret < 0)
+            return ret;
+        ngli_darray_push(&s->intersecting_offsets, s->intersecting_nodes.count);
+    }
+
+    *offsetsp = s->intersecting_offsets.data;
+    *nodesp = s->intersecting_nodes.data;
+
+    return 0;
+}
+
+/*
+ * Separating axis test between the pixel-space rectangle and the node local
+ * aabb. The pixel-space axes are already covered by the screen aabb
+ * broadphase, so only the local axes remain to be checked, using the
+ * rectangle corners projected in local space.
+ */
+static int intersect_rect(const struct ngli_node2d_info *node2d_info, const float *rect)
+{
+    const float corners[4][2] = {
+        {rect[0],           rect[1]},
+        {rect[0] + rect[2], rect[1]},
+        {rect[0],           rect[1] + rect[3]},
+        {rect[0] + rect[2], rect[1] + rect[3]},
+    };
+
+    float local_min[2] = {FLT_MAX, FLT_MAX};
+    float local_max[2] = {-FLT_MAX, -FLT_MAX};
+    for (size_t i = 0; i < NGLI_ARRAY_NB(corners); i++) {
+        const NGLI_ALIGNED_VEC(pixel_point) = {corners[i][0], corners[i][1], 0.f, 1.f};
+        NGLI_ALIGNED_VEC(local_point);
+        ngli_mat4_mul_vec4(local_point, node2d_info->inv_transform_matrix.m, pixel_point);
+        local_min[0] = NGLI_MIN(local_min[0], local_point[0]);
+        local_min[1] = NGLI_MIN(local_min[1], local_point[1]);
+        local_max[0] = NGLI_MAX(local_max[0], local_point[0]);
+        local_max[1] = NGLI_MAX(local_max[1], local_point[1]);
+    }
+
+    NGLI_ALIGNED_VEC(aabb_min);
+    NGLI_ALIGNED_VEC(aabb_max);
+    ngli_aabb_get_min_max(&node2d_info->aabb, aabb_min, aabb_max);
+    return local_min[0] <= aabb_max[0] && local_max[0] >= aabb_min[0] &&
+           local_min[1] <= aabb_max[1] && local_max[1] >= aabb_min[1];
+}
+
+NGL_API int ngl_get_nodes_in_rect(struct ngl_ctx *s, const float *rect, size_t *nb_nodesp, struct ngl_node ***nodesp)
+{
+    *nb_nodesp = 0;
+    *nodesp = NULL;
+
+    ngli_darray_clear(&s->intersecting_nodes);
+
+    int ret = update_bounding_box_grid(s);
+    if (ret < 0)
+        return ret;
+
+    const float box[] = {rect[0], rect[1], rect[0] + rect[2], rect[1] + rect[3]};
+    const uint32_t *indices;
+    size_t nb_indices;
+    ret = ngli_spatial_grid_query_box(s->bounding_box_grid, box, &indices, &nb_indices);
+    if (ret < 0)
+        return ret;
+
+    for (size_t i = 0; i < nb_indices; i++) {
+        struct ngl_node *bounding_box_node = s->bounding_box_nodes.data[indices[i]];
+        const struct ngli_node2d_info *node2d_info = bounding_box_node->priv_data;
+        if (!intersect_rect(node2d_info, rect))
+            continue;
+        if (ngli_darray_push(&s->intersecting_nodes, bounding_box_node) < 0)
+            return NGL_ERROR_MEMORY;
+    }
+
     *nodesp = s->intersecting_nodes.data;
     *nb_nodesp = s->intersecting_nodes.count;
 
@@ -1151,6 +1443,8 @@ void ngl_freep(struct ngl_ctx **ss)
     }
 
     ngli_queue_destroy(&s->background_queue);
+    ngli_parallel_update_freep(&s->parallel_update);
+    ngli_scheduler_freep(&s->scheduler);
     pthread_mutex_destroy(&s->frame_slots_lock);
 
     ngli_darray_reset(&s->modelview_matrix_stack);
@@ -1158,7 +1452,11 @@ void ngl_freep(struct ngl_ctx **ss)
     ngli_darray_reset(&s->transform_2d_stack);
     ngli_darray_reset(&s->opacity_2d_stack);
     ngli_darray_reset(&s->activitycheck_nodes);
+    ngli_darray_reset(&s->parallel_update_nodes);
     ngli_darray_reset(&s->bounding_box_nodes);
     ngli_darray_reset(&s->intersecting_nodes);
+    ngli_darray_reset(&s->intersecting_offsets);
+    ngli_spatial_grid_freep(&s->bounding_box_grid);
+    ngli_darray_reset(&s->bounding_box_grid_boxes);
     ngli_freep(ss);
 }
@@ -0,0 +1,128 @@
+/*
+ * Copyright 2026 Matthieu Bouron <matthieu.bouron@gmail.com>
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "utils/job_queue.h"
+#include "utils/memory.h"
+#include "utils/scheduler.h"
+#include "utils/thread.h"
+#include "utils/time.h"
+#include "utils/utils.h"
+
+#define NB_ROUNDS 50
+#define NB_ELEMS (1 << 20)
+
+struct range {
+    float *elems;
+    size_t start;
+    size_t end;
+};
+
+static void process(float *elems, size_t start, size_t end)
+{
+    for (size_t i = start; i < end; i++)
+        elems[i] = sqrtf(elems[i] * 0.5f + 1.f);
+}
+
+static void queue_job(void *data, void *shared_data, uint32_t thread_index)
+{
+    struct range *range = data;
+    process(range->elems, range->start, range->end);
+}
+
+static void scheduler_range(void *arg, size_t start, size_t end, uint32_t thread_index)
+{
+    process(arg, start, end);
+}
+
+/* One fenced job per range, all of them going through the queue lock */
+static int64_t run_queue(uint32_t nb_threads, float *elems, size_t nb_ranges)
+{
+    struct ngli_queue queue;
+    ngli_assert(ngli_queue_init(&queue, "bench", (uint32_t)nb_ranges, nb_threads, NULL) == 0);
+
+    struct range *ranges = ngli_calloc(nb_ranges, sizeof(*ranges));
+    struct ngli_fence *fences = ngli_calloc(nb_ranges, sizeof(*fences));
+    ngli_assert(ranges && fences);
+    for (size_t i = 0; i < nb_ranges; i++)
+        ngli_fence_init(&fences[i]);
+
+    const size_t range_size = NB_ELEMS / nb_ranges;
+    const int64_t start = ngli_gettime_relative();
+    for (int round = 0; round < NB_ROUNDS; round++) {
+        for (size_t i = 0; i < nb_ranges; i++) {
+            ranges[i] = (struct range){elems, i * range_size, (i + 1) * range_size};
+            ngli_queue_add_job(&queue, &ranges[i], &fences[i], queue_job, NULL);
+        }
+        for (size_t i = 0; i < nb_ranges; i++)
+            ngli_fence_wait(&fences[i]);
+    }
+    const int64_t elapsed = ngli_gettime_relative() - start;
+
+    ngli_queue_destroy(&queue);
+    for (size_t i = 0; i < nb_ranges; i++)
+        ngli_fence_destroy(&fences[i]);
+    ngli_freep(&fences);
+    ngli_freep(&ranges);
+    return elapsed;
+}
+
+static int64_t run_scheduler(uint32_t nb_threads, float *elems, size_t nb_ranges)
+{
+    struct ngli_scheduler *scheduler = ngli_scheduler_create("bench", nb_threads);
+    ngli_assert(scheduler);
+
+    const size_t range_size = NB_ELEMS / nb_ranges;
+    const int64_t start = ngli_gettime_relative();
+    for (int round = 0; round < NB_ROUNDS; round++)
+        ngli_parallel_for(scheduler, NB_ELEMS, range_size, scheduler_range, elems);
+    const int64_t elapsed = ngli_gettime_relative() - start;
+
+    ngli_scheduler_freep(&scheduler);
+    return elapsed;
+}
+
+int main(void)
+{
+    float *elems = ngli_calloc(NB_ELEMS, sizeof(*elems));
+    ngli_assert(elems);
+
+    const uint32_t nb_cpus = ngli_thread_get_cpu_count();
+    const uint32_t nb_threads = NGLI_MIN(nb_cpus, NGLI_QUEUE_MAX_THREAD);
+
+    /* From coarse to very fine-grained work */
+    static const size_t nb_ranges_list[] = {16, 256, 4096, 65536};
+    for (size_t i = 0; i < NGLI_ARRAY_NB(nb_ranges_list); i++) {
+        const size_t nb_ranges = nb_ranges_list[i];
+        const int64_t queue_us = run_queue(nb_threads, elems, nb_ranges);
+        const int64_t scheduler_us = run_scheduler(nb_threads, elems, nb_ranges);
+        printf("%u threads, %6zu ranges: queue %8" PRId64 "us, scheduler %8" PRId64 "us (x%.2f)\n",
+               nb_threads, nb_ranges, queue_us, scheduler_us,
+               (double)queue_us / (double)NGLI_MAX(scheduler_us, 1));
+    }
+
+    ngli_freep(&elems);
+    return 0;
+}
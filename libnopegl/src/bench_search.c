@@ -0,0 +1,109 @@
+/*
+ * Copyright 2026 Matthieu Bouron <matthieu.bouron@gmail.com>
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "utils/memory.h"
+#include "utils/search.h"
+#include "utils/time.h"
+#include "utils/utils.h"
+
+#define NB_TIMESTAMPS 200000
+#define NB_SEEKS 10000
+#define NB_PLAYBACK_FRAMES 100000
+
+static uint32_t random_state = 0x12345678;
+
+static uint32_t random_u32(void)
+{
+    random_state = random_state * 1664525 + 1013904223;
+    return random_state;
+}
+
+/* Former lookup: linear scan from the hint, restarting from 0 on backward seeks */
+static size_t search_timestamp_linear(const int64_t *timestamps, size_t nb_timestamps, size_t hint, int64_t t)
+{
+    for (int pass = 0; pass < 2; pass++) {
+        size_t ret = SIZE_MAX;
+        for (size_t i = pass ? 0 : hint; i < nb_timestamps && timestamps[i] <= t; i++)
+            ret = i;
+        if (ret != SIZE_MAX)
+            return ret;
+    }
+    return SIZE_MAX;
+}
+
+typedef size_t (*search_func_type)(const int64_t *timestamps, size_t nb_timestamps, size_t hint, int64_t t);
+
+static int64_t run(search_func_type search_func, const int64_t *timestamps, const int64_t *times, size_t nb_times, size_t *checksum)
+{
+    size_t hint = 0;
+    const int64_t start = ngli_gettime_relative();
+    for (size_t i = 0; i < nb_times; i++) {
+        const size_t index = search_func(timestamps, NB_TIMESTAMPS, hint, times[i]);
+        hint = index == SIZE_MAX ? 0 : index;
+        *checksum += hint;
+    }
+    return ngli_gettime_relative() - start;
+}
+
+static void bench(const char *name, const int64_t *timestamps, const int64_t *times, size_t nb_times)
+{
+    size_t checksum_linear = 0;
+    size_t checksum_search = 0;
+    const int64_t linear_us = run(search_timestamp_linear, timestamps, times, nb_times, &checksum_linear);
+    const int64_t search_us = run(ngli_search_timestamp, timestamps, times, nb_times, &checksum_search);
+    ngli_assert(checksum_linear == checksum_search);
+
+    printf("%-10s %zu lookups: linear %8" PRId64 "us, hybrid %8" PRId64 "us (%.1f ns/lookup)\n",
+           name, nb_times, linear_us, search_us, (double)search_us * 1000.0 / (double)nb_times);
+}
+
+int main(void)
+{
+    int64_t *timestamps = ngli_calloc(NB_TIMESTAMPS, sizeof(*timestamps));
+    int64_t *times = ngli_calloc(NB_PLAYBACK_FRAMES, sizeof(*times));
+    ngli_assert(timestamps && times);
+
+    /* Irregular timestamps in microseconds, about 30 per second */
+    int64_t ts = 0;
+    for (size_t i = 0; i < NB_TIMESTAMPS; i++) {
+        timestamps[i] = ts;
+        ts += 30000 + random_u32() % 6667;
+    }
+    const int64_t duration = ts;
+
+    /* Scrubbing: random seeks across the whole timeline */
+    for (size_t i = 0; i < NB_SEEKS; i++)
+        times[i] = (int64_t)(random_u32() % (uint32_t)(duration / 1000)) * 1000;
+    bench("seek", timestamps, times, NB_SEEKS);
+
+    /* Playback at 60 FPS */
+    for (size_t i = 0; i < NB_PLAYBACK_FRAMES; i++)
+        times[i] = (int64_t)i * 1000000 / 60;
+    bench("playback", timestamps, times, NB_PLAYBACK_FRAMES);
+
+    ngli_freep(&times);
+    ngli_freep(&timestamps);
+    return 0;
+}
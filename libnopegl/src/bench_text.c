@@ -0,0 +1,124 @@
+/*
+ * Copyright 2026 Matthieu Bouron <matthieu.bouron@gmail.com>
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <nopegl/nopegl.h>
+
+#include "utils/memory.h"
+#include "utils/time.h"
+#include "utils/utils.h"
+
+#define NB_ROUNDS 100
+#define LINE_LENGTH 64
+
+/*
+ * Measure the cost of a live text update (relayout + GPU upload + draw) as a
+ * function of the string length, when the whole string changes versus when a
+ * single character changes.
+ *
+ * The text is shaped with the font file passed as argument, or rendered with
+ * the builtin font otherwise.
+ */
+
+static void fill_text(char *str, size_t len, size_t seed)
+{
+    for (size_t i = 0; i < len; i++)
+        str[i] = (i + 1) % LINE_LENGTH == 0 ? '\n' : (char)('a' + (i + seed) % 26);
+    str[len] = 0;
+}
+
+static int64_t run_updates(struct ngl_ctx *ctx, struct ngl_node *text, char *str, size_t len, int full)
+{
+    fill_text(str, len, 0);
+    ngli_assert(ngl_node_param_set_str(text, "text", str) == 0);
+    ngli_assert(ngl_draw(ctx, 0.0, NULL) == 0);
+
+    const int64_t start = ngli_gettime_relative();
+    for (size_t round = 1; round <= NB_ROUNDS; round++) {
+        if (full)
+            fill_text(str, len, round);
+        else
+            str[len / 2] = (char)('a' + round % 26);
+        ngli_assert(ngl_node_param_set_str(text, "text", str) == 0);
+        ngli_assert(ngl_draw(ctx, (double)round / 60.0, NULL) == 0);
+    }
+    return (ngli_gettime_relative() - start) / NB_ROUNDS;
+}
+
+int main(int argc, char *argv[])
+{
+    struct ngl_ctx *ctx = ngl_create();
+    ngli_assert(ctx);
+
+    const struct ngl_config config = {
+        .backend   = NGL_BACKEND_AUTO,
+        .offscreen = 1,
+        .width     = 1280,
+        .height    = 720,
+    };
+    int ret = ngl_configure(ctx, &config);
+    if (ret < 0) {
+        fprintf(stderr, "unable to configure the rendering context\n");
+        ngl_freep(&ctx);
+        return 1;
+    }
+
+    struct ngl_node *text = ngl_node_create(NGL_NODE_TEXT);
+    struct ngl_scene *scene = ngl_scene_create();
+    ngli_assert(text && scene);
+
+    if (argc > 1) {
+        struct ngl_node *font_face = ngl_node_create(NGL_NODE_FONTFACE);
+        ngli_assert(font_face);
+        ngli_assert(ngl_node_param_set_str(font_face, "path", argv[1]) == 0);
+        ngli_assert(ngl_node_param_add_nodes(text, "font_faces", 1, &font_face) == 0);
+        ngl_node_unrefp(&font_face);
+        printf("external text with font %s\n", argv[1]);
+    } else {
+        printf("builtin text\n");
+    }
+
+    const struct ngl_scene_params params = ngl_scene_default_params(text);
+    ngli_assert(ngl_scene_init(scene, &params) == 0);
+    ngli_assert(ngl_set_scene(ctx, scene) == 0);
+
+    static const size_t lengths[] = {64, 256, 1024, 4096};
+    char *str = ngli_malloc(lengths[NGLI_ARRAY_NB(lengths) - 1] + 1);
+    ngli_assert(str);
+
+    for (size_t i = 0; i < NGLI_ARRAY_NB(lengths); i++) {
+        const size_t len = lengths[i];
+        const int64_t full_us = run_updates(ctx, text, str, len, 1);
+        const int64_t single_us = run_updates(ctx, text, str, len, 0);
+        printf("%5zu chars: full change %7" PRId64 "us, single char change %7" PRId64 "us (x%.2f)\n",
+               len, full_us, single_us, (double)full_us / (double)NGLI_MAX(single_us, 1));
+    }
+
+    ngli_freep(&str);
+    ngl_scene_unrefp(&scene);
+    ngl_node_unrefp(&text);
+    ngl_freep(&ctx);
+    return 0;
+}
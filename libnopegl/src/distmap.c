@@ -20,6 +20,7 @@
  * under the License.
  */
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
@@ -36,6 +37,7 @@
 #include "path.h"
 #include "pipeline_compat.h"
 #include <ngpu/ngpu.h>
+#include "skyline.h"
 #include "utils/darray.h"
 #include "utils/memory.h"
 #include "utils/utils.h"
@@ -52,6 +54,8 @@ struct bezier3 {
 
 struct shape {
     int32_t width, height;
+    uint32_t flags;
+    int32_t x, y; // position of the padded shape in the texture
 };
 
 struct distmap {
@@ -59,9 +63,9 @@ struct distmap {
 
     int32_t pad;
     int32_t max_shape_w, max_shape_h;
-    int32_t max_shape_padded_w, max_shape_padded_h;
     int32_t texture_w, texture_h;
-    int32_t nb_rows, nb_cols;
+    size_t texture_size; // texture and packed shapes sizes accounted in the context statistics
+    size_t used_size;
     float scale;
 
     NGLI_DARRAY(struct shape) shapes;
@@ -69,6 +73,7 @@ struct distmap {
     NGLI_DARRAY(struct bezier3) bezier_y;
     NGLI_DARRAY(int32_t) bezier_counts;
     NGLI_DARRAY(int32_t) beziergroup_counts;
+    bool dynamic;
 
     struct ngpu_texture *texture;
     struct ngpu_rendertarget *rt;
@@ -125,19 +130,12 @@ static struct bezier3 scaled_bezier(struct bezier3 bezier, float scale)
     return bezier;
 }
 
-int ngli_distmap_add_shape(struct distmap *s, int32_t shape_w, int32_t shape_h,
-                           const struct path *path, uint32_t flags, int32_t *shape_id)
+/*
+ * Convert the path segments into cubic bézier curves and append them (along
+ * with their grouping information) to the distmap arrays.
+ */
+static int add_path_beziers(struct distmap *s, const struct path *path, uint32_t flags, int32_t *nb_beziergroupsp)
 {
-    if (shape_w <= 0 || shape_h <= 0) {
-        LOG(ERROR, "invalid shape dimensions %dx%d", shape_w, shape_h);
-        return NGL_ERROR_INVALID_ARG;
-    }
-
-    if (s->shapes.count >= INT32_MAX) {
-        LOG(ERROR, "number of shapes reached limit of %d", INT32_MAX);
-        return NGL_ERROR_LIMIT_EXCEEDED;
-    }
-
     int32_t nb_beziers = 0, nb_beziergroups = 0;
     const struct ngli_path_segment_darray *segments_array = ngli_path_get_segments(path);
     const struct path_segment *segments = segments_array->data;
@@ -201,7 +199,34 @@ int ngli_distmap_add_shape(struct distmap *s, int32_t shape_w, int32_t shape_h,
 
     ngli_assert(nb_beziers == 0);
 
-    const struct shape shape = {.width=shape_w, .height=shape_h};
+    *nb_beziergroupsp = nb_beziergroups;
+    return 0;
+}
+
+int ngli_distmap_add_shape(struct distmap *s, int32_t shape_w, int32_t shape_h,
+                           const struct path *path, uint32_t flags, int32_t *shape_id)
+{
+    if (shape_w <= 0 || shape_h <= 0) {
+        LOG(ERROR, "invalid shape dimensions %dx%d", shape_w, shape_h);
+        return NGL_ERROR_INVALID_ARG;
+    }
+
+    if (s->shapes.count >= INT32_MAX) {
+        LOG(ERROR, "number of shapes reached limit of %d", INT32_MAX);
+        return NGL_ERROR_LIMIT_EXCEEDED;
+    }
+
+    if (s->texture) {
+        LOG(ERROR, "shapes can not be added after the texture is generated");
+        return NGL_ERROR_INVALID_USAGE;
+    }
+
+    int32_t nb_beziergroups;
+    int ret = add_path_beziers(s, path, flags, &nb_beziergroups);
+    if (ret < 0)
+        return ret;
+
+    const struct shape shape = {.width=shape_w, .height=shape_h, .flags=flags};
     if (ngli_darray_push(&s->shapes, shape) < 0 ||
         ngli_darray_push(&s->beziergroup_counts, nb_beziergroups) < 0)
         return NGL_ERROR_MEMORY;
@@ -209,6 +234,9 @@ int ngli_distmap_add_shape(struct distmap *s, int32_t shape_w, int32_t shape_h,
     s->max_shape_w = NGLI_MAX(shape_w, s->max_shape_w);
     s->max_shape_h = NGLI_MAX(shape_h, s->max_shape_h);
 
+    if (flags & NGLI_DISTMAP_FLAG_DYNAMIC)
+        s->dynamic = true;
+
     *shape_id = (int32_t)s->shapes.count - 1;
     return 0;
 }
@@ -362,26 +390,28 @@ static int draw_glyphs(struct distmap *s)
     ngli_pipeline_compat_update_buffer(s->pipeline_compat, 0, s->vert_buffer, 0, s->vert_offset);
     ngli_pipeline_compat_update_buffer(s->pipeline_compat, 1, s->frag_buffer, 0, s->frag_offset);
 
-    const int32_t nb_shapes = (int32_t)s->shapes.count;
-    int32_t shape_id = 0;
-
-    for (int32_t y = 0; y < s->nb_rows; y++) {
-        for (int32_t x = 0; x < s->nb_cols; x++) {
-            if (shape_id == nb_shapes)
-                return 0;
-
-            const uint32_t offsets[] = {(uint32_t)shape_id * (uint32_t)s->vert_offset, (uint32_t)shape_id * (uint32_t)s->frag_offset};
-            ret = ngli_pipeline_compat_update_dynamic_offsets(s->pipeline_compat, offsets, NGLI_ARRAY_NB(offsets));
-            if (ret < 0)
-                return ret;
-            ngli_pipeline_compat_draw(s->pipeline_compat, 3, 1, 0);
-            shape_id++;
-        }
+    for (size_t shape_id = 0; shape_id < s->shapes.count; shape_id++) {
+        const uint32_t offsets[] = {(uint32_t)shape_id * (uint32_t)s->vert_offset, (uint32_t)shape_id * (uint32_t)s->frag_offset};
+        ret = ngli_pipeline_compat_update_dynamic_offsets(s->pipeline_compat, offsets, NGLI_ARRAY_NB(offsets));
+        if (ret < 0)
+            return ret;
+        ngli_pipeline_compat_draw(s->pipeline_compat, 3, 1, 0);
     }
 
     return 0;
 }
 
+static int render_distmap(struct distmap *s)
+{
+    struct ngpu_ctx *gpu_ctx = s->ctx->gpu_ctx;
+
+    ngpu_ctx_begin_render_pass(gpu_ctx, s->rt);
+    int ret = draw_glyphs(s);
+    ngpu_ctx_end_render_pass(gpu_ctx);
+
+    return ret;
+}
+
 static void reset_tmp_data(struct distmap *s)
 {
     ngli_darray_reset(&s->bezier_x);
@@ -419,6 +449,105 @@ static enum ngpu_format get_preferred_distmap_format(const struct distmap *s)
     ngli_assert(0);
 }
 
+/*
+ * +1 represents the extra half texel on each side used to prevent texture
+ * bleeding between shapes because of the linear filtering.
+ */
+static int32_t get_padded_w(const struct distmap *s, const struct shape *shape)
+{
+    return shape->width + 2 * s->pad + 1;
+}
+
+static int32_t get_padded_h(const struct distmap *s, const struct shape *shape)
+{
+    return shape->height + 2 * s->pad + 1;
+}
+
+static int cmp_shape_height(const void *a, const void *b)
+{
+    const struct shape *shape_a = *(const struct shape **)a;
+    const struct shape *shape_b = *(const struct shape **)b;
+    return (shape_b->height > shape_a->height) - (shape_b->height < shape_a->height);
+}
+
+static int grow_skyline(struct distmap *s, struct skyline *skyline)
+{
+    const struct ngpu_limits *limits = ngpu_ctx_get_limits(s->ctx->gpu_ctx);
+    const int32_t max_size = (int32_t)NGLI_MIN(limits->max_texture_dimension_2d, INT32_MAX / 2);
+
+    /* Grow the smallest dimension to keep the texture mostly squared */
+    if (s->texture_w <= s->texture_h && s->texture_w * 2 <= max_size)
+        s->texture_w *= 2;
+    else if (s->texture_h * 2 <= max_size)
+        s->texture_h *= 2;
+    else if (s->texture_w * 2 <= max_size)
+        s->texture_w *= 2;
+    else
+        return NGL_ERROR_LIMIT_EXCEEDED;
+
+    return ngli_skyline_grow(skyline, s->texture_w, s->texture_h);
+}
+
+/*
+ * Pack the padded shapes with a skyline packer, from the tallest to the
+ * smallest, and crop the texture to the area actually covered.
+ */
+static int pack_shapes(struct distmap *s, struct skyline *skyline)
+{
+    const size_t nb_shapes = s->shapes.count;
+
+    int64_t area = 0;
+    int32_t max_padded_w = 0, max_padded_h = 0;
+    for (size_t i = 0; i < nb_shapes; i++) {
+        const struct shape *shape = &s->shapes.data[i];
+        const int32_t w = get_padded_w(s, shape);
+        const int32_t h = get_padded_h(s, shape);
+        area += (int64_t)w * h;
+        max_padded_w = NGLI_MAX(max_padded_w, w);
+        max_padded_h = NGLI_MAX(max_padded_h, h);
+    }
+
+    const int32_t side = (int32_t)ceil(sqrt((double)area));
+    s->texture_w = NGLI_MAX(side, max_padded_w);
+    s->texture_h = NGLI_MAX(side, max_padded_h);
+    int ret = ngli_skyline_init(skyline, s->texture_w, s->texture_h);
+    if (ret < 0)
+        return ret;
+
+    struct shape **sorted = ngli_calloc(nb_shapes, sizeof(*sorted));
+    if (!sorted)
+        return NGL_ERROR_MEMORY;
+    for (size_t i = 0; i < nb_shapes; i++)
+        sorted[i] = &s->shapes.data[i];
+    qsort(sorted, nb_shapes, sizeof(*sorted), cmp_shape_height);
+
+    int32_t used_w = 0, used_h = 0;
+    for (size_t i = 0; i < nb_shapes; i++) {
+        struct shape *shape = sorted[i];
+        const int32_t w = get_padded_w(s, shape);
+        const int32_t h = get_padded_h(s, shape);
+        while ((ret = ngli_skyline_insert(skyline, w, h, &shape->x, &shape->y)) == NGL_ERROR_LIMIT_EXCEEDED) {
+            ret = grow_skyline(s, skyline);
+            if (ret < 0) {
+                LOG(ERROR, "shape %dx%d does not fit in the distance map (%dx%d)",
+                    shape->width, shape->height, s->texture_w, s->texture_h);
+                break;
+            }
+        }
+        if (ret < 0)
+            break;
+        used_w = NGLI_MAX(used_w, shape->x + w);
+        used_h = NGLI_MAX(used_h, shape->y + h);
+    }
+    ngli_free(sorted);
+    if (ret < 0)
+        return ret;
+
+    s->texture_w = used_w;
+    s->texture_h = used_h;
+    return 0;
+}
+
 int ngli_distmap_finalize(struct distmap *s)
 {
     if (s->texture) {
@@ -430,15 +559,6 @@ int ngli_distmap_finalize(struct distmap *s)
     if (!nb_shapes)
         return 0;
 
-    /*
-     * Define texture dimension (mostly squared).
-     * TODO shapes are assumed to be square when balancing the number of rows
-     * and cols, we're not taking into account max_shape_padded_[wh] as we should
-     */
-    s->nb_rows = (int32_t)lrintf(sqrtf((float)nb_shapes));
-    s->nb_cols = (int32_t)ceilf((float)nb_shapes / (float)s->nb_rows);
-    ngli_assert(s->nb_rows * s->nb_cols >= nb_shapes);
-
     /*
      * Padding needs to be the same length in both directions and for all
      * shapes so that effects are consistent whatever the ratio or size of a
@@ -446,15 +566,15 @@ int ngli_distmap_finalize(struct distmap *s)
      */
     s->pad = NGLI_MAX(s->max_shape_w, s->max_shape_h) * PCENT_PADDING / 100;
 
-    /*
-     * +1 represents the extra half texel on each side used to prevent texture
-     * bleeding between shapes because of the linear filtering.
-     */
-    s->max_shape_padded_w = s->max_shape_w + 2 * s->pad + 1;
-    s->max_shape_padded_h = s->max_shape_h + 2 * s->pad + 1;
-
-    s->texture_w = s->max_shape_padded_w * s->nb_cols;
-    s->texture_h = s->max_shape_padded_h * s->nb_rows;
+    /* Define the texture dimensions (mostly squared) and the shape positions */
+    struct skyline *skyline = ngli_skyline_create();
+    if (!skyline)
+        return NGL_ERROR_MEMORY;
+    int ret = pack_shapes(s, skyline);
+    const int64_t used_area = ngli_skyline_get_used_area(skyline);
+    ngli_skyline_freep(&skyline);
+    if (ret < 0)
+        return ret;
 
     /*
      * Build pipeline and execute the computation of the complete signed
@@ -479,10 +599,16 @@ int ngli_distmap_finalize(struct distmap *s)
     if (!s->texture)
         return NGL_ERROR_MEMORY;
 
-    int ret = ngpu_texture_init(s->texture, &tex_params);
+    ret = ngpu_texture_init(s->texture, &tex_params);
     if (ret < 0)
         return ret;
 
+    const size_t bytes_per_pixel = ngpu_format_get_bytes_per_pixel(tex_params.format);
+    s->texture_size = (size_t)s->texture_w * (size_t)s->texture_h * bytes_per_pixel;
+    s->used_size = (size_t)used_area * bytes_per_pixel;
+    s->ctx->atlas_texture_size += s->texture_size;
+    s->ctx->atlas_used_size += s->used_size;
+
     const struct ngpu_rendertarget_params rt_params = {
         .width = (uint32_t)s->texture_w,
         .height = (uint32_t)s->texture_h,
@@ -595,23 +721,84 @@ int ngli_distmap_finalize(struct distmap *s)
     if (ret < 0)
         return ret;
 
-    ngpu_ctx_begin_render_pass(gpu_ctx, s->rt);
-
-    ret = draw_glyphs(s);
+    ret = render_distmap(s);
     if (ret < 0)
         return ret;
 
-    ngpu_ctx_end_render_pass(gpu_ctx);
-
     /*
      * Now that the distmap is rendered, the pipeline and other related
      * allocations are not needed anymore, we just have to keep the texture.
+     * Dynamic shapes are the exception since they will need to be rendered
+     * again every time they are updated.
      */
-    reset_tmp_data(s);
+    if (!s->dynamic)
+        reset_tmp_data(s);
 
     return 0;
 }
 
+int ngli_distmap_update_shape(struct distmap *s, int32_t shape_id, const struct path *path)
+{
+    const struct shape *shape = ngli_darray_get(&s->shapes, (size_t)shape_id);
+    if (!s->texture || !(shape->flags & NGLI_DISTMAP_FLAG_DYNAMIC)) {
+        LOG(ERROR, "shape %d can not be updated", shape_id);
+        return NGL_ERROR_INVALID_USAGE;
+    }
+
+    const int32_t beziergroup_start_idx = get_beziergroup_start(s, shape_id);
+    const int32_t beziergroup_count     = s->beziergroup_counts.data[shape_id];
+
+    const int32_t bezier_start_idx = sum_bezier_counts(s, 0, beziergroup_start_idx);
+    const int32_t bezier_count     = sum_bezier_counts(s, beziergroup_start_idx, beziergroup_start_idx + beziergroup_count);
+
+    /*
+     * The new curves are appended at the end of the arrays before being moved
+     * in place of the previous ones.
+     */
+    const size_t nb_beziers = s->bezier_x.count;
+    const size_t nb_bezier_counts = s->bezier_counts.count;
+
+    int32_t nb_beziergroups;
+    int ret = add_path_beziers(s, path, shape->flags, &nb_beziergroups);
+    if (ret < 0)
+        goto end;
+
+    /*
+     * The uniform blocks are sized when the distmap is finalized, so the
+     * number of sub-shapes and curves must be preserved. Only the closing
+     * state (the sign of the counts) of each sub-shape is allowed to change.
+     */
+    int32_t *counts = s->bezier_counts.data + beziergroup_start_idx;
+    const int32_t *new_counts = s->bezier_counts.data + nb_bezier_counts;
+    bool same_layout = nb_beziergroups == beziergroup_count;
+    for (int32_t i = 0; same_layout && i < beziergroup_count; i++)
+        same_layout = abs(counts[i]) == abs(new_counts[i]);
+    if (!same_layout) {
+        LOG(ERROR, "the number of curves in shape %d can not change", shape_id);
+        ret = NGL_ERROR_INVALID_USAGE;
+        goto end;
+    }
+
+    memcpy(counts, new_counts, (size_t)beziergroup_count * sizeof(*counts));
+    memcpy(s->bezier_x.data + bezier_start_idx, s->bezier_x.data + nb_beziers, (size_t)bezier_count * sizeof(*s->bezier_x.data));
+    memcpy(s->bezier_y.data + bezier_start_idx, s->bezier_y.data + nb_beziers, (size_t)bezier_count * sizeof(*s->bezier_y.data));
+
+end:
+    ngli_darray_remove_range(&s->bezier_x, nb_beziers, s->bezier_x.count - nb_beziers);
+    ngli_darray_remove_range(&s->bezier_y, nb_beziers, s->bezier_y.count - nb_beziers);
+    ngli_darray_remove_range(&s->bezier_counts, nb_bezier_counts, s->bezier_counts.count - nb_bezier_counts);
+    return ret;
+}
+
+int ngli_distmap_regenerate(struct distmap *s)
+{
+    if (!s->texture || !s->dynamic) {
+        LOG(ERROR, "distmap has no dynamic shape to regenerate");
+        return NGL_ERROR_INVALID_USAGE;
+    }
+    return render_distmap(s);
+}
+
 struct ngpu_texture *ngli_distmap_get_texture(const struct distmap *s)
 {
     return s->texture;
@@ -621,12 +808,10 @@ struct ngpu_texture *ngli_distmap_get_texture(const struct distmap *s)
 struct ngli_aabb ngli_distmap_get_shape_coords(const struct distmap *s, int32_t shape_id)
 {
     const struct shape *shape = ngli_darray_get(&s->shapes, (size_t)shape_id);
-    const int32_t col = shape_id % s->nb_cols;
-    const int32_t row = shape_id / s->nb_cols;
-    const int32_t x0 = col * s->max_shape_padded_w;
-    const int32_t y0 = row * s->max_shape_padded_h;
-    const int32_t x1 = x0 + 2*s->pad + shape->width + 1;
-    const int32_t y1 = y0 + 2*s->pad + shape->height + 1;
+    const int32_t x0 = shape->x;
+    const int32_t y0 = shape->y;
+    const int32_t x1 = x0 + get_padded_w(s, shape);
+    const int32_t y1 = y0 + get_padded_h(s, shape);
     const float tw = (float)s->texture_w, th = (float)s->texture_h;
     struct ngli_aabb r = {(float)x0 / tw, (float)y0 / th, (float)x1 / tw, (float)y1 / th};
     return r;
@@ -650,6 +835,9 @@ void ngli_distmap_freep(struct distmap **dp)
         return;
     reset_tmp_data(s);
 
+    s->ctx->atlas_texture_size -= s->texture_size;
+    s->ctx->atlas_used_size -= s->used_size;
+
     ngli_darray_reset(&s->shapes);
     ngpu_texture_freep(&s->texture);
     ngli_freep(dp);
@@ -29,6 +29,7 @@
 #include "box.h"
 
 #define NGLI_DISTMAP_FLAG_PATH_AUTO_CLOSE (1 << 0) // Consider all sub-paths to be closed
+#define NGLI_DISTMAP_FLAG_DYNAMIC         (1 << 1) // Shape can be updated after finalization
 
 struct ngl_ctx;
 struct distmap;
@@ -40,6 +41,14 @@ int ngli_distmap_add_shape(struct distmap *s, int32_t shape_w, int32_t shape_h,
                            const struct path *path, uint32_t flags, int32_t *shape_id);
 int ngli_distmap_finalize(struct distmap *s);
 
+/*
+ * Replace the geometry of a shape added with NGLI_DISTMAP_FLAG_DYNAMIC; the
+ * new path must have the same number of sub-paths and segments. The texture
+ * content is only refreshed by the next call to ngli_distmap_regenerate().
+ */
+int ngli_distmap_update_shape(struct distmap *s, int32_t shape_id, const struct path *path);
+int ngli_distmap_regenerate(struct distmap *s);
+
 struct ngpu_texture *ngli_distmap_get_texture(const struct distmap *s);
 struct ngli_aabb ngli_distmap_get_shape_coords(const struct distmap *s, int32_t shape_id);
 void ngli_distmap_get_shape_scale(const struct distmap *s, int32_t shape_id, float *dst);
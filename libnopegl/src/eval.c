@@ -229,6 +229,53 @@ struct token {
 
 NGLI_DECLARE_DARRAY_WITH_NAME(token_darray, struct token);
 
+enum opcode {
+    OPCODE_ADD,
+    OPCODE_SUB,
+    OPCODE_MUL,
+    OPCODE_DIV,
+    OPCODE_NEGATE,
+    OPCODE_CALL1,
+    OPCODE_CALL2,
+    OPCODE_CALL3,
+};
+
+/*
+ * Bytecode instruction: read up to 3 source registers and write the result
+ * into the destination register
+ */
+struct instruction {
+    enum opcode opcode;
+    uint32_t dst;
+    uint32_t src[3];
+    union {
+        void *f;
+        float (*f1)(float a);
+        float (*f2)(float a, float b);
+        float (*f3)(float a, float b, float c);
+    } func; // OPCODE_CALL*
+};
+
+struct variable {
+    const float *ptr;   // pointer to the changing data
+    uint32_t reg;       // register receiving the variable value
+};
+
+/* Variable values of a ngli_eval_run_batch() call */
+struct batch_binding {
+    uint32_t reg;
+    const float *data;
+    size_t stride;
+};
+
+NGLI_DECLARE_DARRAY_WITH_NAME(instruction_darray, struct instruction);
+NGLI_DECLARE_DARRAY_WITH_NAME(variable_darray, struct variable);
+NGLI_DECLARE_DARRAY_WITH_NAME(batch_binding_darray, struct batch_binding);
+NGLI_DECLARE_DARRAY_WITH_NAME(f32_darray, float);
+
+/* Number of evaluations processed at once by ngli_eval_run_batch() */
+#define BATCH_SIZE 64
+
 struct eval {
     struct token_darray tokens;       // user input, infix notation
     struct token_darray tmp_stack;    // temporary token stack
@@ -236,6 +283,13 @@ struct eval {
     struct hmap *funcs;         // hash map of functions_map
     struct hmap *consts;        // hash map of constants_map
     const struct hmap *vars;    // hash map of user variables
+    struct instruction_darray program;  // compiled expression
+    struct variable_darray variables;   // variables referenced by the program
+    struct f32_darray registers;        // constants, variables and intermediate results
+    int has_result;
+    uint32_t result_reg;
+    float *batch_registers;             // registers, each with BATCH_SIZE lanes
+    struct batch_binding_darray batch_bindings;
 };
 
 struct eval *ngli_eval_create(void)
@@ -489,8 +543,8 @@ static int check_operator_pop(struct token_darray *stack, const struct token *to
  * - check if the expression is valid by simulating a simplified evaluation of
  *   the expression with extra checks (which would have been redundant if
  *   called for every eval_run call).
- * - make sure the temporary stack is pre-allocated with enough space so that
- *   eval_run calls do not trigger any heap re-alloc
+ * - make sure the stack can not underflow, so that the compile pass does not
+ *   need to check for it
  */
 static int prepare_eval_run(struct eval *s)
 {
@@ -608,6 +662,173 @@ static int infix_to_rpn(struct eval *s, const char *expr)
     return prepare_eval_run(s);
 }
 
+static int add_register(struct eval *s, float value, uint32_t *regp)
+{
+    if (s->registers.count >= UINT32_MAX)
+        return NGL_ERROR_LIMIT_EXCEEDED;
+    *regp = (uint32_t)s->registers.count;
+    if (ngli_darray_push(&s->registers, value) < 0)
+        return NGL_ERROR_MEMORY;
+    return 0;
+}
+
+static int get_variable_register(struct eval *s, const float *ptr, uint32_t *regp)
+{
+    ngli_darray_foreach(var, &s->variables) {
+        if (var->ptr == ptr) {
+            *regp = var->reg;
+            return 0;
+        }
+    }
+
+    int ret = add_register(s, 0.f, regp);
+    if (ret < 0)
+        return ret;
+
+    const struct variable var = {.ptr=ptr, .reg=*regp};
+    if (ngli_darray_push(&s->variables, var) < 0)
+        return NGL_ERROR_MEMORY;
+    return 0;
+}
+
+NGLI_DECLARE_DARRAY_WITH_NAME(u32_darray, uint32_t);
+
+static int get_temporary_register(struct eval *s, struct u32_darray *temporaries, size_t depth, uint32_t *regp)
+{
+    while (temporaries->count <= depth) {
+        uint32_t reg;
+        int ret = add_register(s, 0.f, &reg);
+        if (ret < 0)
+            return ret;
+        if (ngli_darray_push(temporaries, reg) < 0)
+            return NGL_ERROR_MEMORY;
+    }
+    *regp = temporaries->data[depth];
+    return 0;
+}
+
+static enum opcode get_opcode(const struct token *token)
+{
+    if (token->func.f2 == f_add)    return OPCODE_ADD;
+    if (token->func.f2 == f_sub)    return OPCODE_SUB;
+    if (token->func.f2 == f_mul)    return OPCODE_MUL;
+    if (token->func.f2 == f_div)    return OPCODE_DIV;
+    if (token->func.f1 == f_negate) return OPCODE_NEGATE;
+    switch (token->nb_args) {
+    case 1: return OPCODE_CALL1;
+    case 2: return OPCODE_CALL2;
+    case 3: return OPCODE_CALL3;
+    }
+    ngli_assert(0);
+}
+
+static float call_operator(const struct token *token, const float *args)
+{
+    switch (token->nb_args) {
+    case 1: return token->func.f1(args[0]);
+    case 2: return token->func.f2(args[0], args[1]);
+    case 3: return token->func.f3(args[0], args[1], args[2]);
+    }
+    ngli_assert(0);
+}
+
+struct operand {
+    int constant;
+    uint32_t reg;
+};
+
+NGLI_DECLARE_DARRAY_WITH_NAME(operand_darray, struct operand);
+
+/*
+ * Compile pass: translate the RPN tokens into a register based bytecode.
+ *
+ * Every value of the evaluation stack lives in a register: constants and
+ * variables get a dedicated one while intermediate results use one register
+ * per stack depth. Operators for which all the operands are constant are
+ * evaluated immediately (constant folding) and do not produce any
+ * instruction.
+ */
+static int compile(struct eval *s)
+{
+    int ret = 0;
+    struct operand_darray stack = {0};
+    struct u32_darray temporaries = {0};
+
+    for (size_t i = 0; i < s->output.count; i++) {
+        const struct token *token = &s->output.data[i];
+
+        struct operand result = {0};
+        if (token->type == TOKEN_CONSTANT) {
+            result.constant = 1;
+            if ((ret = add_register(s, token->value, &result.reg)) < 0)
+                goto end;
+        } else if (token->type == TOKEN_VARIABLE) {
+            if ((ret = get_variable_register(s, token->ptr, &result.reg)) < 0)
+                goto end;
+        } else {
+            /* Unary plus: the operand is left untouched on the stack */
+            if (token->func.f1 == f_noop)
+                continue;
+
+            const size_t nb_args = (size_t)token->nb_args;
+            const size_t depth = stack.count - nb_args;
+            const struct operand *args = &stack.data[depth];
+
+            /* print() must be kept for its side effect */
+            int foldable = token->func.f1 != f_print;
+            float values[3];
+            for (size_t j = 0; j < nb_args; j++) {
+                foldable &= args[j].constant;
+                values[j] = s->registers.data[args[j].reg];
+            }
+
+            if (foldable) {
+                /*
+                 * Constant registers are never shared so the register of
+                 * the first operand can receive the folded value
+                 */
+                result = args[0];
+                s->registers.data[result.reg] = call_operator(token, values);
+            } else {
+                if ((ret = get_temporary_register(s, &temporaries, depth, &result.reg)) < 0)
+                    goto end;
+                struct instruction insn = {
+                    .opcode = get_opcode(token),
+                    .dst    = result.reg,
+                    .func.f = token->func.f,
+                };
+                for (size_t j = 0; j < nb_args; j++)
+                    insn.src[j] = args[j].reg;
+                if (ngli_darray_push(&s->program, insn) < 0) {
+                    ret = NGL_ERROR_MEMORY;
+                    goto end;
+                }
+            }
+            ngli_darray_remove_range(&stack, depth, nb_args);
+        }
+
+        if (ngli_darray_push(&stack, result) < 0) {
+            ret = NGL_ERROR_MEMORY;
+            goto end;
+        }
+    }
+
+    ngli_assert(stack.count <= 1);
+    if (stack.count) {
+        s->has_result = 1;
+        s->result_reg = stack.data[0].reg;
+    }
+
+    /* The program has been generated so we don't need the RPN anymore */
+    ngli_darray_reset(&s->output);
+    ngli_darray_reset(&s->tmp_stack);
+
+end:
+    ngli_darray_reset(&stack);
+    ngli_darray_reset(&temporaries);
+    return ret;
+}
+
 int ngli_eval_init(struct eval *s, const char *expr, const struct hmap *vars)
 {
     if (!expr)
@@ -617,53 +838,153 @@ int ngli_eval_init(struct eval *s, const char *expr, const struct hmap *vars)
 
     int ret;
     if ((ret = tokenize(s, expr)) < 0 ||
-        (ret = infix_to_rpn(s, expr)) < 0)
+        (ret = infix_to_rpn(s, expr)) < 0 ||
+        (ret = compile(s)) < 0)
         return ret;
 
     return 0;
 }
 
-/*
- * Evaluate the operator by consuming the stack.
- */
-static float eval_operator_pop(struct token_darray *stack, const struct token *token)
+int ngli_eval_run(struct eval *s, float *dst)
 {
-    const struct token *o1 = ngli_darray_pop_unsafe(stack);
-    if (token->nb_args == 1)
-        return token->func.f1(o1->value);
+    float *regs = s->registers.data;
+
+    ngli_darray_foreach(var, &s->variables)
+        regs[var->reg] = *var->ptr;
+
+    ngli_darray_foreach(insn, &s->program) {
+        const uint32_t *src = insn->src;
+        float *r = &regs[insn->dst];
+        switch (insn->opcode) {
+        case OPCODE_ADD:    *r = regs[src[0]] + regs[src[1]]; break;
+        case OPCODE_SUB:    *r = regs[src[0]] - regs[src[1]]; break;
+        case OPCODE_MUL:    *r = regs[src[0]] * regs[src[1]]; break;
+        case OPCODE_DIV:    *r = regs[src[0]] / regs[src[1]]; break;
+        case OPCODE_NEGATE: *r = -regs[src[0]]; break;
+        case OPCODE_CALL1:  *r = insn->func.f1(regs[src[0]]); break;
+        case OPCODE_CALL2:  *r = insn->func.f2(regs[src[0]], regs[src[1]]); break;
+        case OPCODE_CALL3:  *r = insn->func.f3(regs[src[0]], regs[src[1]], regs[src[2]]); break;
+        default:
+            ngli_assert(0);
+        }
+    }
 
-    const struct token *o2 = ngli_darray_pop_unsafe(stack);
-    if (token->nb_args == 2)
-        return token->func.f2(o2->value, o1->value);
+    *dst = s->has_result ? regs[s->result_reg] : 0.f;
+    return 0;
+}
 
-    const struct token *o3 = ngli_darray_pop_unsafe(stack);
-    if (token->nb_args == 3)
-        return token->func.f3(o3->value, o2->value, o1->value);
+static int init_batch_registers(struct eval *s)
+{
+    const size_t nb_regs = s->registers.count;
+    s->batch_registers = ngli_calloc(nb_regs, BATCH_SIZE * sizeof(*s->batch_registers));
+    if (!s->batch_registers)
+        return NGL_ERROR_MEMORY;
 
-    ngli_assert(0);
+    /* Broadcast the constants once for all, the other registers are overwritten at each run */
+    for (size_t i = 0; i < nb_regs; i++) {
+        float *lanes = &s->batch_registers[i * BATCH_SIZE];
+        for (size_t j = 0; j < BATCH_SIZE; j++)
+            lanes[j] = s->registers.data[i];
+    }
+    return 0;
 }
 
-int ngli_eval_run(struct eval *s, float *dst)
+static int bind_batch_variables(struct eval *s, const struct eval_binding *bindings, size_t nb_bindings)
 {
-    struct token_darray *stack = &s->tmp_stack;
+    ngli_darray_clear(&s->batch_bindings);
+
+    for (size_t i = 0; i < nb_bindings; i++) {
+        const struct eval_binding *binding = &bindings[i];
+        const float *ptr = s->vars ? ngli_hmap_get_str(s->vars, binding->name) : NULL;
+        if (!ptr) {
+            LOG(ERROR, "unknown variable \"%s\"", binding->name);
+            return NGL_ERROR_INVALID_ARG;
+        }
 
-    ngli_darray_clear(stack);
+        ngli_darray_foreach(var, &s->variables) {
+            if (var->ptr != ptr)
+                continue;
+            const struct batch_binding batch_binding = {
+                .reg    = var->reg,
+                .data   = binding->data,
+                .stride = binding->stride,
+            };
+            if (ngli_darray_push(&s->batch_bindings, batch_binding) < 0)
+                return NGL_ERROR_MEMORY;
+            break;
+        }
+    }
 
-    for (size_t i = 0; i < s->output.count; i++) {
-        const struct token *token = &s->output.data[i];
-        if (token->type == TOKEN_VARIABLE) {
-            const struct token r = {.type=TOKEN_CONSTANT, .value=*token->ptr};
-            PUSH(stack, &r);
-        } else if (token->type == TOKEN_CONSTANT) {
-            PUSH(stack, token);
-        } else {
-            const struct token r = {.type=TOKEN_CONSTANT, .value=eval_operator_pop(stack, token)};
-            PUSH(stack, &r);
+    return 0;
+}
+
+/*
+ * Run the program on up to BATCH_SIZE evaluations: each instruction is
+ * executed over all the lanes of its registers before moving to the next one,
+ * which amortizes the dispatch and lets the compiler vectorize the loops.
+ */
+static void run_batch_program(struct eval *s, size_t n)
+{
+    float *regs = s->batch_registers;
+
+    ngli_darray_foreach(insn, &s->program) {
+        float *r = &regs[insn->dst * BATCH_SIZE];
+        const float *a = &regs[insn->src[0] * BATCH_SIZE];
+        const float *b = &regs[insn->src[1] * BATCH_SIZE];
+        const float *c = &regs[insn->src[2] * BATCH_SIZE];
+        switch (insn->opcode) {
+        case OPCODE_ADD:    for (size_t i = 0; i < n; i++) r[i] = a[i] + b[i]; break;
+        case OPCODE_SUB:    for (size_t i = 0; i < n; i++) r[i] = a[i] - b[i]; break;
+        case OPCODE_MUL:    for (size_t i = 0; i < n; i++) r[i] = a[i] * b[i]; break;
+        case OPCODE_DIV:    for (size_t i = 0; i < n; i++) r[i] = a[i] / b[i]; break;
+        case OPCODE_NEGATE: for (size_t i = 0; i < n; i++) r[i] = -a[i]; break;
+        case OPCODE_CALL1:  for (size_t i = 0; i < n; i++) r[i] = insn->func.f1(a[i]); break;
+        case OPCODE_CALL2:  for (size_t i = 0; i < n; i++) r[i] = insn->func.f2(a[i], b[i]); break;
+        case OPCODE_CALL3:  for (size_t i = 0; i < n; i++) r[i] = insn->func.f3(a[i], b[i], c[i]); break;
+        default:
+            ngli_assert(0);
         }
     }
+}
+
+int ngli_eval_run_batch(struct eval *s, float *dst, size_t count,
+                        const struct eval_binding *bindings, size_t nb_bindings)
+{
+    int ret = bind_batch_variables(s, bindings, nb_bindings);
+    if (ret < 0)
+        return ret;
+
+    if (!s->has_result) {
+        memset(dst, 0, count * sizeof(*dst));
+        return 0;
+    }
+
+    if (!s->batch_registers && (ret = init_batch_registers(s)) < 0)
+        return ret;
+
+    /* Unbound variables keep their current value during the whole batch */
+    ngli_darray_foreach(var, &s->variables) {
+        float *lanes = &s->batch_registers[var->reg * BATCH_SIZE];
+        const float value = *var->ptr;
+        for (size_t i = 0; i < BATCH_SIZE; i++)
+            lanes[i] = value;
+    }
+
+    for (size_t start = 0; start < count; start += BATCH_SIZE) {
+        const size_t n = NGLI_MIN(count - start, BATCH_SIZE);
+
+        ngli_darray_foreach(binding, &s->batch_bindings) {
+            float *lanes = &s->batch_registers[binding->reg * BATCH_SIZE];
+            const float *data = binding->data + start * binding->stride;
+            for (size_t i = 0; i < n; i++)
+                lanes[i] = data[i * binding->stride];
+        }
+
+        run_batch_program(s, n);
+
+        memcpy(dst + start, &s->batch_registers[s->result_reg * BATCH_SIZE], n * sizeof(*dst));
+    }
 
-    ngli_assert(stack->count <= 1);
-    *dst = stack->count ? ngli_darray_pop(stack)->value : 0.f;
     return 0;
 }
 
@@ -675,6 +996,11 @@ void ngli_eval_freep(struct eval **sp)
     ngli_darray_reset(&s->tokens);
     ngli_darray_reset(&s->tmp_stack);
     ngli_darray_reset(&s->output);
+    ngli_darray_reset(&s->program);
+    ngli_darray_reset(&s->variables);
+    ngli_darray_reset(&s->registers);
+    ngli_darray_reset(&s->batch_bindings);
+    ngli_freep(&s->batch_registers);
     ngli_hmap_freep(&s->funcs);
     ngli_hmap_freep(&s->consts);
     ngli_freep(sp);
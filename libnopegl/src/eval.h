@@ -23,13 +23,27 @@
 #ifndef EVAL_H
 #define EVAL_H
 
+#include <stddef.h>
+
 #include "utils/hmap.h"
 
 struct eval;
 
+/*
+ * Values of a variable for ngli_eval_run_batch(): the i-th evaluation reads
+ * the variable value at data[i * stride]
+ */
+struct eval_binding {
+    const char *name;   // name of the variable in the hmap passed to ngli_eval_init()
+    const float *data;
+    size_t stride;      // in number of floats, 0 to use the same value for all evaluations
+};
+
 struct eval *ngli_eval_create(void);
 int ngli_eval_init(struct eval *s, const char *expr, const struct hmap *vars);
 int ngli_eval_run(struct eval *s, float *dst);
+int ngli_eval_run_batch(struct eval *s, float *dst, size_t count,
+                        const struct eval_binding *bindings, size_t nb_bindings);
 void ngli_eval_freep(struct eval **sp);
 
 #endif
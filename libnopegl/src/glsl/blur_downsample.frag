@@ -21,6 +21,7 @@
  */
 
 #include helper_srgb.glsl
+#include helper_blur.glsl
 
 const vec3 offsets_weights[5] = vec3[](
     vec3(0.0,  0.0,  0.5),
@@ -38,7 +39,7 @@ void main()
         highp vec2 offset = offset * offsets_weights[i].xy / size;
         highp float weight = offsets_weights[i].z;
         highp vec4 value = texture(tex, tex_coord + offset);
-        color += vec4(ngli_srgb2linear(value.rgb), value.a) * weight;
+        color += ngli_blur_load(value) * weight;
     }
-    ngl_out_color = vec4(ngli_linear2srgb(color.rgb), color.a);
+    ngl_out_color = ngli_blur_store(color);
 }
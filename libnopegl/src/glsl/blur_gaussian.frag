@@ -21,6 +21,7 @@
  */
 
 #include helper_srgb.glsl
+#include helper_blur.glsl
 
 void main()
 {
@@ -30,7 +31,7 @@ void main()
         highp vec2 offset = direction.direction * kernel.weights[i].x / size;
         highp float weight = kernel.weights[i].y;
         highp vec4 value = texture(tex, tex_coord + offset);
-        color += vec4(ngli_srgb2linear(value.rgb), value.a) * weight;
+        color += ngli_blur_load(value) * weight;
     }
-    ngl_out_color = vec4(ngli_linear2srgb(color.rgb), color.a);
+    ngl_out_color = ngli_blur_store(color);
 }
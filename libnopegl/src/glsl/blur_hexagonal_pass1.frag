@@ -43,6 +43,6 @@ void main()
     vec4 color = ngli_blur_hexagonal(tex, tex_coord, map, map_coord, up, scale, lod, nb_samples);
     vec4 color2 = ngli_blur_hexagonal(tex, tex_coord, map, map_coord, down_left, scale, lod, nb_samples);
 
-    ngl_out_color[0] = vec4(ngli_linear2srgb(color.rgb), color.a);
-    ngl_out_color[1] = vec4(ngli_linear2srgb(color.rgb + color2.rgb), color.a + color2.a);
+    ngl_out_color[0] = ngli_blur_store(color);
+    ngl_out_color[1] = ngli_blur_store(color + color2);
 }
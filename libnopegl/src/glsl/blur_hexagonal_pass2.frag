@@ -51,5 +51,5 @@ void main()
     vec4 color2 = ngli_blur_hexagonal(tex1, tex_coord, map, map_coord, down_right, scale, lod, nb_samples);
 
     vec4 out_color = mix(color, color2, 0.5);
-    ngl_out_color = vec4(ngli_linear2srgb(out_color.rgb), out_color.a);
+    ngl_out_color = ngli_blur_store(out_color);
 }
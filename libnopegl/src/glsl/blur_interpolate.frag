@@ -21,10 +21,11 @@
  */
 
 #include helper_srgb.glsl
+#include helper_blur.glsl
 
 void main()
 {
-    highp vec4 c0 = texture(tex0, tex_coord);
-    highp vec4 c1 = texture(tex1, tex_coord);
-    ngl_out_color = ngli_srgbmix(c0, c1, interpolate.lod);
+    highp vec4 c0 = ngli_blur_load(texture(tex0, tex_coord));
+    highp vec4 c1 = ngli_blur_load(texture(tex1, tex_coord));
+    ngl_out_color = ngli_blur_store(mix(c0, c1, interpolate.lod));
 }
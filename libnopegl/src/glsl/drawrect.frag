@@ -60,6 +60,11 @@ float ngli_sdf_rounded_box(vec2 pos, vec2 half_size, vec2 radius)
 
 void main()
 {
+#ifdef NGLI_BATCHED
+    /* Instanced path: fetch this rect's parameters (see drawrect_batch.frag) */
+    ngli_load_instance();
+#endif
+
     /*
      * Rounded clip rectangles: each clip is a rounded box evaluated in its own
      * local space: map the canvas-pixel position into that space (inverse of
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2026 Matthieu Bouron <matthieu.bouron@gmail.com>
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * Instanced variant of the drawrect fragment parameters: instead of the frag
+ * uniform block, every parameter is a global filled by
+ * ngli_load_rect_instance() from the per-instance record of the rect being
+ * rasterized (see struct drawrect2d_instance).
+ */
+vec2  ngli_rect_size;
+vec2  ngli_corner_radius;
+float ngli_outline_width;
+int   ngli_outline_mode;
+float ngli_opacity;
+float ngli_fill_opacity;
+float ngli_stroke_opacity;
+int   ngli_content_wrap;
+float ngli_content_zoom;
+vec2  ngli_content_translate;
+vec2  ngli_content_orientation;
+vec2  ngli_frag_uv_scale;
+int   ngli_fill_premult;
+vec4  ngli_clip_inv[NGLI_MAX_CLIPS_2D];
+vec4  ngli_clip_rect[NGLI_MAX_CLIPS_2D];
+vec4  ngli_clip_radius[NGLI_MAX_CLIPS_2D];
+int   ngli_nb_clips;
+
+void ngli_load_rect_instance(int base)
+{
+    vec4 rect      = frag_instances.data[base + 4];
+    vec4 uv_params = frag_instances.data[base + 5];
+    vec4 params0   = frag_instances.data[base + 6];
+    vec4 params1   = frag_instances.data[base + 7];
+    vec4 params2   = frag_instances.data[base + 8];
+    vec4 params3   = frag_instances.data[base + 9];
+
+    ngli_rect_size           = rect.zw;
+    ngli_frag_uv_scale       = uv_params.xy;
+    ngli_opacity             = params0.y;
+    ngli_outline_width       = params0.z;
+    ngli_outline_mode        = floatBitsToInt(params0.w);
+    ngli_corner_radius       = params1.xy;
+    ngli_fill_opacity        = params1.z;
+    ngli_stroke_opacity      = params1.w;
+    ngli_content_translate   = params2.xy;
+    ngli_content_orientation = params2.zw;
+    ngli_content_zoom        = params3.x;
+    ngli_content_wrap        = floatBitsToInt(params3.y);
+    ngli_fill_premult        = floatBitsToInt(params3.z);
+    ngli_nb_clips            = floatBitsToInt(params3.w);
+
+    for (int i = 0; i < ngli_nb_clips; i++) {
+        ngli_clip_inv[i]    = frag_instances.data[base + 10 + i];
+        ngli_clip_rect[i]   = frag_instances.data[base + 10 + NGLI_MAX_CLIPS_2D + i];
+        ngli_clip_radius[i] = frag_instances.data[base + 10 + 2 * NGLI_MAX_CLIPS_2D + i];
+    }
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright 2026 Matthieu Bouron <matthieu.bouron@gmail.com>
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * Instanced variant of drawrect.vert: the rect geometry, transform and
+ * dilation parameters are read from the per-instance records of the
+ * vert_instances storage block instead of the vertex attributes and the
+ * vert uniform block (see struct drawrect2d_instance).
+ */
+void main()
+{
+    int base = ngl_instance_index * NGLI_INSTANCE_STRIDE;
+    mat4 modelview_matrix = mat4(vert_instances.data[base + 0],
+                                 vert_instances.data[base + 1],
+                                 vert_instances.data[base + 2],
+                                 vert_instances.data[base + 3]);
+    vec4 rect      = vert_instances.data[base + 4];
+    vec4 uv_params = vert_instances.data[base + 5]; /* uv_scale, margin_uv */
+    float margin_px = vert_instances.data[base + 6].x;
+
+    vec2 dir = sign(uvcoord - 0.5);
+    vec2 position = rect.xy + uvcoord * rect.zw;
+    vec4 canvas_pos = modelview_matrix * vec4(position + dir * margin_px, 0.0, 1.0);
+    ngl_out_pos = projection_matrix * canvas_pos;
+    ngli_clip_pos = canvas_pos.xy;
+    ngli_uv = uvcoord + dir * uv_params.zw;
+    vec2 adj_uvcoord = (uvcoord - 0.5) * uv_params.xy + 0.5;
+    ngli_tex_coord = adj_uvcoord;
+    ngli_instance = ngl_instance_index;
+}
@@ -20,6 +20,29 @@
  * under the License.
  */
 
+/*
+ * Blur passes accumulate in linear space. Intermediate render targets using a
+ * floating point format hold linear values directly (NGLI_BLUR_LINEAR_INPUT
+ * and NGLI_BLUR_LINEAR_OUTPUT), which saves the sRGB transfer on every tap.
+ */
+vec4 ngli_blur_load(vec4 value)
+{
+#ifdef NGLI_BLUR_LINEAR_INPUT
+    return value;
+#else
+    return vec4(ngli_srgb2linear(value.rgb), value.a);
+#endif
+}
+
+vec4 ngli_blur_store(vec4 color)
+{
+#ifdef NGLI_BLUR_LINEAR_OUTPUT
+    return color;
+#else
+    return vec4(ngli_linear2srgb(color.rgb), color.a);
+#endif
+}
+
 vec4 ngli_blur_hexagonal(sampler2D tex, vec2 tex_coord, sampler2D map, vec2 map_coord, vec2 direction, float scale, float lod, int nb_samples)
 {
     nb_samples = max(nb_samples, 1);
@@ -40,7 +63,7 @@ vec4 ngli_blur_hexagonal(sampler2D tex, vec2 tex_coord, sampler2D map, vec2 map_
         vec4 value = textureLod(tex, tex_coord + coord_offset, lod);
         float coc = texture(map, map_coord + coord_offset).r;
         coc = mix(1.0, coc, use_coc);
-        color += vec4(ngli_srgb2linear(value.rgb), value.a) * coc;
+        color += ngli_blur_load(value) * coc;
         amount += coc;
     }
     return color / amount;
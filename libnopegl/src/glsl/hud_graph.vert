@@ -0,0 +1,78 @@
+/*
+ * Copyright 2026 Matthieu Bouron <matthieu.bouron@gmail.com>
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+const vec2 uvs[] = vec2[](vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(0.0, 1.0), vec2(1.0, 1.0));
+
+#define GRAPH_LINE 0.0
+
+/* Height in pixels of a sample within the graph range */
+float get_sample_height(int graph, int row, vec4 rect, vec4 range)
+{
+    float value = texelFetch(history, ivec2(graph, row), 0).r;
+    return floor((value - range.x) * rect.w / (range.y - range.x));
+}
+
+void main()
+{
+    int graph = int(graph_column.x);
+    int column = int(graph_column.y);
+    vec4 rect = graph_rect[graph];
+    vec4 range = graph_range[graph]; /* min, max, number of samples, type */
+    int count = int(range.z);
+    color = graph_color[graph];
+
+    /* Collapse the columns without sample as well as empty ranges */
+    if (column >= count || range.y <= range.x) {
+        ngl_out_pos = vec4(0.0, 0.0, 0.0, 1.0);
+        return;
+    }
+
+    /*
+     * The history is a ring buffer shared by all the graphs: history_pos is
+     * the next row to be written, so the last count rows are the samples of
+     * the graph, from the oldest to the most recent.
+     */
+    int history_len = textureSize(history, 0).y;
+    int row = (history_pos - count + column + history_len) % history_len;
+    float h = get_sample_height(graph, row, rect, range);
+
+    float y0, y1;
+    if (range.w == GRAPH_LINE) {
+        float y = clamp(rect.w - 1.0 - h, 0.0, rect.w - 1.0);
+        y0 = y;
+        y1 = y;
+        if (column > 0) {
+            /* Join the previous sample with a vertical segment */
+            float prev_h = get_sample_height(graph, (row + history_len - 1) % history_len, rect, range);
+            float prev_y = clamp(rect.w - 1.0 - prev_h, 0.0, rect.w - 1.0);
+            y0 = min(y0, prev_y);
+            y1 = max(y1, prev_y);
+        }
+        y1 += 1.0;
+    } else {
+        y0 = clamp(rect.w - h, 0.0, rect.w);
+        y1 = rect.w;
+    }
+
+    vec2 uv = uvs[ngl_vertex_index];
+    vec2 position = vec2(rect.x + float(column) + uv.x, rect.y + mix(y0, y1, uv.y));
+    ngl_out_pos = projection_matrix * modelview_matrix * pixel_matrix * vec4(position, 0.0, 1.0);
+}
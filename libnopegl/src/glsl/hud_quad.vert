@@ -0,0 +1,37 @@
+/*
+ * Copyright 2026 Matthieu Bouron <matthieu.bouron@gmail.com>
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+const vec2 uvs[] = vec2[](vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(0.0, 1.0), vec2(1.0, 1.0));
+
+void main()
+{
+    vec2 uv = uvs[ngl_vertex_index];
+    vec2 position = quad_rect.xy + quad_rect.zw * uv;
+    ngl_out_pos = projection_matrix * modelview_matrix * pixel_matrix * vec4(position, 0.0, 1.0);
+    color = quad_color;
+
+    /*
+     * The glyph is the horizontal offset of the character in the atlas (in
+     * texels), or a negative value for a plain rectangle.
+     */
+    atlas_coord = vec2(max(quad_glyph, 0.0), 0.0) + quad_rect.zw * uv;
+    use_atlas = quad_glyph < 0.0 ? 0.0 : 1.0;
+}
@@ -22,11 +22,98 @@
 
 const vec2 uvs[] = vec2[](vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(0.0, 1.0), vec2(1.0, 1.0));
 
+/* Must match the layout of the effects textures in text.h */
+const int EFFECTS_LUT_ROWS = 8;
+
+const int EFFECT_PARAM_TRANSFORM     = 1 << 0;
+const int EFFECT_PARAM_COLOR         = 1 << 1;
+const int EFFECT_PARAM_OPACITY       = 1 << 2;
+const int EFFECT_PARAM_OUTLINE_COLOR = 1 << 3;
+const int EFFECT_PARAM_OUTLINE       = 1 << 4;
+const int EFFECT_PARAM_GLOW_COLOR    = 1 << 5;
+const int EFFECT_PARAM_GLOW          = 1 << 6;
+const int EFFECT_PARAM_BLUR          = 1 << 7;
+const int EFFECT_PARAM_OUTLINE_POS   = 1 << 8;
+
+/* Linearly interpolate a row of the sampled effect parameters at time t in [0,1] */
+vec4 get_effect_param(int effect, int row, float t)
+{
+    int lut_size = textureSize(effects_lut, 0).x;
+    float x = t * float(lut_size - 1);
+    int x0 = int(x);
+    int x1 = min(x0 + 1, lut_size - 1);
+    int y = effect * EFFECTS_LUT_ROWS + row;
+    return mix(texelFetch(effects_lut, ivec2(x0, y), 0), texelFetch(effects_lut, ivec2(x1, y), 0), fract(x));
+}
+
+mat4 translate(vec2 v)
+{
+    return mat4(1.0, 0.0, 0.0, 0.0,
+                0.0, 1.0, 0.0, 0.0,
+                0.0, 0.0, 1.0, 0.0,
+                v.x, v.y, 0.0, 1.0);
+}
+
 void main()
 {
     vec2 ref_uv = uvs[ngl_vertex_index];
     vec2 position = mix(vertices.xy, vertices.zw, ref_uv);
-    ngl_out_pos = projection_matrix * modelview_matrix * user_transform * vec4(position, 0.0, 1.0);
+
+    mat4 transform = user_transform;
+    vec4 chr_color = frag_color;
+    vec4 chr_outline = frag_outline;
+    vec4 chr_glow = frag_glow;
+    float chr_blur = frag_blur;
+    float chr_outline_pos = frag_outline_pos;
+
+    /* Evaluate the effects (none if they are applied on the CPU) */
+    int chars_width = textureSize(effects_chars, 0).x;
+    for (int i = 0; i < nb_effects; i++) {
+        vec4 timing = effect_timing[i]; /* effect time, duration, timescale, number of elements */
+        vec4 range = effect_range[i];   /* start position, end position, active, parameters mask */
+        if (range.z == 0.0)
+            continue;
+
+        /* Position of the character in the effect segmentation, and its real dimensions */
+        vec4 chr = texelFetch(effects_chars, ivec2(ngl_instance_index % chars_width,
+                                                   i * effect_chars_rows + ngl_instance_index / chars_width), 0);
+
+        /* Spacially filter out characters that do not land into the user specified range */
+        float pos_f = (chr.x + 0.5) / timing.w;
+        if (pos_f < range.x || pos_f > range.y)
+            continue;
+
+        /* Interpolate the time of the target, taking into account the overlap */
+        float t = clamp((timing.x - timing.z * chr.x) / timing.y, 0.0, 1.0);
+
+        int mask = int(range.w);
+        if ((mask & EFFECT_PARAM_TRANSFORM) != 0) {
+            vec4 anchor = effect_anchor[i];
+            vec2 pivot = anchor.z > 0.0
+                       ? (vertices.xy + vertices.zw) / 2.0 + anchor.xy * chr.yz / 2.0
+                       : anchor.xy;
+            mat4 tm = mat4(get_effect_param(i, 0, t),
+                           get_effect_param(i, 1, t),
+                           get_effect_param(i, 2, t),
+                           get_effect_param(i, 3, t));
+            transform = transform * translate(pivot) * tm * translate(-pivot);
+        }
+
+        vec4 color_opacity = get_effect_param(i, 4, t);
+        vec4 outline_params = get_effect_param(i, 5, t);
+        vec4 glow_params = get_effect_param(i, 6, t);
+        vec4 misc_params = get_effect_param(i, 7, t);
+        if ((mask & EFFECT_PARAM_COLOR) != 0)         chr_color.rgb = color_opacity.rgb;
+        if ((mask & EFFECT_PARAM_OPACITY) != 0)       chr_color.a = color_opacity.a;
+        if ((mask & EFFECT_PARAM_OUTLINE_COLOR) != 0) chr_outline.rgb = outline_params.rgb;
+        if ((mask & EFFECT_PARAM_OUTLINE) != 0)       chr_outline.a = outline_params.a;
+        if ((mask & EFFECT_PARAM_GLOW_COLOR) != 0)    chr_glow.rgb = glow_params.rgb;
+        if ((mask & EFFECT_PARAM_GLOW) != 0)          chr_glow.a = glow_params.a;
+        if ((mask & EFFECT_PARAM_BLUR) != 0)          chr_blur = misc_params.x;
+        if ((mask & EFFECT_PARAM_OUTLINE_POS) != 0)   chr_outline_pos = misc_params.y;
+    }
+
+    ngl_out_pos = projection_matrix * modelview_matrix * transform * vec4(position, 0.0, 1.0);
 
     /* Interpolate em-space texcoords from the glyph bounding box */
     texcoord = mix(texcoord_bounds.xy, texcoord_bounds.zw, ref_uv);
@@ -34,9 +121,9 @@ void main()
     /* Pass through per-instance data */
     banding = frag_banding;
     glyph = frag_glyph_data;
-    color = frag_color;
-    outline = frag_outline;
-    glow = frag_glow;
-    blur = frag_blur;
-    outline_pos = frag_outline_pos;
+    color = chr_color;
+    outline = chr_outline;
+    glow = chr_glow;
+    blur = chr_blur;
+    outline_pos = chr_outline_pos;
 }
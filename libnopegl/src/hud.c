@@ -34,6 +34,7 @@
 
 #include <inttypes.h>
 #include <math.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <string.h>
 #include <sys/stat.h>
@@ -41,6 +42,10 @@
 
 #include "drawutils.h"
 #include "hud.h"
+#include "hud_graph_frag.h"
+#include "hud_graph_vert.h"
+#include "hud_quad_frag.h"
+#include "hud_quad_vert.h"
 #include "internal.h"
 #include "log.h"
 #include "math_utils.h"
@@ -56,6 +61,7 @@
 struct transforms_block {
     struct ngli_mat4 modelview_matrix;
     struct ngli_mat4 projection_matrix;
+    struct ngli_mat4 pixel_matrix;
 };
 
 enum {
@@ -72,6 +78,10 @@ enum {
     MEMORY_BLOCKS_CPU,
     MEMORY_BLOCKS_GPU,
     MEMORY_TEXTURES,
+    MEMORY_DEVICE_ALLOCATED,
+    MEMORY_DEVICE_USED,
+    MEMORY_ATLAS_ALLOCATED,
+    MEMORY_ATLAS_USED,
     NB_MEMORY
 };
 
@@ -91,6 +101,34 @@ enum {
     NB_DRAWCALL
 };
 
+#define NB_GRAPHS (NB_LATENCY + NB_MEMORY + NB_ACTIVITY + NB_DRAWCALL)
+
+enum graph_type {
+    GRAPH_LINE,
+    GRAPH_BLOCK,
+};
+
+struct graphs_block {
+    int32_t history_pos;
+    int32_t _pad[3];
+    float rect[NB_GRAPHS][4];
+    float color[NB_GRAPHS][4];
+    float range[NB_GRAPHS][4];
+};
+
+/* Background rectangle or character, drawn as one instance */
+struct hud_quad {
+    float rect[4];
+    float color[4];
+    float glyph;
+};
+
+/* Column of a graph, drawn as one instance */
+struct graph_column {
+    float graph;
+    float column;
+};
+
 enum widget_type {
     WIDGET_LATENCY,
     WIDGET_MEMORY,
@@ -140,6 +178,7 @@ struct widget {
     struct rect rect;
     int text_x, text_y;
     struct rect graph_rect;
+    size_t graph_id;
     struct data_graph *data_graph;
     const void *user_data;
     void *priv_data;
@@ -159,6 +198,14 @@ struct widget_spec {
 };
 
 NGLI_DECLARE_DARRAY_WITH_NAME(widget_darray, struct widget);
+NGLI_DECLARE_DARRAY_WITH_NAME(hud_quad_darray, struct hud_quad);
+
+struct hud_pipeline {
+    struct ngpu_pgcraft *crafter;
+    struct pipeline_compat *pipeline_compat;
+    int32_t transforms_block_index;
+    int32_t graphs_block_index;
+};
 
 struct hud {
     struct ngl_ctx *ctx;
@@ -172,19 +219,35 @@ struct hud {
     locale_t c_locale;
 #endif
     struct widget_darray widgets;
-    uint32_t bg_color_u32;
+    size_t nb_graphs;
+    int width, height;
     FILE *fp_export;
     struct bstr *csv_line;
-    struct canvas canvas;
     double refresh_rate_interval;
     double last_refresh_time;
 
-    struct ngpu_pgcraft *crafter;
-    struct ngpu_texture *texture;
-    struct ngpu_buffer *coords;
-    int32_t transforms_block_index;
-    struct pipeline_compat *pipeline_compat;
-    struct ngpu_graphics_state graphics_state;
+    /*
+     * Widget backgrounds followed by the characters of the last refresh,
+     * drawn from a single atlas of the builtin font
+     */
+    struct hud_quad_darray quads;
+    size_t nb_bg_quads;
+    size_t max_quads;
+    struct ngpu_buffer *quads_buffer;
+    struct ngpu_texture *atlas;
+
+    /*
+     * Graph history: one column per graph and one row per refresh, only the
+     * row of the latest samples is uploaded at each refresh
+     */
+    float samples[NB_GRAPHS];
+    struct graphs_block graphs_data;
+    struct ngpu_texture *history;
+    struct ngpu_buffer *columns;
+    uint32_t nb_columns;
+
+    struct hud_pipeline quad_pipeline;
+    struct hud_pipeline graph_pipeline;
 };
 
 #define WIDGET_PADDING 4
@@ -195,6 +258,11 @@ struct hud {
 #define ACTIVITY_WIDGET_TEXT_LEN    12
 #define DRAWCALL_WIDGET_TEXT_LEN    12
 
+/* Printable ASCII characters of the builtin font */
+#define ATLAS_FIRST_CHAR 32
+#define ATLAS_LAST_CHAR  127
+#define ATLAS_NB_CHARS   (ATLAS_LAST_CHAR - ATLAS_FIRST_CHAR + 1)
+
 #define BUFFER_NODES                \
     NGL_NODE_ANIMATEDBUFFERFLOAT,   \
     NGL_NODE_ANIMATEDBUFFERVEC2,    \
@@ -271,6 +339,28 @@ static const struct {
         .node_types=(const uint32_t[]){NGL_NODE_TEXTURE2D, NGL_NODE_TEXTURE3D, NGL_NODE_CUSTOMTEXTURE, NGLI_NODE_NONE},
         .color=0xFF3232FF,
     },
+    /* Device memory sub-allocator statistics (Vulkan only) */
+    [MEMORY_DEVICE_ALLOCATED] = {
+        .label="Device alloc",
+        .node_types=(const uint32_t[]){NGLI_NODE_NONE},
+        .color=0xFF9A32FF,
+    },
+    [MEMORY_DEVICE_USED] = {
+        .label="Device used",
+        .node_types=(const uint32_t[]){NGLI_NODE_NONE},
+        .color=0x9A9AFFFF,
+    },
+    /* Distance map atlases texture size and area covered by the packed shapes */
+    [MEMORY_ATLAS_ALLOCATED] = {
+        .label="Atlas alloc",
+        .node_types=(const uint32_t[]){NGLI_NODE_NONE},
+        .color=0x32D6D6FF,
+    },
+    [MEMORY_ATLAS_USED] = {
+        .label="Atlas used",
+        .node_types=(const uint32_t[]){NGLI_NODE_NONE},
+        .color=0xD6D632FF,
+    },
 };
 
 static const struct activity_spec {
@@ -316,6 +406,7 @@ static const struct drawcall_spec {
             NGL_NODE_DRAWGRADIENT4,
             NGL_NODE_DRAWHISTOGRAM,
             NGL_NODE_DRAWPATH,
+            NGL_NODE_DRAWRECT2D,
             NGL_NODE_DRAWTEXTURE,
             NGL_NODE_DRAWWAVEFORM,
             NGLI_NODE_NONE
@@ -430,6 +521,7 @@ static void widget_latency_make_stats(struct hud *s, struct widget *widget)
 
 static void widget_memory_make_stats(struct hud *s, struct widget *widget)
 {
+    struct ngl_ctx *ctx = s->ctx;
     struct widget_memory *priv = widget->priv_data;
 
     struct ngli_node_darray *nodes_buf_array_cpu = &priv->nodes[MEMORY_BUFFERS_CPU];
@@ -465,6 +557,14 @@ static void widget_memory_make_stats(struct hud *s, struct widget *widget)
         priv->sizes[MEMORY_TEXTURES] += ngli_image_get_memory_size(&texture_info->image)
                                       * tex_node->is_active;
     }
+
+    struct ngpu_memory_stats memory_stats;
+    ngpu_ctx_get_memory_stats(ctx->gpu_ctx, &memory_stats);
+    priv->sizes[MEMORY_DEVICE_ALLOCATED] = (size_t)memory_stats.allocated_size;
+    priv->sizes[MEMORY_DEVICE_USED]      = (size_t)memory_stats.used_size;
+
+    priv->sizes[MEMORY_ATLAS_ALLOCATED] = ctx->atlas_texture_size;
+    priv->sizes[MEMORY_ATLAS_USED]      = ctx->atlas_used_size;
 }
 
 static void widget_activity_make_stats(struct hud *s, struct widget *widget)
@@ -489,94 +589,59 @@ static void widget_drawcall_make_stats(struct hud *s, struct widget *widget)
 
 /* Draw utils */
 
-static inline uint8_t *set_color(uint8_t *p, uint32_t rgba)
+static void get_color(float *dst, uint32_t rgba)
 {
-    p[0] = (uint8_t)(rgba >> 24);
-    p[1] = rgba >> 16 & 0xff;
-    p[2] = rgba >>  8 & 0xff;
-    p[3] = rgba       & 0xff;
-    return p + 4;
-}
-
-static inline int get_pixel_pos(struct hud *s, int px, int py)
-{
-    return (py * s->canvas.w + px) * 4;
-}
-
-static inline void set_color_at(struct hud *s, int px, int py, uint32_t rgba)
-{
-    uint8_t *p = s->canvas.buf + get_pixel_pos(s, px, py);
-    set_color(p, rgba);
-}
-
-static inline void set_color_at_column(struct hud *s, int px, int py, int height, uint32_t rgba)
-{
-    uint8_t *p = s->canvas.buf + get_pixel_pos(s, px, py);
-    const int sign = height >= 0 ? 1 : -1;
-    for (int h = 0; h < height; h++) {
-        set_color(p, rgba);
-        p += sign * s->canvas.w * 4;
-    }
-}
-
-static void draw_block_graph(struct hud *s,
-                             const struct data_graph *d,
-                             const struct rect *rect,
-                             int64_t graph_min, int64_t graph_max,
-                             const uint32_t c)
-{
-    const int64_t graph_h = graph_max - graph_min;
-    const float vscale = (float)rect->h / (float)graph_h;
-    const size_t start = (d->nb_values + d->pos - d->count) % d->nb_values;
-
-    for (size_t k = 0; k < d->count; k++) {
-        const int64_t v = d->values[(start + k) % d->nb_values];
-        const int h = (int)((float)(v - graph_min) * vscale);
-        const int y = NGLI_CLAMP(rect->h - h, 0, rect->h);
-        set_color_at_column(s, rect->x + (int)k, rect->y + y, h, c);
-    }
-}
-
-static void draw_line_graph(struct hud *s,
-                            const struct data_graph *d,
-                            const struct rect *rect,
-                            int64_t graph_min, int64_t graph_max,
-                            const uint32_t c)
-{
-    const int64_t graph_h = graph_max - graph_min;
-    const float vscale = (float)rect->h / (float)graph_h;
-    const size_t start = (d->nb_values + d->pos - d->count) % d->nb_values;
-    int prev_y;
-
-    for (size_t k = 0; k < d->count; k++) {
-        const int64_t v = d->values[(start + k) % d->nb_values];
-        const int h = (int)((float)(v - graph_min) * vscale);
-        const int y = NGLI_CLAMP(rect->h - 1 - h, 0, rect->h - 1);
-
-        set_color_at(s, rect->x + (int)k, rect->y + y, c);
-        if (k)
-            set_color_at_column(s, rect->x + (int)k, rect->y + prev_y, y - prev_y, c);
-        prev_y = y;
-    }
+    dst[0] = (float)(rgba >> 24)        / 255.f;
+    dst[1] = (float)(rgba >> 16 & 0xff) / 255.f;
+    dst[2] = (float)(rgba >>  8 & 0xff) / 255.f;
+    dst[3] = (float)(rgba       & 0xff) / 255.f;
 }
 
 static void print_text(struct hud *s, int x, int y, const char *buf, const uint32_t c)
 {
-    ngli_drawutils_print(&s->canvas, x, y, buf, c);
+    struct hud_quad quad = {
+        .rect = {(float)x, (float)y, NGLI_FONT_W, NGLI_FONT_H},
+    };
+    get_color(quad.color, c);
+
+    for (size_t i = 0; buf[i]; i++, quad.rect[0] += NGLI_FONT_W) {
+        /* Spaces and characters outside of the font are left blank */
+        const uint8_t chr = (uint8_t)buf[i];
+        if (chr <= ATLAS_FIRST_CHAR || chr > ATLAS_LAST_CHAR)
+            continue;
+        if (s->quads.count >= s->max_quads)
+            return;
+        quad.glyph = (float)((chr - ATLAS_FIRST_CHAR) * NGLI_FONT_W);
+        if (ngli_darray_push(&s->quads, quad) < 0)
+            return;
+    }
 }
 
-static void widgets_clear(struct hud *s)
+static void set_graph(struct hud *s, const struct widget *widget, size_t i,
+                      int64_t graph_min, int64_t graph_max, const uint32_t c,
+                      enum graph_type type)
 {
-    struct widget_darray *widgets_array = &s->widgets;
-    struct widget *widgets = widgets_array->data;
-    for (size_t i = 0; i < widgets_array->count; i++)
-        ngli_drawutils_draw_rect(&s->canvas, &widgets[i].rect, s->bg_color_u32);
+    const struct data_graph *d = &widget->data_graph[i];
+    const struct rect *rect = &widget->graph_rect;
+    const size_t id = widget->graph_id + i;
+    struct graphs_block *data = &s->graphs_data;
+
+    data->rect[id][0] = (float)rect->x;
+    data->rect[id][1] = (float)rect->y;
+    data->rect[id][2] = (float)rect->w;
+    data->rect[id][3] = (float)rect->h;
+    get_color(data->color[id], c);
+    data->range[id][0] = (float)graph_min;
+    data->range[id][1] = (float)graph_max;
+    data->range[id][2] = (float)d->count;
+    data->range[id][3] = (float)type;
 }
 
 /* Widget draw */
 
-static void register_graph_value(struct data_graph *d, int64_t v)
+static void register_graph_value(struct hud *s, struct widget *widget, size_t graph, int64_t v)
 {
+    struct data_graph *d = &widget->data_graph[graph];
     const int64_t old_v = d->values[d->pos];
 
     d->values[d->pos] = v;
@@ -602,6 +667,8 @@ static void register_graph_value(struct data_graph *d, int64_t v)
         d->max = v;
     }
     d->amax = NGLI_MAX(d->amax, d->max);
+
+    s->samples[widget->graph_id + graph] = (float)v;
 }
 
 static int64_t get_latency_avg(const struct widget_latency *priv, size_t id)
@@ -620,7 +687,7 @@ static void widget_latency_draw(struct hud *s, struct widget *widget)
 
         snprintf(buf, sizeof(buf), "%s %5" PRId64 "usec", latency_specs[i].label, t);
         print_text(s, widget->text_x, widget->text_y + (int)i * NGLI_FONT_H, buf, latency_specs[i].color);
-        register_graph_value(&widget->data_graph[i], t);
+        register_graph_value(s, widget, i, t);
     }
 
     int64_t graph_min = widget->data_graph[0].min;
@@ -630,12 +697,8 @@ static void widget_latency_draw(struct hud *s, struct widget *widget)
         graph_max = NGLI_MAX(graph_max, widget->data_graph[i].max);
     }
 
-    const int64_t graph_h = graph_max - graph_min;
-    if (graph_h) {
-        for (size_t i = 0; i < NB_LATENCY; i++)
-            draw_line_graph(s, &widget->data_graph[i], &widget->graph_rect,
-                            graph_min, graph_max, latency_specs[i].color);
-    }
+    for (size_t i = 0; i < NB_LATENCY; i++)
+        set_graph(s, widget, i, graph_min, graph_max, latency_specs[i].color, GRAPH_LINE);
 }
 
 static void widget_memory_draw(struct hud *s, struct widget *widget)
@@ -656,10 +719,18 @@ static void widget_memory_draw(struct hud *s, struct widget *widget)
             snprintf(buf, sizeof(buf), "%-12s %zuM", label, size / (1024 * 1024));
         else
             snprintf(buf, sizeof(buf), "%-12s %zuG", label, size / (1024 * 1024 * 1024));
+
+        /* Packing efficiency of the atlases */
+        const size_t atlas_size = priv->sizes[MEMORY_ATLAS_ALLOCATED];
+        if (i == MEMORY_ATLAS_USED && atlas_size) {
+            const size_t len = strlen(buf);
+            snprintf(buf + len, sizeof(buf) - len, " (%zu%%)", size * 100 / atlas_size);
+        }
+
         print_text(s, widget->text_x, widget->text_y + (int)i * NGLI_FONT_H, buf, color);
 
         const int64_t size_i64 = (int64_t)NGLI_MIN(size, INT64_MAX);
-        register_graph_value(&widget->data_graph[i], size_i64);
+        register_graph_value(s, widget, i, size_i64);
     }
 
     int64_t graph_min = widget->data_graph[0].min;
@@ -669,12 +740,8 @@ static void widget_memory_draw(struct hud *s, struct widget *widget)
         graph_max = NGLI_MAX(graph_max, widget->data_graph[i].max);
     }
 
-    const int64_t graph_h = graph_max - graph_min;
-    if (graph_h) {
-        for (size_t i = 0; i < NB_MEMORY; i++)
-            draw_line_graph(s, &widget->data_graph[i], &widget->graph_rect,
-                            graph_min, graph_max, memory_specs[i].color);
-    }
+    for (size_t i = 0; i < NB_MEMORY; i++)
+        set_graph(s, widget, i, graph_min, graph_max, memory_specs[i].color, GRAPH_LINE);
 }
 
 static void widget_activity_draw(struct hud *s, struct widget *widget)
@@ -688,9 +755,9 @@ static void widget_activity_draw(struct hud *s, struct widget *widget)
     print_text(s, widget->text_x, widget->text_y, spec->label, color);
     print_text(s, widget->text_x, widget->text_y + NGLI_FONT_H, buf, color);
 
-    struct data_graph *d = &widget->data_graph[0];
-    register_graph_value(d, priv->nb_actives);
-    draw_block_graph(s, d, &widget->graph_rect, d->amin, d->amax, color);
+    register_graph_value(s, widget, 0, priv->nb_actives);
+    const struct data_graph *d = &widget->data_graph[0];
+    set_graph(s, widget, 0, d->amin, d->amax, color, GRAPH_BLOCK);
 }
 
 static void widget_drawcall_draw(struct hud *s, struct widget *widget)
@@ -704,9 +771,9 @@ static void widget_drawcall_draw(struct hud *s, struct widget *widget)
     print_text(s, widget->text_x, widget->text_y, spec->label, color);
     print_text(s, widget->text_x, widget->text_y + NGLI_FONT_H, buf, color);
 
-    struct data_graph *d = &widget->data_graph[0];
-    register_graph_value(d, priv->nb_draws);
-    draw_block_graph(s, d, &widget->graph_rect, d->amin, d->amax, color);
+    register_graph_value(s, widget, 0, priv->nb_draws);
+    const struct data_graph *d = &widget->data_graph[0];
+    set_graph(s, widget, 0, d->amin, d->amax, color, GRAPH_BLOCK);
 }
 
 /* Widget CSV header */
@@ -871,9 +938,9 @@ static inline int get_widget_height(enum widget_type type)
 static int create_widget(struct hud *s, enum widget_type type, const void *user_data, int x, int y)
 {
     if (x < 0)
-        x = s->canvas.w + x;
+        x = s->width + x;
     if (y < 0)
-        y = s->canvas.h + y;
+        y = s->height + y;
 
     const struct widget_spec *spec = &widget_specs[type];
 
@@ -890,6 +957,7 @@ static int create_widget(struct hud *s, enum widget_type type, const void *user_
         .rect.h    = get_widget_height(type),
         .text_x    = x + WIDGET_PADDING,
         .text_y    = y + WIDGET_PADDING,
+        .graph_id  = s->nb_graphs,
         .user_data = user_data,
     };
 
@@ -905,6 +973,9 @@ static int create_widget(struct hud *s, enum widget_type type, const void *user_
         widget.graph_rect.h = spec->graph_h;
     }
 
+    ngli_assert(s->nb_graphs + spec->nb_data_graph <= NB_GRAPHS);
+    s->nb_graphs += spec->nb_data_graph;
+
     if (ngli_darray_push(&s->widgets, widget) < 0)
         return NGL_ERROR_MEMORY;
     struct widget *widgetp = ngli_darray_tail(&s->widgets);
@@ -948,14 +1019,14 @@ static int widgets_init(struct hud *s)
     const int activity_width = get_widget_width(WIDGET_ACTIVITY) * NB_ACTIVITY + WIDGET_MARGIN * (NB_ACTIVITY - 1);
     const int drawcall_width = get_widget_width(WIDGET_DRAWCALL) * NB_DRAWCALL + WIDGET_MARGIN * (NB_DRAWCALL - 1);
 
-    s->canvas.w = WIDGET_MARGIN * 2
-                + NGLI_MAX(NGLI_MAX(NGLI_MAX(latency_width, memory_width), activity_width), drawcall_width);
+    s->width = WIDGET_MARGIN * 2
+             + NGLI_MAX(NGLI_MAX(NGLI_MAX(latency_width, memory_width), activity_width), drawcall_width);
 
-    s->canvas.h = WIDGET_MARGIN * 4
-                + get_widget_height(WIDGET_LATENCY)
-                + get_widget_height(WIDGET_MEMORY)
-                + get_widget_height(WIDGET_ACTIVITY)
-                + get_widget_height(WIDGET_DRAWCALL);
+    s->height = WIDGET_MARGIN * 4
+              + get_widget_height(WIDGET_LATENCY)
+              + get_widget_height(WIDGET_MEMORY)
+              + get_widget_height(WIDGET_ACTIVITY)
+              + get_widget_height(WIDGET_DRAWCALL);
 
     /* Latency widget in the top-left */
     const int x_latency = WIDGET_MARGIN;
@@ -1035,14 +1106,40 @@ static void widgets_make_stats(struct hud *s)
     }
 }
 
-static void widgets_draw(struct hud *s)
+static int widgets_draw(struct hud *s)
 {
+    /* Only the widget backgrounds are kept from the previous refresh */
+    ngli_darray_remove_range(&s->quads, s->nb_bg_quads, s->quads.count - s->nb_bg_quads);
+
     struct widget_darray *widgets_array = &s->widgets;
     struct widget *widgets = widgets_array->data;
     for (size_t i = 0; i < widgets_array->count; i++) {
         struct widget *widget = &widgets[i];
         widget_specs[widget->type].draw(s, widget);
     }
+
+    int ret = ngpu_buffer_upload(s->quads_buffer, s->quads.data, 0, s->quads.count * sizeof(*s->quads.data));
+    if (ret < 0)
+        return ret;
+
+    /* Write the latest sample of every graph in the next row of the history */
+    const uint32_t history_pos = (uint32_t)s->graphs_data.history_pos;
+    const struct ngpu_texture_transfer_params transfer_params = {
+        .pixels_per_row = NB_GRAPHS,
+        .y              = history_pos,
+        .width          = NB_GRAPHS,
+        .height         = 1,
+        .depth          = 1,
+        .layer_count    = 1,
+    };
+    ret = ngpu_texture_upload_with_params(s->history, (const uint8_t *)s->samples, &transfer_params);
+    if (ret < 0)
+        return ret;
+
+    const uint32_t history_len = ngpu_texture_get_params(s->history)->height;
+    s->graphs_data.history_pos = (int32_t)((history_pos + 1) % history_len);
+
+    return 0;
 }
 
 static int widgets_csv_header(struct hud *s)
@@ -1124,23 +1221,14 @@ static void widgets_uninit(struct hud *s)
     ngli_darray_reset(&s->widgets);
 }
 
-static const char * const vertex_data =
-    "void main()"                                                           "\n"
-    "{"                                                                     "\n"
-    "    ngl_out_pos = projection_matrix"                                   "\n"
-    "                * modelview_matrix"                                    "\n"
-    "                * vec4(coords.xy, 0.0, 1.0);"                          "\n"
-    "    tex_coord = coords.zw;"                                            "\n"
-    "}";
-
-static const char * const fragment_data =
-    "void main()"                                                           "\n"
-    "{"                                                                     "\n"
-    "    ngl_out_color = texture(tex, tex_coord);"                          "\n"
-    "}";
-
-static const struct ngpu_pgcraft_iovar vert_out_vars[] = {
-    {.name = "tex_coord", .type = NGPU_TYPE_VEC2},
+static const struct ngpu_pgcraft_iovar quad_vert_out_vars[] = {
+    {.name = "color",       .type = NGPU_TYPE_VEC4},
+    {.name = "atlas_coord", .type = NGPU_TYPE_VEC2, .precision_out = NGPU_PRECISION_HIGH, .precision_in = NGPU_PRECISION_HIGH},
+    {.name = "use_atlas",   .type = NGPU_TYPE_F32},
+};
+
+static const struct ngpu_pgcraft_iovar graph_vert_out_vars[] = {
+    {.name = "color", .type = NGPU_TYPE_VEC4},
 };
 
 struct hud *ngli_hud_create(struct ngl_ctx *ctx)
@@ -1152,6 +1240,208 @@ struct hud *ngli_hud_create(struct ngl_ctx *ctx)
     return s;
 }
 
+static int init_atlas(struct hud *s)
+{
+    struct ngpu_ctx *gpu_ctx = s->ctx->gpu_ctx;
+
+    /* All the characters of the builtin font on a single row, white on transparent */
+    struct canvas canvas = {
+        .w = ATLAS_NB_CHARS * NGLI_FONT_W,
+        .h = NGLI_FONT_H,
+    };
+    canvas.buf = ngli_calloc((size_t)canvas.w * (size_t)canvas.h, 4);
+    if (!canvas.buf)
+        return NGL_ERROR_MEMORY;
+
+    char chars[ATLAS_NB_CHARS + 1] = {0};
+    for (int i = 0; i < ATLAS_NB_CHARS; i++)
+        chars[i] = (char)(ATLAS_FIRST_CHAR + i);
+    ngli_drawutils_print(&canvas, 0, 0, chars, 0xffffffff);
+
+    const struct ngpu_texture_params tex_params = {
+        .type       = NGPU_TEXTURE_TYPE_2D,
+        .format     = NGPU_FORMAT_R8G8B8A8_UNORM,
+        .width      = (uint32_t)canvas.w,
+        .height     = (uint32_t)canvas.h,
+        .min_filter = NGPU_FILTER_NEAREST,
+        .mag_filter = NGPU_FILTER_NEAREST,
+        .usage      = NGPU_TEXTURE_USAGE_TRANSFER_DST_BIT | NGPU_TEXTURE_USAGE_SAMPLED_BIT,
+    };
+
+    int ret;
+    s->atlas = ngpu_texture_create(gpu_ctx);
+    if (!s->atlas) {
+        ret = NGL_ERROR_MEMORY;
+        goto done;
+    }
+
+    ret = ngpu_texture_init(s->atlas, &tex_params);
+    if (ret < 0)
+        goto done;
+
+    ret = ngpu_texture_upload(s->atlas, canvas.buf, 0);
+
+done:
+    ngli_free(canvas.buf);
+    return ret;
+}
+
+static int init_quads(struct hud *s)
+{
+    struct ngpu_ctx *gpu_ctx = s->ctx->gpu_ctx;
+
+    /* One background per widget, followed by at most one character per text cell */
+    ngli_darray_foreach(widget, &s->widgets) {
+        const struct widget_spec *spec = &widget_specs[widget->type];
+        const struct hud_quad quad = {
+            .rect  = {(float)widget->rect.x, (float)widget->rect.y, (float)widget->rect.w, (float)widget->rect.h},
+            .color = {0.0f, 0.0f, 0.0f, 0.8f},
+            .glyph = -1.0f,
+        };
+        if (ngli_darray_push(&s->quads, quad) < 0)
+            return NGL_ERROR_MEMORY;
+        s->max_quads += 1 + (size_t)(spec->text_cols * spec->text_rows);
+    }
+    s->nb_bg_quads = s->quads.count;
+
+    int ret = ngli_darray_reserve(&s->quads, s->max_quads);
+    if (ret < 0)
+        return ret;
+
+    s->quads_buffer = ngpu_buffer_create(gpu_ctx);
+    if (!s->quads_buffer)
+        return NGL_ERROR_MEMORY;
+
+    return ngpu_buffer_init(s->quads_buffer, s->max_quads * sizeof(struct hud_quad),
+                            NGPU_BUFFER_USAGE_DYNAMIC_BIT |
+                            NGPU_BUFFER_USAGE_TRANSFER_DST_BIT |
+                            NGPU_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+}
+
+static int init_graphs(struct hud *s)
+{
+    struct ngpu_ctx *gpu_ctx = s->ctx->gpu_ctx;
+
+    ngli_assert(s->nb_graphs == NB_GRAPHS);
+
+    /* The history ring buffer is as long as the widest graph */
+    int history_len = 0;
+    size_t nb_columns = 0;
+    ngli_darray_foreach(widget, &s->widgets) {
+        const struct widget_spec *spec = &widget_specs[widget->type];
+        history_len = NGLI_MAX(history_len, widget->graph_rect.w);
+        nb_columns += spec->nb_data_graph * (size_t)widget->graph_rect.w;
+    }
+
+    struct graph_column *columns = ngli_calloc(nb_columns, sizeof(*columns));
+    if (!columns)
+        return NGL_ERROR_MEMORY;
+
+    struct graph_column *column = columns;
+    ngli_darray_foreach(widget, &s->widgets) {
+        const struct widget_spec *spec = &widget_specs[widget->type];
+        for (size_t i = 0; i < spec->nb_data_graph; i++) {
+            for (int k = 0; k < widget->graph_rect.w; k++) {
+                column->graph = (float)(widget->graph_id + i);
+                column->column = (float)k;
+                column++;
+            }
+        }
+    }
+    s->nb_columns = (uint32_t)nb_columns;
+
+    int ret;
+    s->columns = ngpu_buffer_create(gpu_ctx);
+    if (!s->columns) {
+        ret = NGL_ERROR_MEMORY;
+        goto done;
+    }
+
+    ret = ngpu_buffer_init(s->columns, nb_columns * sizeof(*columns),
+                           NGPU_BUFFER_USAGE_TRANSFER_DST_BIT |
+                           NGPU_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+    if (ret < 0)
+        goto done;
+
+    ret = ngpu_buffer_upload(s->columns, columns, 0, nb_columns * sizeof(*columns));
+    if (ret < 0)
+        goto done;
+
+    const struct ngpu_texture_params tex_params = {
+        .type       = NGPU_TEXTURE_TYPE_2D,
+        .format     = NGPU_FORMAT_R32_SFLOAT,
+        .width      = NB_GRAPHS,
+        .height     = (uint32_t)history_len,
+        .min_filter = NGPU_FILTER_NEAREST,
+        .mag_filter = NGPU_FILTER_NEAREST,
+        .usage      = NGPU_TEXTURE_USAGE_TRANSFER_DST_BIT | NGPU_TEXTURE_USAGE_SAMPLED_BIT,
+    };
+
+    s->history = ngpu_texture_create(gpu_ctx);
+    if (!s->history) {
+        ret = NGL_ERROR_MEMORY;
+        goto done;
+    }
+
+    ret = ngpu_texture_init(s->history, &tex_params);
+
+done:
+    ngli_free(columns);
+    return ret;
+}
+
+static int init_pipeline(struct hud *s, struct hud_pipeline *pipeline,
+                         const struct ngpu_pgcraft_params *crafter_params)
+{
+    struct ngl_ctx *ctx = s->ctx;
+    struct ngpu_ctx *gpu_ctx = ctx->gpu_ctx;
+
+    pipeline->crafter = ngpu_pgcraft_create(gpu_ctx);
+    if (!pipeline->crafter)
+        return NGL_ERROR_MEMORY;
+
+    int ret = ngpu_pgcraft_craft(pipeline->crafter, crafter_params);
+    if (ret < 0)
+        return ret;
+
+    pipeline->transforms_block_index = ngpu_pgcraft_get_block_index(pipeline->crafter, "transforms", NGPU_PROGRAM_STAGE_VERT);
+    pipeline->graphs_block_index = ngpu_pgcraft_get_block_index(pipeline->crafter, "graphs", NGPU_PROGRAM_STAGE_VERT);
+
+    pipeline->pipeline_compat = ngli_pipeline_compat_create(gpu_ctx);
+    if (!pipeline->pipeline_compat)
+        return NGL_ERROR_MEMORY;
+
+    struct ngpu_graphics_state graphics_state = ctx->default_graphics_state;
+    graphics_state.blend = 1;
+    graphics_state.blend_src_factor = NGPU_BLEND_FACTOR_SRC_ALPHA;
+    graphics_state.blend_dst_factor = NGPU_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    graphics_state.blend_src_factor_a = NGPU_BLEND_FACTOR_ZERO;
+    graphics_state.blend_dst_factor_a = NGPU_BLEND_FACTOR_ONE;
+
+    const struct pipeline_compat_params params = {
+        .type         = NGPU_PIPELINE_TYPE_GRAPHICS,
+        .graphics     = {
+            .topology = NGPU_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP,
+            .state    = graphics_state,
+            .rt_layout    = ctx->default_rendertarget_layout,
+            .vertex_state = ngpu_pgcraft_get_vertex_state(pipeline->crafter),
+        },
+        .program          = ngpu_pgcraft_get_program(pipeline->crafter),
+        .layout_desc      = ngpu_pgcraft_get_bindgroup_layout_desc(pipeline->crafter),
+        .resources        = ngpu_pgcraft_get_bindgroup_resources(pipeline->crafter),
+        .vertex_resources = ngpu_pgcraft_get_vertex_resources(pipeline->crafter),
+        .texture_infos    = ngpu_pgcraft_get_texture_infos(pipeline->crafter),
+    };
+
+    return ngli_pipeline_compat_init(pipeline->pipeline_compat, &params);
+}
+
+static void reset_pipeline(struct hud_pipeline *pipeline)
+{
+    ngli_pipeline_compat_freep(&pipeline->pipeline_compat);
+    ngpu_pgcraft_freep(&pipeline->crafter);
+}
+
 int ngli_hud_init(struct hud *s)
 {
     struct ngl_ctx *ctx = s->ctx;
@@ -1192,151 +1482,153 @@ int ngli_hud_init(struct hud *s)
         return widgets_csv_header(s);
     }
 
-    s->canvas.buf = ngli_calloc((size_t)s->canvas.w * (size_t)s->canvas.h, 4);
-    if (!s->canvas.buf)
-        return NGL_ERROR_MEMORY;
-
-    static const float bg_color[] = {0.0f, 0.0f, 0.0f, 0.8f};
-    s->bg_color_u32 = NGLI_COLOR_VEC4_TO_U32(bg_color);
-    widgets_clear(s);
-
-    static const float coords[] = {
-        -1.0f, -1.0f, 0.0f, 1.0f,
-         1.0f, -1.0f, 1.0f, 1.0f,
-        -1.0f,  1.0f, 0.0f, 0.0f,
-         1.0f,  1.0f, 1.0f, 0.0f,
-    };
-
-    s->coords = ngpu_buffer_create(gpu_ctx);
-    if (!s->coords)
-        return NGL_ERROR_MEMORY;
-
-
-    ret = ngpu_buffer_init(s->coords, sizeof(coords), NGPU_BUFFER_USAGE_DYNAMIC_BIT |
-                                                          NGPU_BUFFER_USAGE_TRANSFER_DST_BIT |
-                                                          NGPU_BUFFER_USAGE_VERTEX_BUFFER_BIT);
-    if (ret < 0)
-        return ret;
-
-    ret = ngpu_buffer_upload(s->coords, coords, 0, sizeof(coords));
-    if (ret < 0)
-        return ret;
-
-    struct ngpu_texture_params tex_params = {
-        .type          = NGPU_TEXTURE_TYPE_2D,
-        .format        = NGPU_FORMAT_R8G8B8A8_UNORM,
-        .width         = (uint32_t)s->canvas.w,
-        .height        = (uint32_t)s->canvas.h,
-        .min_filter    = NGPU_FILTER_NEAREST,
-        .mag_filter    = NGPU_FILTER_NEAREST,
-        .usage         = NGPU_TEXTURE_USAGE_TRANSFER_DST_BIT | NGPU_TEXTURE_USAGE_SAMPLED_BIT,
-    };
-    s->texture = ngpu_texture_create(gpu_ctx);
-    if (!s->texture)
-        return NGL_ERROR_MEMORY;
-    ret = ngpu_texture_init(s->texture, &tex_params);
-    if (ret < 0)
+    if ((ret = init_atlas(s)) < 0 ||
+        (ret = init_quads(s)) < 0 ||
+        (ret = init_graphs(s)) < 0)
         return ret;
 
     struct ngpu_block_desc transforms_block_desc;
     ngpu_block_desc_init(gpu_ctx, &transforms_block_desc, NGPU_BLOCK_LAYOUT_STD140);
     ngpu_block_desc_add_field(&transforms_block_desc, "modelview_matrix", NGPU_TYPE_MAT4, 0);
     ngpu_block_desc_add_field(&transforms_block_desc, "projection_matrix", NGPU_TYPE_MAT4, 0);
+    ngpu_block_desc_add_field(&transforms_block_desc, "pixel_matrix", NGPU_TYPE_MAT4, 0);
     ngli_assert(ngpu_block_desc_get_size(&transforms_block_desc, 0) == sizeof(struct transforms_block));
 
+    struct ngpu_block_desc graphs_block_desc;
+    ngpu_block_desc_init(gpu_ctx, &graphs_block_desc, NGPU_BLOCK_LAYOUT_STD140);
+    ngpu_block_desc_add_field(&graphs_block_desc, "history_pos", NGPU_TYPE_I32, 0);
+    ngpu_block_desc_add_field(&graphs_block_desc, "graph_rect", NGPU_TYPE_VEC4, NB_GRAPHS);
+    ngpu_block_desc_add_field(&graphs_block_desc, "graph_color", NGPU_TYPE_VEC4, NB_GRAPHS);
+    ngpu_block_desc_add_field(&graphs_block_desc, "graph_range", NGPU_TYPE_VEC4, NB_GRAPHS);
+    ngli_assert(ngpu_block_desc_get_size(&graphs_block_desc, 0) == sizeof(struct graphs_block));
+
     struct ngpu_buffer *staging_buf = ngpu_staging_buffer_get_buffer(ctx->current_staging_buffer);
 
-    const struct ngpu_pgcraft_block blocks[] = {
-        {
-            .name          = "transforms",
-            .instance_name = "",
-            .type          = NGPU_TYPE_UNIFORM_BUFFER,
-            .stage         = NGPU_PROGRAM_STAGE_VERT,
-            .block         = &transforms_block_desc,
-            .buffer = {
-                .buffer = staging_buf,
-                .size   = sizeof(struct transforms_block),
-            }
-        },
+    const struct ngpu_pgcraft_block transforms_block = {
+        .name          = "transforms",
+        .instance_name = "",
+        .type          = NGPU_TYPE_UNIFORM_BUFFER,
+        .stage         = NGPU_PROGRAM_STAGE_VERT,
+        .block         = &transforms_block_desc,
+        .buffer = {
+            .buffer = staging_buf,
+            .size   = sizeof(struct transforms_block),
+        }
     };
 
-    struct ngpu_pgcraft_texture textures[] = {
+    /* Backgrounds and characters */
+    const struct ngpu_pgcraft_texture quad_textures[] = {
         {
-            .name        = "tex",
+            .name        = "atlas",
             .type        = NGPU_PGCRAFT_TEXTURE_TYPE_2D,
             .stage       = NGPU_PROGRAM_STAGE_FRAG,
-            .texture     = s->texture,
+            .texture     = s->atlas,
             .no_metadata = true,
         },
     };
 
-    const struct ngpu_pgcraft_attribute attributes[] = {
+    const struct ngpu_pgcraft_attribute quad_attributes[] = {
         {
-            .name     = "coords",
+            .name     = "quad_rect",
+            .type     = NGPU_TYPE_VEC4,
+            .format   = NGPU_FORMAT_R32G32B32A32_SFLOAT,
+            .stride   = sizeof(struct hud_quad),
+            .offset   = offsetof(struct hud_quad, rect),
+            .buffer   = s->quads_buffer,
+            .rate     = 1,
+        }, {
+            .name     = "quad_color",
             .type     = NGPU_TYPE_VEC4,
             .format   = NGPU_FORMAT_R32G32B32A32_SFLOAT,
-            .stride   = 4 * sizeof(float),
-            .buffer   = s->coords,
+            .stride   = sizeof(struct hud_quad),
+            .offset   = offsetof(struct hud_quad, color),
+            .buffer   = s->quads_buffer,
+            .rate     = 1,
+        }, {
+            .name     = "quad_glyph",
+            .type     = NGPU_TYPE_F32,
+            .format   = NGPU_FORMAT_R32_SFLOAT,
+            .stride   = sizeof(struct hud_quad),
+            .offset   = offsetof(struct hud_quad, glyph),
+            .buffer   = s->quads_buffer,
+            .rate     = 1,
         },
     };
 
-    struct ngpu_graphics_state graphics_state = ctx->default_graphics_state;
-    graphics_state.blend = 1;
-    graphics_state.blend_src_factor = NGPU_BLEND_FACTOR_SRC_ALPHA;
-    graphics_state.blend_dst_factor = NGPU_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
-    graphics_state.blend_src_factor_a = NGPU_BLEND_FACTOR_ZERO;
-    graphics_state.blend_dst_factor_a = NGPU_BLEND_FACTOR_ONE;
-
-    const struct ngpu_pgcraft_params crafter_params = {
-        .program_label    = "nopegl/hud",
-        .vert_base        = vertex_data,
-        .frag_base        = fragment_data,
-        .blocks           = blocks,
-        .nb_blocks        = NGLI_ARRAY_NB(blocks),
-        .textures         = textures,
-        .nb_textures      = NGLI_ARRAY_NB(textures),
-        .attributes       = attributes,
-        .nb_attributes    = NGLI_ARRAY_NB(attributes),
-        .vert_out_vars    = vert_out_vars,
-        .nb_vert_out_vars = NGLI_ARRAY_NB(vert_out_vars),
+    const struct ngpu_pgcraft_params quad_crafter_params = {
+        .program_label    = "nopegl/hud-quad",
+        .vert_base        = hud_quad_vert,
+        .frag_base        = hud_quad_frag,
+        .blocks           = &transforms_block,
+        .nb_blocks        = 1,
+        .textures         = quad_textures,
+        .nb_textures      = NGLI_ARRAY_NB(quad_textures),
+        .attributes       = quad_attributes,
+        .nb_attributes    = NGLI_ARRAY_NB(quad_attributes),
+        .vert_out_vars    = quad_vert_out_vars,
+        .nb_vert_out_vars = NGLI_ARRAY_NB(quad_vert_out_vars),
     };
 
-    s->crafter = ngpu_pgcraft_create(gpu_ctx);
-    if (!s->crafter) {
-        ret = NGL_ERROR_MEMORY;
-        goto done;
-    }
-
-    ret = ngpu_pgcraft_craft(s->crafter, &crafter_params);
+    ret = init_pipeline(s, &s->quad_pipeline, &quad_crafter_params);
     if (ret < 0)
         goto done;
 
-    s->transforms_block_index = ngpu_pgcraft_get_block_index(s->crafter, "transforms", NGPU_PROGRAM_STAGE_VERT);
+    /* Graph columns */
+    const struct ngpu_pgcraft_block graph_blocks[] = {
+        transforms_block,
+        {
+            .name          = "graphs",
+            .instance_name = "",
+            .type          = NGPU_TYPE_UNIFORM_BUFFER,
+            .stage         = NGPU_PROGRAM_STAGE_VERT,
+            .block         = &graphs_block_desc,
+            .buffer = {
+                .buffer = staging_buf,
+                .size   = sizeof(struct graphs_block),
+            }
+        },
+    };
 
-    s->pipeline_compat = ngli_pipeline_compat_create(gpu_ctx);
-    if (!s->pipeline_compat) {
-        ret = NGL_ERROR_MEMORY;
-        goto done;
-    }
+    const struct ngpu_pgcraft_texture graph_textures[] = {
+        {
+            .name        = "history",
+            .type        = NGPU_PGCRAFT_TEXTURE_TYPE_2D,
+            .precision   = NGPU_PRECISION_HIGH,
+            .stage       = NGPU_PROGRAM_STAGE_VERT,
+            .texture     = s->history,
+            .no_metadata = true,
+        },
+    };
 
-    const struct pipeline_compat_params params = {
-        .type         = NGPU_PIPELINE_TYPE_GRAPHICS,
-        .graphics     = {
-            .topology = NGPU_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP,
-            .state    = graphics_state,
-            .rt_layout    = ctx->default_rendertarget_layout,
-            .vertex_state = ngpu_pgcraft_get_vertex_state(s->crafter),
+    const struct ngpu_pgcraft_attribute graph_attributes[] = {
+        {
+            .name     = "graph_column",
+            .type     = NGPU_TYPE_VEC2,
+            .format   = NGPU_FORMAT_R32G32_SFLOAT,
+            .stride   = sizeof(struct graph_column),
+            .buffer   = s->columns,
+            .rate     = 1,
         },
-        .program          = ngpu_pgcraft_get_program(s->crafter),
-        .layout_desc      = ngpu_pgcraft_get_bindgroup_layout_desc(s->crafter),
-        .resources        = ngpu_pgcraft_get_bindgroup_resources(s->crafter),
-        .vertex_resources = ngpu_pgcraft_get_vertex_resources(s->crafter),
-        .texture_infos    = ngpu_pgcraft_get_texture_infos(s->crafter),
     };
 
-    ret = ngli_pipeline_compat_init(s->pipeline_compat, &params);
+    const struct ngpu_pgcraft_params graph_crafter_params = {
+        .program_label    = "nopegl/hud-graph",
+        .vert_base        = hud_graph_vert,
+        .frag_base        = hud_graph_frag,
+        .blocks           = graph_blocks,
+        .nb_blocks        = NGLI_ARRAY_NB(graph_blocks),
+        .textures         = graph_textures,
+        .nb_textures      = NGLI_ARRAY_NB(graph_textures),
+        .attributes       = graph_attributes,
+        .nb_attributes    = NGLI_ARRAY_NB(graph_attributes),
+        .vert_out_vars    = graph_vert_out_vars,
+        .nb_vert_out_vars = NGLI_ARRAY_NB(graph_vert_out_vars),
+    };
+
+    ret = init_pipeline(s, &s->graph_pipeline, &graph_crafter_params);
 
 done:
+    ngpu_block_desc_reset(&graphs_block_desc);
     ngpu_block_desc_reset(&transforms_block_desc);
     return ret;
 }
@@ -1356,30 +1648,11 @@ void ngli_hud_draw(struct hud *s)
     const int need_refresh = fabs(t - s->last_refresh_time) >= s->refresh_rate_interval;
     if (need_refresh) {
         s->last_refresh_time = t;
-        widgets_clear(s);
-        widgets_draw(s);
+        int ret = widgets_draw(s);
+        if (ret < 0)
+            return;
     }
 
-    const int scale = s->scale > 0 ? s->scale : 1;
-    const float ratio_w = (float)(scale * s->canvas.w) / (float)ctx->viewport.width;
-    const float ratio_h = (float)(scale * s->canvas.h) / (float)ctx->viewport.height;
-    const float x =-1.0f + 2 * ratio_w;
-    const float y = 1.0f - 2 * ratio_h;
-    const float coords[] = {
-        -1.0f,  y,    0.0f, 1.0f,
-         x,     y,    1.0f, 1.0f,
-        -1.0f,  1.0f, 0.0f, 0.0f,
-         x,     1.0f, 1.0f, 0.0f,
-    };
-
-    int ret = ngpu_buffer_upload(s->coords, coords, 0, sizeof(coords));
-    if (ret < 0)
-        return;
-
-    ret = ngpu_texture_upload(s->texture, s->canvas.buf, 0);
-    if (ret < 0)
-        return;
-
     if (!ngpu_ctx_is_render_pass_active(gpu_ctx)) {
         ngpu_ctx_begin_render_pass(gpu_ctx, ctx->current_rendertarget);
     }
@@ -1393,11 +1666,26 @@ void ngli_hud_draw(struct hud *s)
     transforms_data.modelview_matrix = *modelview_matrix;
     transforms_data.projection_matrix = *projection_matrix;
 
-    const size_t offset = ngpu_staging_buffer_push(ctx->current_staging_buffer, &transforms_data, sizeof(transforms_data));
+    /* Map the HUD pixels, scaled up, from the top-left corner of the viewport */
+    const int scale = s->scale > 0 ? s->scale : 1;
+    const float width = (float)ctx->viewport.width / (float)scale;
+    const float height = (float)ctx->viewport.height / (float)scale;
+    ngli_mat4_orthographic(transforms_data.pixel_matrix.m, 0.0f, width, height, 0.0f, -1.0f, 1.0f);
+
     struct ngpu_buffer *buffer = ngpu_staging_buffer_get_buffer(ctx->current_staging_buffer);
-    ngli_pipeline_compat_update_buffer(s->pipeline_compat, s->transforms_block_index, buffer, offset, sizeof(transforms_data));
 
-    ngli_pipeline_compat_draw(s->pipeline_compat, 4, 1, 0);
+    const size_t transforms_offset = ngpu_staging_buffer_push(ctx->current_staging_buffer, &transforms_data, sizeof(transforms_data));
+    ngli_pipeline_compat_update_buffer(s->quad_pipeline.pipeline_compat, s->quad_pipeline.transforms_block_index,
+                                       buffer, transforms_offset, sizeof(transforms_data));
+    ngli_pipeline_compat_update_buffer(s->graph_pipeline.pipeline_compat, s->graph_pipeline.transforms_block_index,
+                                       buffer, transforms_offset, sizeof(transforms_data));
+
+    const size_t graphs_offset = ngpu_staging_buffer_push(ctx->current_staging_buffer, &s->graphs_data, sizeof(s->graphs_data));
+    ngli_pipeline_compat_update_buffer(s->graph_pipeline.pipeline_compat, s->graph_pipeline.graphs_block_index,
+                                       buffer, graphs_offset, sizeof(s->graphs_data));
+
+    ngli_pipeline_compat_draw(s->quad_pipeline.pipeline_compat, 4, (uint32_t)s->quads.count, 0);
+    ngli_pipeline_compat_draw(s->graph_pipeline.pipeline_compat, 4, s->nb_columns, 0);
 }
 
 void ngli_hud_freep(struct hud **sp)
@@ -1406,12 +1694,14 @@ void ngli_hud_freep(struct hud **sp)
     if (!s)
         return;
 
-    ngli_pipeline_compat_freep(&s->pipeline_compat);
-    ngpu_pgcraft_freep(&s->crafter);
-    ngpu_texture_freep(&s->texture);
-    ngpu_buffer_freep(&s->coords);
+    reset_pipeline(&s->graph_pipeline);
+    reset_pipeline(&s->quad_pipeline);
+    ngpu_texture_freep(&s->history);
+    ngpu_buffer_freep(&s->columns);
+    ngpu_texture_freep(&s->atlas);
+    ngpu_buffer_freep(&s->quads_buffer);
+    ngli_darray_reset(&s->quads);
     widgets_uninit(s);
-    ngli_free(s->canvas.buf);
     if (s->fp_export) {
         fclose(s->fp_export);
         ngli_bstr_freep(&s->csv_line);
@@ -46,8 +46,10 @@
 #include "node2d.h"
 #include <ngpu/ngpu.h>
 #include "slug.h"
+#include "spatial_grid.h"
 #include "nopegl/nopegl.h"
 #include "params.h"
+#include "trace.h"
 #include "utils/darray.h"
 #include "utils/hmap.h"
 #include "utils/job_queue.h"
@@ -56,6 +58,9 @@
 #include "utils/utils.h"
 
 struct node_class;
+struct ngli_scheduler;
+struct parallel_update;
+struct text_font_registry;
 
 NGLI_DECLARE_DARRAY_WITH_NAME(ngli_mat4_darray, struct ngli_mat4);
 NGLI_DECLARE_DARRAY_WITH_NAME(ngli_f32_darray, float);
@@ -120,16 +125,45 @@ struct ngl_ctx {
      */
     struct ngli_node_darray activitycheck_nodes;
 
+    /*
+     * Array of active nodes that can be updated from the update worker pool,
+     * inserted from bottom (leaves) up to the top (root).
+     */
+    struct ngli_node_darray parallel_update_nodes;
+    struct parallel_update *parallel_update;
+
+    size_t change_stamp; // identifies the current ngli_node_mark_changed() walk
+
     /*
      * Array of nodes that have a bounding box and that are candidate to
      * spatial queries.
      */
     struct ngli_node_darray bounding_box_nodes;
     struct ngli_node_darray intersecting_nodes;
+    NGLI_DARRAY(size_t) intersecting_offsets;
+
+    /*
+     * Spatial index over the screen bounding boxes of bounding_box_nodes,
+     * rebuilt by the first spatial query following a draw.
+     */
+    struct spatial_grid *bounding_box_grid;
+    struct ngli_f32_darray bounding_box_grid_boxes;
+    bool bounding_box_grid_dirty;
+
+    /*
+     * Time spent regenerating the distance maps of animated paths during the
+     * current update, shared by all DrawPath nodes against their budget.
+     */
+    int64_t distmap_update_time;
 
     struct hmap *text_builtin_atlasses; // struct text_builtin_atlas
+
+    /* Texture and packed areas (in bytes) of the distance map atlases, reported by the HUD */
+    size_t atlas_texture_size;
+    size_t atlas_used_size;
 #if HAVE_TEXT_LIBRARIES
     FT_Library ft_library;
+    struct text_font_registry *text_font_registry; // font faces and glyph atlas shared by the external text
 #endif
 
 #if defined(HAVE_VAAPI)
@@ -142,8 +176,10 @@ struct ngl_ctx {
     int64_t cpu_update_time;
     int64_t cpu_draw_time;
     int64_t gpu_draw_time;
+    struct ngli_trace *trace; // Chrome trace recorder, NULL unless a trace file is configured
 
     struct ngli_queue background_queue;
+    struct ngli_scheduler *scheduler;
 
     /*
      * Array of frame slots tracking the borrow/release state of the ngl_frames.
@@ -207,10 +243,18 @@ struct ngl_node {
 
     bool force_release_prefetch;
 
+    bool time_dependent; // node or one of its descendants is time dependent
+    size_t change_rev; // bumped whenever the node or one of its descendants changes
+    size_t change_stamp; // last ngli_node_mark_changed() walk which bumped change_rev
+    bool parallel_update; // node can be updated from the update worker pool
+    uint32_t update_level; // parallel update wave, after the one of its children
+
     double visit_time;
     double last_update_time;
+    double cpu_update_time;
 
     int draw_count;
+    bool draw_batched; // draw call issued along with the one of another node, not accounted in draw_count
 
     int refcount;
     int ctx_refcount;
@@ -289,6 +333,14 @@ enum node_category {
  */
 #define NGLI_NODE_FLAG_2D  (1 << 2)
 
+/*
+ * Node output varies with time even when none of its parameters is changed
+ * (animations, media, time filters, compute dispatches...). The flag is
+ * propagated to every ancestor (see ngl_node.time_dependent) and used by the
+ * offscreen passes to decide whether their previous render can be reused.
+ */
+#define NGLI_NODE_FLAG_TIME_DEPENDENT (1 << 3)
+
 /*
  * Specifications of a node.
  *
@@ -408,13 +460,29 @@ struct node_class {
      */
     int (*invalidate)(struct ngl_node *node);
 
+    /*
+     * Update the CPU only resources according to the time, ahead of update().
+     *
+     * When the updatable children of the node also only implement this
+     * callback, it may be called from a thread of the update worker pool,
+     * concurrently with other nodes: it must not touch any GPU resource, nor
+     * any state outside the node itself. Its children are always updated
+     * first in that case.
+     *
+     * reentrant: no (based on node cpu_update_time)
+     * execution-order: leaf first
+     * dispatch: managed (and manual through ngli_node_update())
+     * when: straight after ngli_node_honor_release_prefetch()
+     */
+    int (*cpu_update)(struct ngl_node *node, double t);
+
     /*
      * Update CPU/GPU resources according to the time.
      *
      * reentrant: no (based on node last_update_time)
      * execution-order: loose
      * dispatch: manual
-     * when: straight after ngli_node_honor_release_prefetch()
+     * when: after the parallel cpu_update() pass
      */
     int (*update)(struct ngl_node *node, double t);
 
@@ -506,6 +574,7 @@ int ngli_node_prepare(struct ngl_node *node,
 int ngli_node_visit(struct ngl_node *node, bool is_active, double t);
 int ngli_node_honor_release_prefetch(struct ngl_node *scene, double t);
 int ngli_node_update(struct ngl_node *node, double t);
+int ngli_node_cpu_update(struct ngl_node *node, double t);
 int ngli_node_update_children(struct ngl_node *node, double t);
 void ngli_node_pre_draw(struct ngl_node *node);
 void ngli_node_pre_draw_children(struct ngl_node *node);
@@ -513,6 +582,7 @@ int ngli_prepare_draw(struct ngl_ctx *s, double t);
 void ngli_node_draw(struct ngl_node *node);
 void ngli_node_draw_children(struct ngl_node *node);
 int ngli_node_invalidate_branch(struct ngl_node *node);
+void ngli_node_mark_changed(struct ngl_node *node);
 
 int ngli_node_attach_ctx(struct ngl_node *node, struct ngl_ctx *ctx);
 void ngli_node_detach_ctx(struct ngl_node *node, struct ngl_ctx *ctx);
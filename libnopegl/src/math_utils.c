@@ -322,6 +322,12 @@ void ngli_mat4_mul_vec4_c(float *dst, const float *m, const float *v)
     memcpy(dst, tmp, sizeof(tmp));
 }
 
+void ngli_lerp_f32_c(float *dst, const float *v1, const float *v2, float c, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        dst[i] = NGLI_MIX_F32(v1[i], v2[i], c);
+}
+
 void ngli_mat4_look_at(float * restrict dst, float *eye, float *center, float *up)
 {
     float f[3] = NGLI_VEC3_SUB(center, eye);
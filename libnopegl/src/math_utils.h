@@ -22,6 +22,8 @@
 #ifndef MATH_UTILS_H
 #define MATH_UTILS_H
 
+#include <stddef.h>
+
 #include "config.h"
 
 #define PI_F32 3.14159265358979323846f
@@ -153,12 +155,15 @@ void ngli_mat4_abs(float *dst, const float *m);
 #ifdef ARCH_AARCH64
 # define ngli_mat4_mul          ngli_mat4_mul_aarch64
 # define ngli_mat4_mul_vec4     ngli_mat4_mul_vec4_aarch64
+# define ngli_lerp_f32          ngli_lerp_f32_aarch64
 #elif defined(HAVE_X86_INTR)
 # define ngli_mat4_mul          ngli_mat4_mul_sse
 # define ngli_mat4_mul_vec4     ngli_mat4_mul_vec4_sse
+# define ngli_lerp_f32          ngli_lerp_f32_sse
 #else
 # define ngli_mat4_mul          ngli_mat4_mul_c
 # define ngli_mat4_mul_vec4     ngli_mat4_mul_vec4_c
+# define ngli_lerp_f32          ngli_lerp_f32_c
 #endif
 
 void ngli_mat4_mul_aarch64(float *dst, const float *m1, const float *m2);
@@ -166,6 +171,14 @@ void ngli_mat4_mul_vec4_aarch64(float *dst, const float *m, const float *v);
 void ngli_mat4_mul_sse(float *dst, const float *m1, const float *m2);
 void ngli_mat4_mul_vec4_sse(float *dst, const float *m, const float *v);
 
+/*
+ * Linear interpolation of n floats: dst[i] = mix(v1[i], v2[i], c). The arrays
+ * do not need to be aligned and dst may alias v1 or v2.
+ */
+void ngli_lerp_f32_c(float *dst, const float *v1, const float *v2, float c, size_t n);
+void ngli_lerp_f32_aarch64(float *dst, const float *v1, const float *v2, float c, size_t n);
+void ngli_lerp_f32_sse(float *dst, const float *v1, const float *v2, float c, size_t n);
+
 #define NGLI_QUAT_IDENTITY {0.0f, 0.0f, 0.0f, 1.0f}
 
 void ngli_quat_slerp(float * restrict dst, const float *q1, const float *q2, float t);
@@ -58,6 +58,23 @@ int ngli_config_copy(struct ngl_config *dst, const struct ngl_config *src)
             return NGL_ERROR_MEMORY;
     }
 
+    if (src->trace_filename) {
+        tmp.trace_filename = ngli_strdup(src->trace_filename);
+        if (!tmp.trace_filename) {
+            ngli_freep(&tmp.hud_export_filename);
+            return NGL_ERROR_MEMORY;
+        }
+    }
+
+    if (src->program_cache_dir) {
+        tmp.program_cache_dir = ngli_strdup(src->program_cache_dir);
+        if (!tmp.program_cache_dir) {
+            ngli_freep(&tmp.hud_export_filename);
+            ngli_freep(&tmp.trace_filename);
+            return NGL_ERROR_MEMORY;
+        }
+    }
+
     if (src->backend_config) {
 #if defined(BACKEND_GL) || defined(BACKEND_GLES)
         if (src->backend == NGL_BACKEND_OPENGL ||
@@ -66,6 +83,8 @@ int ngli_config_copy(struct ngl_config *dst, const struct ngl_config *src)
             tmp.backend_config = ngli_memdup(src->backend_config, size);
             if (!tmp.backend_config) {
                 ngli_freep(&tmp.hud_export_filename);
+                ngli_freep(&tmp.trace_filename);
+                ngli_freep(&tmp.program_cache_dir);
                 return NGL_ERROR_MEMORY;
             }
             goto done;
@@ -73,6 +92,8 @@ int ngli_config_copy(struct ngl_config *dst, const struct ngl_config *src)
 #endif
 
         ngli_freep(&tmp.hud_export_filename);
+        ngli_freep(&tmp.trace_filename);
+        ngli_freep(&tmp.program_cache_dir);
         LOG(ERROR, "backend_config %p is not supported by backend %u",
             src->backend_config, src->backend);
         return NGL_ERROR_UNSUPPORTED;
@@ -88,5 +109,7 @@ void ngli_config_reset(struct ngl_config *config)
 {
     ngli_freep(&config->backend_config);
     ngli_freep(&config->hud_export_filename);
+    ngli_freep(&config->trace_filename);
+    ngli_freep(&config->program_cache_dir);
     memset(config, 0, sizeof(*config));
 }
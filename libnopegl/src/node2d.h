@@ -56,6 +56,8 @@ struct ngli_node2d_info {
     NGLI_ATTR_ALIGNED struct aabb aabb;
     struct ngli_mat4 transform_matrix;
     NGLI_ATTR_ALIGNED struct aabb screen_aabb;
+    /* Inverse of transform_matrix, computed lazily by the spatial queries */
+    struct ngli_mat4 inv_transform_matrix;
 };
 
 /*
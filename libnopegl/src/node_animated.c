@@ -428,13 +428,34 @@ static int animation_update(struct ngl_node *node, double t)
     return ngli_animation_evaluate(&s->anim, s->var.data, t - o->time_offset);
 }
 
-#define animatedtime_update  animation_update
-#define animatedfloat_update animation_update
-#define animatedvec2_update  animation_update
-#define animatedvec3_update  animation_update
-#define animatedvec4_update  animation_update
-#define animatedpath_update  animation_update
-#define animatedcolor_update animation_update
+/*
+ * The path evaluation relies on a lookup cursor stored in the (potentially
+ * shared) path node, so AnimatedPath can not be updated concurrently
+ */
+#define animatedtime_cpu_update  animation_update
+#define animatedfloat_cpu_update animation_update
+#define animatedvec2_cpu_update  animation_update
+#define animatedvec3_cpu_update  animation_update
+#define animatedvec4_cpu_update  animation_update
+#define animatedpath_cpu_update  NULL
+#define animatedcolor_cpu_update animation_update
+
+#define animatedtime_update  NULL
+#define animatedfloat_update NULL
+#define animatedvec2_update  NULL
+#define animatedvec3_update  NULL
+#define animatedvec4_update  NULL
+#define animatedcolor_update NULL
+
+/* The path geometry may be animated as well, so it must be refreshed first */
+static int animatedpath_update(struct ngl_node *node, double t)
+{
+    const struct variable_opts *o = node->opts;
+    int ret = ngli_node_update(o->path_node, t);
+    if (ret < 0)
+        return ret;
+    return animation_update(node, t);
+}
 
 static int animatedtime_invalidate(struct ngl_node *node)
 {
@@ -476,7 +497,7 @@ static int animatedtime_invalidate(struct ngl_node *node)
 #define animatedcolor_invalidate NULL
 #define animatedquat_invalidate  NULL
 
-static int animatedquat_update(struct ngl_node *node, double t)
+static int animatedquat_cpu_update(struct ngl_node *node, double t)
 {
     struct animated_priv *s = node->priv_data;
     const struct variable_opts *o = node->opts;
@@ -488,18 +509,22 @@ static int animatedquat_update(struct ngl_node *node, double t)
     return 0;
 }
 
+#define animatedquat_update NULL
+
 #define DEFINE_ANIMATED_CLASS(class_id, class_name, type)       \
 const struct node_class ngli_animated##type##_class = {         \
     .id        = class_id,                                      \
     .category  = NGLI_NODE_CATEGORY_VARIABLE,                   \
     .name      = class_name,                                    \
     .init      = animated##type##_init,                         \
+    .cpu_update = animated##type##_cpu_update,                  \
     .update    = animated##type##_update,                       \
     .invalidate = animated##type##_invalidate,                  \
     .opts_size = sizeof(struct variable_opts),                  \
     .priv_size = sizeof(struct animated_priv),                  \
     .params    = animated##type##_params,                       \
-    .flags     = NGLI_NODE_FLAG_SHAREABLE,                      \
+    .flags     = NGLI_NODE_FLAG_SHAREABLE |                     \
+                 NGLI_NODE_FLAG_TIME_DEPENDENT,                 \
     .file      = __FILE__,                                      \
 };
 
@@ -36,11 +36,16 @@
 struct animatedbuffer_opts {
     struct ngl_node **animkf;
     size_t nb_animkf;
+    int direct_write;
 };
 
 struct animatedbuffer_priv {
     struct buffer_info buf;
     struct animation anim;
+    /* direct_write only: one buffer per in-flight frame, and their persistent mappings if supported */
+    struct ngpu_buffer **frame_buffers;
+    uint8_t **frame_data;
+    size_t nb_frame_buffers;
 };
 
 NGLI_STATIC_ASSERT(offsetof(struct animatedbuffer_priv, buf) == 0, "buffer_info is first");
@@ -51,6 +56,11 @@ static const struct node_param animatedbuffer_params[] = {
                   .node_types=(const uint32_t[]){NGL_NODE_ANIMKEYFRAMEBUFFER, NGLI_NODE_NONE},
                   .flags=NGLI_PARAM_FLAG_DOT_DISPLAY_PACKED,
                   .desc=NGLI_DOCSTRING("key frame buffers to interpolate from")},
+    {"direct_write", NGLI_PARAM_TYPE_BOOL, OFFSET(direct_write), {.i32=0},
+                     .desc=NGLI_DOCSTRING("interpolate directly into a mapped GPU buffer (one per in-flight frame) "
+                                          "instead of going through an intermediate CPU copy; ignored when the "
+                                          "buffer data is also read on the CPU (uniforms, block fields, textures) "
+                                          "or used by a Geometry")},
     {NULL}
 };
 
@@ -65,10 +75,7 @@ static void mix_buffer(void *user_arg, void *dst,
     const float *d0 = (const float *)kf0->data;
     const float *d1 = (const float *)kf1->data;
     const struct buffer_layout *layout = &info->layout;
-    const size_t comp = layout->comp;
-    for (size_t k = 0; k < layout->count; k++)
-        for (size_t i = 0; i < comp; i++)
-            dstf[k*comp + i] = NGLI_MIX_F32(d0[k*comp + i], d1[k*comp + i], (float)ratio);
+    ngli_lerp_f32(dstf, d0, d1, (float)ratio, layout->count * layout->comp);
 }
 
 static void cpy_buffer(void *user_arg, void *dst,
@@ -79,14 +86,75 @@ static void cpy_buffer(void *user_arg, void *dst,
     memcpy(dst, kf->data, info->data_size);
 }
 
-static int animatedbuffer_update(struct ngl_node *node, double t)
+static int update_mapped_buffer(struct ngl_node *node, double t)
 {
     struct animatedbuffer_priv *s = node->priv_data;
     struct buffer_info *info = &s->buf;
-    int ret = ngli_animation_evaluate(&s->anim, info->data, t);
+
+    const uint32_t frame_index = ngpu_ctx_get_current_frame_index(node->ctx->gpu_ctx);
+    struct ngpu_buffer *buffer = s->frame_buffers[frame_index];
+
+    /*
+     * The buffer of this frame slot was last used by the frame submitted
+     * nb_in_flight_frames ago, which is normally complete already: unlike the
+     * frames still in flight, it is safe to overwrite without stalling.
+     */
+    int ret = ngpu_buffer_wait(buffer);
+    if (ret < 0)
+        return ret;
+
+    void *data = s->frame_data[frame_index];
+    if (data) {
+        ret = ngli_animation_evaluate(&s->anim, data, t);
+    } else {
+        ret = ngpu_buffer_map(buffer, 0, info->data_size, &data);
+        if (ret < 0)
+            return ret;
+        ret = ngli_animation_evaluate(&s->anim, data, t);
+        ngpu_buffer_unmap(buffer);
+    }
     if (ret < 0)
         return ret;
 
+    if (info->buffer != buffer) {
+        info->buffer = buffer;
+        info->buffer_rev++;
+    }
+
+    return 0;
+}
+
+static bool use_direct_write(const struct ngl_node *node)
+{
+    const struct animatedbuffer_priv *s = node->priv_data;
+    const struct animatedbuffer_opts *o = node->opts;
+    const struct buffer_info *info = &s->buf;
+
+    return o->direct_write &&
+           (info->flags & NGLI_BUFFER_INFO_FLAG_GPU_UPLOAD) &&
+           !(info->flags & (NGLI_BUFFER_INFO_FLAG_CPU_READ | NGLI_BUFFER_INFO_FLAG_FIXED));
+}
+
+static int animatedbuffer_cpu_update(struct ngl_node *node, double t)
+{
+    struct animatedbuffer_priv *s = node->priv_data;
+    struct buffer_info *info = &s->buf;
+
+    /* The interpolation happens in the mapped GPU buffer, during update() */
+    if (use_direct_write(node))
+        return 0;
+
+    return ngli_animation_evaluate(&s->anim, info->data, t);
+}
+
+static int animatedbuffer_update(struct ngl_node *node, double t)
+{
+    struct animatedbuffer_priv *s = node->priv_data;
+    struct buffer_info *info = &s->buf;
+
+    if (use_direct_write(node))
+        return update_mapped_buffer(node, t);
+
     if (!(info->flags & NGLI_BUFFER_INFO_FLAG_GPU_UPLOAD))
         return 0;
 
@@ -145,6 +213,49 @@ static int animatedbuffer_init(struct ngl_node *node)
     return 0;
 }
 
+static int init_frame_buffers(struct ngl_node *node)
+{
+    struct animatedbuffer_priv *s = node->priv_data;
+    struct buffer_info *info = &s->buf;
+    struct ngpu_ctx *gpu_ctx = node->ctx->gpu_ctx;
+
+    info->usage |= NGPU_BUFFER_USAGE_MAP_WRITE;
+    const uint64_t features = ngpu_ctx_get_features(gpu_ctx);
+    if (features & NGPU_FEATURE_BUFFER_MAP_PERSISTENT_BIT)
+        info->usage |= NGPU_BUFFER_USAGE_MAP_PERSISTENT;
+
+    const size_t nb_frame_buffers = ngpu_ctx_get_nb_in_flight_frames(gpu_ctx);
+    s->frame_buffers = ngli_calloc(nb_frame_buffers, sizeof(*s->frame_buffers));
+    s->frame_data = ngli_calloc(nb_frame_buffers, sizeof(*s->frame_data));
+    if (!s->frame_buffers || !s->frame_data)
+        return NGL_ERROR_MEMORY;
+    s->nb_frame_buffers = nb_frame_buffers;
+
+    /* The consumers registered the initial buffer, which serves the first frame slot */
+    s->frame_buffers[0] = info->buffer;
+    for (size_t i = 1; i < nb_frame_buffers; i++) {
+        s->frame_buffers[i] = ngpu_buffer_create(gpu_ctx);
+        if (!s->frame_buffers[i])
+            return NGL_ERROR_MEMORY;
+    }
+
+    for (size_t i = 0; i < nb_frame_buffers; i++) {
+        int ret = ngpu_buffer_init(s->frame_buffers[i], info->data_size, info->usage);
+        if (ret < 0)
+            return ret;
+
+        if (info->usage & NGPU_BUFFER_USAGE_MAP_PERSISTENT) {
+            void *data;
+            ret = ngpu_buffer_map(s->frame_buffers[i], 0, info->data_size, &data);
+            if (ret < 0)
+                return ret;
+            s->frame_data[i] = data;
+        }
+    }
+
+    return 0;
+}
+
 static int animatedbuffer_prepare(struct ngl_node *node,
                                   const struct ngpu_graphics_state *graphics_state,
                                   const struct ngpu_rendertarget_layout *rendertarget_layout)
@@ -155,6 +266,9 @@ static int animatedbuffer_prepare(struct ngl_node *node,
     if (!(info->flags & NGLI_BUFFER_INFO_FLAG_GPU_UPLOAD))
         return 0;
 
+    if (use_direct_write(node))
+        return init_frame_buffers(node);
+
     int ret = ngpu_buffer_init(info->buffer, info->data_size, info->usage);
     if (ret < 0)
         return ret;
@@ -167,6 +281,17 @@ static void animatedbuffer_uninit(struct ngl_node *node)
     struct animatedbuffer_priv *s = node->priv_data;
     struct buffer_info *info = &s->buf;
 
+    for (size_t i = 0; i < s->nb_frame_buffers; i++) {
+        if (s->frame_data[i])
+            ngpu_buffer_unmap(s->frame_buffers[i]);
+        if (i > 0)
+            ngpu_buffer_freep(&s->frame_buffers[i]);
+    }
+    if (s->nb_frame_buffers)
+        info->buffer = s->frame_buffers[0];
+    ngli_freep(&s->frame_buffers);
+    ngli_freep(&s->frame_data);
+    s->nb_frame_buffers = 0;
     ngpu_buffer_freep(&info->buffer);
     ngli_freep(&info->data);
 }
@@ -187,13 +312,15 @@ const struct node_class ngli_animatedbuffer##type_name##_class = {
     .name      = class_name,                                                       \
     .init      = animatedbuffer##type_name##_init,                                 \
     .prepare   = animatedbuffer_prepare,                                           \
+    .cpu_update = animatedbuffer_cpu_update,                                       \
     .update    = animatedbuffer_update,                                            \
     .uninit    = animatedbuffer_uninit,                                            \
     .opts_size = sizeof(struct animatedbuffer_opts),                               \
     .priv_size = sizeof(struct animatedbuffer_priv),                               \
     .params    = animatedbuffer_params,                                            \
     .params_id = "AnimatedBuffer",                                                 \
-    .flags     = NGLI_NODE_FLAG_SHAREABLE,                                         \
+    .flags     = NGLI_NODE_FLAG_SHAREABLE |                                        \
+                 NGLI_NODE_FLAG_TIME_DEPENDENT,                                    \
     .file      = __FILE__,                                                         \
 };                                                                                 \
 
@@ -291,11 +291,12 @@ static int block_init(struct ngl_node *node)
         const struct ngl_node *field_node = o->fields[i];
 
         if (field_node->cls->category == NGLI_NODE_CATEGORY_BUFFER) {
-            const struct buffer_info *buffer_info = field_node->priv_data;
+            struct buffer_info *buffer_info = field_node->priv_data;
             if (buffer_info->block) {
                 LOG(ERROR, "buffers used as a block field referencing a block are not supported");
                 return NGL_ERROR_UNSUPPORTED;
             }
+            buffer_info->flags |= NGLI_BUFFER_INFO_FLAG_CPU_READ;
         }
 
         const enum ngpu_type type = get_node_data_type(field_node);
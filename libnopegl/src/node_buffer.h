@@ -31,6 +31,8 @@ struct ngl_node;
 
 #define NGLI_BUFFER_INFO_FLAG_GPU_UPLOAD (1 << 0) /* The ngpu_buffer is responsible for uploading its data to the GPU */
 #define NGLI_BUFFER_INFO_FLAG_DYNAMIC    (1 << 1) /* The ngpu_buffer CPU data may change at every update */
+#define NGLI_BUFFER_INFO_FLAG_CPU_READ   (1 << 2) /* The buffer CPU data is read by another node (uniforms, block fields, textures) */
+#define NGLI_BUFFER_INFO_FLAG_FIXED      (1 << 3) /* The ngpu_buffer is kept by another node which does not follow buffer_rev (geometries) */
 
 struct buffer_info {
     struct buffer_layout layout;
@@ -44,6 +46,7 @@ struct buffer_info {
     uint32_t flags;
 
     struct ngpu_buffer *buffer;
+    size_t buffer_rev;      // bumped whenever buffer is swapped for another one
 };
 
 void ngli_node_buffer_extend_usage(struct ngl_node *node, uint32_t usage);
@@ -24,6 +24,7 @@
 
 #include "internal.h"
 #include "node2d.h"
+#include "node_drawrect2d.h"
 #include "math_utils.h"
 #include <ngpu/ngpu.h>
 #include "nopegl/nopegl.h"
@@ -68,7 +69,9 @@ static int canvas2d_prepare(struct ngl_node *node,
                             const struct ngpu_graphics_state *graphics_state,
                             const struct ngpu_rendertarget_layout *rendertarget_layout)
 {
-    return 0;
+    const struct canvas2d_opts *o = node->opts;
+    return ngli_drawrect2d_prepare_batches(o->children, o->nb_children,
+                                           graphics_state, rendertarget_layout);
 }
 
 static void canvas2d_pre_draw(struct ngl_node *node)
@@ -154,6 +157,7 @@ static void canvas2d_draw(struct ngl_node *node)
 
     /* Draw children */
     for (size_t i = 0; i < o->nb_children; i++) {
+        ngli_drawrect2d_draw_batch(&o->children[i], o->nb_children - i);
         ngli_node_draw(o->children[i]);
     }
 
@@ -197,5 +197,6 @@ const struct node_class ngli_compute_class = {
     .opts_size = sizeof(struct compute_opts),
     .priv_size = sizeof(struct compute_priv),
     .params    = compute_params,
+    .flags     = NGLI_NODE_FLAG_TIME_DEPENDENT,
     .file      = __FILE__,
 };
@@ -413,6 +413,6 @@ const struct node_class ngli_customtexture_class = {
     .priv_size      = sizeof(struct customtexture_priv),
     .opts_size      = sizeof(struct customtexture_opts),
     .params         = customtexture_params,
-    .flags          = NGLI_NODE_FLAG_SHAREABLE,
+    .flags          = NGLI_NODE_FLAG_SHAREABLE | NGLI_NODE_FLAG_TIME_DEPENDENT,
     .file           = __FILE__,
 };
@@ -27,12 +27,15 @@
 #include "box.h"
 #include "distmap.h"
 #include "internal.h"
+#include "log.h"
 #include <ngpu/ngpu.h>
+#include "node_path.h"
 #include "node_uniform.h"
 #include "nopegl/nopegl.h"
 #include "path.h"
 #include "pipeline_compat.h"
 #include <ngpu/ngpu.h>
+#include "utils/time.h"
 #include "utils/utils.h"
 
 /* GLSL fragments as string */
@@ -66,6 +69,7 @@ struct drawpath_opts {
     float glow_color[3];
     struct ngl_node *blur_node;
     float blur;
+    double update_budget;
 };
 
 struct drawpath_vert_block {
@@ -92,7 +96,12 @@ struct drawpath_priv {
     struct ngli_aabb atlas_coords;
     float vertices[4];
     struct distmap *distmap;
+    int32_t shape_id;
     struct path *path;
+    struct ngli_mat4 path_transform;
+    bool dynamic;
+    size_t path_rev;
+    bool update_postponed;
     struct ngpu_pgcraft *crafter;
     struct ngpu_block_desc vert_block_desc;
     struct ngpu_block_desc frag_block_desc;
@@ -139,14 +148,40 @@ static const struct node_param drawpath_params[] = {
     {"blur",         NGLI_PARAM_TYPE_F32, OFFSET(blur_node),
                      .flags=NGLI_PARAM_FLAG_ALLOW_LIVE_CHANGE | NGLI_PARAM_FLAG_ALLOW_NODE,
                      .desc=NGLI_DOCSTRING("path blur")},
+    {"update_budget", NGLI_PARAM_TYPE_F64, OFFSET(update_budget),
+                     .desc=NGLI_DOCSTRING("maximum time (in seconds) spent per frame regenerating the distance fields "
+                                          "of animated paths, after which the regeneration is postponed to the next "
+                                          "frame (0 for no limit)")},
     {NULL}
 };
 
+static int build_path(struct ngl_node *node)
+{
+    struct drawpath_priv *s = node->priv_data;
+    const struct drawpath_opts *o = node->opts;
+    const struct path *src_path = *(struct path **)o->path_node->priv_data;
+
+    ngli_path_clear(s->path);
+
+    int ret = ngli_path_add_path(s->path, src_path);
+    if (ret < 0)
+        return ret;
+
+    ngli_path_transform(s->path, s->path_transform.m);
+
+    return ngli_path_finalize(s->path);
+}
+
 static int drawpath_init(struct ngl_node *node)
 {
     struct drawpath_priv *s = node->priv_data;
     const struct drawpath_opts *o = node->opts;
 
+    if (o->update_budget < 0.) {
+        LOG(ERROR, "update budget must be positive");
+        return NGL_ERROR_INVALID_ARG;
+    }
+
     s->distmap = ngli_distmap_create(node->ctx);
     if (!s->distmap)
         return NGL_ERROR_MEMORY;
@@ -155,16 +190,10 @@ static int drawpath_init(struct ngl_node *node)
     if (ret < 0)
         return ret;
 
-    const struct path *src_path = *(struct path **)o->path_node->priv_data;
-
     s->path = ngli_path_create();
     if (!s->path)
         return NGL_ERROR_MEMORY;
 
-    ret = ngli_path_add_path(s->path, src_path);
-    if (ret < 0)
-        return ret;
-
     /*
      * Build a matrix to transform path into normalized coordinates, scaled up
      * to the desired resolution.
@@ -177,19 +206,27 @@ static int drawpath_init(struct ngl_node *node)
         0.f, 0.f, 1.f, 0.f,
         -vb.x/vb.w*res, -vb.y/vb.h*res, 0.f, 1.f,
     }};
-    ngli_path_transform(s->path, path_transform.m);
+    s->path_transform = path_transform;
 
-    ret = ngli_path_finalize(s->path);
+    ret = build_path(node);
     if (ret < 0)
         return ret;
 
+    /*
+     * If the source path geometry can change over time, the distance map
+     * generation resources are kept around so that it can be regenerated
+     * whenever the path is rebuilt.
+     */
+    s->dynamic = ngli_node_path_is_dynamic(o->path_node);
+    s->path_rev = o->path_node->change_rev;
+
     const struct ngl_scene_params *params = &node->scene->params;
     const float ar = params->height ? (float)params->width / (float)params->height : 1.f;
     const int32_t shape_w = (int32_t)lrintf(ar > 1.f ? res * ar : res);
     const int32_t shape_h = (int32_t)lrintf(ar > 1.f ? res : res / ar);
 
-    int32_t shape_id;
-    ret = ngli_distmap_add_shape(s->distmap, shape_w, shape_h, s->path, 0, &shape_id);
+    const uint32_t flags = s->dynamic ? NGLI_DISTMAP_FLAG_DYNAMIC : 0;
+    ret = ngli_distmap_add_shape(s->distmap, shape_w, shape_h, s->path, flags, &s->shape_id);
     if (ret< 0)
         return ret;
 
@@ -197,10 +234,10 @@ static int drawpath_init(struct ngl_node *node)
     if (ret < 0)
         return ret;
 
-    s->atlas_coords = ngli_distmap_get_shape_coords(s->distmap, shape_id);
+    s->atlas_coords = ngli_distmap_get_shape_coords(s->distmap, s->shape_id);
 
     float scale[2];
-    ngli_distmap_get_shape_scale(s->distmap, shape_id, scale);
+    ngli_distmap_get_shape_scale(s->distmap, s->shape_id, scale);
 
     /* Geometry scale up */
     const struct ngli_box box = {NGLI_ARG_VEC4(o->box)};
@@ -335,6 +372,55 @@ static int drawpath_prepare(struct ngl_node *node,
     return 0;
 }
 
+static int drawpath_update(struct ngl_node *node, double t)
+{
+    struct ngl_ctx *ctx = node->ctx;
+    struct drawpath_priv *s = node->priv_data;
+    const struct drawpath_opts *o = node->opts;
+
+    int ret = ngli_node_update_children(node, t);
+    if (ret < 0)
+        return ret;
+
+    if (!s->dynamic || s->path_rev == o->path_node->change_rev)
+        return 0;
+
+    /*
+     * When the frame budget is exhausted, the previous distance field is kept
+     * for this frame. A postponed regeneration is never postponed twice so
+     * that every DrawPath eventually gets refreshed.
+     */
+    const int64_t budget = (int64_t)(o->update_budget * 1000000.);
+    if (budget && ctx->distmap_update_time >= budget && !s->update_postponed) {
+        s->update_postponed = true;
+        return 0;
+    }
+
+    const int64_t start_time = ngli_gettime_relative();
+
+    ret = build_path(node);
+    if (ret < 0)
+        return ret;
+
+    ret = ngli_distmap_update_shape(s->distmap, s->shape_id, s->path);
+    if (ret < 0)
+        return ret;
+
+    ret = ngli_distmap_regenerate(s->distmap);
+    if (ret < 0)
+        return ret;
+
+    ctx->distmap_update_time += ngli_gettime_relative() - start_time;
+
+    s->path_rev = o->path_node->change_rev;
+    s->update_postponed = false;
+
+    /* The distance field content changed, cached renderings must be invalidated */
+    ngli_node_mark_changed(node);
+
+    return 0;
+}
+
 static void drawpath_draw(struct ngl_node *node)
 {
     struct ngl_ctx *ctx = node->ctx;
@@ -414,7 +500,7 @@ const struct node_class ngli_drawpath_class = {
     .name      = "DrawPath",
     .init      = drawpath_init,
     .prepare   = drawpath_prepare,
-    .update    = ngli_node_update_children,
+    .update    = drawpath_update,
     .draw      = drawpath_draw,
     .uninit    = drawpath_uninit,
     .opts_size = sizeof(struct drawpath_opts),
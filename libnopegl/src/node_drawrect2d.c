@@ -32,6 +32,7 @@
 #include "log.h"
 #include <ngpu/ngpu.h>
 #include "node_block.h"
+#include "node_drawrect2d.h"
 #include "node_fill.h"
 #include "node_uniform.h"
 #include "node_stroke.h"
@@ -39,11 +40,14 @@
 #include "node_uniform.h"
 #include "pipeline_compat.h"
 #include "utils/bstr.h"
+#include "utils/crc32.h"
 #include "utils/darray.h"
 #include "utils/memory.h"
 #include "utils/utils.h"
 
 /* GLSL fragments as string */
+#include "drawrect_batch_frag.h"
+#include "drawrect_batch_vert.h"
 #include "drawrect_frag.h"
 #include "drawrect_vert.h"
 #include "helper_misc_utils_glsl.h"
@@ -158,6 +162,38 @@ struct drawrect2d_frag_block {
     float _pad1[3];
 };
 
+/*
+ * Per-instance record of the batched program, read as an array of vec4 by
+ * drawrect_batch.vert and drawrect_batch.frag: any change to the layout must
+ * be reflected in these shaders. The user block data (fill/stroke/custom
+ * uniforms, std140 layout) directly follows the record.
+ */
+struct drawrect2d_instance {
+    struct ngli_mat4 modelview_matrix;
+    float rect[4];
+    float uv_scale[2];
+    float margin_uv[2];
+    float margin_px;
+    float opacity;
+    float outline_width;
+    int32_t outline_mode;
+    float corner_radius[2];
+    float fill_opacity;
+    float stroke_opacity;
+    float content_translate[2];
+    float content_orientation[2];
+    float content_zoom;
+    int32_t content_wrap;
+    int32_t fill_premult;
+    int32_t nb_clips;
+    struct ngli_vec4 clip_inv[NGLI_MAX_CLIPS_2D];
+    struct ngli_vec4 clip_rect[NGLI_MAX_CLIPS_2D];
+    struct ngli_vec4 clip_radius[NGLI_MAX_CLIPS_2D];
+};
+
+NGLI_STATIC_ASSERT(sizeof(struct drawrect2d_instance) % 16 == 0, "drawrect2d_instance vec4 packing");
+NGLI_STATIC_ASSERT(offsetof(struct drawrect2d_instance, clip_inv) == 10 * 16, "drawrect2d_instance clips offset");
+
 struct drawrect2d_opts {
     float rect[4];
     struct ngl_node *fill_node;
@@ -219,6 +255,21 @@ struct drawrect2d_priv {
     const struct fill_info *fill_info;
     const struct stroke_info *stroke_info;
     char *frag_shader;
+
+    /* Instanced batching with compatible siblings */
+    bool batchable;
+    bool batched;
+    const struct ngl_node *batch_prev;
+    bool batch_prev_compatible;
+    uint32_t batch_key;
+    size_t batch_stride;
+    struct ngpu_block_desc batch_vert_block_desc;
+    struct ngpu_block_desc batch_instances_block_desc;
+    struct ngpu_pgcraft *batch_crafter;
+    struct pipeline_compat *batch_pipeline_compat;
+    int32_t batch_vert_block_index;
+    int32_t batch_vert_instances_index;
+    int32_t batch_frag_instances_index;
 };
 
 
@@ -407,6 +458,82 @@ static int build_texture_map(struct drawrect2d_priv *s)
     return 0;
 }
 
+/*
+ * Number of components of the user uniform types that can be loaded from the
+ * per-instance record, 0 if the type is not supported.
+ */
+static int get_instance_type_nb_comps(enum ngpu_type type)
+{
+    switch (type) {
+    case NGPU_TYPE_F32:
+    case NGPU_TYPE_I32:
+    case NGPU_TYPE_U32:
+    case NGPU_TYPE_BOOL:   return 1;
+    case NGPU_TYPE_VEC2:
+    case NGPU_TYPE_IVEC2:
+    case NGPU_TYPE_UVEC2:  return 2;
+    case NGPU_TYPE_VEC3:
+    case NGPU_TYPE_IVEC3:
+    case NGPU_TYPE_UVEC3:  return 3;
+    case NGPU_TYPE_VEC4:
+    case NGPU_TYPE_IVEC4:
+    case NGPU_TYPE_UVEC4:  return 4;
+    case NGPU_TYPE_MAT4:   return 16;
+    default:               return 0;
+    }
+}
+
+/*
+ * Whether drawing the children of the node may emit draw calls of its own.
+ * The children of the nodes which only forward the draw to their own
+ * children are inspected recursively.
+ */
+static bool has_drawing_children(const struct ngl_node *node)
+{
+    for (size_t i = 0; i < node->children.count; i++) {
+        const struct ngl_node *child = node->children.data[i];
+        if (!child->cls->draw)
+            continue;
+        if (child->cls->draw != ngli_node_draw_children || has_drawing_children(child))
+            return true;
+    }
+    return false;
+}
+
+static bool is_batchable(const struct ngl_node *node)
+{
+    const struct ngl_ctx *ctx = node->ctx;
+    const struct drawrect2d_priv *s = node->priv_data;
+
+    /* Per-instance records are read from a storage buffer in both stages */
+    const struct ngpu_limits *limits = ngpu_ctx_get_limits(ctx->gpu_ctx);
+    if (!(ngpu_ctx_get_features(ctx->gpu_ctx) & NGPU_FEATURE_COMPUTE_BIT) ||
+        limits->max_vertex_storage_blocks < 1 ||
+        limits->max_fragment_storage_blocks < 1)
+        return false;
+
+    /*
+     * The children of the whole batch are drawn before the batch itself, which
+     * only preserves the drawing order if they do not draw anything
+     */
+    if (has_drawing_children(node))
+        return false;
+
+    const struct fill_info *fi = s->fill_info;
+    if (fi->texture || fi->custom_textures.count || fi->custom_blocks.count || fi->color_output_count)
+        return false;
+
+    if (s->user_block_index < 0)
+        return true;
+
+    for (size_t i = 0; i < s->user_block_desc.nb_fields; i++) {
+        const struct ngpu_block_field *field = &s->user_block_desc.fields[i];
+        if (field->count || !get_instance_type_nb_comps(field->type))
+            return false;
+    }
+    return true;
+}
+
 static int drawrect2d_init(struct ngl_node *node)
 {
     struct ngl_ctx *ctx = node->ctx;
@@ -792,6 +919,9 @@ static int drawrect2d_init(struct ngl_node *node)
     if (has_user_uniforms)
         s->user_block_index = ngpu_pgcraft_get_block_index(s->crafter, "user", NGPU_PROGRAM_STAGE_FRAG);
 
+    s->batchable = is_batchable(node);
+    s->batch_key = ngli_crc32(s->frag_shader);
+
     return 0;
 }
 
@@ -928,33 +1058,33 @@ static void drawrect2d_pre_draw(struct ngl_node *node)
     node2d_info->screen_aabb = ngli_aabb_apply_transform(&expanded_aabb, modelview_matrix.m);
 }
 
-static void drawrect2d_draw(struct ngl_node *node)
+static void update_layout(struct ngl_node *node, struct ngli_mat4 *modelview_matrix)
 {
-    struct drawrect2d_priv *s = node->priv_data;
-    const struct drawrect2d_opts *o = node->opts;
-
-    if (!o->node2d.visible) {
-        s->node2d_info.screen_aabb = NGLI_AABB_EMPTY;
-        return;
-    }
-
-    ngli_node_draw_children(node);
-
     struct ngl_ctx *ctx = node->ctx;
-    struct ngpu_ctx *gpu_ctx = ctx->gpu_ctx;
+    struct drawrect2d_priv *s = node->priv_data;
 
     struct ngli_mat4 trs_matrix;
     ngli_node2d_compute_trs(node, trs_matrix.m);
 
-    struct ngli_mat4 modelview_matrix;
     const struct ngli_mat4 *prev_matrix = ngli_darray_tail(&ctx->transform_2d_stack);
-    ngli_mat4_mul(modelview_matrix.m, prev_matrix->m, trs_matrix.m);
-
-    struct pipeline_compat *pl_compat = s->pipeline_compat;
+    ngli_mat4_mul(modelview_matrix->m, prev_matrix->m, trs_matrix.m);
 
     struct ngli_node2d_info *node2d_info = &s->node2d_info;
-    node2d_info->transform_matrix = modelview_matrix;
-    node2d_info->screen_aabb = ngli_aabb_apply_transform(&node2d_info->aabb, modelview_matrix.m);
+    node2d_info->transform_matrix = *modelview_matrix;
+    node2d_info->screen_aabb = ngli_aabb_apply_transform(&node2d_info->aabb, modelview_matrix->m);
+}
+
+/*
+ * Compute the draw parameters of the rect, shared by the regular draw path
+ * (which dispatches them into the vert and frag uniform blocks) and the
+ * batched one.
+ */
+static void fill_instance(struct ngl_node *node, const struct ngli_mat4 *modelview_matrix,
+                          struct drawrect2d_instance *instance)
+{
+    struct ngl_ctx *ctx = node->ctx;
+    struct drawrect2d_priv *s = node->priv_data;
+    const struct drawrect2d_opts *o = node->opts;
 
     const struct stroke_base_opts *so = o->stroke_node
         ? (const struct stroke_base_opts *)o->stroke_node->opts : &default_stroke_base;
@@ -962,10 +1092,6 @@ static void drawrect2d_draw(struct ngl_node *node)
     const struct fill_info *fi = s->fill_info;
     const struct fill_base_opts *fo = (const struct fill_base_opts *)fi->opts;
 
-    /* Update textures */
-    for (size_t i = 0; i < s->textures_map.count; i++)
-        ngli_pipeline_compat_update_image(pl_compat, (int32_t)i, s->textures_map.data[i].image, ctx->current_staging_buffer);
-
     /* Compute texture scaling */
     const int orientation_quarter = ((int)o->content_orientation / 90) & 3;
     const int orientation_is_transposed = orientation_quarter & 1;
@@ -1014,24 +1140,110 @@ static void drawrect2d_draw(struct ngl_node *node)
                              (so->mode == STROKE_CENTER)  ? so->width * 0.5f : 0.f;
     const float margin_uv_px = outer_edge + 1.f;
     const float margin_px = margin_uv_px + 1.f;
-    const float margin_uv[2] = {
-        o->rect[2] > 0.f ? margin_uv_px / o->rect[2] : 0.f,
-        o->rect[3] > 0.f ? margin_uv_px / o->rect[3] : 0.f,
-    };
 
     /* Compute opacity: multiply local opacity by cascaded group opacity */
     const float *group_opacity = ngli_darray_tail(&ctx->opacity_2d_stack);
     const float local_opacity = *(const float *)ngli_node_get_data_ptr(o->node2d.opacity_node, &o->node2d.opacity);
-    const float final_opacity = local_opacity * *group_opacity;
+
+    instance->modelview_matrix = *modelview_matrix;
+    memcpy(instance->rect, o->rect, sizeof(instance->rect));
+    memcpy(instance->uv_scale, uv_scale, sizeof(instance->uv_scale));
+    instance->margin_uv[0] = o->rect[2] > 0.f ? margin_uv_px / o->rect[2] : 0.f;
+    instance->margin_uv[1] = o->rect[3] > 0.f ? margin_uv_px / o->rect[3] : 0.f;
+    instance->margin_px = margin_px;
+    instance->opacity = local_opacity * *group_opacity;
+    instance->outline_width = so->width;
+    instance->outline_mode = so->mode;
+    memcpy(instance->corner_radius, o->corner_radius, sizeof(instance->corner_radius));
+    instance->fill_opacity = fo->opacity;
+    instance->stroke_opacity = so->opacity;
+    memcpy(instance->content_translate, content_translate, sizeof(instance->content_translate));
+    memcpy(instance->content_orientation, orientation_cos_sin[orientation_quarter], sizeof(instance->content_orientation));
+    instance->content_zoom = content_zoom;
+    instance->content_wrap = fo->wrap;
+    instance->fill_premult = fo->premult;
+
+    /* Cascaded Group2D clips followed by the node own clip */
+    size_t nb_clips = ctx->nb_clips_2d;
+    for (size_t i = 0; i < nb_clips; i++) {
+        instance->clip_inv[i]    = ctx->clips_2d[i].inv;
+        instance->clip_rect[i]   = ctx->clips_2d[i].rect;
+        instance->clip_radius[i] = ctx->clips_2d[i].radius;
+    }
+    const float *clip_rect = ngli_node_get_data_ptr(o->clip_rect_node, o->clip_rect);
+    const float *clip_corner_radius = ngli_node_get_data_ptr(o->clip_corner_radius_node, o->clip_corner_radius);
+    struct ngli_clip2d clip;
+    if (nb_clips < NGLI_MAX_CLIPS_2D &&
+        ngli_node2d_compute_clip(modelview_matrix, clip_rect, clip_corner_radius, &clip)) {
+        instance->clip_inv[nb_clips]    = clip.inv;
+        instance->clip_rect[nb_clips]   = clip.rect;
+        instance->clip_radius[nb_clips] = clip.radius;
+        nb_clips++;
+    }
+    instance->nb_clips = (int32_t)nb_clips;
+}
+
+static void fill_user_block(const struct drawrect2d_priv *s, uint8_t *data)
+{
+    /* Fill prebuilt uniforms */
+    const struct ngpu_block_field *fields = s->user_block_desc.fields;
+    const struct prebuilt_uniform *pbu = s->prebuilt_uniforms.data;
+    for (size_t i = 0; i < s->prebuilt_uniforms.count; i++)
+        ngpu_block_field_copy(&fields[pbu[i].field_index], data + fields[pbu[i].field_index].offset, pbu[i].base + pbu[i].offset);
+
+    /* Stroke prebuilt uniforms */
+    const struct prebuilt_uniform *stroke_pbu = s->stroke_prebuilt_uniforms.data;
+    for (size_t i = 0; i < s->stroke_prebuilt_uniforms.count; i++)
+        ngpu_block_field_copy(&fields[stroke_pbu[i].field_index], data + fields[stroke_pbu[i].field_index].offset, stroke_pbu[i].base + stroke_pbu[i].offset);
+
+    /* CustomFill user uniforms */
+    for (size_t i = 0; i < s->user_uniforms.count; i++) {
+        const struct user_uniform *uu = &s->user_uniforms.data[i];
+        ngpu_block_field_copy(&fields[uu->field_index], data + fields[uu->field_index].offset, node_get_data_ptr(uu->node, uu->type));
+    }
+}
+
+static void drawrect2d_draw(struct ngl_node *node)
+{
+    struct drawrect2d_priv *s = node->priv_data;
+    const struct drawrect2d_opts *o = node->opts;
+
+    /* Already drawn by the leader of its batch, see ngli_drawrect2d_draw_batch() */
+    if (s->batched) {
+        s->batched = false;
+        return;
+    }
+
+    if (!o->node2d.visible) {
+        s->node2d_info.screen_aabb = NGLI_AABB_EMPTY;
+        return;
+    }
+
+    ngli_node_draw_children(node);
+
+    struct ngl_ctx *ctx = node->ctx;
+    struct ngpu_ctx *gpu_ctx = ctx->gpu_ctx;
+
+    struct ngli_mat4 modelview_matrix;
+    update_layout(node, &modelview_matrix);
+
+    struct pipeline_compat *pl_compat = s->pipeline_compat;
+
+    /* Update textures */
+    for (size_t i = 0; i < s->textures_map.count; i++)
+        ngli_pipeline_compat_update_image(pl_compat, (int32_t)i, s->textures_map.data[i].image, ctx->current_staging_buffer);
+
+    struct drawrect2d_instance instance;
+    fill_instance(node, &modelview_matrix, &instance);
 
     /* Fill and push vertex block to staging buffer */
     {
         struct drawrect2d_vert_block vert_data = {0};
         vert_data.projection_matrix = ctx->projection_2d_matrix;
-        vert_data.modelview_matrix = modelview_matrix;
-        memcpy(vert_data.uv_scale, uv_scale, sizeof(vert_data.uv_scale));
-        vert_data.margin_px = margin_px;
-        memcpy(vert_data.margin_uv, margin_uv, sizeof(vert_data.margin_uv));
+        vert_data.modelview_matrix = instance.modelview_matrix;
+        memcpy(vert_data.uv_scale, instance.uv_scale, sizeof(vert_data.uv_scale));
+        vert_data.margin_px = instance.margin_px;
+        memcpy(vert_data.margin_uv, instance.margin_uv, sizeof(vert_data.margin_uv));
 
         const size_t vert_offset = ngpu_staging_buffer_push(ctx->current_staging_buffer, &vert_data, s->vert_block_size);
         if (vert_offset == SIZE_MAX)
@@ -1044,37 +1256,26 @@ static void drawrect2d_draw(struct ngl_node *node)
     /* Fill and push static fragment block to staging buffer */
     {
         struct drawrect2d_frag_block frag_data = {0};
-        frag_data.rect_size[0]  = o->rect[2];
-        frag_data.rect_size[1]  = o->rect[3];
-        memcpy(frag_data.corner_radius, o->corner_radius, sizeof(frag_data.corner_radius));
-        frag_data.outline_width = so->width;
-        frag_data.outline_mode  = so->mode;
-        frag_data.opacity       = final_opacity;
-        frag_data.fill_opacity  = fo->opacity;
-        frag_data.stroke_opacity = so->opacity;
-        frag_data.content_wrap  = fo->wrap;
-        frag_data.content_zoom  = content_zoom;
-        memcpy(frag_data.content_translate, content_translate, sizeof(frag_data.content_translate));
-        memcpy(frag_data.content_orientation, orientation_cos_sin[orientation_quarter], sizeof(frag_data.content_orientation));
-        memcpy(frag_data.frag_uv_scale, uv_scale, sizeof(frag_data.frag_uv_scale));
-        frag_data.fill_premult = fo->premult;
-        size_t nb_clips = ctx->nb_clips_2d;
-        for (size_t i = 0; i < nb_clips; i++) {
-            frag_data.clip_inv[i]    = ctx->clips_2d[i].inv;
-            frag_data.clip_rect[i]   = ctx->clips_2d[i].rect;
-            frag_data.clip_radius[i] = ctx->clips_2d[i].radius;
-        }
-        const float *clip_rect = ngli_node_get_data_ptr(o->clip_rect_node, o->clip_rect);
-        const float *clip_corner_radius = ngli_node_get_data_ptr(o->clip_corner_radius_node, o->clip_corner_radius);
-        struct ngli_clip2d clip;
-        if (nb_clips < NGLI_MAX_CLIPS_2D &&
-            ngli_node2d_compute_clip(&modelview_matrix, clip_rect, clip_corner_radius, &clip)) {
-            frag_data.clip_inv[nb_clips]    = clip.inv;
-            frag_data.clip_rect[nb_clips]   = clip.rect;
-            frag_data.clip_radius[nb_clips] = clip.radius;
-            nb_clips++;
+        frag_data.rect_size[0]  = instance.rect[2];
+        frag_data.rect_size[1]  = instance.rect[3];
+        memcpy(frag_data.corner_radius, instance.corner_radius, sizeof(frag_data.corner_radius));
+        frag_data.outline_width = instance.outline_width;
+        frag_data.outline_mode  = instance.outline_mode;
+        frag_data.opacity       = instance.opacity;
+        frag_data.fill_opacity  = instance.fill_opacity;
+        frag_data.stroke_opacity = instance.stroke_opacity;
+        frag_data.content_wrap  = instance.content_wrap;
+        frag_data.content_zoom  = instance.content_zoom;
+        memcpy(frag_data.content_translate, instance.content_translate, sizeof(frag_data.content_translate));
+        memcpy(frag_data.content_orientation, instance.content_orientation, sizeof(frag_data.content_orientation));
+        memcpy(frag_data.frag_uv_scale, instance.uv_scale, sizeof(frag_data.frag_uv_scale));
+        frag_data.fill_premult = instance.fill_premult;
+        for (int32_t i = 0; i < instance.nb_clips; i++) {
+            frag_data.clip_inv[i]    = instance.clip_inv[i];
+            frag_data.clip_rect[i]   = instance.clip_rect[i];
+            frag_data.clip_radius[i] = instance.clip_radius[i];
         }
-        frag_data.nb_clips = (int32_t)nb_clips;
+        frag_data.nb_clips = instance.nb_clips;
 
         const size_t frag_offset = ngpu_staging_buffer_push(ctx->current_staging_buffer,
                                                             &frag_data, sizeof(frag_data));
@@ -1089,24 +1290,7 @@ static void drawrect2d_draw(struct ngl_node *node)
     if (s->user_block_index >= 0) {
         size_t offset = 0;
         uint8_t *data = ngpu_staging_buffer_reserve(ctx->current_staging_buffer, s->user_block_size, &offset);
-
-
-        /* Fill prebuilt uniforms */
-        const struct ngpu_block_field *fields = s->user_block_desc.fields;
-        const struct prebuilt_uniform *pbu = s->prebuilt_uniforms.data;
-        for (size_t i = 0; i < s->prebuilt_uniforms.count; i++)
-            ngpu_block_field_copy(&fields[pbu[i].field_index], data + fields[pbu[i].field_index].offset, pbu[i].base + pbu[i].offset);
-
-        /* Stroke prebuilt uniforms */
-        const struct prebuilt_uniform *stroke_pbu = s->stroke_prebuilt_uniforms.data;
-        for (size_t i = 0; i < s->stroke_prebuilt_uniforms.count; i++)
-            ngpu_block_field_copy(&fields[stroke_pbu[i].field_index], data + fields[stroke_pbu[i].field_index].offset, stroke_pbu[i].base + stroke_pbu[i].offset);
-
-        /* CustomFill user uniforms */
-        for (size_t i = 0; i < s->user_uniforms.count; i++) {
-            const struct user_uniform *uu = &s->user_uniforms.data[i];
-            ngpu_block_field_copy(&fields[uu->field_index], data + fields[uu->field_index].offset, node_get_data_ptr(uu->node, uu->type));
-        }
+        fill_user_block(s, data);
 
         struct ngpu_buffer *buffer = ngpu_staging_buffer_get_buffer(ctx->current_staging_buffer);
         ngli_pipeline_compat_update_buffer(pl_compat, s->user_block_index,
@@ -1132,10 +1316,385 @@ static void drawrect2d_draw(struct ngl_node *node)
     ngli_pipeline_compat_draw(pl_compat, s->nb_vertices, 1, 0);
 }
 
+static bool has_same_user_block_layout(const struct drawrect2d_priv *s0, const struct drawrect2d_priv *s1)
+{
+    const struct ngpu_block_desc *desc0 = &s0->user_block_desc;
+    const struct ngpu_block_desc *desc1 = &s1->user_block_desc;
+    if (desc0->nb_fields != desc1->nb_fields)
+        return false;
+    for (size_t i = 0; i < desc0->nb_fields; i++) {
+        const struct ngpu_block_field *field0 = &desc0->fields[i];
+        const struct ngpu_block_field *field1 = &desc1->fields[i];
+        if (field0->type != field1->type ||
+            field0->offset != field1->offset ||
+            strcmp(field0->name, field1->name))
+            return false;
+    }
+    return true;
+}
+
+/*
+ * Two DrawRect2D can be part of the same batch if they share the same
+ * program and blending. The (costly) shader comparison is memoized on the
+ * node since the sibling order is mostly stable across frames.
+ */
+static bool is_batch_compatible(const struct ngl_node *prev, struct ngl_node *node)
+{
+    if (prev == node ||
+        prev->cls->id != NGL_NODE_DRAWRECT2D ||
+        node->cls->id != NGL_NODE_DRAWRECT2D)
+        return false;
+
+    const struct drawrect2d_priv *prev_s = prev->priv_data;
+    struct drawrect2d_priv *s = node->priv_data;
+    if (!prev_s->batchable || !s->batchable || prev_s->batch_key != s->batch_key)
+        return false;
+
+    if (s->batch_prev == prev)
+        return s->batch_prev_compatible;
+
+    const struct drawrect2d_opts *prev_o = prev->opts;
+    const struct drawrect2d_opts *o = node->opts;
+    s->batch_prev = prev;
+    s->batch_prev_compatible = prev_o->node2d.blending == o->node2d.blending &&
+                               !strcmp(prev_s->frag_shader, s->frag_shader) &&
+                               has_same_user_block_layout(prev_s, s);
+    return s->batch_prev_compatible;
+}
+
+static void print_user_field_load(struct bstr *b, const struct ngpu_block_field *field)
+{
+    const size_t slot = sizeof(struct drawrect2d_instance) / 16 + field->offset / 16;
+
+    if (field->type == NGPU_TYPE_MAT4) {
+        ngli_bstr_printf(b, "    %s = mat4(frag_instances.data[base + %zu], frag_instances.data[base + %zu],\n"
+                            "              frag_instances.data[base + %zu], frag_instances.data[base + %zu]);\n",
+                         field->name, slot, slot + 1, slot + 2, slot + 3);
+        return;
+    }
+
+    /* std140 never makes a scalar or vector field straddle two vec4 */
+    const int nb_comps = get_instance_type_nb_comps(field->type);
+    const char *swizzle = &"xyzw"[(field->offset % 16) / 4];
+
+    switch (field->type) {
+    case NGPU_TYPE_BOOL:
+        ngli_bstr_printf(b, "    %s = floatBitsToInt(frag_instances.data[base + %zu].%.*s) != 0;\n",
+                         field->name, slot, nb_comps, swizzle);
+        break;
+    case NGPU_TYPE_I32:
+    case NGPU_TYPE_IVEC2:
+    case NGPU_TYPE_IVEC3:
+    case NGPU_TYPE_IVEC4:
+        ngli_bstr_printf(b, "    %s = floatBitsToInt(frag_instances.data[base + %zu].%.*s);\n",
+                         field->name, slot, nb_comps, swizzle);
+        break;
+    case NGPU_TYPE_U32:
+    case NGPU_TYPE_UVEC2:
+    case NGPU_TYPE_UVEC3:
+    case NGPU_TYPE_UVEC4:
+        ngli_bstr_printf(b, "    %s = floatBitsToUint(frag_instances.data[base + %zu].%.*s);\n",
+                         field->name, slot, nb_comps, swizzle);
+        break;
+    default:
+        ngli_bstr_printf(b, "    %s = frag_instances.data[base + %zu].%.*s;\n",
+                         field->name, slot, nb_comps, swizzle);
+        break;
+    }
+}
+
+static int prepare_batch_pipeline(struct ngl_node *node,
+                                  const struct ngpu_graphics_state *graphics_state,
+                                  const struct ngpu_rendertarget_layout *rendertarget_layout)
+{
+    struct ngl_ctx *ctx = node->ctx;
+    struct ngpu_ctx *gpu_ctx = ctx->gpu_ctx;
+    struct drawrect2d_priv *s = node->priv_data;
+    const struct drawrect2d_opts *o = node->opts;
+    const struct fill_info *fi = s->fill_info;
+    const struct stroke_info *si = s->stroke_info;
+
+    const size_t user_size = s->user_block_index >= 0 ? NGLI_ALIGN(s->user_block_size, 16) : 0;
+    s->batch_stride = sizeof(struct drawrect2d_instance) + user_size;
+
+    const struct ngpu_block_desc *user_desc = &s->user_block_desc;
+    const size_t nb_user_fields = s->user_block_index >= 0 ? user_desc->nb_fields : 0;
+
+    struct bstr *vert = ngli_bstr_create();
+    struct bstr *frag = ngli_bstr_create();
+    int ret = 0;
+
+    if (!vert || !frag) {
+        ret = NGL_ERROR_MEMORY;
+        goto end;
+    }
+
+    ngli_bstr_printf(vert, "#define NGLI_INSTANCE_STRIDE %zu\n", s->batch_stride / 16);
+    ngli_bstr_print(vert, drawrect_batch_vert);
+
+    /*
+     * The fill, stroke and drawrect GLSL code is shared with the regular
+     * program: the uniforms they reference are declared as globals loaded
+     * from the per-instance record by ngli_load_instance().
+     */
+    ngli_bstr_printf(frag, "#define NGLI_BATCHED\n"
+                           "#define NGLI_MAX_CLIPS_2D %d\n"
+                           "#define NGLI_INSTANCE_STRIDE %zu\n",
+                     NGLI_MAX_CLIPS_2D, s->batch_stride / 16);
+    ngli_bstr_print(frag, drawrect_batch_frag);
+    for (size_t i = 0; i < nb_user_fields; i++) {
+        const struct ngpu_block_field *field = &user_desc->fields[i];
+        ngli_bstr_printf(frag, "%s %s;\n", ngpu_type_get_name(field->type), field->name);
+    }
+    ngli_bstr_print(frag, "void ngli_load_instance()\n"
+                          "{\n"
+                          "    int base = ngli_instance * NGLI_INSTANCE_STRIDE;\n"
+                          "    ngli_load_rect_instance(base);\n");
+    for (size_t i = 0; i < nb_user_fields; i++)
+        print_user_field_load(frag, &user_desc->fields[i]);
+    ngli_bstr_print(frag, "}\n");
+
+    const uint32_t all_helper_flags = fi->helper_flags | si->helper_flags;
+    if (all_helper_flags & FILL_HELPER_MISC_UTILS) ngli_bstr_print(frag, helper_misc_utils_glsl);
+    if (all_helper_flags & FILL_HELPER_NOISE)      ngli_bstr_print(frag, helper_noise_glsl);
+    if (all_helper_flags & FILL_HELPER_SRGB)       ngli_bstr_print(frag, helper_srgb_glsl);
+    ngli_bstr_print(frag, fi->glsl);
+    ngli_bstr_print(frag, si->glsl);
+    ngli_bstr_print(frag, drawrect_frag);
+
+    if (ngli_bstr_check(vert) < 0 || ngli_bstr_check(frag) < 0) {
+        ret = NGL_ERROR_MEMORY;
+        goto end;
+    }
+
+    static const struct ngpu_block_field vert_fields[] = {
+        {.name = "projection_matrix", .type = NGPU_TYPE_MAT4},
+    };
+    ngpu_block_desc_init(gpu_ctx, &s->batch_vert_block_desc, NGPU_BLOCK_LAYOUT_STD140);
+    ret = ngpu_block_desc_add_fields(&s->batch_vert_block_desc, vert_fields, NGLI_ARRAY_NB(vert_fields));
+    if (ret < 0)
+        goto end;
+
+    ngpu_block_desc_init(gpu_ctx, &s->batch_instances_block_desc, NGPU_BLOCK_LAYOUT_STD430);
+    ret = ngpu_block_desc_add_field(&s->batch_instances_block_desc, "data", NGPU_TYPE_VEC4, NGPU_BLOCK_DESC_VARIADIC_COUNT);
+    if (ret < 0)
+        goto end;
+
+    struct ngpu_buffer *staging_buf = ngpu_staging_buffer_get_buffer(ctx->current_staging_buffer);
+    const struct ngpu_pgcraft_block crafter_blocks[] = {
+        {
+            .name          = "vert",
+            .instance_name = "",
+            .type          = NGPU_TYPE_UNIFORM_BUFFER,
+            .stage         = NGPU_PROGRAM_STAGE_VERT,
+            .block         = &s->batch_vert_block_desc,
+            .buffer        = {.buffer = staging_buf, .size = sizeof(struct ngli_mat4)},
+        }, {
+            .name          = "vert_instances",
+            .type          = NGPU_TYPE_STORAGE_BUFFER,
+            .stage         = NGPU_PROGRAM_STAGE_VERT,
+            .block         = &s->batch_instances_block_desc,
+            .buffer        = {.buffer = staging_buf, .size = s->batch_stride},
+        }, {
+            .name          = "frag_instances",
+            .type          = NGPU_TYPE_STORAGE_BUFFER,
+            .stage         = NGPU_PROGRAM_STAGE_FRAG,
+            .block         = &s->batch_instances_block_desc,
+            .buffer        = {.buffer = staging_buf, .size = s->batch_stride},
+        },
+    };
+
+    static const struct ngpu_pgcraft_iovar vert_out_vars[] = {
+        {.name = "ngli_uv",        .type = NGPU_TYPE_VEC2},
+        {.name = "ngli_tex_coord", .type = NGPU_TYPE_VEC2},
+        {.name = "ngli_clip_pos",  .type = NGPU_TYPE_VEC2},
+        {.name = "ngli_instance",  .type = NGPU_TYPE_I32},
+    };
+
+    const struct ngpu_pgcraft_params crafter_params = {
+        .program_label    = "nopegl/drawrect-batch",
+        .vert_base        = ngli_bstr_strptr(vert),
+        .frag_base        = ngli_bstr_strptr(frag),
+        .blocks           = crafter_blocks,
+        .nb_blocks        = NGLI_ARRAY_NB(crafter_blocks),
+        .attributes       = &s->uvcoord_attr,
+        .nb_attributes    = 1,
+        .vert_out_vars    = vert_out_vars,
+        .nb_vert_out_vars = NGLI_ARRAY_NB(vert_out_vars),
+    };
+
+    s->batch_crafter = ngpu_pgcraft_create(gpu_ctx);
+    if (!s->batch_crafter) {
+        ret = NGL_ERROR_MEMORY;
+        goto end;
+    }
+
+    ret = ngpu_pgcraft_craft(s->batch_crafter, &crafter_params);
+    if (ret < 0)
+        goto end;
+
+    s->batch_vert_block_index     = ngpu_pgcraft_get_block_index(s->batch_crafter, "vert", NGPU_PROGRAM_STAGE_VERT);
+    s->batch_vert_instances_index = ngpu_pgcraft_get_block_index(s->batch_crafter, "vert_instances", NGPU_PROGRAM_STAGE_VERT);
+    s->batch_frag_instances_index = ngpu_pgcraft_get_block_index(s->batch_crafter, "frag_instances", NGPU_PROGRAM_STAGE_FRAG);
+
+    struct ngpu_graphics_state state = *graphics_state;
+    ret = ngli_blending_apply_preset(&state, o->node2d.blending);
+    if (ret < 0)
+        goto end;
+
+    s->batch_pipeline_compat = ngli_pipeline_compat_create(gpu_ctx);
+    if (!s->batch_pipeline_compat) {
+        ret = NGL_ERROR_MEMORY;
+        goto end;
+    }
+
+    const struct pipeline_compat_params params = {
+        .type = NGPU_PIPELINE_TYPE_GRAPHICS,
+        .graphics = {
+            .topology     = s->geometry->topology,
+            .state        = state,
+            .rt_layout    = *rendertarget_layout,
+            .vertex_state = ngpu_pgcraft_get_vertex_state(s->batch_crafter),
+        },
+        .program          = ngpu_pgcraft_get_program(s->batch_crafter),
+        .layout_desc      = ngpu_pgcraft_get_bindgroup_layout_desc(s->batch_crafter),
+        .resources        = ngpu_pgcraft_get_bindgroup_resources(s->batch_crafter),
+        .vertex_resources = ngpu_pgcraft_get_vertex_resources(s->batch_crafter),
+        .texture_infos    = ngpu_pgcraft_get_texture_infos(s->batch_crafter),
+    };
+
+    ret = ngli_pipeline_compat_init(s->batch_pipeline_compat, &params);
+
+end:
+    ngli_bstr_freep(&vert);
+    ngli_bstr_freep(&frag);
+    return ret;
+}
+
+int ngli_drawrect2d_prepare_batches(struct ngl_node *const *nodes, size_t nb_nodes,
+                                    const struct ngpu_graphics_state *graphics_state,
+                                    const struct ngpu_rendertarget_layout *rendertarget_layout)
+{
+    for (size_t i = 0; i + 1 < nb_nodes; i++) {
+        if (!is_batch_compatible(nodes[i], nodes[i + 1]))
+            continue;
+
+        struct drawrect2d_priv *s = nodes[i]->priv_data;
+        if (!s->batch_pipeline_compat) {
+            int ret = prepare_batch_pipeline(nodes[i], graphics_state, rendertarget_layout);
+            if (ret < 0)
+                return ret;
+        }
+
+        /* Only the head of the run leads the batch */
+        while (i + 1 < nb_nodes && is_batch_compatible(nodes[i], nodes[i + 1]))
+            i++;
+    }
+    return 0;
+}
+
+void ngli_drawrect2d_draw_batch(struct ngl_node *const *nodes, size_t nb_nodes)
+{
+    struct ngl_node *leader = nodes[0];
+    if (leader->cls->id != NGL_NODE_DRAWRECT2D)
+        return;
+
+    struct drawrect2d_priv *s = leader->priv_data;
+    if (!s->batch_pipeline_compat || s->batched)
+        return;
+
+    struct ngl_ctx *ctx = leader->ctx;
+    struct ngpu_ctx *gpu_ctx = ctx->gpu_ctx;
+    const struct ngpu_limits *limits = ngpu_ctx_get_limits(gpu_ctx);
+    const size_t max_instances = limits->max_storage_block_size / s->batch_stride;
+
+    /* Mark the visible rects of the run of compatible siblings */
+    size_t nb_run = 0;
+    size_t nb_instances = 0;
+    for (; nb_run < nb_nodes && nb_instances < max_instances; nb_run++) {
+        struct ngl_node *node = nodes[nb_run];
+        if (nb_run && !is_batch_compatible(nodes[nb_run - 1], node))
+            break;
+
+        struct drawrect2d_priv *node_s = node->priv_data;
+        const struct drawrect2d_opts *node_o = node->opts;
+        if (!node_o->node2d.visible)
+            continue;
+
+        /* The same node is referenced more than once in the run */
+        if (node_s->batched)
+            break;
+
+        node_s->batched = true;
+        nb_instances++;
+    }
+
+    if (nb_instances < 2) {
+        for (size_t i = 0; i < nb_run; i++) {
+            struct drawrect2d_priv *node_s = nodes[i]->priv_data;
+            node_s->batched = false;
+        }
+        return;
+    }
+
+    /* The instanced draw call is accounted to the first rect of the batch only */
+    bool first = true;
+    for (size_t i = 0; i < nb_run; i++) {
+        const struct drawrect2d_priv *node_s = nodes[i]->priv_data;
+        if (!node_s->batched)
+            continue;
+        ngli_node_draw_children(nodes[i]);
+        nodes[i]->draw_batched = !first;
+        first = false;
+    }
+
+    /* Fill the per-instance records, in drawing order */
+    const size_t size = nb_instances * s->batch_stride;
+    size_t offset = 0;
+    uint8_t *data = ngpu_staging_buffer_reserve(ctx->current_staging_buffer, size, &offset);
+    for (size_t i = 0; i < nb_run; i++) {
+        struct ngl_node *node = nodes[i];
+        const struct drawrect2d_priv *node_s = node->priv_data;
+        if (!node_s->batched)
+            continue;
+
+        struct ngli_mat4 modelview_matrix;
+        update_layout(node, &modelview_matrix);
+        fill_instance(node, &modelview_matrix, (struct drawrect2d_instance *)data);
+        if (node_s->user_block_index >= 0)
+            fill_user_block(node_s, data + sizeof(struct drawrect2d_instance));
+        data += s->batch_stride;
+    }
+
+    struct pipeline_compat *pl_compat = s->batch_pipeline_compat;
+
+    struct ngpu_buffer *staging_buf = ngpu_staging_buffer_get_buffer(ctx->current_staging_buffer);
+    ngli_pipeline_compat_update_buffer(pl_compat, s->batch_vert_instances_index, staging_buf, offset, size);
+    ngli_pipeline_compat_update_buffer(pl_compat, s->batch_frag_instances_index, staging_buf, offset, size);
+
+    const size_t vert_offset = ngpu_staging_buffer_push(ctx->current_staging_buffer,
+                                                        &ctx->projection_2d_matrix, sizeof(struct ngli_mat4));
+    staging_buf = ngpu_staging_buffer_get_buffer(ctx->current_staging_buffer);
+    ngli_pipeline_compat_update_buffer(pl_compat, s->batch_vert_block_index,
+                                       staging_buf, vert_offset, sizeof(struct ngli_mat4));
+
+    if (!ngpu_ctx_is_render_pass_active(gpu_ctx))
+        ngpu_ctx_begin_render_pass(gpu_ctx, ctx->current_rendertarget);
+
+    ngpu_ctx_set_viewport(gpu_ctx, &ctx->viewport);
+    ngpu_ctx_set_scissor(gpu_ctx, &ctx->scissor);
+
+    ngli_pipeline_compat_draw(pl_compat, s->nb_vertices, (uint32_t)nb_instances, 0);
+}
+
 static void drawrect2d_uninit(struct ngl_node *node)
 {
     struct drawrect2d_priv *s = node->priv_data;
     ngli_pipeline_compat_freep(&s->pipeline_compat);
+    ngli_pipeline_compat_freep(&s->batch_pipeline_compat);
+    ngpu_pgcraft_freep(&s->batch_crafter);
+    ngpu_block_desc_reset(&s->batch_vert_block_desc);
+    ngpu_block_desc_reset(&s->batch_instances_block_desc);
     ngli_darray_reset(&s->user_uniforms);
     ngli_darray_reset(&s->prebuilt_uniforms);
     ngli_darray_reset(&s->stroke_prebuilt_uniforms);
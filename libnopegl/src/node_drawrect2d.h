@@ -0,0 +1,52 @@
+/*
+ * Copyright 2026 Matthieu Bouron <matthieu.bouron@gmail.com>
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef NODE_DRAWRECT2D_H
+#define NODE_DRAWRECT2D_H
+
+#include <stddef.h>
+
+#include <ngpu/ngpu.h>
+
+struct ngl_node;
+
+/*
+ * Consecutive DrawRect2D siblings sharing the same fill/stroke program and
+ * blending mode are drawn with a single instanced draw call, their
+ * per-instance parameters being read from a storage buffer.
+ *
+ * ngli_drawrect2d_prepare_batches() must be called by the 2D container
+ * (Group2D, Canvas2D) from its prepare callback (children are prepared
+ * first) to create the instanced pipelines of the batch leaders.
+ *
+ * ngli_drawrect2d_draw_batch() must be called before drawing nodes[0]: if it
+ * leads a batch, all the visible rects of the batch are drawn at once and
+ * their subsequent ngli_node_draw() only updates their 2D layout
+ * information. Since a batch only spans consecutive siblings, the blending
+ * order is preserved. The other rects of the batch are flagged with
+ * ngl_node.draw_batched so that the batch is accounted as a single draw.
+ */
+int ngli_drawrect2d_prepare_batches(struct ngl_node *const *nodes, size_t nb_nodes,
+                                    const struct ngpu_graphics_state *graphics_state,
+                                    const struct ngpu_rendertarget_layout *rendertarget_layout);
+void ngli_drawrect2d_draw_batch(struct ngl_node *const *nodes, size_t nb_nodes);
+
+#endif
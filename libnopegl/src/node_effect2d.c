@@ -91,6 +91,7 @@ struct effect2d_priv {
     struct ngli_node2d_info node2d_info;
 
     struct rtt_ctx *rtt;
+    struct rtt_cache cache;
     struct ngpu_rendertarget_layout layout;
     uint32_t width;
     uint32_t height;
@@ -673,9 +674,22 @@ static void effect2d_pre_draw(struct ngl_node *node)
 
     if (!o->node2d.visible) {
         s->node2d_info.screen_aabb = NGLI_AABB_EMPTY;
+        ngli_rtt_cache_invalidate(&s->cache);
         return;
     }
 
+    /* Reuse the previous render (and bounding box) if none of its inputs changed */
+    bool time_dependent = false;
+    for (size_t i = 0; i < o->nb_children; i++)
+        time_dependent |= o->children[i]->time_dependent;
+    const struct rtt_cache_key key = {
+        .viewport         = ctx->viewport,
+        .canvas_2d_width  = ctx->canvas_2d_width,
+        .canvas_2d_height = ctx->canvas_2d_height,
+    };
+    if (ngli_rtt_cache_begin(&s->cache, node, time_dependent, &key))
+        return;
+
     /* Pre-draw children (computes children bounding boxes) */
     for (size_t i = 0; i < o->nb_children; i++)
         ngli_node_pre_draw(o->children[i]);
@@ -815,6 +829,8 @@ static void effect2d_pre_draw(struct ngl_node *node)
 
     ngli_rtt_end(s->rtt);
 
+    ngli_rtt_cache_end(&s->cache, node);
+
 restore_2d_state:
     ngli_darray_reset(&ctx->transform_2d_stack);
     ngli_darray_reset(&ctx->opacity_2d_stack);
@@ -918,6 +934,7 @@ static void effect2d_release(struct ngl_node *node)
     struct effect2d_priv *s = node->priv_data;
 
     ngli_rtt_freep(&s->rtt);
+    ngli_rtt_cache_reset(&s->cache);
     s->width = 0;
     s->height = 0;
 }
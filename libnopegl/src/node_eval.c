@@ -198,7 +198,7 @@ static int eval_init(struct ngl_node *node)
     return 0;
 }
 
-static int eval_update(struct ngl_node *node, double t)
+static int eval_cpu_update(struct ngl_node *node, double t)
 {
     struct eval_priv *s = node->priv_data;
     const struct eval_opts *o = node->opts;
@@ -255,7 +255,7 @@ const struct node_class ngli_eval##type##_class = {                 \
     .category  = NGLI_NODE_CATEGORY_VARIABLE,                       \
     .name      = class_name,                                        \
     .init      = eval##type##_init,                                 \
-    .update    = eval_update,                                       \
+    .cpu_update = eval_cpu_update,                                  \
     .uninit    = eval_uninit,                                       \
     .opts_size = sizeof(struct eval_opts),                          \
     .priv_size = sizeof(struct eval_priv),                          \
@@ -35,6 +35,7 @@
 #include "rtt.h"
 #include <ngpu/ngpu.h>
 #include "utils/bits.h"
+#include "utils/bstr.h"
 #include "utils/utils.h"
 
 /* GLSL shaders */
@@ -42,6 +43,7 @@
 #include "blur_downsample_frag.h"
 #include "blur_upsample_frag.h"
 #include "blur_interpolate_frag.h"
+#include "blur_linearize_frag.h"
 
 #define _CONSTANT_TO_STR(v) #v
 #define CONSTANT_TO_STR(v) _CONSTANT_TO_STR(v)
@@ -51,6 +53,9 @@
 #define DWS_NAME "nopegl/fast-gaussian-blur-dws"
 #define UPS_NAME "nopegl/fast-gaussian-blur-ups"
 
+#define LINEAR_DEFINES "#define NGLI_BLUR_LINEAR_INPUT\n" \
+                       "#define NGLI_BLUR_LINEAR_OUTPUT\n"
+
 struct down_up_data_block {
     float offset;
     float _pad[3];
@@ -74,6 +79,12 @@ struct fgblur_priv {
     uint32_t max_lod;
     float blurriness;
 
+    /*
+     * Format of the linear intermediates, NGPU_FORMAT_UNDEFINED if the blur
+     * passes operate directly on sRGB encoded intermediates
+     */
+    enum ngpu_format linear_format;
+
     /* Intermediates Mips used by the blur passses */
     struct ngpu_rendertarget_layout mip_layout;
 
@@ -85,6 +96,12 @@ struct fgblur_priv {
     int32_t down_up_block_index_dws;
     int32_t down_up_block_index_ups;
 
+    /* Source decoding pass (linear intermediates only) */
+    struct {
+        struct ngpu_pgcraft *crafter;
+        struct pipeline_compat *pl;
+    } lin;
+
     /* Downsampling pass */
     struct {
         struct ngpu_pgcraft *crafter;
@@ -128,9 +145,91 @@ static const struct node_param fgblur_params[] = {
     {NULL}
 };
 
+#define RENDER_TEXTURE_FEATURES (NGPU_FORMAT_FEATURE_SAMPLED_IMAGE_BIT |               \
+                                 NGPU_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT | \
+                                 NGPU_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT)
+
+static enum ngpu_format get_linear_format(struct ngpu_ctx *gpu_ctx)
+{
+    static const enum ngpu_format formats[] = {
+        NGPU_FORMAT_R16G16B16A16_SFLOAT,
+        NGPU_FORMAT_R32G32B32A32_SFLOAT,
+    };
+    for (size_t i = 0; i < NGLI_ARRAY_NB(formats); i++) {
+        const uint32_t features = ngpu_ctx_get_format_features(gpu_ctx, formats[i]);
+        if (NGLI_HAS_ALL_FLAGS(features, RENDER_TEXTURE_FEATURES))
+            return formats[i];
+    }
+    return NGPU_FORMAT_UNDEFINED;
+}
+
+static int setup_pipeline(struct pipeline_compat *pipeline,
+                          struct ngpu_pgcraft *crafter,
+                          const struct ngpu_rendertarget_layout *layout)
+{
+    const struct pipeline_compat_params params = {
+        .type         = NGPU_PIPELINE_TYPE_GRAPHICS,
+        .graphics     = {
+            .topology = NGPU_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
+            .state    = NGPU_GRAPHICS_STATE_DEFAULTS,
+            .rt_layout    = *layout,
+            .vertex_state = ngpu_pgcraft_get_vertex_state(crafter),
+        },
+        .program          = ngpu_pgcraft_get_program(crafter),
+        .layout_desc      = ngpu_pgcraft_get_bindgroup_layout_desc(crafter),
+        .resources        = ngpu_pgcraft_get_bindgroup_resources(crafter),
+        .vertex_resources = ngpu_pgcraft_get_vertex_resources(crafter),
+        .texture_infos    = ngpu_pgcraft_get_texture_infos(crafter),
+    };
+
+    return ngli_pipeline_compat_init(pipeline, &params);
+}
+
+static int setup_linearize_pipeline(struct ngl_node *node)
+{
+    struct ngl_ctx *ctx = node->ctx;
+    struct ngpu_ctx *gpu_ctx = ctx->gpu_ctx;
+    struct fgblur_priv *s = node->priv_data;
+
+    const struct ngpu_pgcraft_iovar vert_out_vars[] = {
+        {.name = "tex_coord", .type = NGPU_TYPE_VEC2},
+    };
+
+    const struct ngpu_pgcraft_texture textures[] = {
+        {
+            .name        = "tex",
+            .type        = NGPU_PGCRAFT_TEXTURE_TYPE_2D,
+            .precision   = NGPU_PRECISION_HIGH,
+            .stage       = NGPU_PROGRAM_STAGE_FRAG,
+        },
+    };
+
+    const struct ngpu_pgcraft_params crafter_params = {
+        .program_label    = "nopegl/fast-gaussian-blur-linearize",
+        .vert_base        = blur_common_vert,
+        .frag_base        = blur_linearize_frag,
+        .textures         = textures,
+        .nb_textures      = NGLI_ARRAY_NB(textures),
+        .vert_out_vars    = vert_out_vars,
+        .nb_vert_out_vars = NGLI_ARRAY_NB(vert_out_vars),
+    };
+
+    s->lin.crafter = ngpu_pgcraft_create(gpu_ctx);
+    s->lin.pl = ngli_pipeline_compat_create(gpu_ctx);
+    if (!s->lin.crafter || !s->lin.pl)
+        return NGL_ERROR_MEMORY;
+
+    int ret = ngpu_pgcraft_craft(s->lin.crafter, &crafter_params);
+    if (ret < 0)
+        return ret;
+
+    return setup_pipeline(s->lin.pl, s->lin.crafter, &s->mip_layout);
+}
+
 static int setup_down_up_pipeline(struct ngl_ctx *ctx,
                                   struct ngpu_pgcraft *crafter,
                                   const char *name,
+                                  const char *defines,
                                   const char *frag_base,
                                   struct pipeline_compat *pipeline,
                                   const struct ngpu_rendertarget_layout *layout,
@@ -166,10 +265,21 @@ static int setup_down_up_pipeline(struct ngl_ctx *ctx,
         }
     };
 
+    struct bstr *frag = ngli_bstr_create();
+    if (!frag)
+        return NGL_ERROR_MEMORY;
+
+    ngli_bstr_print(frag, defines);
+    ngli_bstr_print(frag, frag_base);
+    if (ngli_bstr_check(frag) < 0) {
+        ngli_bstr_freep(&frag);
+        return NGL_ERROR_MEMORY;
+    }
+
     const struct ngpu_pgcraft_params crafter_params = {
         .program_label    = name,
         .vert_base        = blur_common_vert,
-        .frag_base        = frag_base,
+        .frag_base        = ngli_bstr_strptr(frag),
         .textures         = textures,
         .nb_textures      = NGLI_ARRAY_NB(textures),
         .blocks           = blocks,
@@ -179,29 +289,11 @@ static int setup_down_up_pipeline(struct ngl_ctx *ctx,
     };
 
     int ret = ngpu_pgcraft_craft(crafter, &crafter_params);
+    ngli_bstr_freep(&frag);
     if (ret < 0)
         return ret;
 
-    const struct pipeline_compat_params params = {
-        .type         = NGPU_PIPELINE_TYPE_GRAPHICS,
-        .graphics     = {
-            .topology = NGPU_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
-            .state    = NGPU_GRAPHICS_STATE_DEFAULTS,
-            .rt_layout    = *layout,
-            .vertex_state = ngpu_pgcraft_get_vertex_state(crafter),
-        },
-        .program          = ngpu_pgcraft_get_program(crafter),
-        .layout_desc      = ngpu_pgcraft_get_bindgroup_layout_desc(crafter),
-        .resources        = ngpu_pgcraft_get_bindgroup_resources(crafter),
-        .vertex_resources = ngpu_pgcraft_get_vertex_resources(crafter),
-        .texture_infos    = ngpu_pgcraft_get_texture_infos(crafter),
-    };
-
-    ret = ngli_pipeline_compat_init(pipeline, &params);
-    if (ret < 0)
-        return ret;
-
-    return 0;
+    return setup_pipeline(pipeline, crafter, layout);
 }
 
 static int setup_interpolate_pipeline(struct ngl_node *node)
@@ -248,10 +340,22 @@ static int setup_interpolate_pipeline(struct ngl_node *node)
         }
     };
 
+    struct bstr *frag = ngli_bstr_create();
+    if (!frag)
+        return NGL_ERROR_MEMORY;
+
+    if (s->linear_format != NGPU_FORMAT_UNDEFINED)
+        ngli_bstr_print(frag, "#define NGLI_BLUR_LINEAR_INPUT\n");
+    ngli_bstr_print(frag, blur_interpolate_frag);
+    if (ngli_bstr_check(frag) < 0) {
+        ngli_bstr_freep(&frag);
+        return NGL_ERROR_MEMORY;
+    }
+
     const struct ngpu_pgcraft_params crafter_params = {
         .program_label    = "nopegl/fast-gaussian-blur-interpolate",
         .vert_base        = blur_common_vert,
-        .frag_base        = blur_interpolate_frag,
+        .frag_base        = ngli_bstr_strptr(frag),
         .textures         = interpolate_textures,
         .nb_textures      = NGLI_ARRAY_NB(interpolate_textures),
         .blocks           = crafter_blocks,
@@ -261,31 +365,13 @@ static int setup_interpolate_pipeline(struct ngl_node *node)
     };
 
     int ret = ngpu_pgcraft_craft(s->interpolate.crafter, &crafter_params);
+    ngli_bstr_freep(&frag);
     if (ret < 0)
         return ret;
 
     s->interpolate.block_index = ngpu_pgcraft_get_block_index(s->interpolate.crafter, "interpolate", NGPU_PROGRAM_STAGE_FRAG);
 
-    const struct pipeline_compat_params params = {
-        .type         = NGPU_PIPELINE_TYPE_GRAPHICS,
-        .graphics     = {
-            .topology = NGPU_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
-            .state    = NGPU_GRAPHICS_STATE_DEFAULTS,
-            .rt_layout    = s->dst_layout,
-            .vertex_state = ngpu_pgcraft_get_vertex_state(s->interpolate.crafter),
-        },
-        .program          = ngpu_pgcraft_get_program(s->interpolate.crafter),
-        .layout_desc      = ngpu_pgcraft_get_bindgroup_layout_desc(s->interpolate.crafter),
-        .resources        = ngpu_pgcraft_get_bindgroup_resources(s->interpolate.crafter),
-        .vertex_resources = ngpu_pgcraft_get_vertex_resources(s->interpolate.crafter),
-        .texture_infos    = ngpu_pgcraft_get_texture_infos(s->interpolate.crafter),
-    };
-
-    ret = ngli_pipeline_compat_init(s->interpolate.pl, &params);
-    if (ret < 0)
-        return ret;
-
-    return 0;
+    return setup_pipeline(s->interpolate.pl, s->interpolate.crafter, &s->dst_layout);
 }
 
 static int fgblur_init(struct ngl_node *node)
@@ -305,7 +391,16 @@ static int fgblur_init(struct ngl_node *node)
     src_info->params.wrap_s     = NGPU_WRAP_MIRRORED_REPEAT,
     src_info->params.wrap_t     = NGPU_WRAP_MIRRORED_REPEAT,
 
-    s->mip_layout.colors[s->mip_layout.nb_colors].format = src_info->params.format;
+    /*
+     * When a floating point format is available, the source is decoded once
+     * to a linear intermediate and the mips are kept in linear space, so that
+     * the downsampling and upsampling passes do not have to apply the sRGB
+     * transfer functions on every tap.
+     */
+    s->linear_format = get_linear_format(gpu_ctx);
+    const enum ngpu_format mip_format = s->linear_format != NGPU_FORMAT_UNDEFINED ? s->linear_format
+                                                                                  : src_info->params.format;
+    s->mip_layout.colors[s->mip_layout.nb_colors].format = mip_format;
     s->mip_layout.nb_colors++;
 
     struct texture_info *dst_info = o->destination->priv_data;
@@ -334,10 +429,17 @@ static int fgblur_init(struct ngl_node *node)
     if (!s->dws.pl || !s->ups.pl || !s->interpolate.pl)
         return NGL_ERROR_MEMORY;
 
-    if ((ret = setup_down_up_pipeline(ctx, s->dws.crafter, DWS_NAME, blur_downsample_frag, s->dws.pl, &s->mip_layout, &s->down_up_block_desc, s->down_up_block_size)) < 0 ||
-        (ret = setup_down_up_pipeline(ctx, s->ups.crafter, UPS_NAME, blur_upsample_frag, s->ups.pl, &s->mip_layout, &s->down_up_block_desc, s->down_up_block_size)) < 0)
+    const char *defines = s->linear_format != NGPU_FORMAT_UNDEFINED ? LINEAR_DEFINES : "";
+    if ((ret = setup_down_up_pipeline(ctx, s->dws.crafter, DWS_NAME, defines, blur_downsample_frag, s->dws.pl, &s->mip_layout, &s->down_up_block_desc, s->down_up_block_size)) < 0 ||
+        (ret = setup_down_up_pipeline(ctx, s->ups.crafter, UPS_NAME, defines, blur_upsample_frag, s->ups.pl, &s->mip_layout, &s->down_up_block_desc, s->down_up_block_size)) < 0)
         return ret;
 
+    if (s->linear_format != NGPU_FORMAT_UNDEFINED) {
+        ret = setup_linearize_pipeline(node);
+        if (ret < 0)
+            return ret;
+    }
+
     s->down_up_block_index_dws = ngpu_pgcraft_get_block_index(s->dws.crafter, "data", NGPU_PROGRAM_STAGE_FRAG);
     s->down_up_block_index_ups = ngpu_pgcraft_get_block_index(s->ups.crafter, "data", NGPU_PROGRAM_STAGE_FRAG);
 
@@ -365,7 +467,8 @@ static int resize(struct ngl_node *node)
         return 0;
 
     /* Assert that the source texture format does not change */
-    ngli_assert(src_info->params.format == s->mip_layout.colors[0].format);
+    ngli_assert(s->linear_format != NGPU_FORMAT_UNDEFINED ||
+                src_info->params.format == s->mip_layout.colors[0].format);
 
     /* Assert that the destination texture format does not change */
     struct texture_info *dst_info = o->destination->priv_data;
@@ -373,7 +476,7 @@ static int resize(struct ngl_node *node)
 
     struct ngpu_texture_params texture_params = (struct ngpu_texture_params) {
         .type          = NGPU_TEXTURE_TYPE_2D,
-        .format        = src_info->params.format,
+        .format        = s->mip_layout.colors[0].format,
         .width         = width,
         .height        = height,
         .min_filter    = NGPU_FILTER_LINEAR,
@@ -567,10 +670,17 @@ static void fgblur_pre_draw(struct ngl_node *node)
     ngli_pipeline_compat_update_buffer(s->ups.pl, s->down_up_block_index_ups,
                                        buffer, down_up_offset, sizeof(down_up_data));
 
-    /* Downsample source to mips[1] */
     struct texture_info *src_info = o->source->priv_data;
     const struct image *src_image = &src_info->image;
     const struct image *mip = src_image;
+
+    /* Decode the source to the (linear) full resolution mip */
+    if (s->lin.pl) {
+        execute_down_up_pass(ctx, s->mip, s->lin.pl, src_image);
+        mip = ngli_rtt_get_image(s->mip, 0);
+    }
+
+    /* Downsample source to mips[1] */
     execute_down_up_pass(ctx, s->mips[1], s->dws.pl, mip);
 
     /* Downsample successively until mips[lod_i+1] is generated */
@@ -637,6 +747,9 @@ static void fgblur_uninit(struct ngl_node *node)
 {
     struct fgblur_priv *s = node->priv_data;
 
+    ngli_pipeline_compat_freep(&s->lin.pl);
+    ngpu_pgcraft_freep(&s->lin.crafter);
+
     ngli_pipeline_compat_freep(&s->dws.pl);
     ngpu_pgcraft_freep(&s->dws.crafter);
 
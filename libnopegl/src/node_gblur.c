@@ -34,12 +34,14 @@
 #include "pipeline_compat.h"
 #include "rtt.h"
 #include <ngpu/ngpu.h>
+#include "utils/bstr.h"
 #include "utils/memory.h"
 #include "utils/utils.h"
 
 /* GLSL shaders */
 #include "blur_gaussian_vert.h"
 #include "blur_gaussian_frag.h"
+#include "blur_linearize_frag.h"
 
 #define _CONSTANT_TO_STR(v) #v
 #define CONSTANT_TO_STR(v) _CONSTANT_TO_STR(v)
@@ -76,6 +78,18 @@ struct gblur_priv {
     struct image *image;
     size_t image_rev;
 
+    /*
+     * Format of the linear intermediates, NGPU_FORMAT_UNDEFINED if the blur
+     * passes operate directly on sRGB encoded intermediates
+     */
+    enum ngpu_format linear_format;
+
+    /* Decode the source to a linear intermediate */
+    struct ngpu_rendertarget_layout lin_layout;
+    struct rtt_ctx *lin;
+    struct ngpu_pgcraft *lin_crafter;
+    struct pipeline_compat *pl_lin;
+
     /* Render the horizontal pass to a temporary destination */
     struct ngpu_rendertarget_layout tmp_layout;
     struct rtt_ctx *tmp;
@@ -95,7 +109,8 @@ struct gblur_priv {
     int32_t kernel_block_index;
     uint8_t *kernel_staging_cache;
 
-    struct ngpu_pgcraft *crafter;
+    struct ngpu_pgcraft *crafter_h;
+    struct ngpu_pgcraft *crafter_v;
     struct pipeline_compat *pl_blur_h;
     struct pipeline_compat *pl_blur_v;
 };
@@ -245,48 +260,71 @@ static int setup_pipeline(struct ngl_ctx *ctx, struct ngpu_pgcraft *crafter, str
     return 0;
 }
 
-static int gblur_init(struct ngl_node *node)
+#define RENDER_TEXTURE_FEATURES (NGPU_FORMAT_FEATURE_SAMPLED_IMAGE_BIT |               \
+                                 NGPU_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT | \
+                                 NGPU_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT)
+
+static enum ngpu_format get_linear_format(struct ngpu_ctx *gpu_ctx)
+{
+    static const enum ngpu_format formats[] = {
+        NGPU_FORMAT_R16G16B16A16_SFLOAT,
+        NGPU_FORMAT_R32G32B32A32_SFLOAT,
+    };
+    for (size_t i = 0; i < NGLI_ARRAY_NB(formats); i++) {
+        const uint32_t features = ngpu_ctx_get_format_features(gpu_ctx, formats[i]);
+        if (NGLI_HAS_ALL_FLAGS(features, RENDER_TEXTURE_FEATURES))
+            return formats[i];
+    }
+    return NGPU_FORMAT_UNDEFINED;
+}
+
+static int setup_linearize_program(struct ngl_node *node)
 {
     struct ngl_ctx *ctx = node->ctx;
-    struct ngpu_ctx *gpu_ctx = ctx->gpu_ctx;
     struct gblur_priv *s = node->priv_data;
-    const struct gblur_opts *o = node->opts;
 
-    struct texture_info *src_info = o->source->priv_data;
-    s->image = &src_info->image;
-    s->image_rev = SIZE_MAX;
-
-    /* Disable direct rendering */
-    src_info->supported_image_layouts = NGLI_IMAGE_LAYOUT_DEFAULT_BIT;
+    const struct ngpu_pgcraft_iovar vert_out_vars[] = {
+        {.name = "tex_coord", .type = NGPU_TYPE_VEC2},
+    };
 
-    /* Override texture params */
-    src_info->params.min_filter = NGPU_FILTER_LINEAR;
-    src_info->params.mag_filter = NGPU_FILTER_LINEAR;
-    src_info->params.wrap_s     = NGPU_WRAP_MIRRORED_REPEAT,
-    src_info->params.wrap_t     = NGPU_WRAP_MIRRORED_REPEAT,
+    const struct ngpu_pgcraft_texture textures[] = {
+        {
+            .name        = "tex",
+            .type        = NGPU_PGCRAFT_TEXTURE_TYPE_2D,
+            .precision   = NGPU_PRECISION_HIGH,
+            .stage       = NGPU_PROGRAM_STAGE_FRAG,
+        },
+    };
 
-    s->tmp_layout.colors[s->tmp_layout.nb_colors].format = src_info->params.format;
-    s->tmp_layout.nb_colors++;
+    const struct ngpu_pgcraft_params crafter_params = {
+        .program_label    = "nopegl/gaussian-blur-linearize",
+        .vert_base        = blur_gaussian_vert,
+        .frag_base        = blur_linearize_frag,
+        .textures         = textures,
+        .nb_textures      = NGLI_ARRAY_NB(textures),
+        .vert_out_vars    = vert_out_vars,
+        .nb_vert_out_vars = NGLI_ARRAY_NB(vert_out_vars),
+    };
 
-    struct texture_info *dst_info = o->destination->priv_data;
-    dst_info->params.usage |= NGPU_TEXTURE_USAGE_COLOR_ATTACHMENT_BIT;
+    s->lin_crafter = ngpu_pgcraft_create(ctx->gpu_ctx);
+    if (!s->lin_crafter)
+        return NGL_ERROR_MEMORY;
 
-    s->dst_is_resizable = (dst_info->params.width == 0 && dst_info->params.height == 0);
-    s->dst_layout.colors[0].format = dst_info->params.format;
-    s->dst_layout.nb_colors = 1;
+    int ret = ngpu_pgcraft_craft(s->lin_crafter, &crafter_params);
+    if (ret < 0)
+        return ret;
 
-    ngpu_block_desc_init(gpu_ctx, &s->direction_block_desc, NGPU_BLOCK_LAYOUT_STD140);
-    ngpu_block_desc_add_field(&s->direction_block_desc, "direction", NGPU_TYPE_VEC2, 0);
-    s->direction_block_size = ngpu_block_desc_get_size(&s->direction_block_desc, 0);
-    ngli_assert(s->direction_block_size == sizeof(struct direction_block));
-    s->direction_block_aligned_size = ngpu_block_desc_get_aligned_size(&s->direction_block_desc, 0);
+    s->pl_lin = ngli_pipeline_compat_create(ctx->gpu_ctx);
+    if (!s->pl_lin)
+        return NGL_ERROR_MEMORY;
 
-    ngpu_block_desc_init(gpu_ctx, &s->kernel_block_desc, NGPU_BLOCK_LAYOUT_STD140);
-    ngpu_block_desc_add_field(&s->kernel_block_desc, "weights", NGPU_TYPE_VEC2, MAX_KERNEL_SIZE);
-    ngpu_block_desc_add_field(&s->kernel_block_desc, "nb_weights", NGPU_TYPE_I32, 0);
-    s->kernel_block_size = ngpu_block_desc_get_size(&s->kernel_block_desc, 0);
+    return setup_pipeline(ctx, s->lin_crafter, s->pl_lin, &s->lin_layout);
+}
 
-    int ret;
+static int craft_blur_program(struct ngl_node *node, struct ngpu_pgcraft *crafter, const char *defines)
+{
+    struct ngl_ctx *ctx = node->ctx;
+    struct gblur_priv *s = node->priv_data;
 
     const struct ngpu_pgcraft_iovar vert_out_vars[] = {
         {.name = "tex_coord", .type = NGPU_TYPE_VEC2},
@@ -325,10 +363,21 @@ static int gblur_init(struct ngl_node *node)
         },
     };
 
+    struct bstr *frag = ngli_bstr_create();
+    if (!frag)
+        return NGL_ERROR_MEMORY;
+
+    ngli_bstr_print(frag, defines);
+    ngli_bstr_print(frag, blur_gaussian_frag);
+    if (ngli_bstr_check(frag) < 0) {
+        ngli_bstr_freep(&frag);
+        return NGL_ERROR_MEMORY;
+    }
+
     const struct ngpu_pgcraft_params crafter_params = {
         .program_label    = "nopegl/gaussian-blur",
         .vert_base        = blur_gaussian_vert,
-        .frag_base        = blur_gaussian_frag,
+        .frag_base        = ngli_bstr_strptr(frag),
         .textures         = textures,
         .nb_textures      = NGLI_ARRAY_NB(textures),
         .blocks           = crafter_blocks,
@@ -336,24 +385,102 @@ static int gblur_init(struct ngl_node *node)
         .vert_out_vars    = vert_out_vars,
         .nb_vert_out_vars = NGLI_ARRAY_NB(vert_out_vars),
     };
-    s->crafter = ngpu_pgcraft_create(gpu_ctx);
-    if (!s->crafter)
+
+    int ret = ngpu_pgcraft_craft(crafter, &crafter_params);
+    ngli_bstr_freep(&frag);
+    return ret;
+}
+
+static int gblur_init(struct ngl_node *node)
+{
+    struct ngl_ctx *ctx = node->ctx;
+    struct ngpu_ctx *gpu_ctx = ctx->gpu_ctx;
+    struct gblur_priv *s = node->priv_data;
+    const struct gblur_opts *o = node->opts;
+
+    struct texture_info *src_info = o->source->priv_data;
+    s->image = &src_info->image;
+    s->image_rev = SIZE_MAX;
+
+    /* Disable direct rendering */
+    src_info->supported_image_layouts = NGLI_IMAGE_LAYOUT_DEFAULT_BIT;
+
+    /* Override texture params */
+    src_info->params.min_filter = NGPU_FILTER_LINEAR;
+    src_info->params.mag_filter = NGPU_FILTER_LINEAR;
+    src_info->params.wrap_s     = NGPU_WRAP_MIRRORED_REPEAT,
+    src_info->params.wrap_t     = NGPU_WRAP_MIRRORED_REPEAT,
+
+    /*
+     * When a floating point format is available, the source is decoded once
+     * to a linear intermediate so that the blur passes do not have to apply
+     * the sRGB transfer functions on every kernel tap: the horizontal pass
+     * then works entirely in linear space and the vertical pass only encodes
+     * its output.
+     */
+    s->linear_format = get_linear_format(gpu_ctx);
+    if (s->linear_format != NGPU_FORMAT_UNDEFINED) {
+        s->lin_layout.colors[0].format = s->linear_format;
+        s->lin_layout.nb_colors = 1;
+    }
+
+    const enum ngpu_format tmp_format = s->linear_format != NGPU_FORMAT_UNDEFINED ? s->linear_format
+                                                                                  : src_info->params.format;
+    s->tmp_layout.colors[s->tmp_layout.nb_colors].format = tmp_format;
+    s->tmp_layout.nb_colors++;
+
+    struct texture_info *dst_info = o->destination->priv_data;
+    dst_info->params.usage |= NGPU_TEXTURE_USAGE_COLOR_ATTACHMENT_BIT;
+
+    s->dst_is_resizable = (dst_info->params.width == 0 && dst_info->params.height == 0);
+    s->dst_layout.colors[0].format = dst_info->params.format;
+    s->dst_layout.nb_colors = 1;
+
+    ngpu_block_desc_init(gpu_ctx, &s->direction_block_desc, NGPU_BLOCK_LAYOUT_STD140);
+    ngpu_block_desc_add_field(&s->direction_block_desc, "direction", NGPU_TYPE_VEC2, 0);
+    s->direction_block_size = ngpu_block_desc_get_size(&s->direction_block_desc, 0);
+    ngli_assert(s->direction_block_size == sizeof(struct direction_block));
+    s->direction_block_aligned_size = ngpu_block_desc_get_aligned_size(&s->direction_block_desc, 0);
+
+    ngpu_block_desc_init(gpu_ctx, &s->kernel_block_desc, NGPU_BLOCK_LAYOUT_STD140);
+    ngpu_block_desc_add_field(&s->kernel_block_desc, "weights", NGPU_TYPE_VEC2, MAX_KERNEL_SIZE);
+    ngpu_block_desc_add_field(&s->kernel_block_desc, "nb_weights", NGPU_TYPE_I32, 0);
+    s->kernel_block_size = ngpu_block_desc_get_size(&s->kernel_block_desc, 0);
+
+    int ret;
+
+    if (s->linear_format != NGPU_FORMAT_UNDEFINED) {
+        ret = setup_linearize_program(node);
+        if (ret < 0)
+            return ret;
+    }
+
+    const int linear = s->linear_format != NGPU_FORMAT_UNDEFINED;
+    const char *defines_h = linear ? "#define NGLI_BLUR_LINEAR_INPUT\n#define NGLI_BLUR_LINEAR_OUTPUT\n" : "";
+    const char *defines_v = linear ? "#define NGLI_BLUR_LINEAR_INPUT\n" : "";
+
+    s->crafter_h = ngpu_pgcraft_create(gpu_ctx);
+    s->crafter_v = ngpu_pgcraft_create(gpu_ctx);
+    if (!s->crafter_h || !s->crafter_v)
         return NGL_ERROR_MEMORY;
 
-    ret = ngpu_pgcraft_craft(s->crafter, &crafter_params);
-    if (ret < 0)
+    if ((ret = craft_blur_program(node, s->crafter_h, defines_h)) < 0 ||
+        (ret = craft_blur_program(node, s->crafter_v, defines_v)) < 0)
         return ret;
 
-    s->direction_block_index = ngpu_pgcraft_get_block_index(s->crafter, "direction", NGPU_PROGRAM_STAGE_FRAG);
-    s->kernel_block_index = ngpu_pgcraft_get_block_index(s->crafter, "kernel", NGPU_PROGRAM_STAGE_FRAG);
+    /* Both programs share the same resource layout */
+    s->direction_block_index = ngpu_pgcraft_get_block_index(s->crafter_h, "direction", NGPU_PROGRAM_STAGE_FRAG);
+    s->kernel_block_index = ngpu_pgcraft_get_block_index(s->crafter_h, "kernel", NGPU_PROGRAM_STAGE_FRAG);
+    ngli_assert(s->direction_block_index == ngpu_pgcraft_get_block_index(s->crafter_v, "direction", NGPU_PROGRAM_STAGE_FRAG));
+    ngli_assert(s->kernel_block_index == ngpu_pgcraft_get_block_index(s->crafter_v, "kernel", NGPU_PROGRAM_STAGE_FRAG));
 
     s->pl_blur_h = ngli_pipeline_compat_create(gpu_ctx);
     s->pl_blur_v = ngli_pipeline_compat_create(gpu_ctx);
     if (!s->pl_blur_h || !s->pl_blur_v)
         return NGL_ERROR_MEMORY;
 
-    if ((ret = setup_pipeline(ctx, s->crafter, s->pl_blur_h, &s->tmp_layout)) < 0 ||
-        (ret = setup_pipeline(ctx, s->crafter, s->pl_blur_v, &s->dst_layout)) < 0)
+    if ((ret = setup_pipeline(ctx, s->crafter_h, s->pl_blur_h, &s->tmp_layout)) < 0 ||
+        (ret = setup_pipeline(ctx, s->crafter_v, s->pl_blur_v, &s->dst_layout)) < 0)
         return ret;
 
     return 0;
@@ -376,12 +503,14 @@ static int resize(struct ngl_node *node)
         return 0;
 
     /* Assert that the source texture format does not change */
-    ngli_assert(src_info->params.format == s->tmp_layout.colors[0].format);
+    ngli_assert(s->linear_format != NGPU_FORMAT_UNDEFINED ||
+                src_info->params.format == s->tmp_layout.colors[0].format);
 
     /* Assert that the destination texture format does not change */
     struct texture_info *dst_info = o->destination->priv_data;
     ngli_assert(dst_info->params.format == s->dst_layout.colors[0].format);
 
+    struct rtt_ctx *lin = NULL;
     struct rtt_ctx *tmp = NULL;
 
     struct ngpu_texture *dst = NULL;
@@ -389,7 +518,7 @@ static int resize(struct ngl_node *node)
 
     const struct ngpu_texture_params texture_params = {
         .type          = NGPU_TEXTURE_TYPE_2D,
-        .format        = src_info->params.format,
+        .format        = s->tmp_layout.colors[0].format,
         .width         = width,
         .height        = height,
         .min_filter    = NGPU_FILTER_LINEAR,
@@ -400,6 +529,18 @@ static int resize(struct ngl_node *node)
                          NGPU_TEXTURE_USAGE_SAMPLED_BIT,
     };
 
+    if (s->linear_format != NGPU_FORMAT_UNDEFINED) {
+        lin = ngli_rtt_create(ctx);
+        if (!lin) {
+            ret = NGL_ERROR_MEMORY;
+            goto fail;
+        }
+
+        ret = ngli_rtt_from_texture_params(lin, &texture_params);
+        if (ret < 0)
+            goto fail;
+    }
+
     tmp = ngli_rtt_create(ctx);
     if (!tmp) {
         ret = NGL_ERROR_MEMORY;
@@ -426,6 +567,9 @@ static int resize(struct ngl_node *node)
             goto fail;
     }
 
+    ngli_rtt_freep(&s->lin);
+    s->lin = lin;
+
     ngli_rtt_freep(&s->tmp);
     s->tmp = tmp;
 
@@ -471,6 +615,7 @@ static int resize(struct ngl_node *node)
     return 0;
 
 fail:
+    ngli_rtt_freep(&lin);
     ngli_rtt_freep(&tmp);
 
     ngli_rtt_freep(&dst_rtt_ctx);
@@ -507,11 +652,21 @@ static void gblur_pre_draw(struct ngl_node *node)
     ngli_pipeline_compat_update_buffer(s->pl_blur_v, s->direction_block_index,
                                        buffer, dir_h_offset, s->direction_block_size);
 
+    const struct image *image = s->image;
+    if (s->lin) {
+        ngli_rtt_begin(s->lin);
+        ngpu_ctx_begin_render_pass(gpu_ctx, ctx->current_rendertarget);
+        ngli_pipeline_compat_update_image(s->pl_lin, 0, s->image, ctx->current_staging_buffer);
+        ngli_pipeline_compat_draw(s->pl_lin, 3, 1, 0);
+        ngli_rtt_end(s->lin);
+        image = ngli_rtt_get_image(s->lin, 0);
+    }
+
     ngli_rtt_begin(s->tmp);
     ngpu_ctx_begin_render_pass(gpu_ctx, ctx->current_rendertarget);
     uint32_t offset = 0;
     ngli_pipeline_compat_update_dynamic_offsets(s->pl_blur_h, &offset, 1);
-    ngli_pipeline_compat_update_image(s->pl_blur_h, 0, s->image, ctx->current_staging_buffer);
+    ngli_pipeline_compat_update_image(s->pl_blur_h, 0, image, ctx->current_staging_buffer);
     ngli_pipeline_compat_draw(s->pl_blur_h, 3, 1, 0);
     ngli_rtt_end(s->tmp);
 
@@ -528,6 +683,7 @@ static void gblur_release(struct ngl_node *node)
 {
     struct gblur_priv *s = node->priv_data;
 
+    ngli_rtt_freep(&s->lin);
     ngli_rtt_freep(&s->tmp);
     ngli_rtt_freep(&s->dst_rtt_ctx);
 }
@@ -539,9 +695,12 @@ static void gblur_uninit(struct ngl_node *node)
     ngli_freep(&s->kernel_staging_cache);
     ngpu_block_desc_reset(&s->direction_block_desc);
     ngpu_block_desc_reset(&s->kernel_block_desc);
+    ngli_pipeline_compat_freep(&s->pl_lin);
     ngli_pipeline_compat_freep(&s->pl_blur_h);
     ngli_pipeline_compat_freep(&s->pl_blur_v);
-    ngpu_pgcraft_freep(&s->crafter);
+    ngpu_pgcraft_freep(&s->lin_crafter);
+    ngpu_pgcraft_freep(&s->crafter_h);
+    ngpu_pgcraft_freep(&s->crafter_v);
 }
 
 const struct node_class ngli_gblur_class = {
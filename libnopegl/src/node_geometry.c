@@ -110,20 +110,20 @@ static int geometry_init(struct ngl_node *node)
     struct buffer_info *vertices = o->vertices->priv_data;
     ngli_geometry_set_vertices_buffer(s->geom, vertices->buffer, vertices->layout);
     ngli_node_buffer_extend_usage(o->vertices, NGPU_BUFFER_USAGE_VERTEX_BUFFER_BIT);
-    vertices->flags |= NGLI_BUFFER_INFO_FLAG_GPU_UPLOAD;
+    vertices->flags |= NGLI_BUFFER_INFO_FLAG_GPU_UPLOAD | NGLI_BUFFER_INFO_FLAG_FIXED;
 
     if (o->uvcoords) {
         struct buffer_info *uvcoords = o->uvcoords->priv_data;
         ngli_geometry_set_uvcoords_buffer(s->geom, uvcoords->buffer, uvcoords->layout);
         ngli_node_buffer_extend_usage(o->uvcoords, NGPU_BUFFER_USAGE_VERTEX_BUFFER_BIT);
-        uvcoords->flags |= NGLI_BUFFER_INFO_FLAG_GPU_UPLOAD;
+        uvcoords->flags |= NGLI_BUFFER_INFO_FLAG_GPU_UPLOAD | NGLI_BUFFER_INFO_FLAG_FIXED;
     }
 
     if (o->normals) {
         struct buffer_info *normals = o->normals->priv_data;
         ngli_geometry_set_normals_buffer(s->geom, normals->buffer, normals->layout);
         ngli_node_buffer_extend_usage(o->normals, NGPU_BUFFER_USAGE_VERTEX_BUFFER_BIT);
-        normals->flags |= NGLI_BUFFER_INFO_FLAG_GPU_UPLOAD;
+        normals->flags |= NGLI_BUFFER_INFO_FLAG_GPU_UPLOAD | NGLI_BUFFER_INFO_FLAG_FIXED;
     }
 
     if (o->indices) {
@@ -134,7 +134,7 @@ static int geometry_init(struct ngl_node *node)
         }
 
         ngli_node_buffer_extend_usage(o->indices, NGPU_BUFFER_USAGE_INDEX_BUFFER_BIT);
-        indices->flags |= NGLI_BUFFER_INFO_FLAG_GPU_UPLOAD;
+        indices->flags |= NGLI_BUFFER_INFO_FLAG_GPU_UPLOAD | NGLI_BUFFER_INFO_FLAG_FIXED;
 
         int64_t max_indices = 0;
         switch (indices->layout.format) {
@@ -25,6 +25,7 @@
 #include "internal.h"
 #include "log.h"
 #include "node2d.h"
+#include "node_drawrect2d.h"
 #include "node_uniform.h"
 #include "nopegl/nopegl.h"
 
@@ -124,7 +125,9 @@ static int group2d_prepare(struct ngl_node *node,
                            const struct ngpu_graphics_state *graphics_state,
                            const struct ngpu_rendertarget_layout *rendertarget_layout)
 {
-    return 0;
+    const struct group2d_opts *o = node->opts;
+    return ngli_drawrect2d_prepare_batches(o->children, o->nb_children,
+                                           graphics_state, rendertarget_layout);
 }
 
 static void group2d_pre_draw(struct ngl_node *node)
@@ -213,6 +216,7 @@ static void group2d_draw(struct ngl_node *node)
 
     /* Draw children */
     for (size_t i = 0; i < o->nb_children; i++) {
+        ngli_drawrect2d_draw_batch(&o->children[i], o->nb_children - i);
         ngli_node_draw(o->children[i]);
     }
 
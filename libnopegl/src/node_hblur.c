@@ -34,6 +34,7 @@
 #include "pipeline_compat.h"
 #include "rtt.h"
 #include <ngpu/ngpu.h>
+#include "utils/bstr.h"
 #include "utils/utils.h"
 
 /* GLSL shaders */
@@ -72,6 +73,7 @@ struct hblur_priv {
     size_t blur_block_size;
 
     enum ngpu_format preferred_format;
+    int linear_intermediates;
     struct ngpu_texture *tex0;
     struct ngpu_texture *tex1;
 
@@ -223,10 +225,22 @@ static int setup_pass1_pipeline(struct ngl_node *node)
     if (!s->pass1.crafter)
         return NGL_ERROR_MEMORY;
 
+    struct bstr *frag = ngli_bstr_create();
+    if (!frag)
+        return NGL_ERROR_MEMORY;
+
+    if (s->linear_intermediates)
+        ngli_bstr_print(frag, "#define NGLI_BLUR_LINEAR_OUTPUT\n");
+    ngli_bstr_print(frag, blur_hexagonal_pass1_frag);
+    if (ngli_bstr_check(frag) < 0) {
+        ngli_bstr_freep(&frag);
+        return NGL_ERROR_MEMORY;
+    }
+
     const struct ngpu_pgcraft_params crafter_params = {
         .program_label    = "nopegl/hexagonal-blur-pass1",
         .vert_base        = blur_hexagonal_vert,
-        .frag_base        = blur_hexagonal_pass1_frag,
+        .frag_base        = ngli_bstr_strptr(frag),
         .textures         = textures,
         .nb_textures      = NGLI_ARRAY_NB(textures),
         .blocks           = blocks,
@@ -237,6 +251,7 @@ static int setup_pass1_pipeline(struct ngl_node *node)
     };
 
     int ret = ngpu_pgcraft_craft(s->pass1.crafter, &crafter_params);
+    ngli_bstr_freep(&frag);
     if (ret < 0)
         return ret;
 
@@ -318,10 +333,22 @@ static int setup_pass2_pipeline(struct ngl_node *node)
         },
     };
 
+    struct bstr *frag = ngli_bstr_create();
+    if (!frag)
+        return NGL_ERROR_MEMORY;
+
+    if (s->linear_intermediates)
+        ngli_bstr_print(frag, "#define NGLI_BLUR_LINEAR_INPUT\n");
+    ngli_bstr_print(frag, blur_hexagonal_pass2_frag);
+    if (ngli_bstr_check(frag) < 0) {
+        ngli_bstr_freep(&frag);
+        return NGL_ERROR_MEMORY;
+    }
+
     const struct ngpu_pgcraft_params crafter_params = {
         .program_label    = "nopegl/hexagonal-blur-pass2",
         .vert_base        = blur_hexagonal_vert,
-        .frag_base        = blur_hexagonal_pass2_frag,
+        .frag_base        = ngli_bstr_strptr(frag),
         .textures         = textures,
         .nb_textures      = NGLI_ARRAY_NB(textures),
         .blocks           = crafter_blocks,
@@ -331,10 +358,13 @@ static int setup_pass2_pipeline(struct ngl_node *node)
     };
 
     s->pass2.crafter = ngpu_pgcraft_create(gpu_ctx);
-    if (!s->pass2.crafter)
+    if (!s->pass2.crafter) {
+        ngli_bstr_freep(&frag);
         return NGL_ERROR_MEMORY;
+    }
 
     int ret = ngpu_pgcraft_craft(s->pass2.crafter, &crafter_params);
+    ngli_bstr_freep(&frag);
     if (ret < 0)
         return ret;
 
@@ -403,6 +433,13 @@ static int hblur_init(struct ngl_node *node)
 
     s->preferred_format = get_preferred_format(ctx->gpu_ctx);
 
+    /*
+     * Floating point intermediates can hold linear values without losing
+     * precision, which allows pass1 to skip the sRGB encoding and pass2 the
+     * sRGB decoding of every sample.
+     */
+    s->linear_intermediates = s->preferred_format != NGPU_FORMAT_R8G8B8A8_UNORM;
+
     struct texture_info *dst_info = o->destination->priv_data;
     dst_info->params.usage |= NGPU_TEXTURE_USAGE_COLOR_ATTACHMENT_BIT;
 
@@ -492,6 +492,6 @@ const struct node_class ngli_media_class = {
     .opts_size = sizeof(struct media_opts),
     .priv_size = sizeof(struct media_priv),
     .params    = media_params,
-    .flags     = NGLI_NODE_FLAG_SHAREABLE,
+    .flags     = NGLI_NODE_FLAG_SHAREABLE | NGLI_NODE_FLAG_TIME_DEPENDENT,
     .file      = __FILE__,
 };
@@ -86,22 +86,22 @@ static int noisevec_update(struct ngl_node *node, double t, size_t n)
     return 0;
 }
 
-static int noisefloat_update(struct ngl_node *node, double t)
+static int noisefloat_cpu_update(struct ngl_node *node, double t)
 {
     return noisevec_update(node, t, 1);
 }
 
-static int noisevec2_update(struct ngl_node *node, double t)
+static int noisevec2_cpu_update(struct ngl_node *node, double t)
 {
     return noisevec_update(node, t, 2);
 }
 
-static int noisevec3_update(struct ngl_node *node, double t)
+static int noisevec3_cpu_update(struct ngl_node *node, double t)
 {
     return noisevec_update(node, t, 3);
 }
 
-static int noisevec4_update(struct ngl_node *node, double t)
+static int noisevec4_cpu_update(struct ngl_node *node, double t)
 {
     return noisevec_update(node, t, 4);
 }
@@ -143,12 +143,13 @@ const struct node_class ngli_noise##type##_class = {                        \
     .category  = NGLI_NODE_CATEGORY_VARIABLE,                               \
     .name      = class_name,                                                \
     .init      = noise##type##_init,                                        \
-    .update    = noise##type##_update,                                      \
+    .cpu_update = noise##type##_cpu_update,                                 \
     .opts_size = sizeof(struct noise_opts),                                 \
     .priv_size = sizeof(struct noise_priv),                                 \
     .params    = noise_params,                                              \
     .params_id = "Noise",                                                   \
-    .flags     = NGLI_NODE_FLAG_SHAREABLE,                                  \
+    .flags     = NGLI_NODE_FLAG_SHAREABLE |                                 \
+                 NGLI_NODE_FLAG_TIME_DEPENDENT,                             \
     .file      = __FILE__,                                                  \
 };
 
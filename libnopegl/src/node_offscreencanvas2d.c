@@ -55,6 +55,7 @@ struct offscreencanvas2d_priv {
     struct ngpu_rendertarget_layout layout;
     struct rtt_params rtt_params;
     struct rtt_ctx *rtt_ctx;
+    struct rtt_cache cache;
 };
 
 #define OFFSET(x) offsetof(struct offscreencanvas2d_opts, x)
@@ -130,6 +131,15 @@ static struct rtt_texture_info get_rtt_texture_info(struct ngl_node *node)
     return (struct rtt_texture_info){node, info, 0, nb_layers};
 }
 
+static void mark_texture_changed(struct ngl_node *node)
+{
+    if (node->cls->id == NGL_NODE_TEXTUREVIEW) {
+        const struct textureview_opts *v = node->opts;
+        ngli_node_mark_changed(v->texture);
+    }
+    ngli_node_mark_changed(node);
+}
+
 static int offscreencanvas2d_init(struct ngl_node *node)
 {
     struct ngl_ctx *ctx = node->ctx;
@@ -403,6 +413,18 @@ static void offscreencanvas2d_pre_draw(struct ngl_node *node)
             return;
     }
 
+    /* Reuse the previous render if none of its inputs changed */
+    bool time_dependent = false;
+    for (size_t i = 0; i < o->nb_children; i++)
+        time_dependent |= o->children[i]->time_dependent;
+    const struct rtt_cache_key key = {
+        .viewport         = ctx->viewport,
+        .canvas_2d_width  = ctx->canvas_2d_width,
+        .canvas_2d_height = ctx->canvas_2d_height,
+    };
+    if (ngli_rtt_cache_begin(&s->cache, node, time_dependent, &key))
+        return;
+
     /* Pre-draw children */
     for (size_t i = 0; i < o->nb_children; i++)
         ngli_node_pre_draw(o->children[i]);
@@ -440,6 +462,14 @@ static void offscreencanvas2d_pre_draw(struct ngl_node *node)
 
     ngli_rtt_end(s->rtt_ctx);
 
+    /* Notify the users of the destination textures that their content changed */
+    for (size_t i = 0; i < o->nb_color_textures; i++)
+        mark_texture_changed(o->color_textures[i]);
+    if (o->depth_texture)
+        mark_texture_changed(o->depth_texture);
+
+    ngli_rtt_cache_end(&s->cache, node);
+
 restore:
     /* Restore previous 2D state */
     ngli_darray_reset(&ctx->transform_2d_stack);
@@ -457,6 +487,7 @@ static void offscreencanvas2d_release(struct ngl_node *node)
 {
     struct offscreencanvas2d_priv *s = node->priv_data;
     ngli_rtt_freep(&s->rtt_ctx);
+    ngli_rtt_cache_reset(&s->cache);
 }
 
 static void offscreencanvas2d_uninit(struct ngl_node *node)
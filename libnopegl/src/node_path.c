@@ -24,9 +24,12 @@
 #include <string.h>
 
 #include "internal.h"
+#include "node_path.h"
 #include "node_pathkey.h"
+#include "node_uniform.h"
 #include "nopegl/nopegl.h"
 #include "path.h"
+#include "utils/memory.h"
 
 struct path_opts {
     struct ngl_node **keyframes;
@@ -36,6 +39,9 @@ struct path_opts {
 
 struct path_priv {
     struct path *path;
+    bool dynamic;
+    float (*points)[3];
+    size_t nb_points;
 };
 
 #define OFFSET(x) offsetof(struct path_opts, x)
@@ -59,30 +65,99 @@ static const struct node_param path_params[] = {
 /* We must have the struct path in 1st position for AnimatedPath */
 NGLI_STATIC_ASSERT(offsetof(struct path_priv, path) == 0, "path 1st field");
 
-static int path_init(struct ngl_node *node)
+/*
+ * Fill dst with the current value of every point of the keyframe, and return
+ * the number of points. nodes is optional and receives the nodes associated
+ * with each point (if any).
+ */
+static size_t get_keyframe_points(const struct ngl_node *kf, const float **dst, const struct ngl_node **nodes)
+{
+    const struct ngl_node *point_nodes[3] = {0};
+    size_t nb_points = 0;
+
+    if (kf->cls->id == NGL_NODE_PATHKEYMOVE) {
+        const struct pathkey_move_opts *move = kf->opts;
+        point_nodes[0] = move->to_node;
+        dst[0] = ngli_node_get_data_ptr(move->to_node, move->to);
+        nb_points = 1;
+    } else if (kf->cls->id == NGL_NODE_PATHKEYLINE) {
+        const struct pathkey_line_opts *line = kf->opts;
+        point_nodes[0] = line->to_node;
+        dst[0] = ngli_node_get_data_ptr(line->to_node, line->to);
+        nb_points = 1;
+    } else if (kf->cls->id == NGL_NODE_PATHKEYBEZIER2) {
+        const struct pathkey_bezier2_opts *bezier2 = kf->opts;
+        point_nodes[0] = bezier2->control_node;
+        point_nodes[1] = bezier2->to_node;
+        dst[0] = ngli_node_get_data_ptr(bezier2->control_node, bezier2->control);
+        dst[1] = ngli_node_get_data_ptr(bezier2->to_node, bezier2->to);
+        nb_points = 2;
+    } else if (kf->cls->id == NGL_NODE_PATHKEYBEZIER3) {
+        const struct pathkey_bezier3_opts *bezier3 = kf->opts;
+        point_nodes[0] = bezier3->control1_node;
+        point_nodes[1] = bezier3->control2_node;
+        point_nodes[2] = bezier3->to_node;
+        dst[0] = ngli_node_get_data_ptr(bezier3->control1_node, bezier3->control1);
+        dst[1] = ngli_node_get_data_ptr(bezier3->control2_node, bezier3->control2);
+        dst[2] = ngli_node_get_data_ptr(bezier3->to_node, bezier3->to);
+        nb_points = 3;
+    } else if (kf->cls->id != NGL_NODE_PATHKEYCLOSE) {
+        ngli_assert(0);
+    }
+
+    if (nodes)
+        memcpy(nodes, point_nodes, nb_points * sizeof(*nodes));
+    return nb_points;
+}
+
+/*
+ * Copy the current value of all the key points into the private points
+ * array, and return whether any of them changed.
+ */
+static bool sync_points(struct ngl_node *node)
+{
+    struct path_priv *s = node->priv_data;
+    const struct path_opts *o = node->opts;
+
+    bool changed = false;
+    float (*dst)[3] = s->points;
+    for (size_t i = 0; i < o->nb_keyframes; i++) {
+        const float *points[3];
+        const size_t nb_points = get_keyframe_points(o->keyframes[i], points, NULL);
+        for (size_t j = 0; j < nb_points; j++) {
+            if (memcmp(*dst, points[j], sizeof(*dst))) {
+                memcpy(*dst, points[j], sizeof(*dst));
+                changed = true;
+            }
+            dst++;
+        }
+    }
+    return changed;
+}
+
+static int build_path(struct ngl_node *node)
 {
     int ret;
     struct path_priv *s = node->priv_data;
     const struct path_opts *o = node->opts;
 
-    s->path = ngli_path_create();
-    if (!s->path)
-        return NGL_ERROR_MEMORY;
+    ngli_path_clear(s->path);
 
+    const float (*p)[3] = (const float (*)[3])s->points;
     for (size_t i = 0; i < o->nb_keyframes; i++) {
         const struct ngl_node *kf = o->keyframes[i];
         if (kf->cls->id == NGL_NODE_PATHKEYMOVE) {
-            const struct pathkey_move_opts *move = kf->opts;
-            ret = ngli_path_move_to(s->path, move->to);
+            ret = ngli_path_move_to(s->path, p[0]);
+            p += 1;
         } else if (kf->cls->id == NGL_NODE_PATHKEYLINE) {
-            const struct pathkey_line_opts *line = kf->opts;
-            ret = ngli_path_line_to(s->path, line->to);
+            ret = ngli_path_line_to(s->path, p[0]);
+            p += 1;
         } else if (kf->cls->id == NGL_NODE_PATHKEYBEZIER2) {
-            const struct pathkey_bezier2_opts *bezier2 = kf->opts;
-            ret = ngli_path_bezier2_to(s->path, bezier2->control, bezier2->to);
+            ret = ngli_path_bezier2_to(s->path, p[0], p[1]);
+            p += 2;
         } else if (kf->cls->id == NGL_NODE_PATHKEYBEZIER3) {
-            const struct pathkey_bezier3_opts *bezier3 = kf->opts;
-            ret = ngli_path_bezier3_to(s->path, bezier3->control1, bezier3->control2, bezier3->to);
+            ret = ngli_path_bezier3_to(s->path, p[0], p[1], p[2]);
+            p += 3;
         } else if (kf->cls->id == NGL_NODE_PATHKEYCLOSE) {
             ret = ngli_path_close(s->path);
         } else {
@@ -99,16 +174,82 @@ static int path_init(struct ngl_node *node)
     return ngli_path_init(s->path, o->precision);
 }
 
+static int path_init(struct ngl_node *node)
+{
+    struct path_priv *s = node->priv_data;
+    const struct path_opts *o = node->opts;
+
+    s->path = ngli_path_create();
+    if (!s->path)
+        return NGL_ERROR_MEMORY;
+
+    for (size_t i = 0; i < o->nb_keyframes; i++) {
+        const float *points[3];
+        const struct ngl_node *nodes[3];
+        const size_t nb_points = get_keyframe_points(o->keyframes[i], points, nodes);
+        for (size_t j = 0; j < nb_points; j++)
+            if (nodes[j])
+                s->dynamic = true;
+        s->nb_points += nb_points;
+    }
+
+    if (s->nb_points) {
+        s->points = ngli_calloc(s->nb_points, sizeof(*s->points));
+        if (!s->points)
+            return NGL_ERROR_MEMORY;
+    }
+
+    sync_points(node);
+
+    return build_path(node);
+}
+
+/*
+ * The path is only rebuilt when one of its key points actually changed, in
+ * which case the node is marked as changed so that users of the geometry
+ * (such as DrawPath) can refresh their derived data.
+ */
+static int path_update(struct ngl_node *node, double t)
+{
+    struct path_priv *s = node->priv_data;
+    if (!s->dynamic)
+        return 0;
+
+    int ret = ngli_node_update_children(node, t);
+    if (ret < 0)
+        return ret;
+
+    if (!sync_points(node))
+        return 0;
+
+    ret = build_path(node);
+    if (ret < 0)
+        return ret;
+
+    ngli_node_mark_changed(node);
+    return 0;
+}
+
+bool ngli_node_path_is_dynamic(const struct ngl_node *node)
+{
+    if (node->cls->id != NGL_NODE_PATH)
+        return false;
+    const struct path_priv *s = node->priv_data;
+    return s->dynamic;
+}
+
 static void path_uninit(struct ngl_node *node)
 {
     struct path_priv *s = node->priv_data;
     ngli_path_freep(&s->path);
+    ngli_freep(&s->points);
 }
 
 const struct node_class ngli_path_class = {
     .id        = NGL_NODE_PATH,
     .name      = "Path",
     .init      = path_init,
+    .update    = path_update,
     .uninit    = path_uninit,
     .opts_size = sizeof(struct path_opts),
     .priv_size = sizeof(struct path_priv),
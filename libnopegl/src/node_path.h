@@ -0,0 +1,36 @@
+/*
+ * Copyright 2026 Matthieu Bouron <matthieu.bouron@gmail.com>
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef NODE_PATH_H
+#define NODE_PATH_H
+
+#include <stdbool.h>
+
+struct ngl_node;
+
+/*
+ * Return whether the path geometry may change after initialization, which
+ * happens when some of its key points are driven by nodes. The path node
+ * change revision is bumped every time its geometry is rebuilt.
+ */
+bool ngli_node_path_is_dynamic(const struct ngl_node *node);
+
+#endif
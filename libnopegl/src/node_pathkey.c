@@ -29,34 +29,41 @@
 
 #define OFFSET_MOVE(x) offsetof(struct pathkey_move_opts, x)
 static const struct node_param pathkey_move_params[] = {
-    {"to", NGLI_PARAM_TYPE_VEC3, OFFSET_MOVE(to),
+    {"to", NGLI_PARAM_TYPE_VEC3, OFFSET_MOVE(to_node),
+           .flags=NGLI_PARAM_FLAG_ALLOW_NODE,
            .desc=NGLI_DOCSTRING("new cursor position")},
     {NULL}
 };
 
 #define OFFSET_LINE(x) offsetof(struct pathkey_line_opts, x)
 static const struct node_param pathkey_line_params[] = {
-    {"to", NGLI_PARAM_TYPE_VEC3, OFFSET_LINE(to),
+    {"to", NGLI_PARAM_TYPE_VEC3, OFFSET_LINE(to_node),
+           .flags=NGLI_PARAM_FLAG_ALLOW_NODE,
            .desc=NGLI_DOCSTRING("end point of the line, new cursor position")},
     {NULL}
 };
 
 #define OFFSET_BEZIER2(x) offsetof(struct pathkey_bezier2_opts, x)
 static const struct node_param pathkey_bezier2_params[] = {
-    {"control", NGLI_PARAM_TYPE_VEC3, OFFSET_BEZIER2(control),
+    {"control", NGLI_PARAM_TYPE_VEC3, OFFSET_BEZIER2(control_node),
+                .flags=NGLI_PARAM_FLAG_ALLOW_NODE,
                 .desc=NGLI_DOCSTRING("control point")},
-    {"to", NGLI_PARAM_TYPE_VEC3, OFFSET_BEZIER2(to),
+    {"to", NGLI_PARAM_TYPE_VEC3, OFFSET_BEZIER2(to_node),
+           .flags=NGLI_PARAM_FLAG_ALLOW_NODE,
            .desc=NGLI_DOCSTRING("end point of the curve, new cursor position")},
     {NULL}
 };
 
 #define OFFSET_BEZIER3(x) offsetof(struct pathkey_bezier3_opts, x)
 static const struct node_param pathkey_bezier3_params[] = {
-    {"control1", NGLI_PARAM_TYPE_VEC3, OFFSET_BEZIER3(control1),
+    {"control1", NGLI_PARAM_TYPE_VEC3, OFFSET_BEZIER3(control1_node),
+                 .flags=NGLI_PARAM_FLAG_ALLOW_NODE,
                  .desc=NGLI_DOCSTRING("first control point")},
-    {"control2", NGLI_PARAM_TYPE_VEC3, OFFSET_BEZIER3(control2),
+    {"control2", NGLI_PARAM_TYPE_VEC3, OFFSET_BEZIER3(control2_node),
+                 .flags=NGLI_PARAM_FLAG_ALLOW_NODE,
                  .desc=NGLI_DOCSTRING("second control point")},
-    {"to",       NGLI_PARAM_TYPE_VEC3, OFFSET_BEZIER3(to),
+    {"to",       NGLI_PARAM_TYPE_VEC3, OFFSET_BEZIER3(to_node),
+                 .flags=NGLI_PARAM_FLAG_ALLOW_NODE,
                  .desc=NGLI_DOCSTRING("end point of the curve, new cursor position")},
     {NULL}
 };
@@ -94,6 +101,7 @@ const struct node_class ngli_pathkeymove_class = {
     .id        = NGL_NODE_PATHKEYMOVE,
     .name      = "PathKeyMove",
     .info_str  = pathkey_info_str,
+    .update    = ngli_node_update_children,
     .opts_size = sizeof(struct pathkey_move_opts),
     .params    = pathkey_move_params,
     .flags     = NGLI_NODE_FLAG_SHAREABLE,
@@ -104,6 +112,7 @@ const struct node_class ngli_pathkeyline_class = {
     .id        = NGL_NODE_PATHKEYLINE,
     .name      = "PathKeyLine",
     .info_str  = pathkey_info_str,
+    .update    = ngli_node_update_children,
     .opts_size = sizeof(struct pathkey_line_opts),
     .params    = pathkey_line_params,
     .flags     = NGLI_NODE_FLAG_SHAREABLE,
@@ -114,6 +123,7 @@ const struct node_class ngli_pathkeybezier2_class = {
     .id        = NGL_NODE_PATHKEYBEZIER2,
     .name      = "PathKeyBezier2",
     .info_str  = pathkey_info_str,
+    .update    = ngli_node_update_children,
     .opts_size = sizeof(struct pathkey_bezier2_opts),
     .params    = pathkey_bezier2_params,
     .flags     = NGLI_NODE_FLAG_SHAREABLE,
@@ -124,6 +134,7 @@ const struct node_class ngli_pathkeybezier3_class = {
     .id        = NGL_NODE_PATHKEYBEZIER3,
     .name      = "PathKeyBezier3",
     .info_str  = pathkey_info_str,
+    .update    = ngli_node_update_children,
     .opts_size = sizeof(struct pathkey_bezier3_opts),
     .params    = pathkey_bezier3_params,
     .flags     = NGLI_NODE_FLAG_SHAREABLE,
@@ -56,6 +56,7 @@ struct rtt_priv {
     struct ngpu_rendertarget_layout layout;
     struct rtt_params rtt_params;
     struct rtt_ctx *rtt_ctx;
+    struct rtt_cache cache;
 };
 
 #define OFFSET(x) offsetof(struct rtt_opts, x)
@@ -459,6 +460,17 @@ static void rtt_pre_draw(struct ngl_node *node)
             return;
     }
 
+    struct rtt_cache_key key = {.viewport = ctx->viewport};
+    if (o->forward_transforms) {
+        const struct ngli_mat4 *modelview_matrix = ngli_darray_tail(&ctx->modelview_matrix_stack);
+        const struct ngli_mat4 *projection_matrix = ngli_darray_tail(&ctx->projection_matrix_stack);
+        memcpy(key.modelview_matrix, modelview_matrix->m, sizeof(key.modelview_matrix));
+        memcpy(key.projection_matrix, projection_matrix->m, sizeof(key.projection_matrix));
+    }
+
+    if (ngli_rtt_cache_begin(&s->cache, node, o->child->time_dependent, &key))
+        return;
+
     if (!o->forward_transforms) {
         if (ngli_darray_push(&ctx->modelview_matrix_stack, ctx->default_modelview_matrix) < 0 ||
             ngli_darray_push(&ctx->projection_matrix_stack, ctx->default_projection_matrix) < 0)
@@ -475,6 +487,14 @@ static void rtt_pre_draw(struct ngl_node *node)
         ngli_darray_pop(&ctx->modelview_matrix_stack);
         ngli_darray_pop(&ctx->projection_matrix_stack);
     }
+
+    /* Notify the users of the destination textures that their content changed */
+    for (size_t i = 0; i < o->nb_color_textures; i++)
+        ngli_node_mark_changed(get_rtt_texture_info(o->color_textures[i]).node);
+    if (o->depth_texture)
+        ngli_node_mark_changed(get_rtt_texture_info(o->depth_texture).node);
+
+    ngli_rtt_cache_end(&s->cache, node);
 }
 
 static void rtt_draw(struct ngl_node *node)
@@ -485,6 +505,7 @@ static void rtt_release(struct ngl_node *node)
 {
     struct rtt_priv *s = node->priv_data;
     ngli_rtt_freep(&s->rtt_ctx);
+    ngli_rtt_cache_reset(&s->cache);
 }
 
 const struct node_class ngli_rtt_class = {
@@ -31,6 +31,7 @@
 #include "node_buffer.h"
 #include "node_uniform.h"
 #include "nopegl/nopegl.h"
+#include "utils/search.h"
 
 struct streamed_opts {
     struct ngl_node *timestamps;
@@ -82,21 +83,14 @@ DECLARE_STREAMED_PARAMS(vec3,   NGL_NODE_BUFFERVEC3)
 DECLARE_STREAMED_PARAMS(vec4,   NGL_NODE_BUFFERVEC4)
 DECLARE_STREAMED_PARAMS(mat4,   NGL_NODE_BUFFERMAT4)
 
-static size_t get_data_index(const struct ngl_node *node, size_t start, int64_t t64)
+static size_t get_data_index(const struct ngl_node *node, size_t hint, int64_t t64)
 {
     const struct streamed_opts *o = node->opts;
     const struct buffer_info *timestamps_priv = o->timestamps->priv_data;
     const int64_t *timestamps = (int64_t *)timestamps_priv->data;
     const size_t nb_timestamps = timestamps_priv->layout.count;
 
-    size_t ret = SIZE_MAX;
-    for (size_t i = start; i < nb_timestamps; i++) {
-        const int64_t ts = timestamps[i];
-        if (ts > t64)
-            break;
-        ret = i;
-    }
-    return ret;
+    return ngli_search_timestamp(timestamps, nb_timestamps, hint, t64);
 }
 
 static int streamed_update(struct ngl_node *node, double t)
@@ -123,11 +117,8 @@ static int streamed_update(struct ngl_node *node, double t)
 
     const int64_t t64 = llrint(rt * o->timebase[1] / (double)o->timebase[0]);
     size_t index = get_data_index(node, s->last_index, t64);
-    if (index == SIZE_MAX) {
-        index = get_data_index(node, 0, t64);
-        if (index == SIZE_MAX) // the requested time `t` is before the first user timestamp
-            index = 0;
-    }
+    if (index == SIZE_MAX) // the requested time `t` is before the first user timestamp
+        index = 0;
     s->last_index = index;
 
     const struct buffer_info *buffer_info = o->buffer->priv_data;
@@ -219,7 +210,8 @@ const struct node_class ngli_streamed##class_suffix##_class = {             \
     .opts_size = sizeof(struct streamed_opts),                              \
     .priv_size = sizeof(struct streamed_priv),                              \
     .params    = streamed##class_suffix##_params,                           \
-    .flags     = NGLI_NODE_FLAG_SHAREABLE,                                  \
+    .flags     = NGLI_NODE_FLAG_SHAREABLE |                                 \
+                 NGLI_NODE_FLAG_TIME_DEPENDENT,                             \
     .file      = __FILE__,                                                  \
 };                                                                          \
 
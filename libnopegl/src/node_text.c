@@ -98,9 +98,23 @@ struct text_bg_frag_block {
     float opacity;
 };
 
+/*
+ * Fixed part of the foreground vertex block, followed by the effect_timing,
+ * effect_range and effect_anchor vec4 arrays, sized to the number of effects
+ * evaluated on the GPU (a single unused element otherwise)
+ */
 struct text_fg_vert_block {
     struct ngli_mat4 modelview_matrix;
     struct ngli_mat4 projection_matrix;
+    int32_t nb_effects;
+    int32_t effect_chars_rows;
+    int32_t _pad[2];
+};
+
+enum {
+    FG_VERT_FIELD_EFFECT_TIMING = 4,
+    FG_VERT_FIELD_EFFECT_RANGE,
+    FG_VERT_FIELD_EFFECT_ANCHOR,
 };
 
 struct text_fg_frag_block {
@@ -127,6 +141,7 @@ struct text_opts {
     enum text_valign valign;
     enum text_halign halign;
     enum writing_mode writing_mode;
+    int32_t sampled_effects;
 };
 
 struct text_priv {
@@ -144,6 +159,12 @@ struct text_priv {
     struct ngpu_buffer *blurs;
     struct ngpu_buffer *outline_positions;
     size_t nb_chars;
+    size_t effects_dirty_start, effects_dirty_end; // characters with effects data pending upload
+
+    /* effects evaluated in the vertex shader */
+    struct ngpu_texture *effects_lut;
+    struct ngpu_texture *effects_chars;
+    size_t effects_chars_height;
 
     float dist_scale;
 
@@ -254,6 +275,11 @@ static const struct node_param text_params[] = {
     {"writing_mode", NGLI_PARAM_TYPE_SELECT, OFFSET(writing_mode), {.i32=NGLI_TEXT_WRITING_MODE_HORIZONTAL_TB},
                      .choices=&writing_mode_choices,
                      .desc=NGLI_DOCSTRING("direction flow per character and line")},
+    {"sampled_effects", NGLI_PARAM_TYPE_BOOL, OFFSET(sampled_effects), {.i32=0},
+                     .desc=NGLI_DOCSTRING("evaluate the effects in the vertex shader from their parameters sampled once over "
+                                          "the target time and linearly interpolated, instead of evaluating them exactly on "
+                                          "the CPU every frame; this is an approximation (notably for rotations) and it is "
+                                          "ignored when an effect parameter can not be sampled")},
     {NULL}
 };
 
@@ -273,6 +299,113 @@ static void destroy_characters_resources(struct text_priv *s)
     s->nb_chars = 0;
 }
 
+static int update_atlas_textures(struct text_priv *s)
+{
+    const struct text *text = s->text_ctx;
+    struct pipeline_desc_common *desc = &s->pipeline_desc.fg.common;
+    if (!desc->pipeline_compat)
+        return 0;
+
+    int ret;
+    if ((ret = ngli_pipeline_compat_update_texture(desc->pipeline_compat, 0, text->curve_texture)) < 0 ||
+        (ret = ngli_pipeline_compat_update_texture(desc->pipeline_compat, 1, text->band_texture)) < 0)
+        return ret;
+
+    return 0;
+}
+
+static int create_effects_texture(struct ngpu_ctx *gpu_ctx, struct ngpu_texture **texturep,
+                                  uint32_t width, uint32_t height)
+{
+    ngpu_texture_freep(texturep);
+    *texturep = ngpu_texture_create(gpu_ctx);
+    if (!*texturep)
+        return NGL_ERROR_MEMORY;
+
+    const struct ngpu_texture_params tex_params = {
+        .type       = NGPU_TEXTURE_TYPE_2D,
+        .width      = width,
+        .height     = height,
+        .format     = NGPU_FORMAT_R32G32B32A32_SFLOAT,
+        .min_filter = NGPU_FILTER_NEAREST,
+        .mag_filter = NGPU_FILTER_NEAREST,
+        .usage      = NGPU_TEXTURE_USAGE_TRANSFER_DST_BIT | NGPU_TEXTURE_USAGE_SAMPLED_BIT,
+    };
+
+    return ngpu_texture_init(*texturep, &tex_params);
+}
+
+/*
+ * The effects textures always exist so that the program layout is the same
+ * whether the effects are evaluated on the GPU or not; when they are not, 1x1
+ * placeholders are bound and the shader never samples them.
+ */
+static int init_effects_textures(struct ngl_node *node)
+{
+    struct ngpu_ctx *gpu_ctx = node->ctx->gpu_ctx;
+    struct text_priv *s = node->priv_data;
+    const struct text_effects_gpu *gpu = &s->text_ctx->effects_gpu;
+
+    const uint32_t lut_height = (uint32_t)(s->text_ctx->config.nb_effect_nodes * NGLI_TEXT_EFFECTS_LUT_ROWS);
+
+    int ret;
+    if (gpu->enabled)
+        ret = create_effects_texture(gpu_ctx, &s->effects_lut, NGLI_TEXT_EFFECTS_LUT_SIZE, lut_height);
+    else
+        ret = create_effects_texture(gpu_ctx, &s->effects_lut, 1, 1);
+    if (ret < 0)
+        return ret;
+
+    ret = create_effects_texture(gpu_ctx, &s->effects_chars, 1, 1);
+    if (ret < 0)
+        return ret;
+    s->effects_chars_height = 1;
+
+    return 0;
+}
+
+static int update_effects_textures(struct ngl_node *node)
+{
+    struct text_priv *s = node->priv_data;
+    struct text_effects_gpu *gpu = &s->text_ctx->effects_gpu;
+
+    if (!gpu->enabled)
+        return 0;
+
+    int ret;
+    if (gpu->lut_changed) {
+        ret = ngpu_texture_upload(s->effects_lut, (const uint8_t *)gpu->lut, 0);
+        if (ret < 0)
+            return ret;
+        gpu->lut_changed = false;
+    }
+
+    if (gpu->chars_changed && gpu->chars_rows) {
+        const size_t height = s->text_ctx->config.nb_effect_nodes * gpu->chars_rows;
+        if (height != s->effects_chars_height) {
+            ret = create_effects_texture(node->ctx->gpu_ctx, &s->effects_chars,
+                                         NGLI_TEXT_EFFECTS_CHARS_WIDTH, (uint32_t)height);
+            if (ret < 0)
+                return ret;
+            s->effects_chars_height = height;
+
+            struct pipeline_desc_common *desc = &s->pipeline_desc.fg.common;
+            if (desc->pipeline_compat) {
+                ret = ngli_pipeline_compat_update_texture(desc->pipeline_compat, 3, s->effects_chars);
+                if (ret < 0)
+                    return ret;
+            }
+        }
+
+        ret = ngpu_texture_upload(s->effects_chars, (const uint8_t *)gpu->chars, 0);
+        if (ret < 0)
+            return ret;
+        gpu->chars_changed = false;
+    }
+
+    return 0;
+}
+
 static int refresh_pipeline_data(struct ngl_node *node)
 {
     int ret = 0;
@@ -287,7 +420,14 @@ static int refresh_pipeline_data(struct ngl_node *node)
         return 0;
     }
 
+    /* Only the characters that changed since the previous update need an upload */
+    size_t start = text->dirty_start;
+    size_t end = text->dirty_end;
+
     if (text_nbchr > s->nb_chars) { // need re-alloc
+        start = 0;
+        end = text_nbchr;
+
         destroy_characters_resources(s);
 
         /* The content of these buffers will remain constant until the next text content update */
@@ -340,20 +480,25 @@ static int refresh_pipeline_data(struct ngl_node *node)
     }
 
     if (text->cls->flags & NGLI_TEXT_FLAG_MUTABLE_ATLAS) {
-        struct pipeline_desc_fg *desc_fg = &s->pipeline_desc.fg;
-        struct pipeline_desc_common *desc = &desc_fg->common;
-        if (desc->pipeline_compat &&
-            ((ret = ngli_pipeline_compat_update_texture(desc->pipeline_compat, 0, text->curve_texture)) < 0 ||
-             (ret = ngli_pipeline_compat_update_texture(desc->pipeline_compat, 1, text->band_texture)) < 0))
+        ret = update_atlas_textures(s);
+        if (ret < 0)
             return ret;
     }
 
-    if ((ret = ngpu_buffer_upload(s->vertices,        text->data_ptrs.vertices,        0, text_nbchr * 4 * sizeof(float))) < 0 ||
-        (ret = ngpu_buffer_upload(s->atlas_coords,    text->data_ptrs.atlas_coords,    0, text_nbchr * 4 * sizeof(float))) < 0 ||
-        (ret = ngpu_buffer_upload(s->texcoord_bounds, text->data_ptrs.texcoord_bounds, 0, text_nbchr * 4 * sizeof(float))) < 0 ||
-        (ret = ngpu_buffer_upload(s->band_transforms, text->data_ptrs.band_transforms, 0, text_nbchr * 4 * sizeof(float))) < 0 ||
-        (ret = ngpu_buffer_upload(s->glyph_data,      text->data_ptrs.glyph_data,      0, text_nbchr * 4 * sizeof(int32_t))) < 0)
-        return ret;
+    s->effects_dirty_start = NGLI_MIN(s->effects_dirty_start, start);
+    s->effects_dirty_end   = NGLI_MAX(s->effects_dirty_end, end);
+
+    if (start < end) {
+        const struct text_data_pointers *ptrs = &text->data_ptrs;
+        const size_t vec4_offset = start * 4 * sizeof(float);
+        const size_t vec4_size = (end - start) * 4 * sizeof(float);
+        if ((ret = ngpu_buffer_upload(s->vertices,        ptrs->vertices        + start * 4, vec4_offset, vec4_size)) < 0 ||
+            (ret = ngpu_buffer_upload(s->atlas_coords,    ptrs->atlas_coords    + start * 4, vec4_offset, vec4_size)) < 0 ||
+            (ret = ngpu_buffer_upload(s->texcoord_bounds, ptrs->texcoord_bounds + start * 4, vec4_offset, vec4_size)) < 0 ||
+            (ret = ngpu_buffer_upload(s->band_transforms, ptrs->band_transforms + start * 4, vec4_offset, vec4_size)) < 0 ||
+            (ret = ngpu_buffer_upload(s->glyph_data,      ptrs->glyph_data      + start * 4, vec4_offset, vec4_size)) < 0)
+            return ret;
+    }
 
     s->nb_chars = text_nbchr;
 
@@ -372,23 +517,24 @@ static int update_text_content(struct ngl_node *node)
     return refresh_pipeline_data(node);
 }
 
-/* Update the GPU buffers using the updated effects data */
-static int apply_effects(struct text_priv *s)
+/* Update the GPU buffers of the characters in [start,end) using the updated effects data */
+static int apply_effects(struct text_priv *s, size_t start, size_t end)
 {
     int ret;
     struct text *text = s->text_ctx;
 
-    const size_t text_nbchr = text->chars.count;
-    if (!text_nbchr)
+    end = NGLI_MIN(end, text->chars.count);
+    if (start >= end)
         return 0;
 
+    const size_t n = end - start;
     const struct text_data_pointers *ptrs = &text->data_ptrs;
-    if ((ret = ngpu_buffer_upload(s->user_transforms, ptrs->transform, 0, text_nbchr * 4 * 4 * sizeof(*ptrs->transform))) < 0 ||
-        (ret = ngpu_buffer_upload(s->colors, ptrs->color, 0, text_nbchr * 4 * sizeof(*ptrs->color))) < 0 ||
-        (ret = ngpu_buffer_upload(s->outlines, ptrs->outline, 0, text_nbchr * 4 * sizeof(*ptrs->outline))) < 0 ||
-        (ret = ngpu_buffer_upload(s->glows, ptrs->glow, 0, text_nbchr * 4 * sizeof(*ptrs->glow))) < 0 ||
-        (ret = ngpu_buffer_upload(s->blurs, ptrs->blur, 0, text_nbchr * sizeof(*ptrs->blur))) < 0 ||
-        (ret = ngpu_buffer_upload(s->outline_positions, ptrs->outline_pos, 0, text_nbchr * sizeof(*ptrs->outline_pos))) < 0)
+    if ((ret = ngpu_buffer_upload(s->user_transforms, ptrs->transform + start * 4 * 4, start * 4 * 4 * sizeof(float), n * 4 * 4 * sizeof(float))) < 0 ||
+        (ret = ngpu_buffer_upload(s->colors,          ptrs->color     + start * 4,     start * 4 * sizeof(float),     n * 4 * sizeof(float))) < 0 ||
+        (ret = ngpu_buffer_upload(s->outlines,        ptrs->outline   + start * 4,     start * 4 * sizeof(float),     n * 4 * sizeof(float))) < 0 ||
+        (ret = ngpu_buffer_upload(s->glows,           ptrs->glow      + start * 4,     start * 4 * sizeof(float),     n * 4 * sizeof(float))) < 0 ||
+        (ret = ngpu_buffer_upload(s->blurs,           ptrs->blur      + start,         start * sizeof(float),         n * sizeof(float))) < 0 ||
+        (ret = ngpu_buffer_upload(s->outline_positions, ptrs->outline_pos + start,     start * sizeof(float),         n * sizeof(float))) < 0)
         return ret;
 
     return 0;
@@ -427,6 +573,7 @@ static int text_init(struct ngl_node *node)
     const struct text_opts *o = node->opts;
 
     s->viewport = node->ctx->viewport;
+    s->effects_dirty_start = SIZE_MAX;
 
     s->text_ctx = ngli_text_create(node->ctx);
     if (!s->text_ctx)
@@ -446,6 +593,7 @@ static int text_init(struct ngl_node *node)
         .box = {NGLI_ARG_VEC4(o->box)},
         .effect_nodes = o->effect_nodes,
         .nb_effect_nodes = o->nb_effect_nodes,
+        .sampled_effects = o->sampled_effects,
         .defaults = {
             .color = {NGLI_ARG_VEC3(o->fg_color)},
             .opacity = o->fg_opacity,
@@ -462,6 +610,9 @@ static int text_init(struct ngl_node *node)
 
     s->dist_scale = 72.f / (float)(o->pt_size * o->dpi);
 
+    ret = init_effects_textures(node);
+    if (ret < 0)
+        return ret;
 
     ret = init_bounding_box_geometry(node);
     if (ret < 0)
@@ -609,11 +760,23 @@ static int fg_prepare(struct ngl_node *node, struct pipeline_desc_fg *desc,
     struct ngl_ctx *ctx = node->ctx;
     struct ngpu_buffer *staging_buf = ngpu_staging_buffer_get_buffer(ctx->current_staging_buffer);
 
+    /* The atlas may be shared and have been grown by another text since our init */
+    ngli_text_refresh_atlas(s->text_ctx);
+
     /* Initialize vertex block descriptor */
     ngpu_block_desc_init(gpu_ctx, &desc->vert_block_desc, NGPU_BLOCK_LAYOUT_STD140);
     ngpu_block_desc_add_field(&desc->vert_block_desc, "modelview_matrix", NGPU_TYPE_MAT4, 0);
     ngpu_block_desc_add_field(&desc->vert_block_desc, "projection_matrix", NGPU_TYPE_MAT4, 0);
-    ngli_assert(ngpu_block_desc_get_size(&desc->vert_block_desc, 0) == sizeof(struct text_fg_vert_block));
+    ngpu_block_desc_add_field(&desc->vert_block_desc, "nb_effects", NGPU_TYPE_I32, 0);
+    ngpu_block_desc_add_field(&desc->vert_block_desc, "effect_chars_rows", NGPU_TYPE_I32, 0);
+
+    /* Only the effects evaluated on the GPU need the effect arrays */
+    const struct text_effects_gpu *gpu = &s->text_ctx->effects_gpu;
+    const size_t nb_gpu_effects = gpu->enabled ? s->text_ctx->config.nb_effect_nodes : 1;
+    ngpu_block_desc_add_field(&desc->vert_block_desc, "effect_timing", NGPU_TYPE_VEC4, nb_gpu_effects);
+    ngpu_block_desc_add_field(&desc->vert_block_desc, "effect_range", NGPU_TYPE_VEC4, nb_gpu_effects);
+    ngpu_block_desc_add_field(&desc->vert_block_desc, "effect_anchor", NGPU_TYPE_VEC4, nb_gpu_effects);
+    ngli_assert(desc->vert_block_desc.fields[FG_VERT_FIELD_EFFECT_TIMING].offset == sizeof(struct text_fg_vert_block));
 
     const size_t vert_size = ngpu_block_desc_get_size(&desc->vert_block_desc, 0);
 
@@ -658,6 +821,22 @@ static int fg_prepare(struct ngl_node *node, struct pipeline_desc_fg *desc,
             .texture     = s->text_ctx->band_texture,
             .no_metadata = true,
         },
+        {
+            .name        = "effects_lut",
+            .type        = NGPU_PGCRAFT_TEXTURE_TYPE_2D,
+            .precision   = NGPU_PRECISION_HIGH,
+            .stage       = NGPU_PROGRAM_STAGE_VERT,
+            .texture     = s->effects_lut,
+            .no_metadata = true,
+        },
+        {
+            .name        = "effects_chars",
+            .type        = NGPU_PGCRAFT_TEXTURE_TYPE_2D,
+            .precision   = NGPU_PRECISION_HIGH,
+            .stage       = NGPU_PROGRAM_STAGE_VERT,
+            .texture     = s->effects_chars,
+            .no_metadata = true,
+        },
     };
 
     const struct ngpu_pgcraft_attribute attributes[] = {
@@ -842,11 +1021,33 @@ static int text_update(struct ngl_node *node, double t)
             return ret;
     }
 
+    /* Another text sharing the glyph atlas may have re-allocated its textures */
+    if (ngli_text_refresh_atlas(s->text_ctx)) {
+        int ret = update_atlas_textures(s);
+        if (ret < 0)
+            return ret;
+    }
+
     int ret = ngli_text_set_time(s->text_ctx, t);
     if (ret < 0)
         return ret;
 
-    ret = apply_effects(s);
+    /*
+     * When the effects are evaluated in the vertex shader, the per-character
+     * buffers only hold the defaults and only need an upload when they change
+     */
+    const size_t nb_chars = s->text_ctx->chars.count;
+    if (!s->text_ctx->effects_gpu.enabled) {
+        s->effects_dirty_start = 0;
+        s->effects_dirty_end = nb_chars;
+    }
+    ret = apply_effects(s, s->effects_dirty_start, s->effects_dirty_end);
+    if (ret < 0)
+        return ret;
+    s->effects_dirty_start = SIZE_MAX;
+    s->effects_dirty_end = 0;
+
+    ret = update_effects_textures(node);
     if (ret < 0)
         return ret;
 
@@ -903,15 +1104,39 @@ static void text_draw(struct ngl_node *node)
     if (s->nb_chars) {
         /* Fill and push foreground vertex block to staging buffer */
         struct pipeline_desc_fg *fg_desc = &desc->fg;
-        struct text_fg_vert_block fg_vert_data;
+        float fg_vert_buf[(sizeof(struct text_fg_vert_block) + 3 * NGLI_TEXT_MAX_GPU_EFFECTS * 4 * sizeof(float)) / sizeof(float)] = {0};
+        const size_t fg_vert_size = ngpu_block_desc_get_size(&fg_desc->vert_block_desc, 0);
+        ngli_assert(fg_vert_size <= sizeof(fg_vert_buf));
+
+        struct text_fg_vert_block fg_vert_data = {0};
         fg_vert_data.modelview_matrix = *modelview_matrix;
         fg_vert_data.projection_matrix = *projection_matrix;
 
+        const struct text *text = s->text_ctx;
+        const struct text_effects_gpu *gpu = &text->effects_gpu;
+        if (gpu->enabled) {
+            const size_t nb_effects = text->config.nb_effect_nodes;
+            fg_vert_data.nb_effects = (int32_t)nb_effects;
+            fg_vert_data.effect_chars_rows = (int32_t)gpu->chars_rows;
+
+            /* The vec4 arrays are tightly packed with the std140 layout */
+            const struct ngpu_block_field *fields = fg_desc->vert_block_desc.fields;
+            float *timing = fg_vert_buf + fields[FG_VERT_FIELD_EFFECT_TIMING].offset / sizeof(float);
+            float *range  = fg_vert_buf + fields[FG_VERT_FIELD_EFFECT_RANGE].offset / sizeof(float);
+            float *anchor = fg_vert_buf + fields[FG_VERT_FIELD_EFFECT_ANCHOR].offset / sizeof(float);
+            for (size_t i = 0; i < nb_effects; i++) {
+                memcpy(timing + 4 * i, gpu->params[i].timing, sizeof(gpu->params[i].timing));
+                memcpy(range  + 4 * i, gpu->params[i].range,  sizeof(gpu->params[i].range));
+                memcpy(anchor + 4 * i, gpu->params[i].anchor, sizeof(gpu->params[i].anchor));
+            }
+        }
+        memcpy(fg_vert_buf, &fg_vert_data, sizeof(fg_vert_data));
+
         if (fg_desc->vert_block_index >= 0) {
-            const size_t vert_offset = ngpu_staging_buffer_push(ctx->current_staging_buffer, &fg_vert_data, sizeof(fg_vert_data));
+            const size_t vert_offset = ngpu_staging_buffer_push(ctx->current_staging_buffer, fg_vert_buf, fg_vert_size);
             struct ngpu_buffer *staging_buf = ngpu_staging_buffer_get_buffer(ctx->current_staging_buffer);
             ngli_pipeline_compat_update_buffer(fg_desc->common.pipeline_compat, fg_desc->vert_block_index,
-                                               staging_buf, vert_offset, sizeof(fg_vert_data));
+                                               staging_buf, vert_offset, fg_vert_size);
         }
 
         /* Fill and push foreground fragment block to staging buffer */
@@ -929,6 +1154,12 @@ static void text_draw(struct ngl_node *node)
     }
 }
 
+static int text_prefetch(struct ngl_node *node)
+{
+    struct text_priv *s = node->priv_data;
+    return ngli_text_prefetch(s->text_ctx);
+}
+
 static void text_release(struct ngl_node *node)
 {
     struct text_priv *s = node->priv_data;
@@ -949,6 +1180,8 @@ static void text_uninit(struct ngl_node *node)
     ngpu_block_desc_reset(&desc->fg.vert_block_desc);
     ngpu_block_desc_reset(&desc->fg.frag_block_desc);
     ngpu_buffer_freep(&s->bg_vertices);
+    ngpu_texture_freep(&s->effects_lut);
+    ngpu_texture_freep(&s->effects_chars);
     destroy_characters_resources(s);
     ngli_text_freep(&s->text_ctx);
 }
@@ -959,6 +1192,7 @@ const struct node_class ngli_text_class = {
     .name           = "Text",
     .init           = text_init,
     .prepare        = text_prepare,
+    .prefetch       = text_prefetch,
     .update         = text_update,
     .draw           = text_draw,
     .release        = text_release,
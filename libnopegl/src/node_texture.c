@@ -405,6 +405,7 @@ static int texture_prefetch(struct ngl_node *node)
                 LOG(ERROR, "buffers used as a texture data source referencing a block are not supported");
                 return NGL_ERROR_UNSUPPORTED;
             }
+            buffer->flags |= NGLI_BUFFER_INFO_FLAG_CPU_READ;
 
             if (buffer->layout.type == NGPU_TYPE_VEC3) {
                 LOG(ERROR, "3-components texture formats are not supported");
@@ -43,7 +43,7 @@ static int time_init(struct ngl_node *node)
     return 0;
 }
 
-static int time_update(struct ngl_node *node, double t)
+static int time_cpu_update(struct ngl_node *node, double t)
 {
     struct time_priv *s = node->priv_data;
     s->time = (float)t;
@@ -55,8 +55,8 @@ const struct node_class ngli_time_class = {
     .category  = NGLI_NODE_CATEGORY_VARIABLE,
     .name      = "Time",
     .init      = time_init,
-    .update    = time_update,
+    .cpu_update = time_cpu_update,
     .priv_size = sizeof(struct time_priv),
-    .flags     = NGLI_NODE_FLAG_SHAREABLE,
+    .flags     = NGLI_NODE_FLAG_SHAREABLE | NGLI_NODE_FLAG_TIME_DEPENDENT,
     .file      = __FILE__,
 };
@@ -224,5 +224,6 @@ const struct node_class ngli_timerangefilter_class = {
     .opts_size = sizeof(struct timerangefilter_opts),
     .priv_size = sizeof(struct timerangefilter_priv),
     .params    = timerangefilter_params,
+    .flags     = NGLI_NODE_FLAG_TIME_DEPENDENT,
     .file      = __FILE__,
 };
@@ -257,6 +257,6 @@ const struct node_class ngli_timerangefilter2d_class = {
     .opts_size = sizeof(struct timerangefilter2d_opts),
     .priv_size = sizeof(struct timerangefilter2d_priv),
     .params    = timerangefilter2d_params,
-    .flags     = NGLI_NODE_FLAG_2D,
+    .flags     = NGLI_NODE_FLAG_2D | NGLI_NODE_FLAG_TIME_DEPENDENT,
     .file      = __FILE__,
 };
@@ -39,6 +39,7 @@
 #include "utils/hmap.h"
 #include "utils/memory.h"
 #include "utils/string.h"
+#include "utils/time.h"
 #include "utils/utils.h"
 
 /* We depend on the monotonically incrementing by 1 property of these fields */
@@ -82,6 +83,7 @@ static struct ngl_node *node_create(const struct node_class *cls)
 
     node->cls = cls;
     node->last_update_time = -1.;
+    node->cpu_update_time = -1.;
     node->visit_time = -1.;
 
     node->refcount = 1;
@@ -171,6 +173,7 @@ static void node_release(struct ngl_node *node)
     }
     node->state = NGLI_NODE_STATE_INITIALIZED;
     node->last_update_time = -1.;
+    node->cpu_update_time = -1.;
 }
 
 static void node_uninit(struct ngl_node *node)
@@ -189,6 +192,7 @@ static void node_uninit(struct ngl_node *node)
     node->state = NGLI_NODE_STATE_UNINITIALIZED;
     node->prepared = false;
     node->visit_time = -1.;
+    node->change_stamp = 0;
 }
 
 static int node_init(struct ngl_node *node)
@@ -220,11 +224,21 @@ static int node_set_ctx(struct ngl_node *node, struct ngl_ctx *ctx)
 {
     int ret;
 
+    node->time_dependent = node->cls->flags & NGLI_NODE_FLAG_TIME_DEPENDENT;
+    node->parallel_update = node->cls->cpu_update != NULL;
     for (size_t i = 0; i < node->children.count; i++) {
         struct ngl_node *child = node->children.data[i];
         ret = node_set_ctx(child, ctx);
         if (ret < 0)
             return ret;
+        node->time_dependent |= child->time_dependent;
+
+        /*
+         * The node can only be updated from a worker thread if all the
+         * children it may update can be as well
+         */
+        if (child->cls->update || (child->cls->cpu_update && !child->parallel_update))
+            node->parallel_update = false;
     }
 
     node->ctx = ctx;
@@ -334,8 +348,10 @@ int ngli_node_visit(struct ngl_node *node, bool is_active, double t)
          * scenario is rare but can happen with specific time sequences on time
          * filtered diamond-tree graphs.
          */
-        if (is_active && node->last_update_time == t)
+        if (is_active && node->last_update_time == t) {
             node->last_update_time = -1.;
+            node->cpu_update_time = -1.;
+        }
         /*
          * If we never passed through this node for that given time, the new
          * active state takes over to replace the one from a previous update.
@@ -372,6 +388,10 @@ int ngli_node_visit(struct ngl_node *node, bool is_active, double t)
         ngli_darray_push(&node->ctx->activitycheck_nodes, node) < 0)
         return NGL_ERROR_MEMORY;
 
+    if (queue_node && node->parallel_update &&
+        ngli_darray_push(&node->ctx->parallel_update_nodes, node) < 0)
+        return NGL_ERROR_MEMORY;
+
     return 0;
 }
 
@@ -382,7 +402,11 @@ static int node_prefetch(struct ngl_node *node)
 
     if (node->cls->prefetch) {
         TRACE("PREFETCH %s @ %p", node->label, node);
+        struct ngli_trace *trace = node->ctx->trace;
+        const int64_t start = trace ? ngli_gettime_relative() : 0;
         int ret = node->cls->prefetch(node);
+        if (trace)
+            ngli_trace_add_node_span(trace, node, NGLI_TRACE_PHASE_PREFETCH, start, ngli_gettime_relative());
         if (ret < 0) {
             LOG(ERROR, "prefetching node %s failed: %s", node->label, NGLI_RET_STR(ret));
             node->visit_time = -1.;
@@ -403,6 +427,7 @@ int ngli_node_honor_release_prefetch(struct ngl_node *scene, double t)
     /* Build a new list of activity checks nodes */
     struct ngli_node_darray *nodes_array = &scene->ctx->activitycheck_nodes;
     ngli_darray_clear(nodes_array);
+    ngli_darray_clear(&scene->ctx->parallel_update_nodes);
     int ret = ngli_node_visit(scene, true, t);
     if (ret < 0)
         return ret;
@@ -431,13 +456,39 @@ int ngli_node_honor_release_prefetch(struct ngl_node *scene, double t)
     return 0;
 }
 
+int ngli_node_cpu_update(struct ngl_node *node, double t)
+{
+    ngli_assert(node->state == NGLI_NODE_STATE_READY);
+    if (!node->cls->cpu_update || node->cpu_update_time == t)
+        return 0;
+
+    TRACE("CPU UPDATE %s @ %p with t=%g", node->label, node, t);
+    struct ngli_trace *trace = node->ctx->trace;
+    const int64_t start = trace ? ngli_gettime_relative() : 0;
+    int ret = node->cls->cpu_update(node, t);
+    if (trace)
+        ngli_trace_add_node_span(trace, node, NGLI_TRACE_PHASE_CPU_UPDATE, start, ngli_gettime_relative());
+    if (ret < 0)
+        return ret;
+    node->cpu_update_time = t;
+
+    return 0;
+}
+
 int ngli_node_update(struct ngl_node *node, double t)
 {
     ngli_assert(node->state == NGLI_NODE_STATE_READY);
-    if (node->cls->update) {
+    if (node->cls->cpu_update || node->cls->update) {
         if (node->last_update_time != t) {
             TRACE("UPDATE %s @ %p with t=%g", node->label, node, t);
-            int ret = node->cls->update(node, t);
+            int ret = ngli_node_cpu_update(node, t);
+            if (ret >= 0 && node->cls->update) {
+                struct ngli_trace *trace = node->ctx->trace;
+                const int64_t start = trace ? ngli_gettime_relative() : 0;
+                ret = node->cls->update(node, t);
+                if (trace)
+                    ngli_trace_add_node_span(trace, node, NGLI_TRACE_PHASE_UPDATE, start, ngli_gettime_relative());
+            }
             if (ret < 0) {
                 LOG(ERROR, "updating node %s failed: %s", node->label, NGLI_RET_STR(ret));
                 return ret;
@@ -476,10 +527,15 @@ void ngli_node_pre_draw(struct ngl_node *node)
 {
     if (!node->is_active)
         return;
-    if (node->cls->pre_draw)
+    if (node->cls->pre_draw) {
+        struct ngli_trace *trace = node->ctx->trace;
+        const int64_t start = trace ? ngli_gettime_relative() : 0;
         node->cls->pre_draw(node);
-    else
+        if (trace)
+            ngli_trace_add_node_span(trace, node, NGLI_TRACE_PHASE_PRE_DRAW, start, ngli_gettime_relative());
+    } else {
         ngli_node_pre_draw_children(node);
+    }
 }
 
 void ngli_node_pre_draw_children(struct ngl_node *node)
@@ -520,8 +576,15 @@ void ngli_node_draw(struct ngl_node *node)
 {
     if (node->cls->draw) {
         TRACE("DRAW %s @ %p", node->label, node);
+        struct ngli_trace *trace = node->ctx->trace;
+        const int64_t start = trace ? ngli_gettime_relative() : 0;
         node->cls->draw(node);
-        node->draw_count++;
+        if (trace)
+            ngli_trace_add_node_span(trace, node, NGLI_TRACE_PHASE_DRAW, start, ngli_gettime_relative());
+        if (node->draw_batched)
+            node->draw_batched = false;
+        else
+            node->draw_count++;
     }
 
     if (has_bounding_box(node))
@@ -563,9 +626,14 @@ static int param_add(struct ngl_node *node, const char *key, size_t nb_elems, vo
         return ret;
     }
 
-    if (node->ctx && par->update_func)
+    if (!node->ctx)
+        return ret;
+
+    if (par->update_func)
         ret = par->update_func(node);
 
+    ngli_node_mark_changed(node);
+
     return ret;
 }
 
@@ -613,6 +681,8 @@ int ngl_node_param_swap_elem(struct ngl_node *node, const char *key,
     if (par->swap_func)
         ret = par->swap_func(node, from, to);
 
+    ngli_node_mark_changed(node);
+
     return ret;
 }
 
@@ -620,6 +690,8 @@ int ngli_node_invalidate_branch(struct ngl_node *node)
 {
     node->visit_time = -1.;
     node->last_update_time = -1;
+    node->cpu_update_time = -1;
+    node->change_rev++;
     if (node->cls->invalidate) {
         int ret = node->cls->invalidate(node);
         if (ret < 0)
@@ -633,6 +705,27 @@ int ngli_node_invalidate_branch(struct ngl_node *node)
     return 0;
 }
 
+static void mark_changed(struct ngl_node *node, size_t stamp)
+{
+    /* Ancestors shared by several branches are only bumped once per walk */
+    if (node->change_stamp == stamp)
+        return;
+    node->change_stamp = stamp;
+    node->change_rev++;
+    for (size_t i = 0; i < node->parents.count; i++)
+        mark_changed(node->parents.data[i], stamp);
+}
+
+/*
+ * Notify the ancestors of a node that its content changed without requiring
+ * them to be updated again (typically a texture rendered into by an offscreen
+ * pass).
+ */
+void ngli_node_mark_changed(struct ngl_node *node)
+{
+    mark_changed(node, ++node->ctx->change_stamp);
+}
+
 static int node_param_is_value_allowed(struct ngl_node *node, const char *key,
                                        const uint8_t *ptr, const struct node_param *par)
 {
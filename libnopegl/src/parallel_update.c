@@ -0,0 +1,156 @@
+/*
+ * Copyright 2026 Matthieu Bouron <matthieu.bouron@gmail.com>
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdatomic.h>
+
+#include "internal.h"
+#include "log.h"
+#include "parallel_update.h"
+#include "utils/darray.h"
+#include "utils/memory.h"
+#include "utils/scheduler.h"
+#include "utils/utils.h"
+
+/*
+ * Below this number of nodes per range, dispatching the updates to the
+ * worker threads costs more than running them directly
+ */
+#define MIN_NODES_PER_RANGE 16
+
+struct parallel_update {
+    struct ngl_ctx *ctx;
+    NGLI_DARRAY(struct ngli_node_darray) waves;
+};
+
+struct update_wave {
+    struct ngl_node **nodes;
+    double t;
+    atomic_int ret;
+};
+
+struct parallel_update *ngli_parallel_update_create(struct ngl_ctx *ctx)
+{
+    struct parallel_update *s = ngli_calloc(1, sizeof(*s));
+    if (!s)
+        return NULL;
+    s->ctx = ctx;
+    return s;
+}
+
+static int update_nodes(struct ngl_node **nodes, size_t nb_nodes, double t)
+{
+    for (size_t i = 0; i < nb_nodes; i++) {
+        struct ngl_node *node = nodes[i];
+
+        /* The update() part is left to the rendering thread */
+        if (!node->cls->update) {
+            int ret = ngli_node_update(node, t);
+            if (ret < 0)
+                return ret;
+            continue;
+        }
+
+        int ret = ngli_node_cpu_update(node, t);
+        if (ret < 0) {
+            LOG(ERROR, "updating node %s failed: %s", node->label, NGLI_RET_STR(ret));
+            return ret;
+        }
+    }
+    return 0;
+}
+
+static void update_range(void *arg, size_t start, size_t end, uint32_t thread_index)
+{
+    struct update_wave *wave = arg;
+    int ret = update_nodes(wave->nodes + start, end - start, wave->t);
+    if (ret < 0)
+        atomic_store(&wave->ret, ret);
+}
+
+static int update_wave(struct parallel_update *s, struct ngl_node **nodes, size_t nb_nodes, double t)
+{
+    struct update_wave wave = {.nodes = nodes, .t = t};
+    atomic_init(&wave.ret, 0);
+    ngli_parallel_for(s->ctx->scheduler, nb_nodes, MIN_NODES_PER_RANGE, update_range, &wave);
+    return atomic_load(&wave.ret);
+}
+
+static bool is_pending(const struct ngl_node *node, double t)
+{
+    return node->parallel_update && node->is_active &&
+           node->last_update_time != t && node->cpu_update_time != t;
+}
+
+int ngli_parallel_update_run(struct parallel_update *s, double t)
+{
+    const struct ngli_node_darray *nodes = &s->ctx->parallel_update_nodes;
+
+    ngli_darray_foreach(it, &s->waves)
+        ngli_darray_clear(it);
+
+    /*
+     * Dispatch the pending nodes into waves such that each node comes after
+     * its own pending children. The nodes are collected from the leaves up to
+     * the root, so the wave of the children is always known at that point.
+     */
+    ngli_darray_foreach(it, nodes) {
+        struct ngl_node *node = *it;
+        if (!is_pending(node, t))
+            continue;
+
+        uint32_t level = 0;
+        ngli_darray_foreach(child_it, &node->children) {
+            const struct ngl_node *child = *child_it;
+            if (is_pending(child, t))
+                level = NGLI_MAX(level, child->update_level + 1);
+        }
+        node->update_level = level;
+
+        while (s->waves.count <= level) {
+            const struct ngli_node_darray wave = {0};
+            if (ngli_darray_push(&s->waves, wave) < 0)
+                return NGL_ERROR_MEMORY;
+        }
+        if (ngli_darray_push(&s->waves.data[level], node) < 0)
+            return NGL_ERROR_MEMORY;
+    }
+
+    ngli_darray_foreach(wave, &s->waves) {
+        int ret = update_wave(s, wave->data, wave->count, t);
+        if (ret < 0)
+            return ret;
+    }
+
+    return 0;
+}
+
+void ngli_parallel_update_freep(struct parallel_update **sp)
+{
+    struct parallel_update *s = *sp;
+    if (!s)
+        return;
+
+    ngli_darray_foreach(it, &s->waves)
+        ngli_darray_reset(it);
+    ngli_darray_reset(&s->waves);
+
+    ngli_freep(sp);
+}
@@ -0,0 +1,38 @@
+/*
+ * Copyright 2026 Matthieu Bouron <matthieu.bouron@gmail.com>
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef PARALLEL_UPDATE_H
+#define PARALLEL_UPDATE_H
+
+struct ngl_ctx;
+struct parallel_update;
+
+/*
+ * Evaluate the CPU only part of the update (see node_class.cpu_update) of
+ * the nodes collected in ngl_ctx.parallel_update_nodes during the visit.
+ * Nodes are dispatched in successive waves on the context scheduler, each node being
+ * scheduled after all its children.
+ */
+struct parallel_update *ngli_parallel_update_create(struct ngl_ctx *ctx);
+int ngli_parallel_update_run(struct parallel_update *s, double t);
+void ngli_parallel_update_freep(struct parallel_update **sp);
+
+#endif
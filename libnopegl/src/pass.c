@@ -57,6 +57,12 @@ struct texture_map {
     size_t image_rev;
 };
 
+struct vertex_buffer_map {
+    int32_t index;
+    const struct buffer_info *info;
+    size_t buffer_rev;
+};
+
 static int register_uniform(struct pass *s, const char *name, struct ngl_node *uniform, enum ngpu_program_stage stage)
 {
     struct ngpu_block_desc *block;
@@ -75,6 +81,7 @@ static int register_uniform(struct pass *s, const char *name, struct ngl_node *u
         type  = buffer_info->layout.type;
         count = buffer_info->layout.count;
         data  = buffer_info->data;
+        buffer_info->flags |= NGLI_BUFFER_INFO_FLAG_CPU_READ;
     } else if (uniform->cls->category == NGLI_NODE_CATEGORY_VARIABLE) {
         struct variable_info *variable_info = uniform->priv_data;
         type = variable_info->data_type;
@@ -175,6 +182,9 @@ static int register_texture(struct pass *s, const char *name, struct ngl_node *t
     if (ngli_darray_push(&s->crafter_textures, crafter_texture) < 0)
         return NGL_ERROR_MEMORY;
 
+    if (writable && ngli_darray_push(&s->writable_nodes, texture) < 0)
+        return NGL_ERROR_MEMORY;
+
     return 0;
 }
 
@@ -243,6 +253,9 @@ static int register_block(struct pass *s, const char *name, struct ngl_node *blo
     if (ngli_darray_push(&s->crafter_blocks, crafter_block) < 0)
         return NGL_ERROR_MEMORY;
 
+    if (writable && ngli_darray_push(&s->writable_nodes, block_node) < 0)
+        return NGL_ERROR_MEMORY;
+
     return 0;
 }
 
@@ -448,6 +461,30 @@ static int build_blocks_map(struct pass *s, struct pipeline_desc *desc)
     return 0;
 }
 
+static int build_vertex_buffers_map(struct pass *s, struct pipeline_desc *desc)
+{
+    const struct hmap *attributes_sets[] = {s->params.attributes, s->params.instance_attributes};
+    for (size_t i = 0; i < NGLI_ARRAY_NB(attributes_sets); i++) {
+        if (!attributes_sets[i])
+            continue;
+
+        const struct hmap_entry *entry = NULL;
+        while ((entry = ngli_hmap_next(attributes_sets[i], entry))) {
+            const int32_t index = ngpu_pgcraft_get_vertex_buffer_index(s->crafter, entry->key.str);
+            if (index < 0)
+                continue;
+
+            const struct ngl_node *node = entry->data;
+            const struct buffer_info *info = node->priv_data;
+            const struct vertex_buffer_map map = {.index = index, .info = info, .buffer_rev = info->buffer_rev};
+            if (ngli_darray_push(&desc->vertex_buffers_map, map) < 0)
+                return NGL_ERROR_MEMORY;
+        }
+    }
+
+    return 0;
+}
+
 int ngli_pass_prepare(struct pass *s,
                       const struct ngpu_graphics_state *graphics_state,
                       const struct ngpu_rendertarget_layout *rendertarget_layout)
@@ -532,6 +569,10 @@ int ngli_pass_prepare(struct pass *s,
     if (ret < 0)
         return ret;
 
+    ret = build_vertex_buffers_map(s, desc);
+    if (ret < 0)
+        return ret;
+
     for (size_t i = 0; i < tex_infos.nb_infos; i++) {
         const struct texture_map map = {.image = tex_infos.infos[i].image, .image_rev = SIZE_MAX};
         if (ngli_darray_push(&desc->textures_map, map) < 0)
@@ -606,12 +647,14 @@ void ngli_pass_uninit(struct pass *s)
     ngli_pipeline_compat_freep(&desc->pipeline_compat);
     ngli_darray_reset(&desc->blocks_map);
     ngli_darray_reset(&desc->textures_map);
+    ngli_darray_reset(&desc->vertex_buffers_map);
 
     ngpu_pgcraft_freep(&s->crafter);
     ngpu_block_desc_reset(&s->user_vert_block);
     ngpu_block_desc_reset(&s->user_frag_block);
     ngpu_block_desc_reset(&s->user_comp_block);
     ngli_darray_reset(&s->user_data_ptrs);
+    ngli_darray_reset(&s->writable_nodes);
     ngli_darray_reset(&s->crafter_attributes);
     ngli_darray_reset(&s->crafter_textures);
     ngli_darray_reset(&s->crafter_blocks);
@@ -699,6 +742,16 @@ int ngli_pass_exec(struct pass *s)
         }
     }
 
+    /* Attribute buffers may be swapped from one frame to another (see AnimatedBuffer*.direct_write) */
+    struct vertex_buffer_map *vertex_buffers_map = desc->vertex_buffers_map.data;
+    for (size_t i = 0; i < desc->vertex_buffers_map.count; i++) {
+        const struct buffer_info *info = vertex_buffers_map[i].info;
+        if (vertex_buffers_map[i].buffer_rev != info->buffer_rev) {
+            ngli_pipeline_compat_update_vertex_buffer(pipeline_compat, vertex_buffers_map[i].index, info->buffer);
+            vertex_buffers_map[i].buffer_rev = info->buffer_rev;
+        }
+    }
+
     if (s->pipeline_type == NGPU_PIPELINE_TYPE_GRAPHICS) {
         struct ngpu_ctx *gpu_ctx = ctx->gpu_ctx;
 
@@ -724,5 +777,9 @@ int ngli_pass_exec(struct pass *s)
         ngli_pipeline_compat_dispatch(pipeline_compat, NGLI_ARG_VEC3(params->workgroup_count));
     }
 
+    /* Notify the users of the written resources that their content changed */
+    for (size_t i = 0; i < s->writable_nodes.count; i++)
+        ngli_node_mark_changed(s->writable_nodes.data[i]);
+
     return 0;
 }
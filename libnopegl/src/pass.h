@@ -33,11 +33,13 @@ struct ngl_ctx;
 struct pipeline_compat;
 struct resource_map;
 struct texture_map;
+struct vertex_buffer_map;
 
 struct pipeline_desc {
     struct pipeline_compat *pipeline_compat;
     NGLI_DARRAY(struct resource_map) blocks_map;
     NGLI_DARRAY(struct texture_map) textures_map;
+    NGLI_DARRAY(struct vertex_buffer_map) vertex_buffers_map;
 };
 
 struct pass_params {
@@ -101,6 +103,7 @@ struct pass {
     int32_t user_frag_block_index;
     int32_t user_comp_block_index;
     NGLI_DARRAY(struct user_uniform_entry) user_data_ptrs;
+    NGLI_DARRAY(struct ngl_node *) writable_nodes; // resources the pass may write to
     struct pipeline_desc pipeline_desc;
 };
 
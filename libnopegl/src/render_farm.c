@@ -0,0 +1,359 @@
+/*
+ * Copyright 2026 Matthieu Bouron <matthieu.bouron@gmail.com>
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "log.h"
+#include "ngl_config.h"
+#include "nopegl/nopegl.h"
+#include "utils/memory.h"
+#include "utils/pthread_compat.h"
+#include "utils/string.h"
+#include "utils/thread.h"
+#include "utils/utils.h"
+
+#define DEFAULT_SEGMENT_SIZE 16
+
+struct worker {
+    struct ngl_render_farm *farm;
+    uint32_t index;
+    pthread_t thread;
+    bool thread_started;
+};
+
+struct ngl_render_farm {
+    struct ngl_config config;
+    char *scene_str;
+    double start;
+    int freq;
+    size_t nb_frames;
+    size_t segment_size;
+    size_t nb_segments;
+    size_t warmup_frames;
+    size_t frame_size;
+
+    /*
+     * Reorder queue: frame k is rendered in slot k % nb_slots, which is only
+     * available once the frame k - nb_slots has been read.
+     */
+    uint8_t *slots_data;
+    bool *slots_ready;
+    size_t nb_slots;
+
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    bool sync_initialized;
+    size_t next_segment; // next segment to be picked by a worker
+    size_t read_index;   // index of the next frame returned to the user
+    int error;           // first error raised by a worker
+    bool stopped;
+
+    struct worker *workers;
+    uint32_t nb_workers;
+};
+
+static double get_frame_time(const struct ngl_render_farm *s, size_t index)
+{
+    return s->start + (double)index / (double)s->freq;
+}
+
+static size_t get_nb_frames(const struct ngl_render_farm *s, double end)
+{
+    size_t nb_frames = (size_t)ceil((end - s->start) * (double)s->freq);
+    while (nb_frames && get_frame_time(s, nb_frames - 1) >= end)
+        nb_frames--;
+    while (get_frame_time(s, nb_frames) < end)
+        nb_frames++;
+    return nb_frames;
+}
+
+static void set_error(struct ngl_render_farm *s, int error)
+{
+    pthread_mutex_lock(&s->lock);
+    if (!s->error)
+        s->error = error;
+    pthread_cond_broadcast(&s->cond);
+    pthread_mutex_unlock(&s->lock);
+}
+
+static int create_worker_ctx(struct ngl_render_farm *s, struct ngl_ctx **ctxp)
+{
+    struct ngl_ctx *ctx = ngl_create();
+    if (!ctx)
+        return NGL_ERROR_MEMORY;
+    *ctxp = ctx;
+
+    struct ngl_config config = s->config;
+    config.capture_buffer = NULL;
+    if (!config.nb_threads) {
+        /* Share the CPUs between the contexts instead of oversubscribing them */
+        const uint32_t nb_cpus = ngli_thread_get_cpu_count();
+        config.nb_threads = (int)NGLI_MAX(nb_cpus / s->nb_workers, 1);
+    }
+
+    int ret = ngl_configure(ctx, &config);
+    if (ret < 0)
+        return ret;
+
+    struct ngl_scene *scene = ngl_scene_create();
+    if (!scene)
+        return NGL_ERROR_MEMORY;
+
+    ret = ngl_scene_init_from_str(scene, s->scene_str);
+    if (ret >= 0)
+        ret = ngl_set_scene(ctx, scene);
+    ngl_scene_unrefp(&scene);
+    return ret;
+}
+
+static int render_segment(struct ngl_render_farm *s, struct ngl_ctx *ctx, size_t segment)
+{
+    const size_t first = segment * s->segment_size;
+    const size_t last = NGLI_MIN(first + s->segment_size, s->nb_frames);
+
+    /* The first segment starts from a pristine scene, like a sequential rendering would */
+    const size_t warmup_start = first - NGLI_MIN(first, s->warmup_frames);
+    for (size_t i = warmup_start; i < first; i++) {
+        int ret = ngl_update(ctx, get_frame_time(s, i));
+        if (ret < 0)
+            return ret;
+    }
+
+    for (size_t i = first; i < last; i++) {
+        pthread_mutex_lock(&s->lock);
+        while (!s->stopped && !s->error && i >= s->read_index + s->nb_slots)
+            pthread_cond_wait(&s->cond, &s->lock);
+        const bool abort = s->stopped || s->error;
+        pthread_mutex_unlock(&s->lock);
+        if (abort)
+            return 0;
+
+        const size_t slot = i % s->nb_slots;
+        int ret = ngl_set_capture_buffer(ctx, s->slots_data + slot * s->frame_size);
+        if (ret < 0)
+            return ret;
+
+        ret = ngl_draw(ctx, get_frame_time(s, i), NULL);
+        if (ret < 0) {
+            LOG(ERROR, "unable to draw frame %zu @ t=%g", i, get_frame_time(s, i));
+            return ret;
+        }
+
+        pthread_mutex_lock(&s->lock);
+        s->slots_ready[slot] = true;
+        pthread_cond_broadcast(&s->cond);
+        pthread_mutex_unlock(&s->lock);
+    }
+
+    return 0;
+}
+
+static void *worker_thread(void *arg)
+{
+    struct worker *worker = arg;
+    struct ngl_render_farm *s = worker->farm;
+
+    char name[16];
+    snprintf(name, sizeof(name), "ngl-farm-%u", worker->index);
+    ngli_thread_set_name(name);
+
+    struct ngl_ctx *ctx = NULL;
+    int ret = create_worker_ctx(s, &ctx);
+    if (ret < 0) {
+        LOG(ERROR, "unable to create the context of worker %u: %s", worker->index, NGLI_RET_STR(ret));
+        goto end;
+    }
+
+    for (;;) {
+        /* Segments are handed out in order so that the reader is never starved */
+        pthread_mutex_lock(&s->lock);
+        const bool abort = s->stopped || s->error;
+        const size_t segment = s->next_segment;
+        if (!abort && segment < s->nb_segments)
+            s->next_segment++;
+        pthread_mutex_unlock(&s->lock);
+        if (abort || segment >= s->nb_segments)
+            break;
+
+        ret = render_segment(s, ctx, segment);
+        if (ret < 0)
+            break;
+    }
+
+end:
+    if (ret < 0)
+        set_error(s, ret);
+    ngl_freep(&ctx);
+    return NULL;
+}
+
+struct ngl_render_farm *ngl_render_farm_create(void)
+{
+    struct ngl_render_farm *s = ngli_calloc(1, sizeof(*s));
+    return s;
+}
+
+int ngl_render_farm_init(struct ngl_render_farm *s, const struct ngl_render_farm_params *params)
+{
+    const struct ngl_config *config = params->config;
+
+    if (!config || !params->scene_str) {
+        LOG(ERROR, "a configuration and a serialized scene are required");
+        return NGL_ERROR_INVALID_ARG;
+    }
+
+    if (!config->offscreen || config->capture_buffer_type != NGL_CAPTURE_BUFFER_TYPE_CPU ||
+        !config->width || !config->height) {
+        LOG(ERROR, "the render farm requires sized offscreen contexts with a CPU capture buffer");
+        return NGL_ERROR_INVALID_ARG;
+    }
+
+    if (config->hud || config->trace_filename) {
+        LOG(ERROR, "the HUD and trace are not supported by the render farm");
+        return NGL_ERROR_UNSUPPORTED;
+    }
+
+    if (params->freq <= 0 || params->duration < 0.) {
+        LOG(ERROR, "invalid time range %g:%g@%dHz", params->start, params->duration, params->freq);
+        return NGL_ERROR_INVALID_ARG;
+    }
+
+    int ret = ngli_config_copy(&s->config, config);
+    if (ret < 0)
+        return ret;
+
+    s->scene_str = ngli_strdup(params->scene_str);
+    if (!s->scene_str)
+        return NGL_ERROR_MEMORY;
+
+    s->start = params->start;
+    s->freq = params->freq;
+    s->nb_frames = get_nb_frames(s, params->start + params->duration);
+    s->warmup_frames = params->warmup_frames;
+
+    const uint32_t nb_workers = params->nb_workers ? params->nb_workers : ngli_thread_get_cpu_count();
+    const size_t max_segment_size = NGLI_MAX((s->nb_frames + nb_workers - 1) / nb_workers, 1);
+    s->segment_size = params->segment_size ? params->segment_size : NGLI_MIN(DEFAULT_SEGMENT_SIZE, max_segment_size);
+    s->nb_segments = (s->nb_frames + s->segment_size - 1) / s->segment_size;
+
+    /* Spawning more workers than segments would only create idle contexts */
+    s->nb_workers = (uint32_t)NGLI_MIN(nb_workers, NGLI_MAX(s->nb_segments, 1));
+
+    s->nb_slots = params->max_pending_frames ? params->max_pending_frames : s->nb_workers * s->segment_size;
+    s->frame_size = (size_t)config->width * config->height * 4;
+    s->slots_data = ngli_calloc(s->nb_slots, s->frame_size);
+    s->slots_ready = ngli_calloc(s->nb_slots, sizeof(*s->slots_ready));
+    if (!s->slots_data || !s->slots_ready)
+        return NGL_ERROR_MEMORY;
+
+    if (pthread_mutex_init(&s->lock, NULL))
+        return NGL_ERROR_EXTERNAL;
+    if (pthread_cond_init(&s->cond, NULL)) {
+        pthread_mutex_destroy(&s->lock);
+        return NGL_ERROR_EXTERNAL;
+    }
+    s->sync_initialized = true;
+
+    s->workers = ngli_calloc(s->nb_workers, sizeof(*s->workers));
+    if (!s->workers)
+        return NGL_ERROR_MEMORY;
+
+    LOG(DEBUG, "render %zu frames in %zu segments of %zu frames with %u workers",
+        s->nb_frames, s->nb_segments, s->segment_size, s->nb_workers);
+
+    for (uint32_t i = 0; i < s->nb_workers; i++) {
+        struct worker *worker = &s->workers[i];
+        worker->farm = s;
+        worker->index = i;
+        if (pthread_create(&worker->thread, NULL, worker_thread, worker))
+            return NGL_ERROR_MEMORY;
+        worker->thread_started = true;
+    }
+
+    return 0;
+}
+
+size_t ngl_render_farm_get_nb_frames(const struct ngl_render_farm *s)
+{
+    return s->nb_frames;
+}
+
+int ngl_render_farm_read_frame(struct ngl_render_farm *s, void *data, double *tp)
+{
+    if (!s->workers || s->read_index >= s->nb_frames)
+        return NGL_ERROR_INVALID_USAGE;
+
+    const size_t slot = s->read_index % s->nb_slots;
+
+    pthread_mutex_lock(&s->lock);
+    while (!s->error && !s->slots_ready[slot])
+        pthread_cond_wait(&s->cond, &s->lock);
+    const int error = s->error;
+    pthread_mutex_unlock(&s->lock);
+    if (error)
+        return error;
+
+    memcpy(data, s->slots_data + slot * s->frame_size, s->frame_size);
+    if (tp)
+        *tp = get_frame_time(s, s->read_index);
+
+    pthread_mutex_lock(&s->lock);
+    s->slots_ready[slot] = false;
+    s->read_index++;
+    pthread_cond_broadcast(&s->cond);
+    pthread_mutex_unlock(&s->lock);
+
+    return 0;
+}
+
+void ngl_render_farm_freep(struct ngl_render_farm **sp)
+{
+    struct ngl_render_farm *s = *sp;
+    if (!s)
+        return;
+
+    if (s->workers) {
+        pthread_mutex_lock(&s->lock);
+        s->stopped = true;
+        pthread_cond_broadcast(&s->cond);
+        pthread_mutex_unlock(&s->lock);
+
+        for (uint32_t i = 0; i < s->nb_workers; i++) {
+            if (s->workers[i].thread_started)
+                pthread_join(s->workers[i].thread, NULL);
+        }
+        ngli_freep(&s->workers);
+    }
+
+    if (s->sync_initialized) {
+        pthread_cond_destroy(&s->cond);
+        pthread_mutex_destroy(&s->lock);
+    }
+
+    ngli_freep(&s->slots_data);
+    ngli_freep(&s->slots_ready);
+    ngli_freep(&s->scene_str);
+    ngli_config_reset(&s->config);
+    ngli_freep(sp);
+}
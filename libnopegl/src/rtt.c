@@ -295,3 +295,62 @@ void ngli_rtt_freep(struct rtt_ctx **sp)
 
     ngli_freep(sp);
 }
+
+/* Compared field by field since the struct padding is left uninitialized */
+static bool is_same_cache_key(const struct rtt_cache_key *a, const struct rtt_cache_key *b)
+{
+    return a->viewport.x == b->viewport.x &&
+           a->viewport.y == b->viewport.y &&
+           a->viewport.width == b->viewport.width &&
+           a->viewport.height == b->viewport.height &&
+           a->canvas_2d_width == b->canvas_2d_width &&
+           a->canvas_2d_height == b->canvas_2d_height &&
+           !memcmp(a->modelview_matrix, b->modelview_matrix, sizeof(a->modelview_matrix)) &&
+           !memcmp(a->projection_matrix, b->projection_matrix, sizeof(a->projection_matrix));
+}
+
+bool ngli_rtt_cache_begin(struct rtt_cache *s, struct ngl_node *node, bool time_dependent,
+                          const struct rtt_cache_key *key)
+{
+    struct ngl_ctx *ctx = node->ctx;
+
+    if (s->valid && !time_dependent && s->change_rev == node->change_rev &&
+        is_same_cache_key(&s->key, key)) {
+        for (size_t i = 0; i < s->bounding_box_nodes.count; i++) {
+            if (ngli_darray_push(&ctx->bounding_box_nodes, s->bounding_box_nodes.data[i]) < 0)
+                break;
+        }
+        return true;
+    }
+
+    s->valid = false;
+    s->key = *key;
+    s->bounding_box_nodes_start = ctx->bounding_box_nodes.count;
+
+    return false;
+}
+
+void ngli_rtt_cache_end(struct rtt_cache *s, struct ngl_node *node)
+{
+    struct ngl_ctx *ctx = node->ctx;
+
+    ngli_darray_clear(&s->bounding_box_nodes);
+    for (size_t i = s->bounding_box_nodes_start; i < ctx->bounding_box_nodes.count; i++) {
+        if (ngli_darray_push(&s->bounding_box_nodes, ctx->bounding_box_nodes.data[i]) < 0)
+            return;
+    }
+
+    s->change_rev = node->change_rev;
+    s->valid = true;
+}
+
+void ngli_rtt_cache_invalidate(struct rtt_cache *s)
+{
+    s->valid = false;
+}
+
+void ngli_rtt_cache_reset(struct rtt_cache *s)
+{
+    ngli_darray_reset(&s->bounding_box_nodes);
+    memset(s, 0, sizeof(*s));
+}
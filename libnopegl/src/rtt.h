@@ -23,12 +23,15 @@
 #ifndef RTT_H
 #define RTT_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "image.h"
 #include <ngpu/ngpu.h>
+#include "utils/darray.h"
 
 struct ngl_ctx;
+struct ngl_node;
 struct rtt_ctx;
 
 struct rtt_params {
@@ -53,4 +56,41 @@ void ngli_rtt_begin(struct rtt_ctx *s);
 void ngli_rtt_end(struct rtt_ctx *s);
 void ngli_rtt_freep(struct rtt_ctx **sp);
 
+/*
+ * Context state an offscreen pass output depends on, besides its subtree.
+ * Fields irrelevant to a given node must be left zeroed.
+ */
+struct rtt_cache_key {
+    struct ngpu_viewport viewport;
+    float canvas_2d_width;
+    float canvas_2d_height;
+    float modelview_matrix[16];
+    float projection_matrix[16];
+};
+
+/*
+ * Retained-mode state of an offscreen pass: the previous render is reused as
+ * long as the subtree is not time dependent, no change was notified in the
+ * node branch (see ngl_node.change_rev) and the key is identical.
+ */
+struct rtt_cache {
+    bool valid;
+    size_t change_rev;
+    struct rtt_cache_key key;
+    size_t bounding_box_nodes_start;
+    NGLI_DARRAY(struct ngl_node *) bounding_box_nodes;
+};
+
+/*
+ * Return true if the previous render of the node can be reused, in which
+ * case the 2D nodes drawn by that render are registered again for
+ * hit-testing. Otherwise, the caller must render the subtree and call
+ * ngli_rtt_cache_end() once done.
+ */
+bool ngli_rtt_cache_begin(struct rtt_cache *s, struct ngl_node *node, bool time_dependent,
+                          const struct rtt_cache_key *key);
+void ngli_rtt_cache_end(struct rtt_cache *s, struct ngl_node *node);
+void ngli_rtt_cache_invalidate(struct rtt_cache *s);
+void ngli_rtt_cache_reset(struct rtt_cache *s);
+
 #endif
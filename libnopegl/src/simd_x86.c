@@ -73,3 +73,24 @@ void ngli_mat4_mul_vec4_sse(float *dst, const float *m, const float *v)
 
     _mm_store_ps(dst, r);
 }
+
+void ngli_lerp_f32_sse(float *dst, const float *v1, const float *v2, float c, size_t n)
+{
+    const __m128 c1 = _mm_set1_ps(1.f - c);
+    const __m128 c2 = _mm_set1_ps(c);
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128 r0 = _mm_mul_ps(_mm_loadu_ps(v1 + i),     c1);
+        __m128 r1 = _mm_mul_ps(_mm_loadu_ps(v1 + i + 4), c1);
+
+        r0 = _mm_add_ps(r0, _mm_mul_ps(_mm_loadu_ps(v2 + i),     c2));
+        r1 = _mm_add_ps(r1, _mm_mul_ps(_mm_loadu_ps(v2 + i + 4), c2));
+
+        _mm_storeu_ps(dst + i,     r0);
+        _mm_storeu_ps(dst + i + 4, r1);
+    }
+
+    for (; i < n; i++)
+        dst[i] = NGLI_MIX_F32(v1[i], v2[i], c);
+}
@@ -0,0 +1,192 @@
+/*
+ * Copyright 2026 Matthieu Bouron <matthieu.bouron@gmail.com>
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+
+#include "nopegl/nopegl.h"
+#include "skyline.h"
+#include "utils/darray.h"
+#include "utils/memory.h"
+#include "utils/utils.h"
+
+/* Horizontal segment of the skyline, covering [x,x+w) at height y */
+struct segment {
+    int32_t x, y, w;
+};
+
+struct skyline {
+    int32_t width, height;
+    NGLI_DARRAY(struct segment) segments; // sorted by x, covering [0,width)
+    int64_t used_area;
+};
+
+struct skyline *ngli_skyline_create(void)
+{
+    struct skyline *s = ngli_calloc(1, sizeof(*s));
+    return s;
+}
+
+int ngli_skyline_init(struct skyline *s, int32_t width, int32_t height)
+{
+    if (width <= 0 || height <= 0)
+        return NGL_ERROR_INVALID_ARG;
+
+    s->width = width;
+    s->height = height;
+    s->used_area = 0;
+
+    ngli_darray_clear(&s->segments);
+    const struct segment segment = {.x = 0, .y = 0, .w = width};
+    if (ngli_darray_push(&s->segments, segment) < 0)
+        return NGL_ERROR_MEMORY;
+
+    return 0;
+}
+
+/*
+ * Return the lowest y at which a rectangle of width w can be placed when its
+ * left edge is aligned with the segment at index, or -1 if it doesn't fit.
+ */
+static int32_t get_fit_y(const struct skyline *s, size_t index, int32_t w, int32_t h)
+{
+    const struct segment *segments = s->segments.data;
+    const int32_t x = segments[index].x;
+    if (x + w > s->width)
+        return -1;
+
+    int32_t y = 0;
+    int32_t remaining_w = w;
+    for (size_t i = index; remaining_w > 0; i++) {
+        ngli_assert(i < s->segments.count);
+        y = NGLI_MAX(y, segments[i].y);
+        if (y + h > s->height)
+            return -1;
+        remaining_w -= segments[i].w;
+    }
+    return y;
+}
+
+int ngli_skyline_insert(struct skyline *s, int32_t w, int32_t h, int32_t *xp, int32_t *yp)
+{
+    if (w <= 0 || h <= 0)
+        return NGL_ERROR_INVALID_ARG;
+
+    /* Bottom-left rule: lowest top edge first, then narrowest segment */
+    size_t best_index = SIZE_MAX;
+    int32_t best_y = INT32_MAX;
+    int32_t best_w = INT32_MAX;
+    for (size_t i = 0; i < s->segments.count; i++) {
+        const int32_t y = get_fit_y(s, i, w, h);
+        if (y < 0)
+            continue;
+        const int32_t segment_w = s->segments.data[i].w;
+        if (y < best_y || (y == best_y && segment_w < best_w)) {
+            best_index = i;
+            best_y = y;
+            best_w = segment_w;
+        }
+    }
+
+    if (best_index == SIZE_MAX)
+        return NGL_ERROR_LIMIT_EXCEEDED;
+
+    const int32_t x = s->segments.data[best_index].x;
+
+    /* Insert the top edge of the new rectangle in the skyline */
+    if (ngli_darray_push(&s->segments, (struct segment){0}) < 0)
+        return NGL_ERROR_MEMORY;
+    struct segment *segments = s->segments.data;
+    memmove(&segments[best_index + 1], &segments[best_index],
+            (s->segments.count - 1 - best_index) * sizeof(*segments));
+    segments[best_index] = (struct segment){.x = x, .y = best_y + h, .w = w};
+
+    /* Shrink or remove the segments now covered by the new one */
+    const size_t next = best_index + 1;
+    while (next < s->segments.count) {
+        struct segment *segment = &segments[next];
+        const int32_t overlap = x + w - segment->x;
+        if (overlap <= 0)
+            break;
+        if (overlap < segment->w) {
+            segment->x += overlap;
+            segment->w -= overlap;
+            break;
+        }
+        ngli_darray_remove(&s->segments, next);
+    }
+
+    /* Merge the neighbouring segments sharing the same height */
+    for (size_t i = 1; i < s->segments.count;) {
+        if (segments[i - 1].y == segments[i].y) {
+            segments[i - 1].w += segments[i].w;
+            ngli_darray_remove(&s->segments, i);
+        } else {
+            i++;
+        }
+    }
+
+    s->used_area += (int64_t)w * h;
+
+    *xp = x;
+    *yp = best_y;
+    return 0;
+}
+
+int ngli_skyline_grow(struct skyline *s, int32_t width, int32_t height)
+{
+    if (width < s->width || height < s->height)
+        return NGL_ERROR_INVALID_ARG;
+
+    if (width > s->width) {
+        struct segment *last = ngli_darray_tail(&s->segments);
+        if (last->y == 0) {
+            last->w += width - s->width;
+        } else {
+            const struct segment segment = {.x = s->width, .y = 0, .w = width - s->width};
+            if (ngli_darray_push(&s->segments, segment) < 0)
+                return NGL_ERROR_MEMORY;
+        }
+    }
+
+    s->width = width;
+    s->height = height;
+    return 0;
+}
+
+void ngli_skyline_get_size(const struct skyline *s, int32_t *widthp, int32_t *heightp)
+{
+    *widthp = s->width;
+    *heightp = s->height;
+}
+
+int64_t ngli_skyline_get_used_area(const struct skyline *s)
+{
+    return s->used_area;
+}
+
+void ngli_skyline_freep(struct skyline **sp)
+{
+    struct skyline *s = *sp;
+    if (!s)
+        return;
+    ngli_darray_reset(&s->segments);
+    ngli_freep(sp);
+}
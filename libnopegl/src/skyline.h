@@ -0,0 +1,59 @@
+/*
+ * Copyright 2026 Matthieu Bouron <matthieu.bouron@gmail.com>
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef SKYLINE_H
+#define SKYLINE_H
+
+#include <stdint.h>
+
+/*
+ * Skyline rectangle packer: the free space of the bin is tracked as the top
+ * edge of the rectangles already packed (the skyline), and each new rectangle
+ * is placed at the position minimizing its top coordinate (bottom-left rule).
+ * Rectangles are packed incrementally and the bin can grow without moving the
+ * rectangles already placed.
+ */
+struct skyline;
+
+struct skyline *ngli_skyline_create(void);
+int ngli_skyline_init(struct skyline *s, int32_t width, int32_t height);
+
+/*
+ * Find a position for a rectangle of size w x h and mark it as used. Return
+ * NGL_ERROR_LIMIT_EXCEEDED (without altering the skyline) if the rectangle
+ * does not fit in the bin.
+ */
+int ngli_skyline_insert(struct skyline *s, int32_t w, int32_t h, int32_t *xp, int32_t *yp);
+
+/*
+ * Extend the bin to width x height; the new dimensions must be greater than
+ * or equal to the current ones.
+ */
+int ngli_skyline_grow(struct skyline *s, int32_t width, int32_t height);
+
+void ngli_skyline_get_size(const struct skyline *s, int32_t *widthp, int32_t *heightp);
+
+/* Return the area covered by the rectangles inserted so far */
+int64_t ngli_skyline_get_used_area(const struct skyline *s);
+
+void ngli_skyline_freep(struct skyline **sp);
+
+#endif
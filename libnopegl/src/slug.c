@@ -45,18 +45,25 @@ struct curve {
 NGLI_DECLARE_DARRAY_WITH_NAME(curve_darray, struct curve);
 NGLI_DECLARE_DARRAY_WITH_NAME(slug_texel_darray, struct ngli_vec4);
 
-struct glyph_entry {
+struct slug_glyph {
     struct slug_glyph_data data;
     struct curve_darray curves; /* struct curve */
+    /*
+     * Band headers followed by the curve lists, where the curves are
+     * referenced by their index in the glyph: they are translated to curve
+     * texture locations when the glyph is packed (dropped afterwards)
+     */
+    struct slug_texel_darray bands;
 };
 
 struct slug {
     struct ngl_ctx *ctx;
-    NGLI_DARRAY(struct glyph_entry) glyphs;
+    NGLI_DARRAY(struct slug_glyph) glyphs;
 
-    /* Packed texture data (built during finalize) */
+    /* Packed texture data (appended during finalize for the new glyphs only) */
     struct slug_texel_darray curve_texels; /* float[4] per texel */
     struct slug_texel_darray band_texels;  /* float[4] per texel */
+    size_t nb_finalized_glyphs;
     int32_t curve_texture_height;
     int32_t band_texture_height;
 
@@ -115,13 +122,33 @@ int ngli_slug_init(struct slug *s)
     return 0;
 }
 
+static int upload_texture(struct slug *s, struct slug_texel_darray *texels,
+                          struct ngpu_texture **texturep, int32_t *capacity,
+                          int32_t *texture_height, size_t first_texel);
+
+static int prefetch_texture(struct slug *s, struct slug_texel_darray *texels,
+                            struct ngpu_texture **texturep, int32_t *capacity,
+                            int32_t *texture_height)
+{
+    if (*texturep)
+        return 0;
+
+    /* Restore the content of the already packed glyphs after a release */
+    if (texels->count)
+        return upload_texture(s, texels, texturep, capacity, texture_height, 0);
+
+    return ensure_texture_capacity(s, texturep, capacity, NGLI_SLUG_MIN_TEX_HEIGHT);
+}
+
 int ngli_slug_prefetch(struct slug *s)
 {
-    int ret = ensure_texture_capacity(s, &s->curve_texture, &s->curve_texture_capacity, NGLI_SLUG_MIN_TEX_HEIGHT);
+    int ret = prefetch_texture(s, &s->curve_texels, &s->curve_texture,
+                               &s->curve_texture_capacity, &s->curve_texture_height);
     if (ret < 0)
         return ret;
 
-    ret = ensure_texture_capacity(s, &s->band_texture, &s->band_texture_capacity, NGLI_SLUG_MIN_TEX_HEIGHT);
+    ret = prefetch_texture(s, &s->band_texels, &s->band_texture,
+                           &s->band_texture_capacity, &s->band_texture_height);
     if (ret < 0)
         return ret;
 
@@ -139,7 +166,7 @@ void ngli_slug_release(struct slug *s)
 /*
  * Convert path segments to quadratic bezier curves and collect them.
  */
-static int collect_curves(struct slug *s, const struct path *path, uint32_t flags,
+static int collect_curves(const struct path *path, uint32_t flags,
                           struct curve_darray *curves_out, float bounds[4])
 {
     const struct ngli_path_segment_darray *segments = ngli_path_get_segments(path);
@@ -246,45 +273,13 @@ static int collect_curves(struct slug *s, const struct path *path, uint32_t flag
     return 0;
 }
 
-int ngli_slug_add_glyph(struct slug *s, const struct path *path, uint32_t flags,
-                        float glyph_w, float glyph_h)
-{
-    struct glyph_entry entry = {0};
-
-    float bounds[4];
-    int ret = collect_curves(s, path, flags, &entry.curves, bounds);
-    if (ret < 0) {
-        ngli_darray_reset(&entry.curves);
-        return ret;
-    }
-
-    /* Use provided glyph dimensions for em bounds, falling back to path bounds */
-    if (glyph_w > 0.f && glyph_h > 0.f) {
-        entry.data.em_bounds[0] = 0.f;
-        entry.data.em_bounds[1] = 0.f;
-        entry.data.em_bounds[2] = glyph_w;
-        entry.data.em_bounds[3] = glyph_h;
-    } else {
-        entry.data.em_bounds[0] = bounds[0];
-        entry.data.em_bounds[1] = bounds[1];
-        entry.data.em_bounds[2] = bounds[2];
-        entry.data.em_bounds[3] = bounds[3];
-    }
-
-    if (ngli_darray_push(&s->glyphs, entry) < 0) {
-        ngli_darray_reset(&entry.curves);
-        return NGL_ERROR_MEMORY;
-    }
-
-    /* Return glyph index; full data available after ngli_slug_finalize() via ngli_slug_get_glyph_data() */
-    return (int)s->glyphs.count - 1;
-}
-
 struct band_entry {
     int32_t curve_index;
     float sort_key; /* max-x for h-bands, max-y for v-bands */
 };
 
+NGLI_DECLARE_DARRAY_WITH_NAME(band_entry_darray, struct band_entry);
+
 static int cmp_band_entry_desc(const void *a, const void *b)
 {
     const struct band_entry *ea = a;
@@ -304,215 +299,302 @@ static int push_texel(struct slug_texel_darray *texels, float x, float y, float
     return 0;
 }
 
+/*
+ * Build one direction of bands: band j covers the j-th slice of the glyph
+ * along the axis, and lists the curves overlapping it sorted by descending
+ * maximum coordinate on the other axis.
+ */
+static int build_bands(struct slug_glyph *glyph, struct band_entry_darray *band_entries,
+                       int32_t nb_bands, int32_t first_header, int axis)
+{
+    const struct curve *curves = glyph->curves.data;
+    const size_t nb_curves = glyph->curves.count;
+    const int other = axis ^ 1;
+
+    const float *em_bounds = glyph->data.em_bounds;
+    const float b0 = em_bounds[axis];
+    const float size = em_bounds[2 + axis] - b0;
+
+    for (int32_t j = 0; j < nb_bands; j++) {
+        const float band_0 = b0 + size * (float)j / (float)nb_bands;
+        const float band_1 = b0 + size * (float)(j + 1) / (float)nb_bands;
+
+        ngli_darray_clear(band_entries);
+        for (size_t ci = 0; ci < nb_curves; ci++) {
+            const struct curve *c = &curves[ci];
+            const float min_v = NGLI_MIN(NGLI_MIN(c->p1[axis], c->p2[axis]), c->p3[axis]);
+            const float max_v = NGLI_MAX(NGLI_MAX(c->p1[axis], c->p2[axis]), c->p3[axis]);
+            if (max_v >= band_0 && min_v <= band_1) {
+                const float sort_key = NGLI_MAX(NGLI_MAX(c->p1[other], c->p2[other]), c->p3[other]);
+                const struct band_entry e = {.curve_index = (int32_t)ci, .sort_key = sort_key};
+                if (ngli_darray_push(band_entries, e) < 0)
+                    return NGL_ERROR_MEMORY;
+            }
+        }
+
+        const size_t nb_entries = band_entries->count;
+        if (nb_entries > 1)
+            qsort(band_entries->data, nb_entries, sizeof(*band_entries->data), cmp_band_entry_desc);
+
+        /* Write band header: (count, offset_to_curve_list, 0, 0) */
+        float *header = glyph->bands.data[first_header + j].v;
+        header[0] = (float)nb_entries;
+        header[1] = (float)glyph->bands.count;
+
+        /* Write the index of the curves in this band */
+        for (size_t ei = 0; ei < nb_entries; ei++) {
+            const int32_t ci = band_entries->data[ei].curve_index;
+            int ret = push_texel(&glyph->bands, (float)ci, 0.f, 0.f, 0.f);
+            if (ret < 0)
+                return ret;
+        }
+    }
+
+    return 0;
+}
+
+static int build_glyph_bands(struct slug_glyph *glyph)
+{
+    const size_t nb_curves = glyph->curves.count;
+
+    /* Compute band counts */
+    int32_t nb_hbands, nb_vbands;
+    if (nb_curves == 0) {
+        nb_hbands = 1;
+        nb_vbands = 1;
+    } else {
+        const int32_t n = (int32_t)ceilf(sqrtf((float)nb_curves));
+        nb_hbands = NGLI_CLAMP(n, 1, 255);
+        nb_vbands = NGLI_CLAMP(n, 1, 255);
+    }
+    glyph->data.band_max[0] = nb_hbands - 1;
+    glyph->data.band_max[1] = nb_vbands - 1;
+
+    /* Band transform: maps em-space coord to band index */
+    const float bx0 = glyph->data.em_bounds[0];
+    const float by0 = glyph->data.em_bounds[1];
+    const float em_w = glyph->data.em_bounds[2] - bx0;
+    const float em_h = glyph->data.em_bounds[3] - by0;
+    glyph->data.band_transform[0] = em_w > 0.f ? (float)nb_vbands / em_w : 0.f;
+    glyph->data.band_transform[1] = em_h > 0.f ? (float)nb_hbands / em_h : 0.f;
+    glyph->data.band_transform[2] = -bx0 * glyph->data.band_transform[0];
+    glyph->data.band_transform[3] = -by0 * glyph->data.band_transform[1];
+
+    /* Reserve space for band headers (nb_hbands + nb_vbands entries) */
+    for (int32_t j = 0; j < nb_hbands + nb_vbands; j++) {
+        int ret = push_texel(&glyph->bands, 0.f, 0.f, 0.f, 0.f);
+        if (ret < 0)
+            return ret;
+    }
+
+    /*
+     * H-bands divide the y-axis and are sorted by descending max-x, v-bands
+     * divide the x-axis and are sorted by descending max-y
+     */
+    struct band_entry_darray band_entries = {0};
+    int ret = build_bands(glyph, &band_entries, nb_hbands, 0, 1);
+    if (ret >= 0)
+        ret = build_bands(glyph, &band_entries, nb_vbands, nb_hbands, 0);
+    ngli_darray_reset(&band_entries);
+    return ret;
+}
+
+int ngli_slug_prepare_glyph(struct slug_glyph **glyphp, const struct path *path, uint32_t flags,
+                            float glyph_w, float glyph_h)
+{
+    struct slug_glyph *glyph = ngli_calloc(1, sizeof(*glyph));
+    if (!glyph)
+        return NGL_ERROR_MEMORY;
+
+    float bounds[4];
+    int ret = collect_curves(path, flags, &glyph->curves, bounds);
+    if (ret < 0)
+        goto fail;
+
+    /* Use provided glyph dimensions for em bounds, falling back to path bounds */
+    if (glyph_w > 0.f && glyph_h > 0.f) {
+        glyph->data.em_bounds[0] = 0.f;
+        glyph->data.em_bounds[1] = 0.f;
+        glyph->data.em_bounds[2] = glyph_w;
+        glyph->data.em_bounds[3] = glyph_h;
+    } else {
+        glyph->data.em_bounds[0] = bounds[0];
+        glyph->data.em_bounds[1] = bounds[1];
+        glyph->data.em_bounds[2] = bounds[2];
+        glyph->data.em_bounds[3] = bounds[3];
+    }
+
+    ret = build_glyph_bands(glyph);
+    if (ret < 0)
+        goto fail;
+
+    *glyphp = glyph;
+    return 0;
+
+fail:
+    ngli_slug_glyph_freep(&glyph);
+    return ret;
+}
+
+void ngli_slug_glyph_freep(struct slug_glyph **glyphp)
+{
+    struct slug_glyph *glyph = *glyphp;
+    if (!glyph)
+        return;
+    ngli_darray_reset(&glyph->curves);
+    ngli_darray_reset(&glyph->bands);
+    ngli_freep(glyphp);
+}
+
+int ngli_slug_add_prepared_glyph(struct slug *s, struct slug_glyph **glyphp)
+{
+    struct slug_glyph *glyph = *glyphp;
+    if (ngli_darray_push(&s->glyphs, *glyph) < 0)
+        return NGL_ERROR_MEMORY;
+
+    /* The content now belongs to the slug */
+    ngli_freep(glyphp);
+
+    /* Return glyph index; full data available after ngli_slug_finalize() via ngli_slug_get_glyph_data() */
+    return (int)s->glyphs.count - 1;
+}
+
+int ngli_slug_add_glyph(struct slug *s, const struct path *path, uint32_t flags,
+                        float glyph_w, float glyph_h)
+{
+    struct slug_glyph *glyph = NULL;
+    int ret = ngli_slug_prepare_glyph(&glyph, path, flags, glyph_w, glyph_h);
+    if (ret < 0)
+        return ret;
+
+    ret = ngli_slug_add_prepared_glyph(s, &glyph);
+    ngli_slug_glyph_freep(&glyph);
+    return ret;
+}
+
+/*
+ * Upload the texels starting at first_texel (and up to the end of the array).
+ * If the texture has to be re-allocated to fit all the texels, the whole data
+ * is uploaded instead.
+ */
 static int upload_texture(struct slug *s, struct slug_texel_darray *texels,
                           struct ngpu_texture **texturep, int32_t *capacity,
-                          int32_t *texture_height)
+                          int32_t *texture_height, size_t first_texel)
 {
     const size_t nb_texels = texels->count;
     *texture_height = nb_texels > 0 ? (int32_t)((nb_texels + NGLI_SLUG_BAND_TEX_WIDTH - 1) / NGLI_SLUG_BAND_TEX_WIDTH) : 1;
 
+    const struct ngpu_texture *prev_texture = *texturep;
     int ret = ensure_texture_capacity(s, texturep, capacity, *texture_height);
     if (ret < 0)
         return ret;
 
-    /* Pad to full allocated capacity */
-    while (texels->count < (size_t)(*capacity * NGLI_SLUG_BAND_TEX_WIDTH)) {
-        ret = push_texel(texels, 0.f, 0.f, 0.f, 0.f);
-        if (ret < 0)
-            return NGL_ERROR_MEMORY;
-    }
+    const int32_t first_row = *texturep != prev_texture ? 0 : (int32_t)(first_texel / NGLI_SLUG_BAND_TEX_WIDTH);
+    const int32_t nb_rows = *texture_height - first_row;
 
-    return ngpu_texture_upload(*texturep, (const uint8_t *)texels->data, 0);
+    /* Pad the last row with zeroes without changing the texel count */
+    const size_t padded_count = (size_t)*texture_height * NGLI_SLUG_BAND_TEX_WIDTH;
+    ret = ngli_darray_reserve(texels, padded_count);
+    if (ret < 0)
+        return ret;
+    memset(texels->data + nb_texels, 0, (padded_count - nb_texels) * sizeof(*texels->data));
+
+    const struct ngpu_texture_transfer_params transfer_params = {
+        .pixels_per_row = NGLI_SLUG_BAND_TEX_WIDTH,
+        .y              = (uint32_t)first_row,
+        .width          = NGLI_SLUG_BAND_TEX_WIDTH,
+        .height         = (uint32_t)nb_rows,
+        .depth          = 1,
+        .layer_count    = 1,
+    };
+    const uint8_t *data = (const uint8_t *)(texels->data + (size_t)first_row * NGLI_SLUG_BAND_TEX_WIDTH);
+    return ngpu_texture_upload_with_params(*texturep, data, &transfer_params);
 }
 
 static int finalize_internal(struct slug *s)
 {
-    int ret = 0;
-
     const size_t nb_glyphs = s->glyphs.count;
 
-    int32_t curve_pos = 0;
-    int32_t band_pos = 0;
-
-    NGLI_DARRAY(struct band_entry) band_entries = {0};
+    /* Glyphs are appended after the ones already packed in the textures */
+    const size_t first_curve_texel = s->curve_texels.count;
+    const size_t first_band_texel = s->band_texels.count;
 
-    for (size_t g = 0; g < nb_glyphs; g++) {
-        struct glyph_entry *glyph = &s->glyphs.data[g];
+    for (size_t g = s->nb_finalized_glyphs; g < nb_glyphs; g++) {
+        struct slug_glyph *glyph = &s->glyphs.data[g];
         const struct curve *curves = glyph->curves.data;
         const size_t nb_curves = glyph->curves.count;
 
         /* Write all curves for this glyph to the curve texture */
-        const int32_t glyph_curve_start = curve_pos;
+        const int32_t glyph_curve_start = (int32_t)s->curve_texels.count;
         for (size_t i = 0; i < nb_curves; i++) {
             const struct curve *c = &curves[i];
             /* Texel 0: (p1.x, p1.y, p2.x, p2.y) */
-            ret = push_texel(&s->curve_texels, c->p1[0], c->p1[1], c->p2[0], c->p2[1]);
+            int ret = push_texel(&s->curve_texels, c->p1[0], c->p1[1], c->p2[0], c->p2[1]);
             if (ret < 0)
-                goto end;
+                return ret;
             /* Texel 1: (p3.x, p3.y, 0, 0) */
             ret = push_texel(&s->curve_texels, c->p3[0], c->p3[1], 0.f, 0.f);
             if (ret < 0)
-                goto end;
-            curve_pos += 2;
-        }
-
-        /* Compute band counts */
-        const float bx0 = glyph->data.em_bounds[0];
-        const float by0 = glyph->data.em_bounds[1];
-        const float bx1 = glyph->data.em_bounds[2];
-        const float by1 = glyph->data.em_bounds[3];
-        const float em_w = bx1 - bx0;
-        const float em_h = by1 - by0;
-
-        int32_t nb_hbands, nb_vbands;
-        if (nb_curves == 0) {
-            nb_hbands = 1;
-            nb_vbands = 1;
-        } else {
-            const int32_t n = (int32_t)ceilf(sqrtf((float)nb_curves));
-            nb_hbands = NGLI_CLAMP(n, 1, 255);
-            nb_vbands = NGLI_CLAMP(n, 1, 255);
+                return ret;
         }
 
         /* Record glyph location in band texture */
+        const int32_t band_pos = (int32_t)s->band_texels.count;
         glyph->data.glyph_loc[0] = band_pos % NGLI_SLUG_BAND_TEX_WIDTH;
         glyph->data.glyph_loc[1] = band_pos / NGLI_SLUG_BAND_TEX_WIDTH;
-        glyph->data.band_max[0] = nb_hbands - 1;
-        glyph->data.band_max[1] = nb_vbands - 1;
-
-        /* Band transform: maps em-space coord to band index */
-        if (em_w > 0.f)
-            glyph->data.band_transform[0] = (float)nb_vbands / em_w;
-        else
-            glyph->data.band_transform[0] = 0.f;
-        if (em_h > 0.f)
-            glyph->data.band_transform[1] = (float)nb_hbands / em_h;
-        else
-            glyph->data.band_transform[1] = 0.f;
-        glyph->data.band_transform[2] = -bx0 * glyph->data.band_transform[0];
-        glyph->data.band_transform[3] = -by0 * glyph->data.band_transform[1];
-
-        /*
-         * Build horizontal bands.
-         * For h-bands, we divide the y-axis into nb_hbands slices.
-         * A curve intersects band j if its y-extent overlaps band j's y-range.
-         * Curves within each band are sorted by descending max-x.
-         */
-
-        /* Reserve space for band headers (nb_hbands + nb_vbands entries) */
-        const int32_t header_start = band_pos;
-        for (int32_t j = 0; j < nb_hbands + nb_vbands; j++) {
-            ret = push_texel(&s->band_texels, 0.f, 0.f, 0.f, 0.f);
-            if (ret < 0)
-                goto end;
-            band_pos++;
-        }
-
-        /* Build h-bands */
-        for (int32_t j = 0; j < nb_hbands; j++) {
-            const float band_y0 = by0 + em_h * (float)j / (float)nb_hbands;
-            const float band_y1 = by0 + em_h * (float)(j + 1) / (float)nb_hbands;
-
-            ngli_darray_clear(&band_entries);
-            for (size_t ci = 0; ci < nb_curves; ci++) {
-                const struct curve *c = &curves[ci];
-                const float min_y = NGLI_MIN(NGLI_MIN(c->p1[1], c->p2[1]), c->p3[1]);
-                const float max_y = NGLI_MAX(NGLI_MAX(c->p1[1], c->p2[1]), c->p3[1]);
-                if (max_y >= band_y0 && min_y <= band_y1) {
-                    const float max_x = NGLI_MAX(NGLI_MAX(c->p1[0], c->p2[0]), c->p3[0]);
-                    const struct band_entry e = {.curve_index = (int32_t)ci, .sort_key = max_x};
-                    if (ngli_darray_push(&band_entries, e) < 0) {
-                        ret = NGL_ERROR_MEMORY;
-                        goto end;
-                    }
-                }
-            }
-
-            /* Sort by descending max-x */
-            const size_t nb_entries = band_entries.count;
-            if (nb_entries > 1)
-                qsort(band_entries.data, nb_entries, sizeof(*band_entries.data), cmp_band_entry_desc);
-
-            /* Write band header: (count, offset_to_curve_list, 0, 0) */
-            const int32_t offset = band_pos - header_start;
-            float *header = (float *)s->band_texels.data + (size_t)(header_start + j) * 4;
-            header[0] = (float)nb_entries;
-            header[1] = (float)offset;
-
-            /* Write curve locations for this band */
-            for (size_t ei = 0; ei < nb_entries; ei++) {
-                const int32_t ci = band_entries.data[ei].curve_index;
-                const int32_t curve_texel = glyph_curve_start + ci * 2;
-                const int32_t cx = curve_texel % NGLI_SLUG_BAND_TEX_WIDTH;
-                const int32_t cy = curve_texel / NGLI_SLUG_BAND_TEX_WIDTH;
-                ret = push_texel(&s->band_texels, (float)cx, (float)cy, 0.f, 0.f);
-                if (ret < 0)
-                    goto end;
-                band_pos++;
-            }
-        }
-
-        /* Build v-bands */
-        for (int32_t j = 0; j < nb_vbands; j++) {
-            const float band_x0 = bx0 + em_w * (float)j / (float)nb_vbands;
-            const float band_x1 = bx0 + em_w * (float)(j + 1) / (float)nb_vbands;
-
-            ngli_darray_clear(&band_entries);
-            for (size_t ci = 0; ci < nb_curves; ci++) {
-                const struct curve *c = &curves[ci];
-                const float min_x = NGLI_MIN(NGLI_MIN(c->p1[0], c->p2[0]), c->p3[0]);
-                const float max_x = NGLI_MAX(NGLI_MAX(c->p1[0], c->p2[0]), c->p3[0]);
-                if (max_x >= band_x0 && min_x <= band_x1) {
-                    const float max_y = NGLI_MAX(NGLI_MAX(c->p1[1], c->p2[1]), c->p3[1]);
-                    const struct band_entry e = {.curve_index = (int32_t)ci, .sort_key = max_y};
-                    if (ngli_darray_push(&band_entries, e) < 0) {
-                        ret = NGL_ERROR_MEMORY;
-                        goto end;
-                    }
-                }
-            }
-
-            const size_t nb_entries = band_entries.count;
-            if (nb_entries > 1)
-                qsort(band_entries.data, nb_entries, sizeof(*band_entries.data), cmp_band_entry_desc);
 
-            /* Write band header at offset nb_hbands + j from glyph start */
-            const int32_t offset = band_pos - header_start;
-            float *header = (float *)s->band_texels.data + (size_t)(header_start + nb_hbands + j) * 4;
-            header[0] = (float)nb_entries;
-            header[1] = (float)offset;
-
-            for (size_t ei = 0; ei < nb_entries; ei++) {
-                const int32_t ci = band_entries.data[ei].curve_index;
-                const int32_t curve_texel = glyph_curve_start + ci * 2;
+        /* Copy the band headers as is, and translate the curve indices to curve locations */
+        const size_t nb_headers = (size_t)(glyph->data.band_max[0] + 1 + glyph->data.band_max[1] + 1);
+        for (size_t i = 0; i < glyph->bands.count; i++) {
+            const float *texel = glyph->bands.data[i].v;
+            int ret;
+            if (i < nb_headers) {
+                ret = push_texel(&s->band_texels, texel[0], texel[1], texel[2], texel[3]);
+            } else {
+                const int32_t curve_texel = glyph_curve_start + (int32_t)texel[0] * 2;
                 const int32_t cx = curve_texel % NGLI_SLUG_BAND_TEX_WIDTH;
                 const int32_t cy = curve_texel / NGLI_SLUG_BAND_TEX_WIDTH;
                 ret = push_texel(&s->band_texels, (float)cx, (float)cy, 0.f, 0.f);
-                if (ret < 0)
-                    goto end;
-                band_pos++;
             }
+            if (ret < 0)
+                return ret;
         }
     }
 
-    ret = upload_texture(s, &s->curve_texels, &s->curve_texture, &s->curve_texture_capacity, &s->curve_texture_height);
+    int ret = upload_texture(s, &s->curve_texels, &s->curve_texture, &s->curve_texture_capacity,
+                             &s->curve_texture_height, first_curve_texel);
     if (ret < 0)
-        goto end;
+        return ret;
 
-    ret = upload_texture(s, &s->band_texels, &s->band_texture, &s->band_texture_capacity, &s->band_texture_height);
+    ret = upload_texture(s, &s->band_texels, &s->band_texture, &s->band_texture_capacity,
+                         &s->band_texture_height, first_band_texel);
+    if (ret < 0)
+        return ret;
 
-end:
-    ngli_darray_reset(&band_entries);
-    return ret;
+    /* The bands are now packed in the texture */
+    for (size_t g = s->nb_finalized_glyphs; g < nb_glyphs; g++)
+        ngli_darray_reset(&s->glyphs.data[g].bands);
+    s->nb_finalized_glyphs = nb_glyphs;
+
+    return 0;
 }
 
 int ngli_slug_finalize(struct slug *s)
 {
-    /* Clear texel data (textures are preserved and grown as needed) */
-    ngli_darray_clear(&s->curve_texels);
-    ngli_darray_clear(&s->band_texels);
-
-    return finalize_internal(s);
+    /*
+     * Only the glyphs added since the last call are packed and uploaded: the
+     * location of the previous glyphs in the textures does not change
+     * (textures are preserved and grown as needed)
+     */
+    const size_t prev_curve_count = s->curve_texels.count;
+    const size_t prev_band_count = s->band_texels.count;
+    int ret = finalize_internal(s);
+    if (ret < 0) {
+        /* Drop the partially packed glyphs so that a later call can retry */
+        ngli_darray_remove_range(&s->curve_texels, prev_curve_count, s->curve_texels.count - prev_curve_count);
+        ngli_darray_remove_range(&s->band_texels, prev_band_count, s->band_texels.count - prev_band_count);
+    }
+    return ret;
 }
 
 size_t ngli_slug_get_glyph_count(const struct slug *s)
@@ -541,8 +623,10 @@ void ngli_slug_freep(struct slug **sp)
     if (!s)
         return;
 
-    for (size_t i = 0; i < s->glyphs.count; i++)
+    for (size_t i = 0; i < s->glyphs.count; i++) {
         ngli_darray_reset(&s->glyphs.data[i].curves);
+        ngli_darray_reset(&s->glyphs.data[i].bands);
+    }
     ngli_darray_reset(&s->glyphs);
     ngli_darray_reset(&s->curve_texels);
     ngli_darray_reset(&s->band_texels);
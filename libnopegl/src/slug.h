@@ -29,6 +29,7 @@ struct ngl_ctx;
 struct ngpu_texture;
 struct path;
 struct slug;
+struct slug_glyph;
 
 #define NGLI_SLUG_FLAG_PATH_AUTO_CLOSE (1 << 0)
 
@@ -47,6 +48,12 @@ void ngli_slug_release(struct slug *s);
  * Full glyph data is available after ngli_slug_finalize() via ngli_slug_get_glyph_data(). */
 int ngli_slug_add_glyph(struct slug *s, const struct path *path, uint32_t flags,
                         float glyph_w, float glyph_h);
+/* Convert the path into curves and bands without accessing any slug, so it can run on any thread */
+int ngli_slug_prepare_glyph(struct slug_glyph **glyphp, const struct path *path, uint32_t flags,
+                            float glyph_w, float glyph_h);
+/* Same as ngli_slug_add_glyph() with a prepared glyph, which is taken over on success */
+int ngli_slug_add_prepared_glyph(struct slug *s, struct slug_glyph **glyphp);
+void ngli_slug_glyph_freep(struct slug_glyph **glyphp);
 int ngli_slug_finalize(struct slug *s);
 size_t ngli_slug_get_glyph_count(const struct slug *s);
 void ngli_slug_get_glyph_data(const struct slug *s, int32_t index, struct slug_glyph_data *out);
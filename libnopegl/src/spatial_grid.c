@@ -0,0 +1,339 @@
+/*
+ * Copyright 2026 Matthieu Bouron <matthieu.bouron@gmail.com>
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "spatial_grid.h"
+#include "utils/darray.h"
+#include "utils/memory.h"
+#include "utils/utils.h"
+
+/* Upper bound of the grid resolution on each axis */
+#define MAX_CELLS_PER_AXIS 128
+
+/*
+ * Boxes spanning more cells than this are not binned but stored in a
+ * separate list checked by every query. This keeps the memory footprint
+ * linear with the number of boxes when the scene contains backgrounds and
+ * other large elements.
+ */
+#define MAX_CELLS_PER_BOX 16
+
+struct spatial_grid {
+    const float *boxes;
+    size_t nb_boxes;
+    float min[2];
+    float max[2];
+    float cell_scale[2];
+    int32_t nb_cells[2];
+
+    /* Compressed cell lists: indices of cell c are in [offsets[c], offsets[c + 1]) */
+    uint32_t *cell_offsets;
+    size_t cell_offsets_capacity;
+    uint32_t *cell_indices;
+    size_t cell_indices_capacity;
+    NGLI_DARRAY(uint32_t) large_indices;
+
+    /* Per box query stamp, used to deduplicate boxes spanning several cells */
+    uint32_t *stamps;
+    size_t stamps_capacity;
+    uint32_t stamp;
+
+    NGLI_DARRAY(uint32_t) results;
+};
+
+struct spatial_grid *ngli_spatial_grid_create(void)
+{
+    struct spatial_grid *s = ngli_calloc(1, sizeof(*s));
+    return s;
+}
+
+static int ensure_capacity(uint32_t **datap, size_t *capacityp, size_t count)
+{
+    if (count <= *capacityp)
+        return 0;
+    uint32_t *data = ngli_realloc(*datap, count, sizeof(*data));
+    if (!data)
+        return NGL_ERROR_MEMORY;
+    *datap = data;
+    *capacityp = count;
+    return 0;
+}
+
+static int is_empty(const float *box)
+{
+    return !(box[0] <= box[2] && box[1] <= box[3]) ||
+           !isfinite(box[0]) || !isfinite(box[1]) ||
+           !isfinite(box[2]) || !isfinite(box[3]);
+}
+
+static int contains_point(const float *box, float x, float y)
+{
+    return x >= box[0] && x <= box[2] && y >= box[1] && y <= box[3];
+}
+
+static int overlaps_box(const float *a, const float *b)
+{
+    return a[0] <= b[2] && a[2] >= b[0] && a[1] <= b[3] && a[3] >= b[1];
+}
+
+static int32_t get_cell(const struct spatial_grid *s, int axis, float v)
+{
+    const float cell = (v - s->min[axis]) * s->cell_scale[axis];
+    return (int32_t)NGLI_CLAMP(cell, 0.f, (float)(s->nb_cells[axis] - 1));
+}
+
+static void get_cell_range(const struct spatial_grid *s, const float *box, int32_t *range)
+{
+    range[0] = get_cell(s, 0, box[0]);
+    range[1] = get_cell(s, 1, box[1]);
+    range[2] = get_cell(s, 0, box[2]);
+    range[3] = get_cell(s, 1, box[3]);
+}
+
+static int is_large(const int32_t *range)
+{
+    return (range[2] - range[0] + 1) * (range[3] - range[1] + 1) > MAX_CELLS_PER_BOX;
+}
+
+int ngli_spatial_grid_build(struct spatial_grid *s, const float *boxes, size_t nb_boxes)
+{
+    ngli_assert(nb_boxes < UINT32_MAX);
+
+    s->boxes = boxes;
+    s->nb_boxes = nb_boxes;
+    s->nb_cells[0] = s->nb_cells[1] = 0;
+    s->stamp = 0;
+    ngli_darray_clear(&s->large_indices);
+    ngli_darray_clear(&s->results);
+
+    float min[2] = {FLT_MAX, FLT_MAX};
+    float max[2] = {-FLT_MAX, -FLT_MAX};
+    size_t nb_valid_boxes = 0;
+    for (size_t i = 0; i < nb_boxes; i++) {
+        const float *box = &boxes[i * 4];
+        if (is_empty(box))
+            continue;
+        min[0] = NGLI_MIN(min[0], box[0]);
+        min[1] = NGLI_MIN(min[1], box[1]);
+        max[0] = NGLI_MAX(max[0], box[2]);
+        max[1] = NGLI_MAX(max[1], box[3]);
+        nb_valid_boxes++;
+    }
+    if (!nb_valid_boxes)
+        return 0;
+
+    /* Pick roughly square cells so that the grid holds about one box per cell */
+    const float width = max[0] - min[0];
+    const float height = max[1] - min[1];
+    const float area = width * height;
+    int32_t nb_cells_x = 1;
+    int32_t nb_cells_y = 1;
+    if (area > 0.f) {
+        const float cell_size = sqrtf(area / (float)nb_valid_boxes);
+        nb_cells_x = (int32_t)NGLI_CLAMP(ceilf(width / cell_size), 1.f, (float)MAX_CELLS_PER_AXIS);
+        nb_cells_y = (int32_t)NGLI_CLAMP(ceilf(height / cell_size), 1.f, (float)MAX_CELLS_PER_AXIS);
+    }
+
+    s->min[0] = min[0];
+    s->min[1] = min[1];
+    s->max[0] = max[0];
+    s->max[1] = max[1];
+    s->nb_cells[0] = nb_cells_x;
+    s->nb_cells[1] = nb_cells_y;
+    s->cell_scale[0] = width > 0.f ? (float)nb_cells_x / width : 0.f;
+    s->cell_scale[1] = height > 0.f ? (float)nb_cells_y / height : 0.f;
+
+    const size_t nb_cells = (size_t)nb_cells_x * (size_t)nb_cells_y;
+    int ret = ensure_capacity(&s->cell_offsets, &s->cell_offsets_capacity, nb_cells + 1);
+    if (ret < 0)
+        goto fail;
+    ret = ensure_capacity(&s->stamps, &s->stamps_capacity, nb_boxes);
+    if (ret < 0)
+        goto fail;
+    memset(s->cell_offsets, 0, (nb_cells + 1) * sizeof(*s->cell_offsets));
+    memset(s->stamps, 0, nb_boxes * sizeof(*s->stamps));
+
+    /* Count the boxes per cell (shifted by one to build the offsets in place) */
+    for (size_t i = 0; i < nb_boxes; i++) {
+        const float *box = &boxes[i * 4];
+        if (is_empty(box))
+            continue;
+        int32_t range[4];
+        get_cell_range(s, box, range);
+        if (is_large(range)) {
+            ret = ngli_darray_push(&s->large_indices, (uint32_t)i);
+            if (ret < 0)
+                goto fail;
+            continue;
+        }
+        for (int32_t y = range[1]; y <= range[3]; y++)
+            for (int32_t x = range[0]; x <= range[2]; x++)
+                s->cell_offsets[y * nb_cells_x + x + 1]++;
+    }
+
+    for (size_t i = 0; i < nb_cells; i++)
+        s->cell_offsets[i + 1] += s->cell_offsets[i];
+
+    ret = ensure_capacity(&s->cell_indices, &s->cell_indices_capacity, s->cell_offsets[nb_cells]);
+    if (ret < 0)
+        goto fail;
+
+    /*
+     * Fill the cells in box order so that each cell list is sorted. The
+     * offsets are used as write cursors and end up shifted by one cell, which
+     * is restored afterwards.
+     */
+    for (size_t i = 0; i < nb_boxes; i++) {
+        const float *box = &boxes[i * 4];
+        if (is_empty(box))
+            continue;
+        int32_t range[4];
+        get_cell_range(s, box, range);
+        if (is_large(range))
+            continue;
+        for (int32_t y = range[1]; y <= range[3]; y++)
+            for (int32_t x = range[0]; x <= range[2]; x++)
+                s->cell_indices[s->cell_offsets[y * nb_cells_x + x]++] = (uint32_t)i;
+    }
+
+    memmove(s->cell_offsets + 1, s->cell_offsets, nb_cells * sizeof(*s->cell_offsets));
+    s->cell_offsets[0] = 0;
+
+    return 0;
+
+fail:
+    s->nb_cells[0] = s->nb_cells[1] = 0;
+    ngli_darray_clear(&s->large_indices);
+    return ret;
+}
+
+static int outside_bounds(const struct spatial_grid *s, const float *box)
+{
+    return !s->nb_cells[0] ||
+           !(box[0] <= s->max[0] && box[2] >= s->min[0] &&
+             box[1] <= s->max[1] && box[3] >= s->min[1]);
+}
+
+int ngli_spatial_grid_query_point(struct spatial_grid *s, float x, float y,
+                                  const uint32_t **indicesp, size_t *nb_indicesp)
+{
+    ngli_darray_clear(&s->results);
+
+    const float point_box[] = {x, y, x, y};
+    if (outside_bounds(s, point_box))
+        goto end;
+
+    const int32_t cell = get_cell(s, 1, y) * s->nb_cells[0] + get_cell(s, 0, x);
+    const uint32_t *cell_indices = s->cell_indices + s->cell_offsets[cell];
+    const size_t nb_cell_indices = s->cell_offsets[cell + 1] - s->cell_offsets[cell];
+    const uint32_t *large_indices = s->large_indices.data;
+    const size_t nb_large_indices = s->large_indices.count;
+
+    /* Merge the (sorted) cell and large box lists */
+    size_t i = 0, j = 0;
+    while (i < nb_cell_indices || j < nb_large_indices) {
+        uint32_t index;
+        if (j == nb_large_indices || (i < nb_cell_indices && cell_indices[i] < large_indices[j]))
+            index = cell_indices[i++];
+        else
+            index = large_indices[j++];
+        if (!contains_point(&s->boxes[index * 4], x, y))
+            continue;
+        if (ngli_darray_push(&s->results, index) < 0)
+            return NGL_ERROR_MEMORY;
+    }
+
+end:
+    *indicesp = s->results.data;
+    *nb_indicesp = s->results.count;
+    return 0;
+}
+
+static int compare_index(const void *a, const void *b)
+{
+    const uint32_t index_a = *(const uint32_t *)a;
+    const uint32_t index_b = *(const uint32_t *)b;
+    return (index_a > index_b) - (index_a < index_b);
+}
+
+int ngli_spatial_grid_query_box(struct spatial_grid *s, const float *box,
+                                const uint32_t **indicesp, size_t *nb_indicesp)
+{
+    ngli_darray_clear(&s->results);
+
+    if (is_empty(box) || outside_bounds(s, box))
+        goto end;
+
+    if (++s->stamp == 0) {
+        memset(s->stamps, 0, s->nb_boxes * sizeof(*s->stamps));
+        s->stamp = 1;
+    }
+
+    int32_t range[4];
+    get_cell_range(s, box, range);
+    for (int32_t y = range[1]; y <= range[3]; y++) {
+        for (int32_t x = range[0]; x <= range[2]; x++) {
+            const int32_t cell = y * s->nb_cells[0] + x;
+            for (uint32_t i = s->cell_offsets[cell]; i < s->cell_offsets[cell + 1]; i++) {
+                const uint32_t index = s->cell_indices[i];
+                if (s->stamps[index] == s->stamp)
+                    continue;
+                s->stamps[index] = s->stamp;
+                if (!overlaps_box(&s->boxes[index * 4], box))
+                    continue;
+                if (ngli_darray_push(&s->results, index) < 0)
+                    return NGL_ERROR_MEMORY;
+            }
+        }
+    }
+
+    ngli_darray_foreach(index, &s->large_indices) {
+        if (!overlaps_box(&s->boxes[*index * 4], box))
+            continue;
+        if (ngli_darray_push(&s->results, *index) < 0)
+            return NGL_ERROR_MEMORY;
+    }
+
+    if (s->results.count > 1)
+        qsort(s->results.data, s->results.count, sizeof(*s->results.data), compare_index);
+
+end:
+    *indicesp = s->results.data;
+    *nb_indicesp = s->results.count;
+    return 0;
+}
+
+void ngli_spatial_grid_freep(struct spatial_grid **sp)
+{
+    struct spatial_grid *s = *sp;
+    if (!s)
+        return;
+    ngli_freep(&s->cell_offsets);
+    ngli_freep(&s->cell_indices);
+    ngli_freep(&s->stamps);
+    ngli_darray_reset(&s->large_indices);
+    ngli_darray_reset(&s->results);
+    ngli_freep(sp);
+}
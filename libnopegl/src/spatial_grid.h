@@ -0,0 +1,63 @@
+/*
+ * Copyright 2026 Matthieu Bouron <matthieu.bouron@gmail.com>
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Uniform grid over a set of 2D axis-aligned boxes, used to accelerate point
+ * and rectangle queries. Boxes are identified by their index in the array
+ * passed to ngli_spatial_grid_build() and queries always return these indices
+ * in ascending order.
+ */
+struct spatial_grid;
+
+struct spatial_grid *ngli_spatial_grid_create(void);
+
+/*
+ * (Re)build the grid from nb_boxes boxes, each of them specified as 4 floats
+ * (min_x, min_y, max_x, max_y). Boxes with max < min (or non-finite
+ * coordinates) are considered empty and never returned by the queries. The
+ * boxes array is not copied and must remain valid until the next build.
+ */
+int ngli_spatial_grid_build(struct spatial_grid *s, const float *boxes, size_t nb_boxes);
+
+/*
+ * Return the indices of the boxes containing the point (x, y). The returned
+ * array is owned by the grid and valid until the next query or build.
+ */
+int ngli_spatial_grid_query_point(struct spatial_grid *s, float x, float y,
+                                  const uint32_t **indicesp, size_t *nb_indicesp);
+
+/*
+ * Return the indices of the boxes overlapping the box (min_x, min_y, max_x,
+ * max_y). The returned array is owned by the grid and valid until the next
+ * query or build.
+ */
+int ngli_spatial_grid_query_box(struct spatial_grid *s, const float *box,
+                                const uint32_t **indicesp, size_t *nb_indicesp);
+
+void ngli_spatial_grid_freep(struct spatial_grid **sp);
+
+#endif
@@ -95,5 +95,28 @@ int main(void)
         flt_check(v_diff, 4);
     }
 
+    /* Odd sizes and offsets to cover the unaligned and tail code paths */
+    static const size_t lerp_sizes[] = {0, 1, 3, 4, 7, 8, 13, 33};
+    for (size_t i = 0; i < NGLI_ARRAY_NB(lerp_sizes); i++) {
+        const size_t n = lerp_sizes[i];
+        printf(":: Testing lerp f32 (n=%zu)\n", n);
+
+        float v1[34], v2[34], ref[34], out[34] = {0}, diff[34];
+        for (size_t k = 0; k < n + 1; k++) {
+            v1[k] = m1[k % 16] * (float)(k + 1);
+            v2[k] = m2[k % 16] - (float)k;
+        }
+
+        ngli_lerp_f32_c(ref, v1 + 1, v2 + 1, 0.37f, n);
+        ngli_lerp_f32(out, v1 + 1, v2 + 1, 0.37f, n);
+        flt_diff(diff, ref, out, n);
+        flt_check(diff, n);
+
+        /* In-place */
+        ngli_lerp_f32(v1 + 1, v1 + 1, v2 + 1, 0.37f, n);
+        flt_diff(diff, ref, v1 + 1, n);
+        flt_check(diff, n);
+    }
+
     return 0;
 }
@@ -120,6 +120,85 @@ static const struct test_expr expressions[] = {
 
 static const float vars_data[] = {1.234f, -7.9f, 0.231f};
 
+static const char * const batch_expressions[] = {
+    "",
+    "4*pi",
+    "y",
+    "3+-6--+x",
+    "5*(3+2)-(1/4+6)*exp(x)",
+    "mix(x, 3*(y + 1), z/2 + ceil(cos(3*pi/4)*5)) + .5",
+    "smoothstep(x, -z, 1/2) * x / (1 + y*y)",
+};
+
+#define BATCH_COUNT 150
+
+/*
+ * Compare the batch evaluation (with x and z bound to arrays and y kept to its
+ * current value) against the evaluations of each variable set one by one
+ */
+static int test_batch(const char *expr)
+{
+    int ret = 0;
+    float vars_cur[3] = {0.f, -7.9f, 0.f};
+    float x_data[BATCH_COUNT];
+    float z_data[BATCH_COUNT * 2];
+    float batch_res[BATCH_COUNT];
+
+    for (size_t i = 0; i < BATCH_COUNT; i++) {
+        x_data[i] = -2.f + (float)i * 0.03f;
+        z_data[i * 2] = 0.5f - (float)i * 0.01f;
+        z_data[i * 2 + 1] = NAN;
+    }
+
+    struct eval *e = ngli_eval_create();
+    struct hmap *vars = ngli_hmap_create(NGLI_HMAP_TYPE_STR);
+    if (!e || !vars) {
+        ret = -1;
+        goto end;
+    }
+
+    if ((ret = ngli_hmap_set_str(vars, "x", &vars_cur[0])) < 0 ||
+        (ret = ngli_hmap_set_str(vars, "y", &vars_cur[1])) < 0 ||
+        (ret = ngli_hmap_set_str(vars, "z", &vars_cur[2])) < 0 ||
+        (ret = ngli_eval_init(e, expr, vars)) < 0)
+        goto end;
+
+    const struct eval_binding bindings[] = {
+        {.name="x", .data=x_data, .stride=1},
+        {.name="z", .data=z_data, .stride=2},
+    };
+    ret = ngli_eval_run_batch(e, batch_res, BATCH_COUNT, bindings, NGLI_ARRAY_NB(bindings));
+    if (ret < 0)
+        goto end;
+
+    for (size_t i = 0; i < BATCH_COUNT; i++) {
+        vars_cur[0] = x_data[i];
+        vars_cur[2] = z_data[i * 2];
+        float f;
+        if ((ret = ngli_eval_run(e, &f)) < 0)
+            goto end;
+        if (f != batch_res[i] && !(isnan(f) && isnan(batch_res[i]))) {
+            fprintf(stderr, "E: batch \"%s\" evaluation %zu = %g but expected %g\n", expr, i, batch_res[i], f);
+            ret = -1;
+            goto end;
+        }
+    }
+
+    const struct eval_binding invalid_binding = {.name="w", .data=x_data, .stride=1};
+    if (ngli_eval_run_batch(e, batch_res, BATCH_COUNT, &invalid_binding, 1) >= 0) {
+        fprintf(stderr, "E: batch \"%s\" with unknown variable didn't fail\n", expr);
+        ret = -1;
+        goto end;
+    }
+
+    printf("[OK] batch \"%s\"\n", expr);
+
+end:
+    ngli_hmap_freep(&vars);
+    ngli_eval_freep(&e);
+    return ret;
+}
+
 static int test_expr(const struct hmap *vars, const struct test_expr *test_e)
 {
     int ret = 0;
@@ -183,11 +262,16 @@ int main(int ac, char **av)
     for (size_t i = 0; i < nb_expr; i++)
         failed += test_expr(vars, &expressions[i]) < 0;
 
+    static const size_t nb_batch_expr = NGLI_ARRAY_NB(batch_expressions);
+    for (size_t i = 0; i < nb_batch_expr; i++)
+        failed += test_batch(batch_expressions[i]) < 0;
+
+    const size_t nb_tests = nb_expr + nb_batch_expr;
     if (failed) {
-        fprintf(stderr, "%zu/%zu failed test(s)\n", failed, nb_expr);
+        fprintf(stderr, "%zu/%zu failed test(s)\n", failed, nb_tests);
         ret = 1;
     } else {
-        printf("%zu/%zu tests passing\n", nb_expr, nb_expr);
+        printf("%zu/%zu tests passing\n", nb_tests, nb_tests);
     }
 
 end:
@@ -0,0 +1,147 @@
+/*
+ * Copyright 2026 Matthieu Bouron <matthieu.bouron@gmail.com>
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "utils/memory.h"
+#include "utils/scheduler.h"
+#include "utils/utils.h"
+
+#define NB_TASKS 256
+#define NB_ELEMS 100003
+
+struct test_ctx {
+    struct ngli_scheduler *scheduler;
+    uint32_t nb_threads;
+    atomic_int counter;
+    int done[NB_TASKS];
+    uint8_t *elems;
+};
+
+static void increment(void *arg, uint32_t thread_index)
+{
+    int *done = arg;
+    *done = 1;
+}
+
+static void test_group(struct test_ctx *ctx)
+{
+    for (int round = 0; round < 4; round++) {
+        struct ngli_task_group group;
+        ngli_task_group_init(&group, ctx->scheduler);
+        for (int i = 0; i < NB_TASKS; i++) {
+            ctx->done[i] = 0;
+            ngli_task_group_run(&group, increment, &ctx->done[i]);
+        }
+        ngli_task_group_wait(&group);
+        for (int i = 0; i < NB_TASKS; i++)
+            ngli_assert(ctx->done[i]);
+
+        /* Waiting on a completed group must return immediately */
+        ngli_task_group_wait(&group);
+        ngli_task_group_reset(&group);
+    }
+}
+
+static void count_leaf(void *arg, uint32_t thread_index)
+{
+    struct test_ctx *ctx = arg;
+    ngli_assert(thread_index < ctx->nb_threads);
+    atomic_fetch_add(&ctx->counter, 1);
+}
+
+static void spawn_leaves(void *arg, uint32_t thread_index)
+{
+    struct test_ctx *ctx = arg;
+
+    /* Waiting from within a task must not dead-lock the workers */
+    struct ngli_task_group group;
+    ngli_task_group_init(&group, ctx->scheduler);
+    for (int i = 0; i < 16; i++)
+        ngli_task_group_run(&group, count_leaf, ctx);
+    ngli_task_group_wait(&group);
+    ngli_task_group_reset(&group);
+}
+
+static void test_nested_groups(struct test_ctx *ctx)
+{
+    atomic_store(&ctx->counter, 0);
+
+    struct ngli_task_group group;
+    ngli_task_group_init(&group, ctx->scheduler);
+    for (int i = 0; i < 64; i++)
+        ngli_task_group_run(&group, spawn_leaves, ctx);
+    ngli_task_group_wait(&group);
+    ngli_task_group_reset(&group);
+
+    ngli_assert(atomic_load(&ctx->counter) == 64 * 16);
+}
+
+static void mark_range(void *arg, size_t start, size_t end, uint32_t thread_index)
+{
+    struct test_ctx *ctx = arg;
+    ngli_assert(start < end && end <= NB_ELEMS);
+    ngli_assert(thread_index < ctx->nb_threads);
+    for (size_t i = start; i < end; i++)
+        ctx->elems[i]++;
+}
+
+static void test_parallel_for(struct test_ctx *ctx)
+{
+    static const size_t grain_sizes[] = {0, 1, 1000, NB_ELEMS, NB_ELEMS * 2};
+    for (size_t i = 0; i < NGLI_ARRAY_NB(grain_sizes); i++) {
+        memset(ctx->elems, 0, NB_ELEMS);
+        ngli_parallel_for(ctx->scheduler, NB_ELEMS, grain_sizes[i], mark_range, ctx);
+        for (size_t j = 0; j < NB_ELEMS; j++)
+            ngli_assert(ctx->elems[j] == 1);
+    }
+
+    /* Empty ranges must not call the function */
+    ngli_parallel_for(ctx->scheduler, 0, 0, mark_range, ctx);
+}
+
+static void run_tests(uint32_t nb_threads)
+{
+    struct test_ctx ctx = {.nb_threads = nb_threads};
+    ctx.scheduler = ngli_scheduler_create("test", nb_threads);
+    ngli_assert(ctx.scheduler);
+    ngli_assert(ngli_scheduler_get_nb_threads(ctx.scheduler) == nb_threads);
+    ctx.elems = ngli_calloc(NB_ELEMS, sizeof(*ctx.elems));
+    ngli_assert(ctx.elems);
+
+    test_group(&ctx);
+    test_nested_groups(&ctx);
+    test_parallel_for(&ctx);
+
+    ngli_freep(&ctx.elems);
+    ngli_scheduler_freep(&ctx.scheduler);
+    ngli_assert(!ctx.scheduler);
+}
+
+int main(void)
+{
+    run_tests(1);
+    run_tests(2);
+    run_tests(8);
+    return 0;
+}
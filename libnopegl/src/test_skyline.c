@@ -0,0 +1,143 @@
+/*
+ * Copyright 2026 Matthieu Bouron <matthieu.bouron@gmail.com>
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "nopegl/nopegl.h"
+#include "skyline.h"
+#include "utils/memory.h"
+#include "utils/utils.h"
+
+#define NB_RECTS 800
+
+static uint32_t random_state = 0x12345678;
+
+static int32_t random_i32(int32_t min, int32_t max)
+{
+    random_state = random_state * 1664525 + 1013904223;
+    return min + (int32_t)((random_state >> 8) % (uint32_t)(max - min + 1));
+}
+
+static void check_no_overlap(const int32_t *rects, size_t nb_rects, int32_t width, int32_t height)
+{
+    for (size_t i = 0; i < nb_rects; i++) {
+        const int32_t *a = &rects[i * 4];
+        ngli_assert(a[0] >= 0 && a[1] >= 0);
+        ngli_assert(a[0] + a[2] <= width && a[1] + a[3] <= height);
+        for (size_t j = 0; j < i; j++) {
+            const int32_t *b = &rects[j * 4];
+            const int overlap = a[0] < b[0] + b[2] && b[0] < a[0] + a[2] &&
+                                a[1] < b[1] + b[3] && b[1] < a[1] + a[3];
+            ngli_assert(!overlap);
+        }
+    }
+}
+
+static void test_random(void)
+{
+    struct skyline *s = ngli_skyline_create();
+    ngli_assert(s);
+    ngli_assert(ngli_skyline_init(s, 64, 64) == 0);
+
+    int32_t *rects = ngli_calloc(NB_RECTS, 4 * sizeof(*rects));
+    ngli_assert(rects);
+
+    /* Mostly small glyph-like rectangles with a few large ones */
+    int64_t area = 0;
+    for (size_t i = 0; i < NB_RECTS; i++) {
+        int32_t *rect = &rects[i * 4];
+        rect[2] = i % 40 == 0 ? random_i32(40, 96) : random_i32(4, 24);
+        rect[3] = i % 40 == 0 ? random_i32(40, 96) : random_i32(4, 24);
+        area += (int64_t)rect[2] * rect[3];
+
+        /* Grow the bin like the atlas does until the rectangle fits */
+        int ret;
+        while ((ret = ngli_skyline_insert(s, rect[2], rect[3], &rect[0], &rect[1])) == NGL_ERROR_LIMIT_EXCEEDED) {
+            int32_t width, height;
+            ngli_skyline_get_size(s, &width, &height);
+
+            /* The bin should only need to grow once reasonably filled */
+            const int64_t used_area = ngli_skyline_get_used_area(s);
+            ngli_assert(!used_area || used_area * 2 >= (int64_t)width * height);
+
+            if (width <= height)
+                width *= 2;
+            else
+                height *= 2;
+            ngli_assert(ngli_skyline_grow(s, width, height) == 0);
+        }
+        ngli_assert(ret == 0);
+    }
+
+    int32_t width, height;
+    ngli_skyline_get_size(s, &width, &height);
+    check_no_overlap(rects, NB_RECTS, width, height);
+    ngli_assert(ngli_skyline_get_used_area(s) == area);
+
+    const double efficiency = (double)area / ((double)width * (double)height);
+    printf("packed %d rectangles in %dx%d (%.1f%%)\n", NB_RECTS, width, height, efficiency * 100.0);
+
+    ngli_freep(&rects);
+    ngli_skyline_freep(&s);
+    ngli_assert(!s);
+}
+
+static void test_limits(void)
+{
+    struct skyline *s = ngli_skyline_create();
+    ngli_assert(s);
+    ngli_assert(ngli_skyline_init(s, 16, 16) == 0);
+
+    int32_t x, y;
+    ngli_assert(ngli_skyline_insert(s, 17, 1, &x, &y) == NGL_ERROR_LIMIT_EXCEEDED);
+    ngli_assert(ngli_skyline_insert(s, 1, 17, &x, &y) == NGL_ERROR_LIMIT_EXCEEDED);
+    ngli_assert(ngli_skyline_insert(s, 0, 1, &x, &y) == NGL_ERROR_INVALID_ARG);
+
+    /* Fill the bin exactly */
+    for (int i = 0; i < 4; i++) {
+        ngli_assert(ngli_skyline_insert(s, 8, 8, &x, &y) == 0);
+        ngli_assert(x == (i % 2) * 8 && y == (i / 2) * 8);
+    }
+    ngli_assert(ngli_skyline_insert(s, 1, 1, &x, &y) == NGL_ERROR_LIMIT_EXCEEDED);
+    ngli_assert(ngli_skyline_get_used_area(s) == 16 * 16);
+
+    /* Growing keeps the existing rectangles and exposes the new space */
+    ngli_assert(ngli_skyline_grow(s, 8, 16) == NGL_ERROR_INVALID_ARG);
+    ngli_assert(ngli_skyline_grow(s, 32, 16) == 0);
+    ngli_assert(ngli_skyline_insert(s, 16, 16, &x, &y) == 0);
+    ngli_assert(x == 16 && y == 0);
+    ngli_assert(ngli_skyline_grow(s, 32, 24) == 0);
+    ngli_assert(ngli_skyline_insert(s, 32, 8, &x, &y) == 0);
+    ngli_assert(x == 0 && y == 16);
+
+    ngli_skyline_freep(&s);
+}
+
+int main(void)
+{
+    test_random();
+    test_limits();
+
+    printf("skyline OK\n");
+    return 0;
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright 2026 Matthieu Bouron <matthieu.bouron@gmail.com>
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "spatial_grid.h"
+#include "utils/utils.h"
+
+#define NB_BOXES 500
+#define NB_QUERIES 2000
+
+static uint32_t random_state = 0x12345678;
+
+static float random_float(float min, float max)
+{
+    random_state = random_state * 1664525 + 1013904223;
+    return min + (float)(random_state >> 8) / (float)(1 << 24) * (max - min);
+}
+
+static void check_results(const uint32_t *indices, size_t nb_indices, const int *refs)
+{
+    size_t nb_refs = 0;
+    for (size_t i = 0; i < NB_BOXES; i++)
+        if (refs[i])
+            nb_refs++;
+    ngli_assert(nb_indices == nb_refs);
+    for (size_t i = 0; i < nb_indices; i++) {
+        ngli_assert(refs[indices[i]]);
+        if (i)
+            ngli_assert(indices[i - 1] < indices[i]);
+    }
+}
+
+static void test_random(struct spatial_grid *grid, float *boxes)
+{
+    for (size_t i = 0; i < NB_BOXES; i++) {
+        float *box = &boxes[i * 4];
+        /* Mostly small boxes with a few large ones and some empty ones */
+        const float size = i % 50 == 0 ? random_float(500.f, 1000.f) : random_float(1.f, 60.f);
+        box[0] = random_float(-100.f, 1000.f);
+        box[1] = random_float(-100.f, 1000.f);
+        box[2] = box[0] + size;
+        box[3] = box[1] + size * random_float(0.2f, 2.f);
+        if (i % 37 == 0) {
+            box[2] = box[0] - 1.f;
+        } else if (i % 41 == 0) {
+            box[2] = NAN;
+        }
+    }
+    ngli_assert(ngli_spatial_grid_build(grid, boxes, NB_BOXES) == 0);
+
+    int refs[NB_BOXES];
+    for (size_t q = 0; q < NB_QUERIES; q++) {
+        const float x = random_float(-200.f, 1200.f);
+        const float y = random_float(-200.f, 1200.f);
+        for (size_t i = 0; i < NB_BOXES; i++) {
+            const float *box = &boxes[i * 4];
+            refs[i] = x >= box[0] && x <= box[2] && y >= box[1] && y <= box[3];
+        }
+
+        const uint32_t *indices;
+        size_t nb_indices;
+        ngli_assert(ngli_spatial_grid_query_point(grid, x, y, &indices, &nb_indices) == 0);
+        check_results(indices, nb_indices, refs);
+
+        const float query[] = {x, y, x + random_float(0.f, 300.f), y + random_float(0.f, 300.f)};
+        for (size_t i = 0; i < NB_BOXES; i++) {
+            const float *box = &boxes[i * 4];
+            refs[i] = box[0] <= box[2] && box[1] <= box[3] &&
+                      query[0] <= box[2] && query[2] >= box[0] &&
+                      query[1] <= box[3] && query[3] >= box[1];
+        }
+        ngli_assert(ngli_spatial_grid_query_box(grid, query, &indices, &nb_indices) == 0);
+        check_results(indices, nb_indices, refs);
+    }
+}
+
+static void test_degenerate(struct spatial_grid *grid)
+{
+    const uint32_t *indices;
+    size_t nb_indices;
+
+    /* Queries on an empty grid */
+    ngli_assert(ngli_spatial_grid_build(grid, NULL, 0) == 0);
+    ngli_assert(ngli_spatial_grid_query_point(grid, 0.f, 0.f, &indices, &nb_indices) == 0);
+    ngli_assert(nb_indices == 0);
+
+    /* Zero-area boxes sharing the same coordinates */
+    const float boxes[] = {
+        10.f, 10.f, 10.f, 10.f,
+        10.f,  0.f, 10.f, 20.f,
+        10.f, 10.f, 10.f, 10.f,
+    };
+    ngli_assert(ngli_spatial_grid_build(grid, boxes, 3) == 0);
+    ngli_assert(ngli_spatial_grid_query_point(grid, 10.f, 10.f, &indices, &nb_indices) == 0);
+    ngli_assert(nb_indices == 3);
+    ngli_assert(indices[0] == 0 && indices[1] == 1 && indices[2] == 2);
+    ngli_assert(ngli_spatial_grid_query_point(grid, 10.f, 15.f, &indices, &nb_indices) == 0);
+    ngli_assert(nb_indices == 1 && indices[0] == 1);
+    ngli_assert(ngli_spatial_grid_query_point(grid, 11.f, 10.f, &indices, &nb_indices) == 0);
+    ngli_assert(nb_indices == 0);
+}
+
+int main(void)
+{
+    struct spatial_grid *grid = ngli_spatial_grid_create();
+    ngli_assert(grid);
+
+    float boxes[NB_BOXES * 4];
+    for (int i = 0; i < 4; i++)
+        test_random(grid, boxes);
+    test_degenerate(grid);
+
+    ngli_spatial_grid_freep(&grid);
+    ngli_assert(!grid);
+
+    printf("spatial grid OK\n");
+    return 0;
+}
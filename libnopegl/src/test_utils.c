@@ -21,6 +21,7 @@
 
 #include "utils/crc32.h"
 #include "utils/memory.h"
+#include "utils/search.h"
 #include "utils/string.h"
 #include "utils/utils.h"
 
@@ -32,6 +33,30 @@ static void test_numbered_line(uint32_t crc, const char *s)
     ngli_freep(&p);
 }
 
+static size_t search_timestamp_ref(const int64_t *timestamps, size_t nb_timestamps, int64_t t)
+{
+    size_t ret = SIZE_MAX;
+    for (size_t i = 0; i < nb_timestamps && timestamps[i] <= t; i++)
+        ret = i;
+    return ret;
+}
+
+static void test_search_timestamp(void)
+{
+    /* Includes duplicated timestamps */
+    static const int64_t timestamps[] = {0, 10, 10, 20, 30, 30, 30, 40, 50, 60, 70, 80, 90};
+    const size_t nb_timestamps = NGLI_ARRAY_NB(timestamps);
+
+    ngli_assert(ngli_search_timestamp(timestamps, 0, 0, 0) == SIZE_MAX);
+    for (size_t n = 1; n <= nb_timestamps; n++) {
+        for (int64_t t = -5; t <= 95; t += 5) {
+            const size_t ref = search_timestamp_ref(timestamps, n, t);
+            for (size_t hint = 0; hint <= n; hint++)
+                ngli_assert(ngli_search_timestamp(timestamps, n, hint, t) == ref);
+        }
+    }
+}
+
 int main(void)
 {
     ngli_assert(ngli_crc32("") == 0);
@@ -50,5 +75,7 @@ int main(void)
     test_numbered_line(0x00000000, "");
     test_numbered_line(0x25b15360, X X X X X X X X X);
     test_numbered_line(0x759455a5, X X X X X X X X X X);
+
+    test_search_timestamp();
     return 0;
 }
@@ -28,6 +28,7 @@
 #include "log.h"
 #include "math_utils.h"
 #include <ngpu/ngpu.h>
+#include "node_animkeyframe.h"
 #include "node_text.h"
 #include "node_texteffect.h"
 #include "node_uniform.h"
@@ -123,6 +124,103 @@ struct text *ngli_text_create(struct ngl_ctx *ctx)
     return s;
 }
 
+/*
+ * Whether the value of the node at a target time outside [0,1] is the value
+ * at the nearest bound, so that sampling it over [0,1] is exact
+ */
+static bool is_node_sampleable(const struct ngl_node *node)
+{
+    switch (node->cls->id) {
+    case NGL_NODE_ANIMKEYFRAMEFLOAT:
+    case NGL_NODE_ANIMKEYFRAMEVEC2:
+    case NGL_NODE_ANIMKEYFRAMEVEC3:
+    case NGL_NODE_ANIMKEYFRAMEVEC4:
+    case NGL_NODE_ANIMKEYFRAMEQUAT:
+    case NGL_NODE_ANIMKEYFRAMECOLOR: {
+        const struct animkeyframe_opts *kf = node->opts;
+        return kf->time >= 0.0 && kf->time <= 1.0;
+    }
+    case NGL_NODE_ANIMATEDFLOAT:
+    case NGL_NODE_ANIMATEDVEC2:
+    case NGL_NODE_ANIMATEDVEC3:
+    case NGL_NODE_ANIMATEDVEC4:
+    case NGL_NODE_ANIMATEDQUAT:
+    case NGL_NODE_ANIMATEDCOLOR: {
+        /* The keyframes are only checked in the absence of time offset */
+        const struct variable_opts *o = node->opts;
+        if (o->time_offset != 0.0)
+            return false;
+        break;
+    }
+    case NGL_NODE_UNIFORMFLOAT:
+    case NGL_NODE_UNIFORMVEC2:
+    case NGL_NODE_UNIFORMVEC3:
+    case NGL_NODE_UNIFORMVEC4:
+    case NGL_NODE_UNIFORMQUAT:
+    case NGL_NODE_UNIFORMCOLOR:
+    case NGL_NODE_UNIFORMMAT4:
+    case NGL_NODE_ROTATE:
+    case NGL_NODE_ROTATEQUAT:
+    case NGL_NODE_TRANSFORM:
+    case NGL_NODE_TRANSLATE:
+    case NGL_NODE_SCALE:
+    case NGL_NODE_SKEW:
+    case NGL_NODE_IDENTITY:
+        break;
+    default:
+        return false;
+    }
+
+    for (size_t i = 0; i < node->children.count; i++)
+        if (!is_node_sampleable(node->children.data[i]))
+            return false;
+    return true;
+}
+
+static bool is_effect_sampleable(const struct texteffect_opts *o)
+{
+    const struct ngl_node *nodes[] = {
+        o->transform_chain,
+        o->color_node,
+        o->opacity_node,
+        o->outline_node,
+        o->outline_color_node,
+        o->outline_pos_node,
+        o->glow_node,
+        o->glow_color_node,
+        o->blur_node,
+    };
+    for (size_t i = 0; i < NGLI_ARRAY_NB(nodes); i++)
+        if (nodes[i] && !is_node_sampleable(nodes[i]))
+            return false;
+    return true;
+}
+
+static int init_effects_gpu(struct text *s)
+{
+    struct text_effects_gpu *gpu = &s->effects_gpu;
+
+    const size_t nb_effects = s->config.nb_effect_nodes;
+    if (!s->config.sampled_effects || !nb_effects || nb_effects > NGLI_TEXT_MAX_GPU_EFFECTS)
+        return 0;
+
+    for (size_t i = 0; i < nb_effects; i++) {
+        const struct texteffect_opts *effect_opts = s->config.effect_nodes[i]->opts;
+        if (!is_effect_sampleable(effect_opts))
+            return 0;
+    }
+
+    gpu->lut = ngli_calloc(nb_effects * NGLI_TEXT_EFFECTS_LUT_ROWS * NGLI_TEXT_EFFECTS_LUT_SIZE, 4 * sizeof(*gpu->lut));
+    gpu->lut_revs = ngli_calloc(nb_effects, sizeof(*gpu->lut_revs));
+    if (!gpu->lut || !gpu->lut_revs)
+        return NGL_ERROR_MEMORY;
+    for (size_t i = 0; i < nb_effects; i++)
+        gpu->lut_revs[i] = SIZE_MAX;
+
+    gpu->enabled = true;
+    return 0;
+}
+
 int ngli_text_init(struct text *s, const struct text_config *cfg)
 {
     s->config = *cfg;
@@ -131,6 +229,10 @@ int ngli_text_init(struct text *s, const struct text_config *cfg)
     if (!s->effects)
         return NGL_ERROR_MEMORY;
 
+    int ret = init_effects_gpu(s);
+    if (ret < 0)
+        return ret;
+
     s->cls = cfg->font_faces ? &ngli_text_external : &ngli_text_builtin;
     if (s->cls->priv_size) {
         s->priv_data = ngli_calloc(1, s->cls->priv_size);
@@ -153,6 +255,17 @@ void ngli_text_release(struct text *s)
         s->cls->release(s);
 }
 
+int ngli_text_refresh_atlas(struct text *s)
+{
+    if (!s->cls->refresh_atlas)
+        return 0;
+
+    const struct ngpu_texture *curve_texture = s->curve_texture;
+    const struct ngpu_texture *band_texture = s->band_texture;
+    s->cls->refresh_atlas(s);
+    return s->curve_texture != curve_texture || s->band_texture != band_texture;
+}
+
 /* Apply the new defaults to the user exposed data */
 static void reset_chars_data_to_defaults(struct text *s)
 {
@@ -312,6 +425,8 @@ static void fill_default_data_buffers(struct text *s, size_t nb_chars)
 
 void ngli_text_update_effects_defaults(struct text *s, const struct text_effects_defaults *defaults)
 {
+    if (memcmp(&s->config.defaults, defaults, sizeof(*defaults)))
+        s->defaults_changed = 1;
     s->config.defaults = *defaults;
 
     const size_t nb_chars = s->chars.count;
@@ -328,8 +443,11 @@ void ngli_text_refresh_geometry_data(struct text *s)
     const struct text_data_pointers defaults_ptr = get_chr_data_pointers(s->chars_data_default, nb_chars);
     set_geometry_data(s, defaults_ptr);
 
-    for (size_t i = 0; i < nb_chars; i++) memcpy(s->data_ptrs.vertices,     defaults_ptr.vertices,     nb_chars * 4 * sizeof(float));
-    for (size_t i = 0; i < nb_chars; i++) memcpy(s->data_ptrs.atlas_coords, defaults_ptr.atlas_coords, nb_chars * 4 * sizeof(float));
+    memcpy(s->data_ptrs.vertices,     defaults_ptr.vertices,     nb_chars * 4 * sizeof(float));
+    memcpy(s->data_ptrs.atlas_coords, defaults_ptr.atlas_coords, nb_chars * 4 * sizeof(float));
+
+    s->dirty_start = 0;
+    s->dirty_end = nb_chars;
 }
 
 static int set_value_from_node(float *dst, struct ngl_node *node, double t)
@@ -559,6 +677,57 @@ static int build_effects_segmentation(struct text *s)
     return 0;
 }
 
+/* Expose the segmentation of the characters to the vertex shader */
+static int build_effects_chars(struct text *s)
+{
+    struct text_effects_gpu *gpu = &s->effects_gpu;
+    if (!gpu->enabled)
+        return 0;
+
+    const size_t nb_effects = s->config.nb_effect_nodes;
+    const size_t nb_chars = s->chars.count;
+    if (!nb_chars)
+        return 0;
+
+    const size_t chars_rows = (nb_chars + NGLI_TEXT_EFFECTS_CHARS_WIDTH - 1) / NGLI_TEXT_EFFECTS_CHARS_WIDTH;
+
+    const struct ngpu_limits *limits = ngpu_ctx_get_limits(s->ctx->gpu_ctx);
+    if (nb_effects * chars_rows > limits->max_texture_dimension_2d) {
+        LOG(WARNING, "too many characters to evaluate the effects on the GPU, falling back on the CPU");
+        gpu->enabled = false;
+        return 0;
+    }
+
+    const size_t nb_texels = nb_effects * chars_rows * NGLI_TEXT_EFFECTS_CHARS_WIDTH;
+    float *chars = ngli_calloc(nb_texels, 4 * sizeof(*chars));
+    if (!chars)
+        return NGL_ERROR_MEMORY;
+
+    for (size_t i = 0; i < nb_effects; i++) {
+        const struct effect_segmentation *effect = &s->effects[i];
+        float *dst = chars + i * chars_rows * NGLI_TEXT_EFFECTS_CHARS_WIDTH * 4;
+        for (size_t c = 0; c < nb_chars; c++) {
+            const struct char_info *chr = &s->chars.data[c];
+            const float texel[] = {(float)effect->positions[c], NGLI_ARG_VEC2(chr->real_dim), 0.f};
+            memcpy(dst + c * 4, texel, sizeof(texel));
+        }
+    }
+
+    /* Live changes often keep the same segmentation, in which case there is nothing to upload */
+    if (gpu->chars && gpu->chars_rows == chars_rows &&
+        !memcmp(gpu->chars, chars, nb_texels * 4 * sizeof(*chars))) {
+        ngli_freep(&chars);
+        return 0;
+    }
+
+    ngli_freep(&gpu->chars);
+    gpu->chars = chars;
+    gpu->chars_rows = chars_rows;
+    gpu->chars_changed = true;
+
+    return 0;
+}
+
 static void destroy_effects_data(struct text *s)
 {
     /*
@@ -575,6 +744,53 @@ static void destroy_effects_data(struct text *s)
     s->chars_data_size = 0;
 
     memset(&s->data_ptrs, 0, sizeof(s->data_ptrs)); // user may still be reading them
+
+    ngli_freep(&s->effects_gpu.chars);
+    s->effects_gpu.chars_rows = 0;
+}
+
+static bool chars_are_equal(const struct char_info *a, const struct char_info *b)
+{
+    return !memcmp(&a->geom, &b->geom, sizeof(a->geom)) &&
+           !memcmp(&a->atlas_coords, &b->atlas_coords, sizeof(a->atlas_coords)) &&
+           !memcmp(a->real_dim, b->real_dim, sizeof(a->real_dim)) &&
+           !memcmp(&a->slug, &b->slug, sizeof(a->slug));
+}
+
+/*
+ * Find the range of characters whose geometry changed compared to the
+ * previous string. The characters are laid out in the same text box, so the
+ * normalized geometry of the characters is comparable as long as the text
+ * dimensions did not change; otherwise (or if the defaults changed)
+ * everything is dirty.
+ */
+static void update_dirty_range(struct text *s, int32_t prev_width, int32_t prev_height)
+{
+    const size_t nb_chars = s->chars.count;
+    const size_t nb_prev_chars = s->prev_chars.count;
+
+    if (s->defaults_changed || s->width != prev_width || s->height != prev_height) {
+        s->dirty_start = 0;
+        s->dirty_end = nb_chars;
+        return;
+    }
+
+    const struct char_info *chars = s->chars.data;
+    const struct char_info *prev_chars = s->prev_chars.data;
+
+    size_t start = 0;
+    const size_t nb_common = NGLI_MIN(nb_chars, nb_prev_chars);
+    while (start < nb_common && chars_are_equal(&chars[start], &prev_chars[start]))
+        start++;
+
+    /* The characters following an insertion or a removal are shifted, so they are all dirty */
+    size_t end = nb_chars;
+    if (nb_chars == nb_prev_chars)
+        while (end > start && chars_are_equal(&chars[end - 1], &prev_chars[end - 1]))
+            end--;
+
+    s->dirty_start = start;
+    s->dirty_end = end;
 }
 
 static size_t next_pow2(size_t x)
@@ -589,8 +805,16 @@ int ngli_text_set_string(struct text *s, const char *str)
 {
     struct box_stats stats = {0};
 
+    /* Keep the previous characters around to find out which ones changed */
+    const struct ngli_char_info_darray prev_chars = s->prev_chars;
+    s->prev_chars = s->chars;
+    s->chars = prev_chars;
+    const int32_t prev_width = s->width;
+    const int32_t prev_height = s->height;
+
     ngli_darray_clear(&s->chars);
     ngli_darray_clear(&s->chars_internal);
+    s->dirty_start = s->dirty_end = 0;
 
     int ret = s->cls->set_string(s, str, &s->chars_internal);
     if (ret < 0)
@@ -720,21 +944,151 @@ int ngli_text_set_string(struct text *s, const char *str)
 
     reset_chars_data_to_defaults(s);
 
+    update_dirty_range(s, prev_width, prev_height);
+    s->defaults_changed = 0;
+
     /* Assign each character to an effect */
     ret = build_effects_segmentation(s);
     if (ret < 0)
         return ret;
 
+    ret = build_effects_chars(s);
+    if (ret < 0)
+        return ret;
+
 end:
     box_stats_reset(&stats);
     return ret;
 }
 
+static uint32_t get_effect_mask(const struct texteffect_opts *o)
+{
+    uint32_t mask = 0;
+    if (o->transform_chain)                          mask |= NGLI_TEXT_EFFECT_PARAM_TRANSFORM;
+    if (o->color_node || o->color[0] >= 0.f)         mask |= NGLI_TEXT_EFFECT_PARAM_COLOR;
+    if (o->opacity_node || o->opacity >= 0.f)        mask |= NGLI_TEXT_EFFECT_PARAM_OPACITY;
+    if (o->outline_color_node || o->outline_color[0] >= 0.f) mask |= NGLI_TEXT_EFFECT_PARAM_OUTLINE_COLOR;
+    if (o->outline_node || o->outline >= 0.f)        mask |= NGLI_TEXT_EFFECT_PARAM_OUTLINE;
+    if (o->glow_color_node || o->glow_color[0] >= 0.f) mask |= NGLI_TEXT_EFFECT_PARAM_GLOW_COLOR;
+    if (o->glow_node || o->glow >= 0.f)              mask |= NGLI_TEXT_EFFECT_PARAM_GLOW;
+    if (o->blur_node || o->blur >= 0.f)              mask |= NGLI_TEXT_EFFECT_PARAM_BLUR;
+    if (o->outline_pos_node || o->outline_pos >= 0.f) mask |= NGLI_TEXT_EFFECT_PARAM_OUTLINE_POS;
+    return mask;
+}
+
+#define LUT_TEXEL(lut, row, k) ((lut) + ((size_t)(row) * NGLI_TEXT_EFFECTS_LUT_SIZE + (k)) * 4)
+
+/* Sample the parameters of an effect over the target time range [0,1] */
+static int sample_effect_params(struct text *s, size_t index)
+{
+    const struct texteffect_opts *effect_opts = s->config.effect_nodes[index]->opts;
+    float *lut = s->effects_gpu.lut + index * NGLI_TEXT_EFFECTS_LUT_ROWS * NGLI_TEXT_EFFECTS_LUT_SIZE * 4;
+
+    for (size_t k = 0; k < NGLI_TEXT_EFFECTS_LUT_SIZE; k++) {
+        const double t = (double)k / (double)(NGLI_TEXT_EFFECTS_LUT_SIZE - 1);
+
+        struct ngli_mat4 tm = {.m = NGLI_MAT4_IDENTITY};
+        if (effect_opts->transform_chain) {
+            int ret = ngli_node_update(effect_opts->transform_chain, t);
+            if (ret < 0)
+                return ret;
+            ngli_transform_chain_compute(effect_opts->transform_chain, tm.m);
+        }
+
+        float color[4] = {0}, outline[4] = {0}, glow[4] = {0}, misc[4] = {0};
+
+        int ret;
+        if ((ret = set_vec3_value(color,       effect_opts->color_node,         effect_opts->color,         t)) < 0 ||
+            (ret = set_f32_value( color + 3,   effect_opts->opacity_node,       effect_opts->opacity,       t)) < 0 ||
+            (ret = set_vec3_value(outline,     effect_opts->outline_color_node, effect_opts->outline_color, t)) < 0 ||
+            (ret = set_f32_value( outline + 3, effect_opts->outline_node,       effect_opts->outline,       t)) < 0 ||
+            (ret = set_vec3_value(glow,        effect_opts->glow_color_node,    effect_opts->glow_color,    t)) < 0 ||
+            (ret = set_f32_value( glow + 3,    effect_opts->glow_node,          effect_opts->glow,          t)) < 0 ||
+            (ret = set_f32_value( misc,        effect_opts->blur_node,          effect_opts->blur,          t)) < 0 ||
+            (ret = set_f32_value( misc + 1,    effect_opts->outline_pos_node,   effect_opts->outline_pos,   t)) < 0)
+            return ret;
+
+        for (size_t j = 0; j < 4; j++)
+            memcpy(LUT_TEXEL(lut, j, k), tm.m + j * 4, 4 * sizeof(float));
+        memcpy(LUT_TEXEL(lut, 4, k), color,   sizeof(color));
+        memcpy(LUT_TEXEL(lut, 5, k), outline, sizeof(outline));
+        memcpy(LUT_TEXEL(lut, 6, k), glow,    sizeof(glow));
+        memcpy(LUT_TEXEL(lut, 7, k), misc,    sizeof(misc));
+    }
+
+    return 0;
+}
+
+static int set_time_gpu(struct text *s, double t)
+{
+    struct text_effects_gpu *gpu = &s->effects_gpu;
+
+    for (size_t i = 0; i < s->config.nb_effect_nodes; i++) {
+        struct ngl_node *effect_node = s->config.effect_nodes[i];
+        const struct texteffect_opts *effect_opts = effect_node->opts;
+        struct text_effect_frame_params *params = &gpu->params[i];
+
+        /* The effect parameters only need to be sampled again after a live change */
+        if (gpu->lut_revs[i] != effect_node->change_rev) {
+            int ret = sample_effect_params(s, i);
+            if (ret < 0)
+                return ret;
+            gpu->lut_revs[i] = effect_node->change_rev;
+            gpu->lut_changed = true;
+        }
+
+        memset(params, 0, sizeof(*params));
+
+        const double end_time = effect_opts->end_time < 0.0 ? s->ctx->scene->params.duration : effect_opts->end_time;
+        if (t < effect_opts->start_time || t > end_time)
+            continue;
+
+        const double effect_t = NGLI_LINEAR_NORM(effect_opts->start_time, end_time, t);
+
+        int ret;
+        float start_pos = 0.f, end_pos = 1.f, overlap = 0.f;
+        if ((ret = set_f32_value(&start_pos, effect_opts->start_pos_node, effect_opts->start_pos, effect_t)) < 0 ||
+            (ret = set_f32_value(&end_pos,   effect_opts->end_pos_node,   effect_opts->end_pos,   effect_t)) < 0 ||
+            (ret = set_f32_value(&overlap,   effect_opts->overlap_node,   effect_opts->overlap,   effect_t)) < 0)
+            return ret;
+
+        const size_t nb_elems = s->effects[i].total_segments;
+        const double duration  = 1.f / ((double)nb_elems - overlap * (double)(nb_elems - 1));
+        const double timescale = (1.f - overlap) * duration;
+
+        const struct text_effect_frame_params frame_params = {
+            .timing = {(float)effect_t, (float)duration, (float)timescale, (float)nb_elems},
+            .range  = {start_pos, end_pos, 1.f, (float)get_effect_mask(effect_opts)},
+        };
+        *params = frame_params;
+
+        if (effect_opts->anchor_ref == NGLI_TEXT_ANCHOR_REF_CHAR) {
+            params->anchor[0] = effect_opts->anchor[0];
+            params->anchor[1] = effect_opts->anchor[1];
+            params->anchor[2] = 1.f;
+        } else if (effect_opts->anchor_ref == NGLI_TEXT_ANCHOR_REF_BOX) {
+            const struct ngli_box box = s->config.box;
+            const float norm_x = NGLI_LINEAR_NORM(-1.f, 1.f, effect_opts->anchor[0]);
+            const float norm_y = NGLI_LINEAR_NORM(-1.f, 1.f, effect_opts->anchor[1]);
+            params->anchor[0] = NGLI_MIX_F32(box.x, box.x + box.w, norm_x);
+            params->anchor[1] = NGLI_MIX_F32(box.y, box.y + box.h, norm_y);
+        } else {
+            params->anchor[0] = effect_opts->anchor[0];
+            params->anchor[1] = effect_opts->anchor[1];
+        }
+    }
+
+    return 0;
+}
+
 int ngli_text_set_time(struct text *s, double t)
 {
     if (!s->chars.count)
         return 0;
 
+    if (s->effects_gpu.enabled)
+        return set_time_gpu(s, t);
+
     reset_chars_data_to_defaults(s);
 
     for (size_t i = 0; i < s->config.nb_effect_nodes; i++) {
@@ -779,7 +1133,7 @@ int ngli_text_set_time(struct text *s, double t)
             const double target_t = NGLI_LINEAR_NORM(prev_t, next_t, effect_t);
 
             const struct ngli_aabb chr_aabb = {NGLI_ARG_VEC4(s->data_ptrs.vertices + c * 4)};
-            const struct char_info *chr = &s->chars.data[i];
+            const struct char_info *chr = &s->chars.data[c];
 
             if ((ret = set_transform( s->data_ptrs.transform  + c * 4 * 4, effect_opts, s->config.box, chr_aabb, chr,                   target_t)) < 0 ||
                 (ret = set_vec3_value(s->data_ptrs.color      + c * 4,     effect_opts->color_node,         effect_opts->color,         target_t)) < 0 ||
@@ -805,7 +1159,10 @@ void ngli_text_freep(struct text **sp)
     ngli_freep(&s->priv_data);
     destroy_effects_data(s);
     ngli_freep(&s->effects);
+    ngli_freep(&s->effects_gpu.lut);
+    ngli_freep(&s->effects_gpu.lut_revs);
     ngli_darray_reset(&s->chars);
+    ngli_darray_reset(&s->prev_chars);
     ngli_darray_reset(&s->chars_internal);
     ngli_freep(sp);
 }
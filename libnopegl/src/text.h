@@ -23,6 +23,8 @@
 #ifndef TEXT_H
 #define TEXT_H
 
+#include <stdbool.h>
+
 #include "box.h"
 #include <ngpu/ngpu.h>
 #include "nopegl/nopegl.h"
@@ -103,6 +105,7 @@ struct text_config {
     struct ngli_box box;
     struct ngl_node **effect_nodes;
     size_t nb_effect_nodes;
+    int32_t sampled_effects; // evaluate the effects on the GPU from their sampled parameters (approximation)
     struct text_effects_defaults defaults;
 };
 
@@ -119,6 +122,7 @@ struct text_cls {
     int (*prefetch)(struct text *text);
     int (*set_string)(struct text *text, const char *str, struct ngli_char_info_internal_darray *chars_dst);
     void (*release)(struct text *text);
+    void (*refresh_atlas)(struct text *text); // update the atlas textures if they can be changed by another text
     void (*reset)(struct text *text);
     size_t priv_size;
     uint32_t flags; // combination of NGLI_TEXT_FLAG_*
@@ -149,6 +153,50 @@ struct effect_segmentation {
     size_t total_segments; // total number of segment: all values in positions are between [0,total_segments-1]
 };
 
+#define NGLI_TEXT_MAX_GPU_EFFECTS     32   // maximum number of effects evaluated by the vertex shader
+#define NGLI_TEXT_EFFECTS_LUT_SIZE    1024 // number of samples of the effect parameters over the target time
+#define NGLI_TEXT_EFFECTS_LUT_ROWS    8    // number of vec4 rows per effect in the parameters table
+#define NGLI_TEXT_EFFECTS_CHARS_WIDTH 1024 // number of characters per row in the characters table
+
+/* Parameters set by an effect, must match the masks used in text_slug.vert */
+enum {
+    NGLI_TEXT_EFFECT_PARAM_TRANSFORM     = 1U << 0,
+    NGLI_TEXT_EFFECT_PARAM_COLOR         = 1U << 1,
+    NGLI_TEXT_EFFECT_PARAM_OPACITY       = 1U << 2,
+    NGLI_TEXT_EFFECT_PARAM_OUTLINE_COLOR = 1U << 3,
+    NGLI_TEXT_EFFECT_PARAM_OUTLINE       = 1U << 4,
+    NGLI_TEXT_EFFECT_PARAM_GLOW_COLOR    = 1U << 5,
+    NGLI_TEXT_EFFECT_PARAM_GLOW          = 1U << 6,
+    NGLI_TEXT_EFFECT_PARAM_BLUR          = 1U << 7,
+    NGLI_TEXT_EFFECT_PARAM_OUTLINE_POS   = 1U << 8,
+};
+
+/* Per frame parameters of an effect evaluated on the GPU */
+struct text_effect_frame_params {
+    float timing[4]; // effect time, target duration, target time scale, number of segments
+    float range[4];  // start position, end position, active (0 or 1), mask of NGLI_TEXT_EFFECT_PARAM_*
+    float anchor[4]; // anchor coordinates, 1 if relative to the character center (0 if absolute), unused
+};
+
+/*
+ * Effects evaluated by the vertex shader (opt-in, see text_config.sampled_effects):
+ * the parameters of every effect are sampled once over the target time into a
+ * table, and the segmentation of the characters is uploaded once per string.
+ * Per frame, only the range selection parameters of each effect are evaluated
+ * on the CPU. The samples are linearly interpolated, including the transform
+ * matrices, so the result is only an approximation of the CPU evaluation.
+ */
+struct text_effects_gpu {
+    bool enabled;
+    float *lut;       // vec4[nb_effects * NGLI_TEXT_EFFECTS_LUT_ROWS][NGLI_TEXT_EFFECTS_LUT_SIZE]
+    size_t *lut_revs; // change_rev of every effect node at the time its parameters were sampled
+    bool lut_changed;
+    float *chars;     // vec4[nb_effects * chars_rows][NGLI_TEXT_EFFECTS_CHARS_WIDTH] (segment position, real dimensions)
+    size_t chars_rows;
+    bool chars_changed;
+    struct text_effect_frame_params params[NGLI_TEXT_MAX_GPU_EFFECTS];
+};
+
 struct text {
     struct ngl_ctx *ctx;
     struct text_config config;
@@ -157,6 +205,7 @@ struct text {
     int32_t width;
     int32_t height;
     struct ngli_char_info_darray chars;
+    size_t dirty_start, dirty_end; // range of characters whose default data changed in the last update
     struct ngpu_texture *atlas_texture;
     struct ngpu_texture *curve_texture;
     struct ngpu_texture *band_texture;
@@ -168,7 +217,10 @@ struct text {
     float *chars_data;         // data buffer exposed to the user (through data pointers)
     size_t chars_data_size;    // size of chars_data_default and chars_data
     size_t chars_copy_size;    // actual size needed for copy
+    struct text_effects_gpu effects_gpu;
+    int defaults_changed;
 
+    struct ngli_char_info_darray prev_chars; // characters of the previous string, used to find the dirty range
     struct ngli_char_info_internal_darray chars_internal;
 
     const struct text_cls *cls;
@@ -180,11 +232,19 @@ int ngli_text_init(struct text *s, const struct text_config *cfg);
 int ngli_text_prefetch(struct text *s);
 void ngli_text_release(struct text *s);
 
+/* Returns 1 if the atlas textures changed since the previous call, 0 otherwise */
+int ngli_text_refresh_atlas(struct text *s);
+
 /* The specified new user defaults will be honored at the next ngli_text_set_{string,time}() call */
 void ngli_text_update_effects_defaults(struct text *s, const struct text_effects_defaults *defaults);
 
+/* Rebuild the geometry of all the characters (the whole range is marked dirty) */
 void ngli_text_refresh_geometry_data(struct text *s);
 
+/*
+ * Set a new string, only updating dirty_start and dirty_end to the range of
+ * characters for which the data pointed by data_ptrs changed
+ */
 int ngli_text_set_string(struct text *s, const char *str);
 
 int ngli_text_set_time(struct text *s, double t);
@@ -26,7 +26,9 @@
 #include <hb-ft.h>
 #include <ft2build.h>
 #include FT_OUTLINE_H
+#include FT_SIZES_H
 #include <fribidi.h>
+#include <inttypes.h>
 #endif
 
 #include "internal.h"
@@ -35,62 +37,197 @@
 #include "nopegl/nopegl.h"
 #include "path.h"
 #include "slug.h"
+#include "utils/crc32.h"
 #include "utils/darray.h"
 #include "utils/hmap.h"
 #include "utils/memory.h"
+#include "utils/scheduler.h"
+#include "utils/string.h"
 #include "text.h"
 #include "utils/utils.h"
 
 #if HAVE_TEXT_LIBRARIES
-NGLI_DECLARE_DARRAY_WITH_NAME(ft_face_darray, FT_Face);
-NGLI_DECLARE_DARRAY_WITH_NAME(hb_font_darray, hb_font_t *);
+/*
+ * Font resources shared by all the external text of a context:
+ * - FreeType faces are opened once per (path, index)
+ * - each face has one FreeType size object and HarfBuzz font per
+ *   (pt_size, dpi), along with the index of the glyphs outlined at this size
+ * - the glyph outlines of all the faces are packed into a single slug atlas
+ *   which grows incrementally
+ * - the new glyphs are outlined in parallel by the context scheduler threads,
+ *   each of them having its own FreeType library and faces
+ */
+struct glyph_worker {
+    FT_Library ft_library;
+    struct hmap *faces; // FT_Face indexed by "<size key>:<face key>", for the scheduler threads > 0
+    struct path *path;
+};
 
-struct text_external {
-    struct ft_face_darray ft_faces; // FT_Face (hidden pointer)
-    struct hb_font_darray hb_fonts; // hb_font_t*
+struct text_font_registry {
+    struct hmap *faces; // struct font_face indexed by "<index>:<path>"
     struct slug *slug;
-    struct hmap *glyph_index; // persistent glyph cache across set_string calls
+    struct glyph_worker *workers; // one per scheduler thread
+    size_t nb_workers;
+    size_t refcount;    // number of text instances using the registry
+    size_t prefetch_count; // number of text instances holding the slug textures
 };
 
-static int load_font(struct text *text, const char *font_file, int32_t face_index)
+struct font_face {
+    struct text_font_registry *registry;
+    char *key;
+    char *path;
+    int32_t index;
+    FT_Face ft_face;
+    struct hmap *sizes; // struct font_size indexed by (pt_size, dpi)
+    size_t refcount;    // number of sizes referencing the face
+};
+
+struct font_size {
+    struct font_face *face;
+    uint64_t key;
+    int32_t pt_size;
+    FT_UInt res;
+    FT_Size ft_size;
+    hb_font_t *hb_font;
+    struct hmap *glyphs; // struct glyph indexed by glyph id, persistent glyph cache
+    size_t refcount;     // number of text instances using the size
+};
+
+struct glyph {
+    int32_t slug_index; // index in the slug glyph array, -1 for empty glyphs
+    int32_t width, height; // in 26.6
+    int32_t bearing_x, bearing_y; // in 26.6
+};
+
+NGLI_DECLARE_DARRAY_WITH_NAME(font_size_darray, struct font_size *);
+
+struct line_key;
+
+struct glyph_job;
+NGLI_DECLARE_DARRAY_WITH_NAME(glyph_job_darray, struct glyph_job);
+
+struct text_external {
+    struct text_font_registry *registry;
+    struct font_size_darray font_sizes;
+    struct glyph_job_darray glyph_jobs; // new glyphs of the string being set, pending outlining
+    struct hmap *lines;       // struct shaped_line indexed by struct line_key, lines of the current string
+    struct line_key *key_buf; // scratch key used for the lookups
+    size_t key_buf_size;
+    bool prefetched;
+};
+
+static struct text_font_registry *registry_ref(struct ngl_ctx *ctx)
 {
-    struct text_external *s = text->priv_data;
+    struct text_font_registry *s = ctx->text_font_registry;
+    if (s) {
+        s->refcount++;
+        return s;
+    }
 
-    /* This limitation simplifies the UID computation in GLYPH_UID_STRING() */
-    if (s->ft_faces.count == 0xff) {
-        LOG(ERROR, "maximum number of fonts reached (256)");
-        return NGL_ERROR_LIMIT_EXCEEDED;
+    s = ngli_calloc(1, sizeof(*s));
+    if (!s)
+        return NULL;
+
+    s->faces = ngli_hmap_create(NGLI_HMAP_TYPE_STR);
+    s->slug = ngli_slug_create(ctx);
+    if (!s->faces || !s->slug || ngli_slug_init(s->slug) < 0) {
+        ngli_hmap_freep(&s->faces);
+        ngli_slug_freep(&s->slug);
+        ngli_freep(&s);
+        return NULL;
     }
 
-    FT_Face ft_face = NULL;
-    hb_font_t *hb_font = NULL;
+    s->refcount = 1;
+    ctx->text_font_registry = s;
+    return s;
+}
 
-    FT_Error ft_error = FT_New_Face(text->ctx->ft_library, font_file, face_index, &ft_face);
-    if (ft_error) {
-        LOG(ERROR, "unable to initialize FreeType with font %s face %d", font_file, face_index);
-        return NGL_ERROR_EXTERNAL;
+static void registry_unrefp(struct ngl_ctx *ctx, struct text_font_registry **sp)
+{
+    struct text_font_registry *s = *sp;
+    if (!s)
+        return;
+    *sp = NULL;
+    if (--s->refcount)
+        return;
+
+    ngli_assert(ngli_hmap_count(s->faces) == 0);
+    ngli_hmap_freep(&s->faces);
+    ngli_slug_freep(&s->slug);
+    for (size_t i = 0; i < s->nb_workers; i++) {
+        struct glyph_worker *worker = &s->workers[i];
+        ngli_hmap_freep(&worker->faces);
+        ngli_path_freep(&worker->path);
+        if (worker->ft_library)
+            FT_Done_FreeType(worker->ft_library);
     }
+    ngli_freep(&s->workers);
+    ngli_freep(&s);
+    ctx->text_font_registry = NULL;
+}
 
-    if (!FT_IS_SCALABLE(ft_face)) {
-        LOG(ERROR, "only scalable faces are supported");
-        return NGL_ERROR_UNSUPPORTED;
+static void font_face_unrefp(struct font_face **sp)
+{
+    struct font_face *s = *sp;
+    if (!s)
+        return;
+    *sp = NULL;
+    if (--s->refcount)
+        return;
+
+    ngli_hmap_set_str(s->registry->faces, s->key, NULL);
+    ngli_hmap_freep(&s->sizes);
+    FT_Done_Face(s->ft_face);
+    ngli_freep(&s->key);
+    ngli_freep(&s->path);
+    ngli_freep(&s);
+}
+
+static struct font_face *font_face_ref(struct text *text, struct text_font_registry *registry,
+                                       const char *font_file, int32_t face_index, int *errp)
+{
+    char *key = ngli_asprintf("%d:%s", face_index, font_file);
+    if (!key) {
+        *errp = NGL_ERROR_MEMORY;
+        return NULL;
     }
 
-    if (ngli_darray_push(&s->ft_faces, ft_face) < 0) {
-        FT_Done_Face(ft_face);
-        return NGL_ERROR_MEMORY;
+    struct font_face *s = ngli_hmap_get_str(registry->faces, key);
+    if (s) {
+        ngli_freep(&key);
+        s->refcount++;
+        return s;
     }
 
-    const int32_t pt_size = text->config.pt_size;
-    const FT_F26Dot6 chr_w = NGLI_I32_TO_I26D6(pt_size); // nominal width in 26.6
-    const FT_F26Dot6 chr_h = NGLI_I32_TO_I26D6(pt_size); // nominal height in 26.6
-    const FT_UInt res = (FT_UInt)text->config.dpi; // resolution in dpi
-    ft_error = FT_Set_Char_Size(ft_face, chr_w, chr_h, res, res);
+    s = ngli_calloc(1, sizeof(*s));
+    if (!s) {
+        ngli_freep(&key);
+        *errp = NGL_ERROR_MEMORY;
+        return NULL;
+    }
+    s->registry = registry;
+    s->key = key;
+    s->index = face_index;
+    s->path = ngli_strdup(font_file);
+    if (!s->path) {
+        *errp = NGL_ERROR_MEMORY;
+        goto fail;
+    }
+
+    FT_Error ft_error = FT_New_Face(text->ctx->ft_library, font_file, face_index, &s->ft_face);
     if (ft_error) {
-        LOG(ERROR, "unable to set char size to %d points in %u DPI", pt_size, res);
-        return NGL_ERROR_EXTERNAL;
+        LOG(ERROR, "unable to initialize FreeType with font %s face %d", font_file, face_index);
+        *errp = NGL_ERROR_EXTERNAL;
+        goto fail;
+    }
+
+    if (!FT_IS_SCALABLE(s->ft_face)) {
+        LOG(ERROR, "only scalable faces are supported");
+        *errp = NGL_ERROR_UNSUPPORTED;
+        goto fail;
     }
 
+    const FT_Face ft_face = s->ft_face;
     LOG(DEBUG, "loaded font family %s", ft_face->family_name);
     if (ft_face->style_name)
         LOG(DEBUG, "* style: %s", ft_face->style_name);
@@ -107,38 +244,173 @@ static int load_font(struct text *text, const char *font_file, int32_t face_inde
     LOG(DEBUG, "* underline_[position:%d thickness:%d]",
         ft_face->underline_position, ft_face->underline_thickness);
 
-    hb_font = hb_ft_font_create(ft_face, NULL);
-    if (!hb_font)
-        return NGL_ERROR_MEMORY;
+    s->sizes = ngli_hmap_create(NGLI_HMAP_TYPE_U64);
+    if (!s->sizes) {
+        *errp = NGL_ERROR_MEMORY;
+        goto fail;
+    }
 
-    if (ngli_darray_push(&s->hb_fonts, hb_font) < 0) {
-        hb_font_destroy(hb_font);
-        return NGL_ERROR_MEMORY;
+    int ret = ngli_hmap_set_str(registry->faces, key, s);
+    if (ret < 0) {
+        *errp = ret;
+        goto fail;
     }
 
-    return 0;
+    s->refcount = 1;
+    return s;
+
+fail:
+    ngli_hmap_freep(&s->sizes);
+    if (s->ft_face)
+        FT_Done_Face(s->ft_face);
+    ngli_freep(&s->key);
+    ngli_freep(&s->path);
+    ngli_freep(&s);
+    return NULL;
 }
 
-static void free_ft_face(void *user_arg, void *data)
+/* Make the size current on its face, required before any size dependent FreeType/HarfBuzz call */
+static FT_Face activate_font_size(const struct font_size *s)
 {
-    FT_Face *face = data;
-    FT_Done_Face(*face);
+    FT_Activate_Size(s->ft_size);
+    return s->face->ft_face;
 }
 
-static void free_hb_font(void *user_arg, void *data)
+static void free_glyph(void *user_arg, void *data)
 {
-    struct hb_font_t **fontp = data;
-    hb_font_destroy(*fontp);
+    struct glyph *glyph = data;
+    ngli_freep(&glyph);
 }
 
-static void free_glyph(void *user_arg, void *data);
+static void font_size_unrefp(struct font_size **sp)
+{
+    struct font_size *s = *sp;
+    if (!s)
+        return;
+    *sp = NULL;
+    if (--s->refcount)
+        return;
+
+    struct font_face *face = s->face;
+    ngli_hmap_set_u64(face->sizes, s->key, NULL);
+    ngli_hmap_freep(&s->glyphs);
+    if (s->hb_font)
+        hb_font_destroy(s->hb_font);
+    if (s->ft_size)
+        FT_Done_Size(s->ft_size);
+    ngli_freep(&s);
+    font_face_unrefp(&face);
+}
+
+static struct font_size *font_size_ref(struct text *text, struct font_face *face, int *errp)
+{
+    const int32_t pt_size = text->config.pt_size;
+    const FT_UInt res = (FT_UInt)text->config.dpi; // resolution in dpi
+    const uint64_t key = (uint64_t)(uint32_t)pt_size << 32 | res;
+
+    struct font_size *s = ngli_hmap_get_u64(face->sizes, key);
+    if (s) {
+        s->refcount++;
+        return s;
+    }
+
+    s = ngli_calloc(1, sizeof(*s));
+    if (!s) {
+        *errp = NGL_ERROR_MEMORY;
+        return NULL;
+    }
+    s->face = face;
+    s->key = key;
+    s->pt_size = pt_size;
+    s->res = res;
+    s->refcount = 1;
+
+    /* The size holds a reference on the face from now on */
+    face->refcount++;
+
+    FT_Error ft_error = FT_New_Size(face->ft_face, &s->ft_size);
+    if (ft_error) {
+        LOG(ERROR, "unable to create FreeType size object");
+        *errp = NGL_ERROR_EXTERNAL;
+        goto fail;
+    }
+
+    FT_Activate_Size(s->ft_size);
+
+    const FT_F26Dot6 chr_w = NGLI_I32_TO_I26D6(pt_size); // nominal width in 26.6
+    const FT_F26Dot6 chr_h = NGLI_I32_TO_I26D6(pt_size); // nominal height in 26.6
+    ft_error = FT_Set_Char_Size(face->ft_face, chr_w, chr_h, res, res);
+    if (ft_error) {
+        LOG(ERROR, "unable to set char size to %d points in %u DPI", pt_size, res);
+        *errp = NGL_ERROR_EXTERNAL;
+        goto fail;
+    }
+
+    /* The HarfBuzz font picks its scale from the active size */
+    s->hb_font = hb_ft_font_create(face->ft_face, NULL);
+    s->glyphs = ngli_hmap_create(NGLI_HMAP_TYPE_U64);
+    if (!s->hb_font || !s->glyphs) {
+        *errp = NGL_ERROR_MEMORY;
+        goto fail;
+    }
+    ngli_hmap_set_free_func(s->glyphs, free_glyph, NULL);
+
+    int ret = ngli_hmap_set_u64(face->sizes, key, s);
+    if (ret < 0) {
+        *errp = ret;
+        goto fail;
+    }
+
+    return s;
+
+fail:
+    ngli_hmap_freep(&s->glyphs);
+    if (s->hb_font)
+        hb_font_destroy(s->hb_font);
+    if (s->ft_size)
+        FT_Done_Size(s->ft_size);
+    ngli_freep(&s);
+    font_face_unrefp(&face);
+    return NULL;
+}
+
+static int load_font(struct text *text, const char *font_file, int32_t face_index)
+{
+    struct text_external *s = text->priv_data;
+
+    int ret = 0;
+    struct font_face *face = font_face_ref(text, s->registry, font_file, face_index, &ret);
+    if (!face)
+        return ret;
+
+    struct font_size *font_size = font_size_ref(text, face, &ret);
+    font_face_unrefp(&face);
+    if (!font_size)
+        return ret;
+
+    if (ngli_darray_push(&s->font_sizes, font_size) < 0) {
+        font_size_unrefp(&font_size);
+        return NGL_ERROR_MEMORY;
+    }
+
+    return 0;
+}
+
+static void unref_font_size(void *user_arg, void *data)
+{
+    struct font_size **font_sizep = data;
+    font_size_unrefp(font_sizep);
+}
 
 static int text_external_init(struct text *text)
 {
     struct text_external *s = text->priv_data;
 
-    ngli_darray_set_free_func(&s->ft_faces, free_ft_face, NULL);
-    ngli_darray_set_free_func(&s->hb_fonts, free_hb_font, NULL);
+    ngli_darray_set_free_func(&s->font_sizes, unref_font_size, NULL);
+
+    s->registry = registry_ref(text->ctx);
+    if (!s->registry)
+        return NGL_ERROR_MEMORY;
 
     for (size_t i = 0; i < text->config.nb_font_faces; i++) {
         const struct ngl_node *face_node = text->config.font_faces[i];
@@ -148,78 +420,52 @@ static int text_external_init(struct text *text)
             return ret;
     }
 
-    s->slug = ngli_slug_create(text->ctx);
-    if (!s->slug)
-        return NGL_ERROR_MEMORY;
-    int ret = ngli_slug_init(s->slug);
-    if (ret < 0)
-        return ret;
-
-    s->glyph_index = ngli_hmap_create(NGLI_HMAP_TYPE_STR);
-    if (!s->glyph_index)
-        return NGL_ERROR_MEMORY;
-    ngli_hmap_set_free_func(s->glyph_index, free_glyph, NULL);
-
     return 0;
 }
 
+static void text_external_refresh_atlas(struct text *text)
+{
+    struct text_external *s = text->priv_data;
+    text->curve_texture = ngli_slug_get_curve_texture(s->registry->slug);
+    text->band_texture = ngli_slug_get_band_texture(s->registry->slug);
+}
+
 static int text_external_prefetch(struct text *text)
 {
     struct text_external *s = text->priv_data;
 
-    int ret = ngli_slug_prefetch(s->slug);
-    if (ret < 0)
-        return ret;
+    if (!s->prefetched) {
+        int ret = ngli_slug_prefetch(s->registry->slug);
+        if (ret < 0)
+            return ret;
+        s->prefetched = true;
+        s->registry->prefetch_count++;
+    }
 
-    text->curve_texture = ngli_slug_get_curve_texture(s->slug);
-    text->band_texture = ngli_slug_get_band_texture(s->slug);
+    text_external_refresh_atlas(text);
     return 0;
 }
 
 static void text_external_release(struct text *text)
 {
     struct text_external *s = text->priv_data;
-    ngli_slug_release(s->slug);
+    if (!s->prefetched)
+        return;
+    s->prefetched = false;
+
+    /* The shared atlas is released along with its last user */
+    if (!--s->registry->prefetch_count)
+        ngli_slug_release(s->registry->slug);
     text->curve_texture = NULL;
     text->band_texture = NULL;
 }
 
-struct glyph {
-    int32_t slug_index; // index in the slug glyph array
-    int32_t width, height; // in 26.6
-    int32_t bearing_x, bearing_y; // in 26.6
-};
-
-static void free_glyph(void *user_arg, void *data)
-{
-    struct glyph *glyph = data;
-    ngli_freep(&glyph);
-}
-
 static struct glyph *create_glyph(void)
 {
     struct glyph *glyph = ngli_calloc(1, sizeof(*glyph));
     return glyph;
 }
 
-static const char *hex = "0123456789abcdef";
-
-/* Compute a unique glyph identifier string using the face and glyph IDs */
-#define GLYPH_UID_STRING(fid, gid) {  \
-    hex[(fid) >> 4U & 0xf],     \
-    hex[(fid)       & 0xf],     \
-    '-',                        \
-    hex[(gid) >> 28U & 0xf],    \
-    hex[(gid) >> 24U & 0xf],    \
-    hex[(gid) >> 20U & 0xf],    \
-    hex[(gid) >> 16U & 0xf],    \
-    hex[(gid) >> 12U & 0xf],    \
-    hex[(gid) >>  8U & 0xf],    \
-    hex[(gid) >>  4U & 0xf],    \
-    hex[(gid)        & 0xf],    \
-    '\0'                        \
-}
-
 enum run_type {
     RUN_TYPE_WORD,
     RUN_TYPE_WORDSEP,
@@ -298,21 +544,32 @@ static const FT_Outline_Funcs outline_funcs = {
     .cubic_to = cubic_to_cb,
 };
 
-static int build_glyph_index(struct text *text, struct hmap *glyph_index, const struct text_run_darray *runs_array)
+/*
+ * A glyph missing from the glyph index of its size: it is registered in the
+ * index right away (so that it is only processed once), and its outline is
+ * extracted and converted to slug curves and bands by one of the scheduler
+ * threads.
+ */
+struct glyph_job {
+    struct font_size *font_size;
+    hb_codepoint_t glyph_id;
+    struct glyph *glyph;
+    struct slug_glyph *slug_glyph; // NULL for empty glyphs
+    int ret;
+};
+
+#define GLYPHS_PER_TASK 8
+
+static int queue_glyph_jobs(struct text *text, const struct text_run_darray *runs_array)
 {
-    int ret = 0;
     struct text_external *s = text->priv_data;
 
-    struct path *path = ngli_path_create();
-    if (!path)
-        return NGL_ERROR_MEMORY;
-
     for (size_t i = 0; i < runs_array->count; i++) {
         const struct text_run *run = &runs_array->data[i];
         if (run->face_id == SIZE_MAX)
             continue;
 
-        const FT_Face ft_face = s->ft_faces.data[run->face_id];
+        struct font_size *font_size = s->font_sizes.data[run->face_id];
         const size_t nb_glyphs = hb_buffer_get_length(run->buffer);
         const hb_glyph_info_t *glyph_infos = run->glyph_infos;
 
@@ -323,82 +580,259 @@ static int build_glyph_index(struct text *text, struct hmap *glyph_index, const
              * the glyphs (see ttf-hanazono 20170904 for an example of this).
              */
             const hb_codepoint_t glyph_id = glyph_infos[j].codepoint;
-            const char glyph_uid[] = GLYPH_UID_STRING(run->face_id, glyph_id);
-            if (ngli_hmap_get_str(glyph_index, glyph_uid))
+            if (ngli_hmap_get_u64(font_size->glyphs, glyph_id))
                 continue;
 
-            /*
-             * Harfbuzz seems to use NO_HINTING as well, so we may want to stay
-             * aligned with it.
-             */
-            FT_Error ft_error = FT_Load_Glyph(ft_face, glyph_id, FT_LOAD_DEFAULT | FT_LOAD_NO_BITMAP | FT_LOAD_NO_HINTING);
-            if (ft_error) {
-                /*
-                 * We do not use the "U+XXXX" notation in the format string
-                 * because it does not necessarily correspond to the Unicode
-                 * codepoint (we are post-shaping so this is a font specific
-                 * character code).
-                 */
-                LOG(ERROR, "unable to load glyph id %u", glyph_id);
-                ret = NGL_ERROR_EXTERNAL;
-                goto end;
+            /* Save the glyph in the index shared with the other text using this size */
+            struct glyph *glyph = create_glyph();
+            if (!glyph)
+                return NGL_ERROR_MEMORY;
+            glyph->slug_index = -1;
+
+            int ret = ngli_hmap_set_u64(font_size->glyphs, glyph_id, glyph);
+            if (ret < 0) {
+                free_glyph(NULL, glyph);
+                return ret;
             }
 
-            const FT_GlyphSlot slot = ft_face->glyph;
+            const struct glyph_job job = {
+                .font_size = font_size,
+                .glyph_id  = glyph_id,
+                .glyph     = glyph,
+            };
+            if (ngli_darray_push(&s->glyph_jobs, job) < 0) {
+                ngli_hmap_set_u64(font_size->glyphs, glyph_id, NULL);
+                return NGL_ERROR_MEMORY;
+            }
+        }
+    }
 
-            ngli_path_clear(path);
+    return 0;
+}
 
-            FT_BBox cbox;
-            FT_Outline_Get_CBox(&slot->outline, &cbox);
+/* Drop the pending jobs, removing their glyphs from the index if they were not added to the atlas */
+static void reset_glyph_jobs(struct text *text, int remove_glyphs)
+{
+    struct text_external *s = text->priv_data;
 
-            const struct outline_ctx ft_ctx = {.path=path,.cbox=cbox};
-            FT_Outline_Decompose(&slot->outline, &outline_funcs, (void *)&ft_ctx);
+    ngli_darray_foreach(job, &s->glyph_jobs) {
+        if (remove_glyphs)
+            ngli_hmap_set_u64(job->font_size->glyphs, job->glyph_id, NULL);
+        ngli_slug_glyph_freep(&job->slug_glyph);
+    }
+    ngli_darray_clear(&s->glyph_jobs);
+}
 
-            ret = ngli_path_finalize(path);
-            if (ret < 0)
-                goto end;
+static int init_glyph_workers(struct text_font_registry *registry, size_t nb_workers)
+{
+    if (registry->nb_workers >= nb_workers)
+        return 0;
 
-            const int32_t shape_w_26d6 = (int32_t)(cbox.xMax - cbox.xMin);
-            const int32_t shape_h_26d6 = (int32_t)(cbox.yMax - cbox.yMin);
-            const int32_t shape_w = NGLI_I26D6_TO_I32_TRUNCATED(shape_w_26d6);
-            const int32_t shape_h = NGLI_I26D6_TO_I32_TRUNCATED(shape_h_26d6);
+    struct glyph_worker *workers = ngli_realloc(registry->workers, nb_workers, sizeof(*workers));
+    if (!workers)
+        return NGL_ERROR_MEMORY;
+    memset(workers + registry->nb_workers, 0, (nb_workers - registry->nb_workers) * sizeof(*workers));
+    registry->workers = workers;
+
+    for (size_t i = registry->nb_workers; i < nb_workers; i++) {
+        registry->nb_workers = i + 1;
+        workers[i].path = ngli_path_create();
+        if (!workers[i].path)
+            return NGL_ERROR_MEMORY;
+    }
 
-            // An empty space glyph doesn't need to be rasterized
-            if (shape_w <= 0 || shape_h <= 0)
-                continue;
+    return 0;
+}
 
-            const float glyph_w = NGLI_I26D6_TO_F32(shape_w_26d6);
-            const float glyph_h = NGLI_I26D6_TO_F32(shape_h_26d6);
-            const int slug_idx = ngli_slug_add_glyph(s->slug, path, NGLI_SLUG_FLAG_PATH_AUTO_CLOSE,
-                                                    glyph_w, glyph_h);
-            if (slug_idx < 0) {
-                ret = slug_idx;
-                goto end;
-            }
+static void free_worker_face(void *user_arg, void *data)
+{
+    FT_Done_Face(data);
+}
 
-            /* Save the rasterized glyph in the index */
-            struct glyph *glyph = create_glyph();
-            if (!glyph) {
-                ret = NGL_ERROR_MEMORY;
-                goto end;
-            }
+/*
+ * FreeType objects can not be shared between threads: the calling thread
+ * (index 0) uses the faces of the registry, while the other ones open their
+ * own copy of the face at the same size.
+ */
+static FT_Face get_worker_face(struct glyph_worker *worker, uint32_t thread_index,
+                               const struct font_size *font_size, int *errp)
+{
+    if (thread_index == 0)
+        return activate_font_size(font_size);
+
+    if (!worker->ft_library) {
+        if (FT_Init_FreeType(&worker->ft_library)) {
+            LOG(ERROR, "unable to initialize FreeType");
+            *errp = NGL_ERROR_EXTERNAL;
+            return NULL;
+        }
+        worker->faces = ngli_hmap_create(NGLI_HMAP_TYPE_STR);
+        if (!worker->faces) {
+            *errp = NGL_ERROR_MEMORY;
+            return NULL;
+        }
+        ngli_hmap_set_free_func(worker->faces, free_worker_face, NULL);
+    }
 
-            glyph->slug_index = slug_idx;
-            glyph->width     = shape_w_26d6;
-            glyph->height    = shape_h_26d6;
-            glyph->bearing_x = (int32_t)ft_ctx.cbox.xMin;
-            glyph->bearing_y = (int32_t)ft_ctx.cbox.yMin;
+    const struct font_face *face = font_size->face;
+    char *key = ngli_asprintf("%" PRIu64 ":%s", font_size->key, face->key);
+    if (!key) {
+        *errp = NGL_ERROR_MEMORY;
+        return NULL;
+    }
 
-            ret = ngli_hmap_set_str(glyph_index, glyph_uid, glyph);
-            if (ret < 0) {
-                free_glyph(NULL, glyph);
-                goto end;
-            }
+    FT_Face ft_face = ngli_hmap_get_str(worker->faces, key);
+    if (ft_face) {
+        ngli_freep(&key);
+        return ft_face;
+    }
+
+    FT_Error ft_error = FT_New_Face(worker->ft_library, face->path, face->index, &ft_face);
+    if (ft_error) {
+        LOG(ERROR, "unable to initialize FreeType with font %s face %d", face->path, face->index);
+        ngli_freep(&key);
+        *errp = NGL_ERROR_EXTERNAL;
+        return NULL;
+    }
+
+    const FT_F26Dot6 chr_w = NGLI_I32_TO_I26D6(font_size->pt_size); // nominal width in 26.6
+    const FT_F26Dot6 chr_h = NGLI_I32_TO_I26D6(font_size->pt_size); // nominal height in 26.6
+    ft_error = FT_Set_Char_Size(ft_face, chr_w, chr_h, font_size->res, font_size->res);
+    if (ft_error) {
+        LOG(ERROR, "unable to set char size to %d points in %u DPI", font_size->pt_size, font_size->res);
+        FT_Done_Face(ft_face);
+        ngli_freep(&key);
+        *errp = NGL_ERROR_EXTERNAL;
+        return NULL;
+    }
+
+    int ret = ngli_hmap_set_str(worker->faces, key, ft_face);
+    ngli_freep(&key);
+    if (ret < 0) {
+        FT_Done_Face(ft_face);
+        *errp = ret;
+        return NULL;
+    }
+
+    return ft_face;
+}
+
+static int process_glyph_job(struct glyph_job *job, struct glyph_worker *worker, uint32_t thread_index)
+{
+    int ret = 0;
+    const FT_Face ft_face = get_worker_face(worker, thread_index, job->font_size, &ret);
+    if (!ft_face)
+        return ret;
+
+    /*
+     * Harfbuzz seems to use NO_HINTING as well, so we may want to stay
+     * aligned with it.
+     */
+    const hb_codepoint_t glyph_id = job->glyph_id;
+    FT_Error ft_error = FT_Load_Glyph(ft_face, glyph_id, FT_LOAD_DEFAULT | FT_LOAD_NO_BITMAP | FT_LOAD_NO_HINTING);
+    if (ft_error) {
+        /*
+         * We do not use the "U+XXXX" notation in the format string
+         * because it does not necessarily correspond to the Unicode
+         * codepoint (we are post-shaping so this is a font specific
+         * character code).
+         */
+        LOG(ERROR, "unable to load glyph id %u", glyph_id);
+        return NGL_ERROR_EXTERNAL;
+    }
+
+    const FT_GlyphSlot slot = ft_face->glyph;
+
+    struct path *path = worker->path;
+    ngli_path_clear(path);
+
+    FT_BBox cbox;
+    FT_Outline_Get_CBox(&slot->outline, &cbox);
+
+    const struct outline_ctx ft_ctx = {.path=path,.cbox=cbox};
+    FT_Outline_Decompose(&slot->outline, &outline_funcs, (void *)&ft_ctx);
+
+    ret = ngli_path_finalize(path);
+    if (ret < 0)
+        return ret;
+
+    const int32_t shape_w_26d6 = (int32_t)(cbox.xMax - cbox.xMin);
+    const int32_t shape_h_26d6 = (int32_t)(cbox.yMax - cbox.yMin);
+    const int32_t shape_w = NGLI_I26D6_TO_I32_TRUNCATED(shape_w_26d6);
+    const int32_t shape_h = NGLI_I26D6_TO_I32_TRUNCATED(shape_h_26d6);
+
+    // An empty space glyph doesn't need to be rasterized
+    if (shape_w > 0 && shape_h > 0) {
+        const float glyph_w = NGLI_I26D6_TO_F32(shape_w_26d6);
+        const float glyph_h = NGLI_I26D6_TO_F32(shape_h_26d6);
+        ret = ngli_slug_prepare_glyph(&job->slug_glyph, path, NGLI_SLUG_FLAG_PATH_AUTO_CLOSE,
+                                      glyph_w, glyph_h);
+        if (ret < 0)
+            return ret;
+    }
+
+    struct glyph *glyph = job->glyph;
+    glyph->width     = shape_w_26d6;
+    glyph->height    = shape_h_26d6;
+    glyph->bearing_x = (int32_t)ft_ctx.cbox.xMin;
+    glyph->bearing_y = (int32_t)ft_ctx.cbox.yMin;
+
+    return 0;
+}
+
+static void process_glyph_jobs_range(void *arg, size_t start, size_t end, uint32_t thread_index)
+{
+    struct text *text = arg;
+    struct text_external *s = text->priv_data;
+    struct glyph_worker *worker = &s->registry->workers[thread_index];
+
+    for (size_t i = start; i < end; i++) {
+        struct glyph_job *job = &s->glyph_jobs.data[i];
+        job->ret = process_glyph_job(job, worker, thread_index);
+    }
+}
+
+/*
+ * Outline the pending glyphs on the scheduler threads, then add them to the
+ * slug atlas in order (so that the atlas content does not depend on the
+ * scheduling)
+ */
+static int build_glyph_index(struct text *text)
+{
+    struct text_external *s = text->priv_data;
+    struct ngli_scheduler *scheduler = text->ctx->scheduler;
+
+    const size_t nb_jobs = s->glyph_jobs.count;
+    if (!nb_jobs)
+        return 0;
+
+    int ret = init_glyph_workers(s->registry, ngli_scheduler_get_nb_threads(scheduler));
+    if (ret < 0)
+        goto end;
+
+    ngli_parallel_for(scheduler, nb_jobs, GLYPHS_PER_TASK, process_glyph_jobs_range, text);
+
+    for (size_t i = 0; i < nb_jobs; i++) {
+        struct glyph_job *job = &s->glyph_jobs.data[i];
+        if (job->ret < 0) {
+            ret = job->ret;
+            goto end;
         }
     }
 
+    ngli_darray_foreach(job, &s->glyph_jobs) {
+        if (!job->slug_glyph)
+            continue;
+        const int slug_idx = ngli_slug_add_prepared_glyph(s->registry->slug, &job->slug_glyph);
+        if (slug_idx < 0) {
+            ret = slug_idx;
+            goto end;
+        }
+        job->glyph->slug_index = slug_idx;
+    }
+
 end:
-    ngli_path_freep(&path);
+    reset_glyph_jobs(text, ret < 0);
     return ret;
 }
 
@@ -480,12 +914,12 @@ static int append_run(struct text *text, struct text_run_darray *runs_array,
     return 0;
 }
 
-static size_t find_face_with_codepoint(const struct ft_face_darray *ft_faces_array, FriBidiChar ch, size_t prev_face_id)
+static size_t find_face_with_codepoint(const struct font_size_darray *font_sizes_array, FriBidiChar ch, size_t prev_face_id)
 {
     const FT_ULong charcode = (FT_ULong)ch;
-    const FT_Face *ft_faces = ft_faces_array->data;
-    for (size_t face_id = 0; face_id < ft_faces_array->count; face_id++)
-        if (FT_Get_Char_Index(ft_faces[face_id], charcode))
+    struct font_size * const *font_sizes = font_sizes_array->data;
+    for (size_t face_id = 0; face_id < font_sizes_array->count; face_id++)
+        if (FT_Get_Char_Index(font_sizes[face_id]->face->ft_face, charcode))
             return face_id;
     return SIZE_MAX;
 }
@@ -502,13 +936,13 @@ static int split_into_runs(struct text *text, struct text_run_darray *runs_array
 
     ngli_assert(start < end);
 
-    size_t prev_face_id = find_face_with_codepoint(&s->ft_faces, str[start], 0);
+    size_t prev_face_id = find_face_with_codepoint(&s->font_sizes, str[start], 0);
     size_t pos = start;
 
     for (;;) {
         size_t face_id;
         do {
-            face_id = find_face_with_codepoint(&s->ft_faces, str[pos], prev_face_id);
+            face_id = find_face_with_codepoint(&s->font_sizes, str[pos], prev_face_id);
             if (face_id != prev_face_id)
                 break;
             pos++;
@@ -562,21 +996,6 @@ static int handle_words_and_wordseps(struct text *text, struct text_run_darray *
     return 0;
 }
 
-static int handle_line_breaks(struct text *text, struct text_run_darray *runs_array,
-                              const FriBidiChar *str, size_t len, size_t *pos)
-{
-    size_t end = *pos;
-    while (end < len && char_is_linebreak(str[end]))
-        end++;
-    if (end > *pos) {
-        int ret = split_into_runs(text, runs_array, str, len, RUN_TYPE_LINEBREAK, *pos, end);
-        if (ret < 0)
-            return ret;
-        *pos = end;
-    }
-    return 0;
-}
-
 #define STACK_LIST_SIZE 128
 
 /*
@@ -625,56 +1044,129 @@ end:
 }
 
 /*
- * Split text into runs, where each run is essentially a harfbuzz buffer
+ * Shaping result of a line, or of a sequence of line breaks. The lines are
+ * cached across string updates so that a live change only reshapes the lines
+ * that actually changed.
  */
-static int build_text_runs(struct text *text, const char *str_orig, struct text_run_darray *runs_array)
+struct shaped_line {
+    struct text_run_darray runs;
+    FriBidiParType base_dir; // paragraph direction after this line, input of the next line
+    size_t refcount;
+};
+
+NGLI_DECLARE_DARRAY_WITH_NAME(shaped_line_darray, const struct shaped_line *);
+
+/*
+ * The shaping of a line only depends on its codepoints and on the paragraph
+ * direction resolved by the previous lines (the fonts and writing mode are
+ * constant for a given text)
+ */
+struct line_key {
+    uint32_t len;
+    int32_t base_dir;
+    FriBidiChar codepoints[];
+};
+
+static size_t get_line_key_size(const struct line_key *key)
+{
+    return sizeof(*key) + key->len * sizeof(*key->codepoints);
+}
+
+static uint32_t line_key_hash(union hmap_key x)
+{
+    return ngli_crc32_mem(x.ptr, get_line_key_size(x.ptr), NGLI_CRC32_INIT);
+}
+
+static int line_key_cmp(union hmap_key a, union hmap_key b)
+{
+    const struct line_key *key_a = a.ptr;
+    const struct line_key *key_b = b.ptr;
+    if (key_a->len != key_b->len)
+        return 1;
+    return memcmp(key_a, key_b, get_line_key_size(key_a));
+}
+
+static union hmap_key line_key_dup(union hmap_key x)
+{
+    return (union hmap_key){.ptr=ngli_memdup(x.ptr, get_line_key_size(x.ptr))};
+}
+
+static int line_key_check(union hmap_key x)
+{
+    return !!x.ptr;
+}
+
+static void line_key_free(union hmap_key x)
+{
+    ngli_free(x.ptr);
+}
+
+static const struct hmap_key_funcs line_key_funcs = {
+    line_key_hash,
+    line_key_cmp,
+    line_key_dup,
+    line_key_check,
+    line_key_free,
+};
+
+static void shaped_line_unref(void *user_arg, void *data)
+{
+    struct shaped_line *line = data;
+    if (--line->refcount)
+        return;
+    reset_runs(&line->runs);
+    ngli_freep(&line);
+}
+
+static struct hmap *create_lines_cache(void)
+{
+    struct hmap *lines = ngli_hmap_create_ptr(&line_key_funcs);
+    if (!lines)
+        return NULL;
+    ngli_hmap_set_free_func(lines, shaped_line_unref, NULL);
+    return lines;
+}
+
+static const struct line_key *get_line_key(struct text *text, const FriBidiChar *str, size_t len, FriBidiParType base_dir)
 {
-    int ret = 0;
     struct text_external *s = text->priv_data;
 
-    const size_t full_len = strlen(str_orig);
-    if (full_len > INT32_MAX)
-        return NGL_ERROR_LIMIT_EXCEEDED;
+    const size_t size = sizeof(struct line_key) + len * sizeof(*str);
+    if (size > s->key_buf_size) {
+        struct line_key *key_buf = ngli_realloc(s->key_buf, 1, size);
+        if (!key_buf)
+            return NULL;
+        s->key_buf = key_buf;
+        s->key_buf_size = size;
+    }
 
-    /* Convert the full string in UTF-8 to Unicode codepoints */
-    FriBidiChar *codepoints = ngli_calloc(full_len, sizeof(*codepoints));
-    if (!codepoints)
-        return NGL_ERROR_MEMORY;
-    FriBidiStrIndex unicode_len = fribidi_charset_to_unicode(FRIBIDI_CHAR_SET_UTF8, str_orig, (FriBidiStrIndex)full_len, codepoints);
-    ngli_assert(unicode_len <= full_len);
+    struct line_key *key = s->key_buf;
+    key->len = (uint32_t)len;
+    key->base_dir = (int32_t)base_dir;
+    memcpy(key->codepoints, str, len * sizeof(*str));
+    return key;
+}
 
-    /* Split input into lines and re-order codepoints of each line for bidirectionnal */
-    FriBidiParType pbase_dir = FRIBIDI_PAR_ON;
-    size_t pos = 0;
-    for (;;) {
-        ret = handle_line_breaks(text, runs_array, codepoints, (size_t)unicode_len, &pos);
-        if (ret < 0)
-            goto end;
-        if (pos == unicode_len)
-            break;
+static int shape_line(struct text *text, struct shaped_line *line,
+                      const FriBidiChar *str, size_t len, FriBidiParType base_dir)
+{
+    struct text_external *s = text->priv_data;
 
-        /*
-         * FriBidi works with lines (or paragraphs) so we must break the input
-         * into multiple chunks: this is our first level of segmentation.
-         */
-        size_t end = find_line_end(codepoints, (size_t)unicode_len, pos);
-        if (end == pos) {
-            ngli_assert(end == unicode_len);
-            break;
-        }
-        ngli_assert(end > pos);
-        const size_t len = end - pos;
+    line->base_dir = base_dir;
 
+    if (char_is_linebreak(str[0])) {
+        int ret = split_into_runs(text, &line->runs, str, len, RUN_TYPE_LINEBREAK, 0, len);
+        if (ret < 0)
+            return ret;
+    } else {
         /* Transform codepoints array from logical to visual order */
         FriBidiChar *visual_str = ngli_calloc(len, sizeof(*visual_str));
-        if (!visual_str) {
-            ret = NGL_ERROR_MEMORY;
-            goto end;
-        }
-        ret = log2vis(&codepoints[pos], (int)len, &pbase_dir, visual_str);
+        if (!visual_str)
+            return NGL_ERROR_MEMORY;
+        int ret = log2vis(str, (int)len, &line->base_dir, visual_str);
         if (ret < 0) {
             ngli_freep(&visual_str);
-            goto end;
+            return ret;
         }
 
         /*
@@ -682,20 +1174,20 @@ static int build_text_runs(struct text *text, const char *str_orig, struct text_
          * won't be possible to identify whether a character is a glyph, space,
          * linebreak, etc. This our 2nd level of segmentation.
          */
-        ret = handle_words_and_wordseps(text, runs_array, visual_str, len);
+        ret = handle_words_and_wordseps(text, &line->runs, visual_str, len);
         ngli_freep(&visual_str);
         if (ret < 0)
-            goto end;
-
-        pos += len;
+            return ret;
     }
 
     /* Run shaping on all run buffers */
-    for (size_t i = 0; i < runs_array->count; i++) {
-        struct text_run *run = &runs_array->data[i];
+    for (size_t i = 0; i < line->runs.count; i++) {
+        struct text_run *run = &line->runs.data[i];
         hb_buffer_t *buffer = run->buffer;
         const size_t face_id = run->face_id != SIZE_MAX ? run->face_id : 0;
-        hb_shape(s->hb_fonts.data[face_id], buffer, NULL, 0);
+        const struct font_size *font_size = s->font_sizes.data[face_id];
+        activate_font_size(font_size);
+        hb_shape(font_size->hb_font, buffer, NULL, 0);
 
         /*
          * Save these pointers because they take a mutable buffer and we want to
@@ -705,6 +1197,106 @@ static int build_text_runs(struct text *text, const char *str_orig, struct text_
         run->glyph_positions = hb_buffer_get_glyph_positions(buffer, NULL);
     }
 
+    return queue_glyph_jobs(text, &line->runs);
+}
+
+/*
+ * Get the shaped line from the lines of the new string, or from the lines of
+ * the previous string, or shape it if it is new
+ */
+static const struct shaped_line *get_shaped_line(struct text *text, struct hmap *lines,
+                                                 const FriBidiChar *str, size_t len,
+                                                 FriBidiParType base_dir, int *errp)
+{
+    struct text_external *s = text->priv_data;
+
+    const struct line_key *key = get_line_key(text, str, len, base_dir);
+    if (!key) {
+        *errp = NGL_ERROR_MEMORY;
+        return NULL;
+    }
+
+    struct shaped_line *line = ngli_hmap_get_ptr(lines, key);
+    if (line)
+        return line;
+
+    line = s->lines ? ngli_hmap_get_ptr(s->lines, key) : NULL;
+    if (line) {
+        line->refcount++;
+    } else {
+        line = ngli_calloc(1, sizeof(*line));
+        if (!line) {
+            *errp = NGL_ERROR_MEMORY;
+            return NULL;
+        }
+        line->refcount = 1;
+
+        int ret = shape_line(text, line, str, len, base_dir);
+        if (ret < 0) {
+            shaped_line_unref(NULL, line);
+            *errp = ret;
+            return NULL;
+        }
+    }
+
+    int ret = ngli_hmap_set_ptr(lines, key, line);
+    if (ret < 0) {
+        shaped_line_unref(NULL, line);
+        *errp = ret;
+        return NULL;
+    }
+
+    return line;
+}
+
+/*
+ * Split text into lines (and sequences of line breaks), each of them being
+ * split into runs, where each run is essentially a harfbuzz buffer
+ */
+static int build_text_lines(struct text *text, const char *str_orig,
+                            struct hmap *lines, struct shaped_line_darray *lines_array)
+{
+    int ret = 0;
+
+    const size_t full_len = strlen(str_orig);
+    if (full_len > INT32_MAX)
+        return NGL_ERROR_LIMIT_EXCEEDED;
+
+    /* Convert the full string in UTF-8 to Unicode codepoints */
+    FriBidiChar *codepoints = ngli_calloc(full_len, sizeof(*codepoints));
+    if (!codepoints)
+        return NGL_ERROR_MEMORY;
+    FriBidiStrIndex unicode_len = fribidi_charset_to_unicode(FRIBIDI_CHAR_SET_UTF8, str_orig, (FriBidiStrIndex)full_len, codepoints);
+    ngli_assert(unicode_len <= full_len);
+
+    /*
+     * FriBidi works with lines (or paragraphs) so we must break the input
+     * into multiple chunks: this is our first level of segmentation.
+     */
+    FriBidiParType pbase_dir = FRIBIDI_PAR_ON;
+    size_t pos = 0;
+    while (pos < (size_t)unicode_len) {
+        size_t end = pos;
+        if (char_is_linebreak(codepoints[pos])) {
+            while (end < (size_t)unicode_len && char_is_linebreak(codepoints[end]))
+                end++;
+        } else {
+            end = find_line_end(codepoints, (size_t)unicode_len, pos);
+        }
+        ngli_assert(end > pos);
+
+        const struct shaped_line *line = get_shaped_line(text, lines, &codepoints[pos], end - pos, pbase_dir, &ret);
+        if (!line)
+            goto end;
+        if (ngli_darray_push(lines_array, line) < 0) {
+            ret = NGL_ERROR_MEMORY;
+            goto end;
+        }
+
+        pbase_dir = line->base_dir;
+        pos = end;
+    }
+
 end:
     ngli_freep(&codepoints);
     return ret;
@@ -713,77 +1305,103 @@ end:
 // XXX is this a reasonable thing to use for vertical text as well?
 // See also the also the max_advance field
 // The value is using 26.6 encoding
-#define GET_LINE_ADVANCE(face_id) ((int32_t)(ft_faces[face_id]->size->metrics.height))
+#define GET_LINE_ADVANCE(face_id) ((int32_t)(font_sizes[face_id]->ft_size->metrics.height))
 
-static int register_chars(struct text *text, const char *str, struct ngli_char_info_internal_darray *chars_dst,
-                          const struct text_run_darray *runs_array, const struct hmap *glyph_index)
+static int register_run_chars(struct text *text, struct ngli_char_info_internal_darray *chars_dst,
+                              const struct text_run *run, hb_position_t *x_curp, hb_position_t *y_curp,
+                              int32_t *line_advancep)
 {
     struct text_external *s = text->priv_data;
 
     const int32_t adv_sign = text->config.writing_mode == NGLI_TEXT_WRITING_MODE_VERTICAL_LR ? 1 : -1;
 
-    ngli_assert(s->ft_faces.count > 0);
-    const FT_Face *ft_faces = s->ft_faces.data;
+    struct font_size * const *font_sizes = s->font_sizes.data;
 
-    hb_position_t x_cur = 0, y_cur = 0;
-    int32_t line_advance = GET_LINE_ADVANCE(0);
+    hb_position_t x_cur = *x_curp, y_cur = *y_curp;
+    int32_t line_advance = *line_advancep;
 
-    for (size_t i = 0; i < runs_array->count; i++) {
-        const struct text_run *run = &runs_array->data[i];
-        const size_t len = hb_buffer_get_length(run->buffer);
-        const hb_direction_t direction = hb_buffer_get_direction(run->buffer);
+    const size_t len = hb_buffer_get_length(run->buffer);
+    const hb_direction_t direction = hb_buffer_get_direction(run->buffer);
 
-        /* Update line advance in case there was a font change in the middle of the line */
-        if (run->face_id != SIZE_MAX) {
-            const int32_t run_line_advance = GET_LINE_ADVANCE(run->face_id);
-            line_advance = NGLI_MAX(line_advance, run_line_advance);
-        }
-
-        for (size_t j = 0; j < len; j++) {
-            const hb_glyph_position_t *pos = &run->glyph_positions[j];
-            struct char_info_internal chr = {0};
-
-            if (run->type == RUN_TYPE_LINEBREAK) {
-                chr.tags = NGLI_TEXT_CHAR_TAG_LINE_BREAK;
-                if (HB_DIRECTION_IS_HORIZONTAL(direction)) {
-                    x_cur = 0;
-                    y_cur += adv_sign * line_advance;
-                } else {
-                    y_cur = 0;
-                    x_cur += adv_sign * line_advance;
-                }
-
-                /* Reset line advance to its default value */
-                line_advance = GET_LINE_ADVANCE(0);
-
-                /* We assume the linebreak is never displayable */
-                if (ngli_darray_push(chars_dst, chr) < 0)
-                    return NGL_ERROR_MEMORY;
-                continue;
+    /* Update line advance in case there was a font change in the middle of the line */
+    if (run->face_id != SIZE_MAX) {
+        const int32_t run_line_advance = GET_LINE_ADVANCE(run->face_id);
+        line_advance = NGLI_MAX(line_advance, run_line_advance);
+    }
 
-            } else if (run->type == RUN_TYPE_WORDSEP) {
-                chr.tags = NGLI_TEXT_CHAR_TAG_WORD_SEPARATOR;
+    for (size_t j = 0; j < len; j++) {
+        const hb_glyph_position_t *pos = &run->glyph_positions[j];
+        struct char_info_internal chr = {0};
+
+        if (run->type == RUN_TYPE_LINEBREAK) {
+            chr.tags = NGLI_TEXT_CHAR_TAG_LINE_BREAK;
+            if (HB_DIRECTION_IS_HORIZONTAL(direction)) {
+                x_cur = 0;
+                y_cur += adv_sign * line_advance;
+            } else {
+                y_cur = 0;
+                x_cur += adv_sign * line_advance;
             }
 
-            const hb_codepoint_t glyph_id = run->glyph_infos[j].codepoint;
-            const char glyph_uid[] = GLYPH_UID_STRING(run->face_id, glyph_id);
-            const struct glyph *glyph = ngli_hmap_get_str(glyph_index, glyph_uid);
-            if (glyph) {
-                chr.tags |= NGLI_TEXT_CHAR_TAG_GLYPH;
-                chr.x = x_cur + glyph->bearing_x + pos->x_offset;
-                chr.y = y_cur + glyph->bearing_y + pos->y_offset;
-                chr.w = glyph->width;
-                chr.h = glyph->height;
-                chr.scale[0] = 1.f;
-                chr.scale[1] = 1.f;
-                ngli_slug_get_glyph_data(s->slug, glyph->slug_index, &chr.slug);
-            }
+            /* Reset line advance to its default value */
+            line_advance = GET_LINE_ADVANCE(0);
 
+            /* We assume the linebreak is never displayable */
             if (ngli_darray_push(chars_dst, chr) < 0)
                 return NGL_ERROR_MEMORY;
+            continue;
 
-            x_cur += pos->x_advance;
-            y_cur += pos->y_advance;
+        } else if (run->type == RUN_TYPE_WORDSEP) {
+            chr.tags = NGLI_TEXT_CHAR_TAG_WORD_SEPARATOR;
+        }
+
+        const hb_codepoint_t glyph_id = run->glyph_infos[j].codepoint;
+        const struct glyph *glyph = run->face_id != SIZE_MAX ? ngli_hmap_get_u64(font_sizes[run->face_id]->glyphs, glyph_id) : NULL;
+        if (glyph && glyph->slug_index >= 0) {
+            chr.tags |= NGLI_TEXT_CHAR_TAG_GLYPH;
+            chr.x = x_cur + glyph->bearing_x + pos->x_offset;
+            chr.y = y_cur + glyph->bearing_y + pos->y_offset;
+            chr.w = glyph->width;
+            chr.h = glyph->height;
+            chr.scale[0] = 1.f;
+            chr.scale[1] = 1.f;
+            ngli_slug_get_glyph_data(s->registry->slug, glyph->slug_index, &chr.slug);
+        }
+
+        if (ngli_darray_push(chars_dst, chr) < 0)
+            return NGL_ERROR_MEMORY;
+
+        x_cur += pos->x_advance;
+        y_cur += pos->y_advance;
+    }
+
+    *x_curp = x_cur;
+    *y_curp = y_cur;
+    *line_advancep = line_advance;
+    return 0;
+}
+
+/*
+ * The positions depend on all the previous lines, so the characters are
+ * always registered from the (cheap) shaped lines, even the cached ones
+ */
+static int register_chars(struct text *text, struct ngli_char_info_internal_darray *chars_dst,
+                          const struct shaped_line_darray *lines_array)
+{
+    struct text_external *s = text->priv_data;
+
+    ngli_assert(s->font_sizes.count > 0);
+    struct font_size * const *font_sizes = s->font_sizes.data;
+
+    hb_position_t x_cur = 0, y_cur = 0;
+    int32_t line_advance = GET_LINE_ADVANCE(0);
+
+    for (size_t i = 0; i < lines_array->count; i++) {
+        const struct text_run_darray *runs_array = &lines_array->data[i]->runs;
+        for (size_t j = 0; j < runs_array->count; j++) {
+            int ret = register_run_chars(text, chars_dst, &runs_array->data[j], &x_cur, &y_cur, &line_advance);
+            if (ret < 0)
+                return ret;
         }
     }
     return 0;
@@ -793,32 +1411,44 @@ static int text_external_set_string(struct text *text, const char *str, struct n
 {
     struct text_external *s = text->priv_data;
 
-    struct text_run_darray runs_array = {0};
+    struct shaped_line_darray lines_array = {0};
 
-    int ret = build_text_runs(text, str, &runs_array);
-    if (ret < 0)
+    struct hmap *lines = create_lines_cache();
+    if (!lines)
+        return NGL_ERROR_MEMORY;
+
+    struct slug *slug = s->registry->slug;
+    const size_t prev_glyph_count = ngli_slug_get_glyph_count(slug);
+
+    /* The glyphs of the new lines are queued while shaping them */
+    int ret = build_text_lines(text, str, lines, &lines_array);
+    if (ret < 0) {
+        reset_glyph_jobs(text, 1);
         goto end;
+    }
 
-    const size_t prev_glyph_count = ngli_slug_get_glyph_count(s->slug);
-    ret = build_glyph_index(text, s->glyph_index, &runs_array);
+    ret = build_glyph_index(text);
     if (ret < 0)
         goto end;
 
-    /* Only rebuild GPU textures when new glyphs were added */
-    if (ngli_slug_get_glyph_count(s->slug) > prev_glyph_count) {
-        ret = ngli_slug_finalize(s->slug);
+    /* Only upload the glyphs that were not already in the shared atlas */
+    if (ngli_slug_get_glyph_count(slug) > prev_glyph_count) {
+        ret = ngli_slug_finalize(slug);
         if (ret < 0)
             goto end;
-        text->curve_texture = ngli_slug_get_curve_texture(s->slug);
-        text->band_texture = ngli_slug_get_band_texture(s->slug);
     }
+    text_external_refresh_atlas(text);
 
-    ret = register_chars(text, str, chars_dst, &runs_array, s->glyph_index);
+    ret = register_chars(text, chars_dst, &lines_array);
     if (ret < 0)
         goto end;
 
+    /* Only keep the lines of the current string for the next update */
+    NGLI_SWAP(lines, s->lines);
+
 end:
-    reset_runs(&runs_array);
+    ngli_darray_reset(&lines_array);
+    ngli_hmap_freep(&lines);
     return ret;
 }
 
@@ -826,10 +1456,13 @@ static void text_external_reset(struct text *text)
 {
     struct text_external *s = text->priv_data;
 
-    ngli_hmap_freep(&s->glyph_index);
-    ngli_darray_reset(&s->hb_fonts);
-    ngli_darray_reset(&s->ft_faces);
-    ngli_slug_freep(&s->slug);
+    if (s->registry)
+        text_external_release(text);
+    ngli_hmap_freep(&s->lines);
+    ngli_freep(&s->key_buf);
+    ngli_darray_reset(&s->glyph_jobs);
+    ngli_darray_reset(&s->font_sizes);
+    registry_unrefp(text->ctx, &s->registry);
 }
 
 const struct text_cls ngli_text_external = {
@@ -838,6 +1471,7 @@ const struct text_cls ngli_text_external = {
     .prefetch        = text_external_prefetch,
     .set_string      = text_external_set_string,
     .release         = text_external_release,
+    .refresh_atlas   = text_external_refresh_atlas,
     .reset           = text_external_reset,
     .flags           = NGLI_TEXT_FLAG_MUTABLE_ATLAS,
 };
@@ -0,0 +1,223 @@
+/*
+ * Copyright 2026 Matthieu Bouron <matthieu.bouron@gmail.com>
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdio.h>
+
+#include "internal.h"
+#include "log.h"
+#include "ngpu/ngpu.h"
+#include "trace.h"
+#include "utils/bstr.h"
+#include "utils/memory.h"
+#include "utils/pthread_compat.h"
+#include "utils/utils.h"
+
+#define TRACE_PID 1
+#define GPU_TID   0 /* the CPU threads are numbered from 1 */
+
+struct ngli_trace {
+    FILE *fp;
+    pthread_mutex_t lock;
+    bool lock_initialized;
+    struct bstr *events; /* events pending to be written to the file */
+    bool has_events;
+};
+
+static const char * const phase_names[NGLI_TRACE_PHASE_NB] = {
+    [NGLI_TRACE_PHASE_PREFETCH]   = "prefetch",
+    [NGLI_TRACE_PHASE_UPDATE]     = "update",
+    [NGLI_TRACE_PHASE_CPU_UPDATE] = "cpu_update",
+    [NGLI_TRACE_PHASE_PRE_DRAW]   = "pre_draw",
+    [NGLI_TRACE_PHASE_DRAW]       = "draw",
+};
+
+static atomic_uint tid_counter;
+static _Thread_local uint32_t current_tid;
+
+static uint32_t get_tid(void)
+{
+    if (!current_tid)
+        current_tid = atomic_fetch_add(&tid_counter, 1) + 1;
+    return current_tid;
+}
+
+struct ngli_trace *ngli_trace_create(void)
+{
+    struct ngli_trace *s = ngli_calloc(1, sizeof(*s));
+    return s;
+}
+
+static void print_json_string(struct bstr *b, const char *str)
+{
+    ngli_bstr_print(b, "\"");
+    const char *p = str;
+    while (*p) {
+        size_t len = 0;
+        while (p[len] && p[len] != '"' && p[len] != '\\' && (unsigned char)p[len] >= 0x20)
+            len++;
+        if (len) {
+            ngli_bstr_printf(b, "%.*s", (int)len, p);
+            p += len;
+            continue;
+        }
+        const unsigned char c = (unsigned char)*p++;
+        if (c == '"' || c == '\\')
+            ngli_bstr_printf(b, "\\%c", c);
+        else
+            ngli_bstr_printf(b, "\\u%04x", c);
+    }
+    ngli_bstr_print(b, "\"");
+}
+
+static void print_separator(struct ngli_trace *s)
+{
+    ngli_bstr_print(s->events, s->has_events ? ",\n" : "\n");
+    s->has_events = true;
+}
+
+static void print_thread_name(struct ngli_trace *s, uint32_t tid, const char *name)
+{
+    print_separator(s);
+    ngli_bstr_printf(s->events, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%u,\"args\":{\"name\":",
+                     TRACE_PID, tid);
+    print_json_string(s->events, name);
+    ngli_bstr_print(s->events, "}}");
+}
+
+/* Timestamps are expressed in microseconds */
+static void print_span(struct ngli_trace *s, const char *name, const char *category, const char *type,
+                       uint32_t tid, double start, double end)
+{
+    print_separator(s);
+    ngli_bstr_print(s->events, "{\"name\":");
+    print_json_string(s->events, name);
+    ngli_bstr_printf(s->events, ",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%u",
+                     category, start, end - start, TRACE_PID, tid);
+    if (type)
+        ngli_bstr_printf(s->events, ",\"args\":{\"type\":\"%s\"}", type);
+    ngli_bstr_print(s->events, "}");
+}
+
+int ngli_trace_init(struct ngli_trace *s, const char *filename)
+{
+    if (pthread_mutex_init(&s->lock, NULL))
+        return NGL_ERROR_EXTERNAL;
+    s->lock_initialized = true;
+
+    s->events = ngli_bstr_create();
+    if (!s->events)
+        return NGL_ERROR_MEMORY;
+
+    s->fp = fopen(filename, "wb");
+    if (!s->fp) {
+        LOG(ERROR, "unable to open \"%s\" for writing", filename);
+        return NGL_ERROR_IO;
+    }
+
+    ngli_bstr_print(s->events, "[");
+    print_thread_name(s, GPU_TID, "GPU");
+
+    return ngli_trace_flush(s);
+}
+
+void ngli_trace_add_span(struct ngli_trace *s, const char *name, const char *category, int64_t start, int64_t end)
+{
+    const uint32_t tid = get_tid();
+
+    pthread_mutex_lock(&s->lock);
+    print_span(s, name, category, NULL, tid, (double)start, (double)end);
+    pthread_mutex_unlock(&s->lock);
+}
+
+void ngli_trace_add_node_span(struct ngli_trace *s, const struct ngl_node *node, enum ngli_trace_phase phase,
+                              int64_t start, int64_t end)
+{
+    const uint32_t tid = get_tid();
+    const char *name = node->label ? node->label : node->cls->name;
+
+    pthread_mutex_lock(&s->lock);
+    print_span(s, name, phase_names[phase], node->cls->name, tid, (double)start, (double)end);
+    pthread_mutex_unlock(&s->lock);
+}
+
+void ngli_trace_add_gpu_spans(struct ngli_trace *s, struct ngpu_ctx *gpu_ctx, int64_t start, int64_t draw_time)
+{
+    /*
+     * The GPU and CPU clocks are not correlated: the GPU spans are aligned on
+     * the CPU start of the draw, and the render passes on the GPU draw.
+     */
+    const double origin = (double)start;
+
+    const struct ngpu_render_pass_time *times;
+    const size_t nb_times = ngpu_ctx_get_render_pass_times(gpu_ctx, &times);
+
+    pthread_mutex_lock(&s->lock);
+    print_span(s, "draw", "gpu", NULL, GPU_TID, origin, origin + (double)draw_time / 1000.0);
+    for (size_t i = 0; i < nb_times; i++) {
+        char name[32];
+        snprintf(name, sizeof(name), "render pass %zu", i);
+        print_span(s, name, "gpu", NULL, GPU_TID,
+                   origin + (double)times[i].start / 1000.0,
+                   origin + (double)times[i].end / 1000.0);
+    }
+    pthread_mutex_unlock(&s->lock);
+}
+
+int ngli_trace_flush(struct ngli_trace *s)
+{
+    int ret = 0;
+
+    pthread_mutex_lock(&s->lock);
+    if (ngli_bstr_check(s->events) < 0) {
+        ret = NGL_ERROR_MEMORY;
+        goto end;
+    }
+
+    const size_t len = ngli_bstr_len(s->events);
+    if (fwrite(ngli_bstr_strptr(s->events), 1, len, s->fp) != len) {
+        LOG(ERROR, "unable to write trace events");
+        ret = NGL_ERROR_IO;
+    }
+    ngli_bstr_clear(s->events);
+
+end:
+    pthread_mutex_unlock(&s->lock);
+    return ret;
+}
+
+void ngli_trace_freep(struct ngli_trace **sp)
+{
+    struct ngli_trace *s = *sp;
+    if (!s)
+        return;
+
+    if (s->fp) {
+        ngli_trace_flush(s);
+        fputs("\n]\n", s->fp);
+        fclose(s->fp);
+    }
+    ngli_bstr_freep(&s->events);
+    if (s->lock_initialized)
+        pthread_mutex_destroy(&s->lock);
+    ngli_freep(sp);
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2026 Matthieu Bouron <matthieu.bouron@gmail.com>
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+struct ngl_node;
+struct ngpu_ctx;
+
+/*
+ * Recorder of CPU and GPU time spans, written to a Chrome trace file (JSON
+ * array format) which can be opened in Perfetto or chrome://tracing.
+ *
+ * CPU spans can be added from any thread. They are buffered and written to
+ * the file at the end of every frame.
+ */
+
+enum ngli_trace_phase {
+    NGLI_TRACE_PHASE_PREFETCH,
+    NGLI_TRACE_PHASE_UPDATE,
+    NGLI_TRACE_PHASE_CPU_UPDATE,
+    NGLI_TRACE_PHASE_PRE_DRAW,
+    NGLI_TRACE_PHASE_DRAW,
+    NGLI_TRACE_PHASE_NB
+};
+
+struct ngli_trace;
+
+struct ngli_trace *ngli_trace_create(void);
+int ngli_trace_init(struct ngli_trace *s, const char *filename);
+void ngli_trace_add_span(struct ngli_trace *s, const char *name, const char *category, int64_t start, int64_t end);
+void ngli_trace_add_node_span(struct ngli_trace *s, const struct ngl_node *node, enum ngli_trace_phase phase,
+                              int64_t start, int64_t end);
+void ngli_trace_add_gpu_spans(struct ngli_trace *s, struct ngpu_ctx *gpu_ctx, int64_t start, int64_t draw_time);
+int ngli_trace_flush(struct ngli_trace *s);
+void ngli_trace_freep(struct ngli_trace **sp);
+
+#endif
@@ -35,6 +35,8 @@ const char *ngli_error_to_string(int error)
     return "operation not allowed";
   case NGL_ERROR_BUG:
     return "a buggy code path was triggered, please report if it happens";
+  case NGL_ERROR_BUSY:
+    return "resource temporarily unavailable";
   case NGL_ERROR_EXTERNAL:
     return "an error occurred in an external dependency";
   case NGL_ERROR_INVALID_ARG:
@@ -0,0 +1,432 @@
+/*
+ * Copyright 2026 Matthieu Bouron <matthieu.bouron@gmail.com>
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "nopegl/nopegl.h"
+
+#include "memory.h"
+#include "scheduler.h"
+#include "thread.h"
+#include "utils.h"
+
+#define DEQUE_MIN_CAPACITY 64
+
+struct task {
+    struct ngli_task_group *group;
+    ngli_task_func func;
+    ngli_range_func range_func;
+    void *arg;
+    size_t start;
+    size_t end;
+};
+
+/*
+ * Ring buffer of tasks: the owner thread pushes and pops at the bottom while
+ * the other threads steal from the top. Every deque has its own lock so the
+ * threads only contend when stealing from the same victim.
+ */
+struct deque {
+    pthread_mutex_t lock;
+    struct task *tasks;
+    size_t capacity; // always a power of 2
+    size_t top;
+    size_t bottom;
+};
+
+struct worker {
+    struct ngli_scheduler *scheduler;
+    uint32_t index;
+    pthread_t thread;
+    struct deque deque;
+    uint32_t random_state;
+};
+
+struct ngli_scheduler {
+    char name[14];
+    uint32_t nb_threads;
+    struct worker *workers; // workers[0] is the thread driving the scheduler
+    uint32_t nb_started;
+
+    atomic_size_t nb_queued;
+    atomic_uint nb_sleeping;
+    pthread_mutex_t sleep_lock;
+    pthread_cond_t sleep_cond;
+    bool stopped;
+};
+
+static _Thread_local struct worker *current_worker;
+
+static int deque_init(struct deque *d)
+{
+    d->tasks = ngli_calloc(DEQUE_MIN_CAPACITY, sizeof(*d->tasks));
+    if (!d->tasks)
+        return NGL_ERROR_MEMORY;
+    d->capacity = DEQUE_MIN_CAPACITY;
+    pthread_mutex_init(&d->lock, NULL);
+    return 0;
+}
+
+static void deque_reset(struct deque *d)
+{
+    if (!d->tasks)
+        return;
+    ngli_assert(d->top == d->bottom);
+    pthread_mutex_destroy(&d->lock);
+    ngli_freep(&d->tasks);
+}
+
+static int deque_grow(struct deque *d)
+{
+    const size_t capacity = d->capacity * 2;
+    struct task *tasks = ngli_calloc(capacity, sizeof(*tasks));
+    if (!tasks)
+        return NGL_ERROR_MEMORY;
+    for (size_t i = d->top; i != d->bottom; i++)
+        tasks[i & (capacity - 1)] = d->tasks[i & (d->capacity - 1)];
+    ngli_freep(&d->tasks);
+    d->tasks = tasks;
+    d->capacity = capacity;
+    return 0;
+}
+
+static int deque_push(struct deque *d, const struct task *task)
+{
+    pthread_mutex_lock(&d->lock);
+    if (d->bottom - d->top == d->capacity) {
+        int ret = deque_grow(d);
+        if (ret < 0) {
+            pthread_mutex_unlock(&d->lock);
+            return ret;
+        }
+    }
+    d->tasks[d->bottom & (d->capacity - 1)] = *task;
+    d->bottom++;
+    pthread_mutex_unlock(&d->lock);
+    return 0;
+}
+
+static bool deque_pop(struct deque *d, struct task *task)
+{
+    bool ret = false;
+    pthread_mutex_lock(&d->lock);
+    if (d->bottom != d->top) {
+        d->bottom--;
+        *task = d->tasks[d->bottom & (d->capacity - 1)];
+        ret = true;
+    }
+    pthread_mutex_unlock(&d->lock);
+    return ret;
+}
+
+static bool deque_steal(struct deque *d, struct task *task)
+{
+    bool ret = false;
+    pthread_mutex_lock(&d->lock);
+    if (d->bottom != d->top) {
+        *task = d->tasks[d->top & (d->capacity - 1)];
+        d->top++;
+        ret = true;
+    }
+    pthread_mutex_unlock(&d->lock);
+    return ret;
+}
+
+static struct worker *get_current_worker(struct ngli_scheduler *s)
+{
+    struct worker *worker = current_worker;
+    if (worker && worker->scheduler == s)
+        return worker;
+    return &s->workers[0];
+}
+
+static bool find_task(struct ngli_scheduler *s, struct worker *worker, struct task *task)
+{
+    if (!atomic_load(&s->nb_queued))
+        return false;
+
+    if (deque_pop(&worker->deque, task))
+        goto found;
+
+    /* Start from a random victim to spread the thieves over the deques */
+    worker->random_state = worker->random_state * 1664525 + 1013904223;
+    const uint32_t offset = (worker->random_state >> 16) % s->nb_threads;
+    for (uint32_t i = 0; i < s->nb_threads; i++) {
+        struct worker *victim = &s->workers[(offset + i) % s->nb_threads];
+        if (victim != worker && deque_steal(&victim->deque, task))
+            goto found;
+    }
+    return false;
+
+found:
+    atomic_fetch_sub(&s->nb_queued, 1);
+    return true;
+}
+
+static void run_task(const struct worker *worker, const struct task *task)
+{
+    if (task->range_func)
+        task->range_func(task->arg, task->start, task->end, worker->index);
+    else
+        task->func(task->arg, worker->index);
+}
+
+static void execute_task(const struct worker *worker, const struct task *task)
+{
+    run_task(worker, task);
+
+    /* The group may be released as soon as its last task is accounted for */
+    struct ngli_task_group *group = task->group;
+    pthread_mutex_lock(&group->lock);
+    if (--group->nb_pending == 0)
+        pthread_cond_broadcast(&group->cond);
+    pthread_mutex_unlock(&group->lock);
+}
+
+static void *worker_thread(void *arg)
+{
+    struct worker *worker = arg;
+    struct ngli_scheduler *s = worker->scheduler;
+
+    current_worker = worker;
+
+    if (strlen(s->name) > 0) {
+        char name[16];
+        snprintf(name, sizeof(name), "%s-%u", s->name, worker->index);
+        ngli_thread_set_name(name);
+    }
+
+    for (;;) {
+        struct task task;
+        if (find_task(s, worker, &task)) {
+            execute_task(worker, &task);
+            continue;
+        }
+
+        pthread_mutex_lock(&s->sleep_lock);
+        atomic_fetch_add(&s->nb_sleeping, 1);
+        while (!s->stopped && !atomic_load(&s->nb_queued))
+            pthread_cond_wait(&s->sleep_cond, &s->sleep_lock);
+        atomic_fetch_sub(&s->nb_sleeping, 1);
+        const bool stopped = s->stopped;
+        pthread_mutex_unlock(&s->sleep_lock);
+
+        if (stopped)
+            break;
+    }
+
+    return NULL;
+}
+
+struct ngli_scheduler *ngli_scheduler_create(const char *name, uint32_t nb_threads)
+{
+    struct ngli_scheduler *s = ngli_calloc(1, sizeof(*s));
+    if (!s)
+        return NULL;
+
+    snprintf(s->name, sizeof(s->name), "%s", name);
+    pthread_mutex_init(&s->sleep_lock, NULL);
+    pthread_cond_init(&s->sleep_cond, NULL);
+
+    s->nb_threads = NGLI_MAX(nb_threads, 1);
+    s->workers = ngli_calloc(s->nb_threads, sizeof(*s->workers));
+    if (!s->workers)
+        goto fail;
+
+    for (uint32_t i = 0; i < s->nb_threads; i++) {
+        struct worker *worker = &s->workers[i];
+        worker->scheduler = s;
+        worker->index = i;
+        worker->random_state = i + 1;
+        if (deque_init(&worker->deque) < 0)
+            goto fail;
+    }
+
+    for (uint32_t i = 1; i < s->nb_threads; i++) {
+        struct worker *worker = &s->workers[i];
+        if (pthread_create(&worker->thread, NULL, worker_thread, worker) != 0)
+            goto fail;
+        s->nb_started++;
+    }
+
+    return s;
+
+fail:
+    ngli_scheduler_freep(&s);
+    return NULL;
+}
+
+uint32_t ngli_scheduler_get_nb_threads(const struct ngli_scheduler *s)
+{
+    return s->nb_threads;
+}
+
+void ngli_scheduler_freep(struct ngli_scheduler **sp)
+{
+    struct ngli_scheduler *s = *sp;
+    if (!s)
+        return;
+
+    pthread_mutex_lock(&s->sleep_lock);
+    s->stopped = true;
+    pthread_cond_broadcast(&s->sleep_cond);
+    pthread_mutex_unlock(&s->sleep_lock);
+
+    for (uint32_t i = 0; i < s->nb_started; i++)
+        pthread_join(s->workers[i + 1].thread, NULL);
+
+    if (s->workers) {
+        for (uint32_t i = 0; i < s->nb_threads; i++)
+            deque_reset(&s->workers[i].deque);
+        ngli_freep(&s->workers);
+    }
+
+    pthread_cond_destroy(&s->sleep_cond);
+    pthread_mutex_destroy(&s->sleep_lock);
+    ngli_freep(sp);
+}
+
+static void submit_task(struct ngli_scheduler *s, const struct task *task)
+{
+    struct worker *worker = get_current_worker(s);
+    struct ngli_task_group *group = task->group;
+
+    /* Without any other thread to share it with, the task is run right away */
+    if (s->nb_started == 0) {
+        run_task(worker, task);
+        return;
+    }
+
+    pthread_mutex_lock(&group->lock);
+    group->nb_pending++;
+    pthread_mutex_unlock(&group->lock);
+
+    atomic_fetch_add(&s->nb_queued, 1);
+    if (deque_push(&worker->deque, task) < 0) {
+        atomic_fetch_sub(&s->nb_queued, 1);
+        execute_task(worker, task);
+        return;
+    }
+
+    if (atomic_load(&s->nb_sleeping)) {
+        pthread_mutex_lock(&s->sleep_lock);
+        pthread_cond_signal(&s->sleep_cond);
+        pthread_mutex_unlock(&s->sleep_lock);
+    }
+}
+
+void ngli_task_group_init(struct ngli_task_group *group, struct ngli_scheduler *s)
+{
+    memset(group, 0, sizeof(*group));
+    group->scheduler = s;
+    pthread_mutex_init(&group->lock, NULL);
+    pthread_cond_init(&group->cond, NULL);
+}
+
+void ngli_task_group_run(struct ngli_task_group *group, ngli_task_func func, void *arg)
+{
+    const struct task task = {
+        .group = group,
+        .func  = func,
+        .arg   = arg,
+    };
+    submit_task(group->scheduler, &task);
+}
+
+void ngli_task_group_wait(struct ngli_task_group *group)
+{
+    struct ngli_scheduler *s = group->scheduler;
+    struct worker *worker = get_current_worker(s);
+
+    for (;;) {
+        pthread_mutex_lock(&group->lock);
+        const size_t nb_pending = group->nb_pending;
+        pthread_mutex_unlock(&group->lock);
+        if (!nb_pending)
+            return;
+
+        /* Help with any queued task (from this group or not) while waiting */
+        struct task task;
+        if (find_task(s, worker, &task)) {
+            execute_task(worker, &task);
+            continue;
+        }
+
+        /*
+         * Nothing left to steal: the remaining tasks of the group are being
+         * executed, and the sub-tasks they may spawn will be processed by
+         * the threads running them
+         */
+        pthread_mutex_lock(&group->lock);
+        while (group->nb_pending)
+            pthread_cond_wait(&group->cond, &group->lock);
+        pthread_mutex_unlock(&group->lock);
+        return;
+    }
+}
+
+void ngli_task_group_reset(struct ngli_task_group *group)
+{
+    if (!group->scheduler)
+        return;
+    ngli_assert(group->nb_pending == 0);
+    pthread_cond_destroy(&group->cond);
+    pthread_mutex_destroy(&group->lock);
+    memset(group, 0, sizeof(*group));
+}
+
+void ngli_parallel_for(struct ngli_scheduler *s, size_t count, size_t grain_size,
+                       ngli_range_func func, void *arg)
+{
+    if (!count)
+        return;
+
+    const struct worker *worker = get_current_worker(s);
+
+    /* A few ranges per thread to balance uneven workloads */
+    const size_t nb_ranges = (size_t)s->nb_threads * 4;
+    const size_t range_size = NGLI_MAX(NGLI_MAX(grain_size, 1), (count + nb_ranges - 1) / nb_ranges);
+    if (s->nb_started == 0 || count <= range_size) {
+        func(arg, 0, count, worker->index);
+        return;
+    }
+
+    struct ngli_task_group group;
+    ngli_task_group_init(&group, s);
+
+    for (size_t start = range_size; start < count; start += range_size) {
+        const struct task task = {
+            .group      = &group,
+            .range_func = func,
+            .arg        = arg,
+            .start      = start,
+            .end        = NGLI_MIN(start + range_size, count),
+        };
+        submit_task(s, &task);
+    }
+    func(arg, 0, range_size, worker->index);
+
+    ngli_task_group_wait(&group);
+    ngli_task_group_reset(&group);
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2026 Matthieu Bouron <matthieu.bouron@gmail.com>
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "utils/pthread_compat.h"
+
+/*
+ * Work-stealing task scheduler
+ *
+ * Every thread of the scheduler owns a deque: the tasks spawned from a thread
+ * are pushed at the bottom of its own deque and popped back from there (most
+ * recent first, while its data is still hot in cache), and the idle threads
+ * steal the oldest tasks from the top of the other deques. A thread waiting
+ * for a task group executes the pending tasks instead of blocking, which
+ * allows task groups to be nested.
+ *
+ * The threads are identified by an index in [0, nb_threads), which is passed
+ * to the tasks so they can use per-thread resources. Index 0 is the thread
+ * driving the scheduler: only one thread outside the pool may use a given
+ * scheduler at a time.
+ *
+ * The context owns a single scheduler, which runs all of its parallel CPU
+ * work, including the work it hands out to ngpu (such as the program batch
+ * compilation).
+ */
+
+typedef void (*ngli_task_func)(void *arg, uint32_t thread_index);
+typedef void (*ngli_range_func)(void *arg, size_t start, size_t end, uint32_t thread_index);
+
+struct ngli_scheduler;
+
+struct ngli_task_group {
+    struct ngli_scheduler *scheduler;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    size_t nb_pending;
+};
+
+/*
+ * Create a scheduler running the tasks on nb_threads threads, including the
+ * calling one: nb_threads - 1 worker threads are spawned.
+ */
+struct ngli_scheduler *ngli_scheduler_create(const char *name, uint32_t nb_threads);
+uint32_t ngli_scheduler_get_nb_threads(const struct ngli_scheduler *s);
+void ngli_scheduler_freep(struct ngli_scheduler **sp);
+
+void ngli_task_group_init(struct ngli_task_group *group, struct ngli_scheduler *s);
+void ngli_task_group_run(struct ngli_task_group *group, ngli_task_func func, void *arg);
+void ngli_task_group_wait(struct ngli_task_group *group);
+void ngli_task_group_reset(struct ngli_task_group *group);
+
+/*
+ * Call func on sub-ranges of [0, count) in parallel and return once all of
+ * them are processed. The ranges contain at least grain_size elements, and
+ * are otherwise sized to give a few of them to every thread.
+ */
+void ngli_parallel_for(struct ngli_scheduler *s, size_t count, size_t grain_size,
+                       ngli_range_func func, void *arg);
+
+#endif
@@ -0,0 +1,39 @@
+/*
+ * Copyright 2026 Matthieu Bouron <matthieu.bouron@gmail.com>
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "search.h"
+
+struct timestamp_search {
+    const int64_t *timestamps;
+    int64_t t;
+};
+
+static bool timestamp_le(const void *arg, size_t i)
+{
+    const struct timestamp_search *search = arg;
+    return search->timestamps[i] <= search->t;
+}
+
+size_t ngli_search_timestamp(const int64_t *timestamps, size_t nb_timestamps, size_t hint, int64_t t)
+{
+    const struct timestamp_search search = {.timestamps = timestamps, .t = t};
+    return ngli_search_sorted(nb_timestamps, hint, timestamp_le, &search);
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2026 Matthieu Bouron <matthieu.bouron@gmail.com>
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef bool (*ngli_search_le_func)(const void *arg, size_t i);
+
+/*
+ * Return the index of the last element of a monotonically increasing
+ * sequence which is lower than or equal to the searched value, or SIZE_MAX if
+ * the first one is already greater. le(arg, i) tells whether the i-th element
+ * is lower than or equal to the searched value; being inline, the comparison
+ * is specialized by the compiler for every caller.
+ *
+ * The hint (typically the index returned by the previous call) and its
+ * neighbours are checked first so that playback is O(1); other seeks fall back
+ * to a binary search.
+ */
+static inline size_t ngli_search_sorted(size_t nb, size_t hint, ngli_search_le_func le, const void *arg)
+{
+    if (!nb || !le(arg, 0))
+        return SIZE_MAX;
+
+    /* Search interval such that le(lo) && !le(hi) */
+    size_t lo = 0;
+    size_t hi = nb;
+    if (hint < nb) {
+        if (le(arg, hint)) {
+            if (hint + 1 == nb || !le(arg, hint + 1))
+                return hint;
+            if (hint + 2 == nb || !le(arg, hint + 2))
+                return hint + 1;
+            lo = hint + 2;
+        } else {
+            if (le(arg, hint - 1))
+                return hint - 1;
+            hi = hint - 1;
+        }
+    }
+
+    while (hi - lo > 1) {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (le(arg, mid))
+            lo = mid;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/*
+ * Return the index of the last timestamp lower than or equal to t in the
+ * monotonically increasing timestamps array, or SIZE_MAX if t is before the
+ * first timestamp.
+ */
+size_t ngli_search_timestamp(const int64_t *timestamps, size_t nb_timestamps, size_t hint, int64_t t);
+
+#endif
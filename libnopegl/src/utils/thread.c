@@ -21,6 +21,12 @@
 
 #define _GNU_SOURCE
 
+#include "config.h"
+
+#if !defined(TARGET_WINDOWS)
+#include <unistd.h>
+#endif
+
 #include "pthread_compat.h"
 #include "thread.h"
 
@@ -32,3 +38,15 @@ void ngli_thread_set_name(const char *name)
     pthread_setname_np(pthread_self(), name);
 #endif
 }
+
+uint32_t ngli_thread_get_cpu_count(void)
+{
+#if defined(TARGET_WINDOWS)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (uint32_t)info.dwNumberOfProcessors : 1;
+#else
+    const long nb_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return nb_cpus > 0 ? (uint32_t)nb_cpus : 1;
+#endif
+}
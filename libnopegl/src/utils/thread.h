@@ -22,6 +22,9 @@
 #ifndef THREAD_H
 #define THREAD_H
 
+#include <stdint.h>
+
 void ngli_thread_set_name(const char *name);
+uint32_t ngli_thread_get_cpu_count(void);
 
 #endif /* THREAD_H */
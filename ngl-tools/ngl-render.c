@@ -60,6 +60,8 @@ static struct ngl_scene *get_scene(const char *filename)
     return scene;
 }
 
+#define MAX_PENDING_FRAMES 8
+
 struct range {
     float start;
     float duration;
@@ -75,6 +77,12 @@ struct ctx {
     const char *output;
     struct range *ranges;
     size_t nb_ranges;
+    int nb_jobs;
+    int warmup_frames;
+
+    /* asynchronous capture state */
+    struct ngl_frame *pending_frames[MAX_PENDING_FRAMES];
+    size_t nb_pending_frames;
 };
 
 static int opt_timerange(const char *arg, void *dst)
@@ -100,6 +108,122 @@ static int opt_timerange(const char *arg, void *dst)
     return 0;
 }
 
+static int write_oldest_frame(struct ctx *s, int fd, uint8_t *capture_buffer, size_t capture_buffer_size)
+{
+    struct ngl_frame *frame = s->pending_frames[0];
+    s->nb_pending_frames--;
+    memmove(s->pending_frames, s->pending_frames + 1, s->nb_pending_frames * sizeof(*s->pending_frames));
+
+    int ret = ngl_frame_read_capture(frame, capture_buffer, 1);
+    ngl_frame_release(frame, NULL);
+    if (ret < 0) {
+        fprintf(stderr, "unable to read capture buffer\n");
+        return ret;
+    }
+
+    const size_t n = write(fd, capture_buffer, capture_buffer_size);
+    if (n != capture_buffer_size) {
+        fprintf(stderr, "unable to write capture buffer to output\n");
+        return NGL_ERROR_IO;
+    }
+    return 0;
+}
+
+/*
+ * Queue the frame readbacks instead of waiting for each of them, so that the
+ * GPU keeps rendering the next frames while the previous ones are transferred.
+ */
+static int draw_async(struct ctx *s, struct ngl_ctx *ctx, double t,
+                      int fd, uint8_t *capture_buffer, size_t capture_buffer_size)
+{
+    if (s->nb_pending_frames == MAX_PENDING_FRAMES) {
+        int ret = write_oldest_frame(s, fd, capture_buffer, capture_buffer_size);
+        if (ret < 0)
+            return ret;
+    }
+
+    struct ngl_draw_output output = {0};
+    int ret = ngl_draw(ctx, t, &output);
+    if (ret == NGL_ERROR_BUSY && s->nb_pending_frames) {
+        ret = write_oldest_frame(s, fd, capture_buffer, capture_buffer_size);
+        if (ret < 0)
+            return ret;
+        ret = ngl_draw(ctx, t, &output);
+    }
+    if (ret < 0)
+        return ret;
+
+    s->pending_frames[s->nb_pending_frames++] = output.frame;
+    return 0;
+}
+
+/*
+ * Render the ranges with a pool of contexts, each one drawing a different
+ * segment of the range on its own thread.
+ */
+static int render_parallel(const struct ctx *s, int fd, uint8_t *capture_buffer, size_t capture_buffer_size)
+{
+    char *scene_str = get_text_file_content(s->input);
+    if (!scene_str)
+        return NGL_ERROR_IO;
+
+    int ret = 0;
+    for (size_t i = 0; i < s->nb_ranges; i++) {
+        const struct range *r = &s->ranges[i];
+        const struct ngl_render_farm_params params = {
+            .config        = &s->cfg,
+            .scene_str     = scene_str,
+            .start         = r->start,
+            .duration      = r->duration,
+            .freq          = r->freq,
+            .nb_workers    = (uint32_t)s->nb_jobs,
+            .warmup_frames = (uint32_t)s->warmup_frames,
+        };
+
+        const int64_t start = gettime_relative();
+
+        struct ngl_render_farm *farm = ngl_render_farm_create();
+        if (!farm) {
+            ret = NGL_ERROR_MEMORY;
+            break;
+        }
+
+        ret = ngl_render_farm_init(farm, &params);
+        if (ret < 0) {
+            ngl_render_farm_freep(&farm);
+            break;
+        }
+
+        const size_t nb_frames = ngl_render_farm_get_nb_frames(farm);
+        for (size_t k = 0; k < nb_frames; k++) {
+            double t;
+            ret = ngl_render_farm_read_frame(farm, capture_buffer, &t);
+            if (ret < 0) {
+                fprintf(stderr, "Unable to render frame %zu\n", k);
+                break;
+            }
+            if (s->debug_timings)
+                printf("draw @ t=%f [range %zu/%zu: %g-%g @ %dHz]\n",
+                       t, i + 1, s->nb_ranges, r->start, r->start + r->duration, r->freq);
+            const size_t n = write(fd, capture_buffer, capture_buffer_size);
+            if (n != capture_buffer_size) {
+                fprintf(stderr, "unable to write capture buffer to output\n");
+                ret = NGL_ERROR_IO;
+                break;
+            }
+        }
+        ngl_render_farm_freep(&farm);
+        if (ret < 0)
+            break;
+
+        const double tdiff = (double)(gettime_relative() - start) / 1000000.;
+        printf("Rendered %zu frames in %g (FPS=%g)\n", nb_frames, tdiff, (double)nb_frames / tdiff);
+    }
+
+    free(scene_str);
+    return ret;
+}
+
 #define OFFSET(x) offsetof(struct ctx, x)
 static const struct opt options[] = {
     {"-d", "--debug-timings", OPT_TYPE_TOGGLE,   .offset=OFFSET(debug_timings)},
@@ -114,6 +238,10 @@ static const struct opt options[] = {
     {"-c", "--clear_color",   OPT_TYPE_COLOR,    .offset=OFFSET(cfg.clear_color)},
     {"-m", "--samples",       OPT_TYPE_INT,      .offset=OFFSET(cfg.samples)},
     {NULL, "--debug",         OPT_TYPE_TOGGLE,   .offset=OFFSET(cfg.debug)},
+    {"-a", "--async_capture", OPT_TYPE_TOGGLE,   .offset=OFFSET(cfg.async_capture)},
+    {NULL, "--trace",         OPT_TYPE_STR,      .offset=OFFSET(cfg.trace_filename)},
+    {"-j", "--jobs",          OPT_TYPE_INT,      .offset=OFFSET(nb_jobs)},
+    {NULL, "--warmup",        OPT_TYPE_INT,      .offset=OFFSET(warmup_frames)},
 };
 
 int main(int argc, char *argv[])
@@ -134,6 +262,11 @@ int main(int argc, char *argv[])
     int ret = opts_parse(argc, argc, argv, options, ARRAY_NB(options), &s);
     if (ret < 0 || ret == OPT_HELP) {
         opts_print_usage(argv[0], options, ARRAY_NB(options), NULL);
+        fprintf(stderr, "\n"
+                "With -j, every segment of the range is rendered by a different context.\n"
+                "--warmup sets the number of frames for which the scene is updated before\n"
+                "each segment; without it (default: 0), media and history-dependent nodes\n"
+                "may render differently than with a sequential rendering.\n");
         return ret == OPT_HELP ? 0 : EXIT_FAILURE;
     }
 
@@ -144,6 +277,22 @@ int main(int argc, char *argv[])
         return EXIT_FAILURE;
     }
 
+    if (s.cfg.async_capture && (!s.cfg.offscreen || !s.output)) {
+        fprintf(stderr, "Asynchronous capture requires an offscreen rendering with an output\n");
+        return EXIT_FAILURE;
+    }
+
+    if (s.nb_jobs > 1 && (!s.cfg.offscreen || !s.output || s.cfg.async_capture)) {
+        fprintf(stderr, "Parallel rendering requires an offscreen rendering with an output "
+                "and no asynchronous capture\n");
+        return EXIT_FAILURE;
+    }
+
+    if (s.warmup_frames < 0) {
+        fprintf(stderr, "The number of warm-up frames must be positive\n");
+        return EXIT_FAILURE;
+    }
+
     printf("%s -> %s %dx%d\n", s.input ? s.input : "<stdin>", s.output ? s.output : "-", s.cfg.width, s.cfg.height);
 
     if (!s.cfg.offscreen) {
@@ -189,13 +338,20 @@ int main(int argc, char *argv[])
             goto end;
     }
 
+    if (s.nb_jobs > 1) {
+        ngl_scene_unrefp(&scene);
+        ret = render_parallel(&s, fd, capture_buffer, capture_buffer_size);
+        goto end;
+    }
+
     ctx = ngl_create();
     if (!ctx) {
         ngl_scene_unrefp(&scene);
         goto end;
     }
 
-    s.cfg.capture_buffer = capture_buffer;
+    if (!s.cfg.async_capture)
+        s.cfg.capture_buffer = capture_buffer;
 
     if (!s.cfg.offscreen) {
         ret = wsi_set_ngl_config(&s.cfg, window);
@@ -231,12 +387,15 @@ int main(int argc, char *argv[])
             if (s.debug_timings)
                 printf("draw @ t=%f [range %zu/%zu: %g-%g @ %dHz]\n",
                        t, i + 1, s.nb_ranges, t0, t1, r->freq);
-            ret = ngl_draw(ctx, t, NULL);
+            if (s.cfg.async_capture)
+                ret = draw_async(&s, ctx, t, fd, capture_buffer, capture_buffer_size);
+            else
+                ret = ngl_draw(ctx, t, NULL);
             if (ret < 0) {
                 fprintf(stderr, "Unable to draw @ t=%g\n", t);
                 goto end;
             }
-            if (capture_buffer) {
+            if (capture_buffer && !s.cfg.async_capture) {
                 const size_t n = write(fd, capture_buffer, capture_buffer_size);
                 if (n != capture_buffer_size) {
                     fprintf(stderr, "unable to write capture buffer to output\n");
@@ -252,11 +411,19 @@ int main(int argc, char *argv[])
             k++;
         }
 
+        while (s.nb_pending_frames) {
+            ret = write_oldest_frame(&s, fd, capture_buffer, capture_buffer_size);
+            if (ret < 0)
+                goto end;
+        }
+
         const double tdiff = (double)(gettime_relative() - start) / 1000000.;
         printf("Rendered %zu frames in %g (FPS=%g)\n", k, tdiff, (double)k / tdiff);
     }
 
 end:
+    for (size_t i = 0; i < s.nb_pending_frames; i++)
+        ngl_frame_release(s.pending_frames[i], NULL);
     ngl_freep(&ctx);
 
     if (fd != -1)
@@ -22,7 +22,7 @@
 #
 
 from cpython cimport array, pystate
-from libc.stdint cimport int32_t, uint8_t, uint32_t, uintptr_t
+from libc.stdint cimport int32_t, uint8_t, uint32_t, uint64_t, uintptr_t
 from libc.stdlib cimport calloc, free
 from libc.string cimport memset
 
@@ -42,6 +42,7 @@ cdef extern from "nopegl/nopegl.h":
     cdef int NGL_ERROR_GENERIC
     cdef int NGL_ERROR_ACCESS
     cdef int NGL_ERROR_BUG
+    cdef int NGL_ERROR_BUSY
     cdef int NGL_ERROR_EXTERNAL
     cdef int NGL_ERROR_INVALID_ARG
     cdef int NGL_ERROR_INVALID_DATA
@@ -193,6 +194,7 @@ cdef extern from "nopegl/nopegl.h":
     cdef struct ngl_ctx
 
     cdef struct ngpu_ctx
+    cdef struct ngpu_fence
     cdef struct ngl_config:
         ngl_platform_type platform
         ngl_backend_type backend
@@ -208,11 +210,15 @@ cdef extern from "nopegl/nopegl.h":
         float clear_color[4]
         void *capture_buffer
         ngl_capture_buffer_type capture_buffer_type
+        int async_capture
         int hud
         int hud_measure_window
         int hud_refresh_rate[2]
         const char *hud_export_filename
         int hud_scale
+        const char *trace_filename
+        const char *program_cache_dir
+        int nb_threads
         int debug
         ngpu_ctx *shared_gpu_ctx
 
@@ -242,6 +248,10 @@ cdef extern from "nopegl/nopegl.h":
         void (*uninit)(void *reserved, void *user_data)
         void (*free)(void *reserved, void *user_data)
 
+    cdef struct ngl_program_cache_stats:
+        uint64_t hits
+        uint64_t misses
+
     ngl_ctx *ngl_create()
     int ngl_backends_probe(const ngl_config *user_config, size_t *nb_backendsp, ngl_backend **backendsp)
     int ngl_backends_get(const ngl_config *user_config, size_t *nb_backendsp, ngl_backend **backendsp)
@@ -251,11 +261,21 @@ cdef extern from "nopegl/nopegl.h":
     void ngl_reset_backend(ngl_backend *backend)
     int ngl_resize(ngl_ctx *s, uint32_t width, uint32_t height)
     int ngl_get_viewport(ngl_ctx *s, int32_t *viewport)
+    int ngl_get_program_cache_stats(ngl_ctx *s, ngl_program_cache_stats *stats)
     int ngl_set_capture_buffer(ngl_ctx *s, void *capture_buffer)
     int ngl_set_scene(ngl_ctx *s, ngl_scene *scene)
     int ngl_update(ngl_ctx *s, double t) nogil
-    int ngl_draw(ngl_ctx *s, double t, void *output) nogil
+    cdef struct ngl_frame
+    cdef struct ngl_draw_output:
+        ngl_frame *frame
+
+    int ngl_frame_read_capture(ngl_frame *f, void *data, int wait) nogil
+    void ngl_frame_release(ngl_frame *f, ngpu_fence *fence)
+    int ngl_draw(ngl_ctx *s, double t, ngl_draw_output *output) nogil
     int ngl_get_nodes_at_point(ngl_ctx *s, const float *point, size_t *nb_nodesp, ngl_node ***nodesp)
+    int ngl_get_nodes_at_points(ngl_ctx *s, const float *points, size_t nb_points,
+                                const size_t **offsetsp, ngl_node ***nodesp)
+    int ngl_get_nodes_in_rect(ngl_ctx *s, const float *rect, size_t *nb_nodesp, ngl_node ***nodesp)
     ngpu_ctx *ngl_get_gpu_ctx(ngl_ctx *s)
     char *ngl_dot(ngl_ctx *s, double t) nogil
     int ngl_node_set_funcs(ngl_node *node, void *user_data, ngl_node_funcs *funcs)
@@ -263,6 +283,24 @@ cdef extern from "nopegl/nopegl.h":
     void ngl_livectls_freep(ngl_livectl **livectlsp)
     void ngl_freep(ngl_ctx **ss)
 
+    cdef struct ngl_render_farm
+    cdef struct ngl_render_farm_params:
+        const ngl_config *config
+        const char *scene_str
+        double start
+        double duration
+        int freq
+        uint32_t nb_workers
+        uint32_t segment_size
+        uint32_t max_pending_frames
+        uint32_t warmup_frames
+
+    ngl_render_farm *ngl_render_farm_create()
+    int ngl_render_farm_init(ngl_render_farm *s, const ngl_render_farm_params *params)
+    size_t ngl_render_farm_get_nb_frames(const ngl_render_farm *s)
+    int ngl_render_farm_read_frame(ngl_render_farm *s, void *data, double *tp) nogil
+    void ngl_render_farm_freep(ngl_render_farm **sp) nogil
+
     int ngl_easing_evaluate(const char *name, const double *args, size_t nb_args,
                             const double *offsets, double t, double *v)
     int ngl_easing_derivate(const char *name, const double *args, size_t nb_args,
@@ -341,6 +379,7 @@ log_set_min_level = ngl_log_set_min_level
 ERROR_GENERIC                 = NGL_ERROR_GENERIC
 ERROR_ACCESS                  = NGL_ERROR_ACCESS
 ERROR_BUG                     = NGL_ERROR_BUG
+ERROR_BUSY                    = NGL_ERROR_BUSY
 ERROR_EXTERNAL                = NGL_ERROR_EXTERNAL
 ERROR_INVALID_ARG             = NGL_ERROR_INVALID_ARG
 ERROR_INVALID_DATA            = NGL_ERROR_INVALID_DATA
@@ -937,6 +976,10 @@ cdef class Config:
         hud_scale,
         debug,
         shared_gpu_ctx=0,
+        program_cache_dir=None,
+        async_capture=False,
+        nb_threads=0,
+        trace_filename=None,
     ):
         self.config.platform = platform.value
         self.config.backend = backend.value
@@ -957,6 +1000,7 @@ cdef class Config:
         if capture_buffer is not None:
             self.config.capture_buffer = <uint8_t *>capture_buffer
         self.config.capture_buffer_type = capture_buffer_type
+        self.config.async_capture = async_capture
         self.config.hud = hud
         self.config.hud_measure_window = hud_measure_window
         self.config.hud_refresh_rate[0] = hud_refresh_rate[0]
@@ -964,6 +1008,11 @@ cdef class Config:
         if hud_export_filename is not None:
             self.config.hud_export_filename = hud_export_filename
         self.config.hud_scale = hud_scale
+        if trace_filename is not None:
+            self.config.trace_filename = trace_filename
+        if program_cache_dir is not None:
+            self.config.program_cache_dir = program_cache_dir
+        self.config.nb_threads = nb_threads
         self.config.debug = debug
         cdef uintptr_t shared_ptr = shared_gpu_ctx
         self.config.shared_gpu_ctx = <ngpu_ctx *>shared_ptr
@@ -973,6 +1022,26 @@ cdef class Config:
         return <uintptr_t>&self.config
 
 
+cdef class Frame:
+    cdef ngl_frame *frame
+    # Keep the context alive as long as the frame is not released
+    cdef object ctx
+
+    def read_capture(self, capture_buffer, int wait=1):
+        cdef uint8_t *ptr = <uint8_t *>capture_buffer
+        with nogil:
+            ret = ngl_frame_read_capture(self.frame, ptr, wait)
+        return ret
+
+    def release(self):
+        ngl_frame_release(self.frame, NULL)
+        self.frame = NULL
+        self.ctx = None
+
+    def __dealloc__(self):
+        ngl_frame_release(self.frame, NULL)
+
+
 cdef class Context:
     cdef ngl_ctx *ctx
     cdef object capture_buffer
@@ -1021,6 +1090,13 @@ cdef class Context:
             raise Exception("Error getting the viewport")
         return tuple(v for v in vp)
 
+    def get_program_cache_stats(self):
+        cdef ngl_program_cache_stats stats
+        cdef int ret = ngl_get_program_cache_stats(self.ctx, &stats)
+        if ret < 0:
+            raise Exception("Error getting the program cache statistics")
+        return dict(hits=stats.hits, misses=stats.misses)
+
     def set_capture_buffer(self, capture_buffer):
         self.capture_buffer = capture_buffer
         cdef uint8_t *ptr = NULL
@@ -1046,6 +1122,18 @@ cdef class Context:
             ret = ngl_draw(self.ctx, t, NULL)
         return ret
 
+    def draw_frame(self, double t):
+        cdef ngl_draw_output output
+        output.frame = NULL
+        with nogil:
+            ret = ngl_draw(self.ctx, t, &output)
+        if ret < 0:
+            return ret, None
+        frame = Frame()
+        frame.frame = output.frame
+        frame.ctx = self
+        return ret, frame
+
     def get_nodes_at_point(self, point):
         cdef float c_point[2]
         c_point[0] = point[0]
@@ -1060,6 +1148,39 @@ cdef class Context:
             result.append(<uintptr_t>nodes[i])
         return result
 
+    def get_nodes_at_points(self, points):
+        cdef size_t nb_points = len(points)
+        cdef float *c_points = <float *>calloc(max(nb_points, 1), 2 * sizeof(float))
+        if c_points is NULL:
+            raise MemoryError()
+        for i, point in enumerate(points):
+            c_points[i * 2] = point[0]
+            c_points[i * 2 + 1] = point[1]
+        cdef const size_t *offsets = NULL
+        cdef ngl_node **nodes = NULL
+        cdef int ret = ngl_get_nodes_at_points(self.ctx, c_points, nb_points, &offsets, &nodes)
+        free(c_points)
+        if ret < 0:
+            return [[] for _ in range(nb_points)]
+        result = []
+        for i in range(nb_points):
+            result.append([<uintptr_t>nodes[j] for j in range(offsets[i], offsets[i + 1])])
+        return result
+
+    def get_nodes_in_rect(self, rect):
+        cdef float c_rect[4]
+        for i in range(4):
+            c_rect[i] = rect[i]
+        cdef size_t nb_nodes = 0
+        cdef ngl_node **nodes = NULL
+        cdef int ret = ngl_get_nodes_in_rect(self.ctx, c_rect, &nb_nodes, &nodes)
+        if ret < 0:
+            return []
+        result = []
+        for i in range(nb_nodes):
+            result.append(<uintptr_t>nodes[i])
+        return result
+
     def dot(self, double t):
         cdef char *s
         with nogil:
@@ -1073,6 +1194,55 @@ cdef class Context:
         return ngl_gl_wrap_framebuffer(self.ctx, framebuffer)
 
 
+cdef class RenderFarm:
+    cdef ngl_render_farm *ctx
+
+    def __cinit__(self):
+        self.ctx = ngl_render_farm_create()
+        if self.ctx is NULL:
+            raise MemoryError()
+
+    def init(
+        self,
+        py_config,
+        const char *scene_str,
+        double start,
+        double duration,
+        int freq,
+        uint32_t nb_workers,
+        uint32_t segment_size,
+        uint32_t max_pending_frames,
+        uint32_t warmup_frames,
+    ):
+        cdef uintptr_t ptr = py_config.cptr
+        cdef ngl_render_farm_params params
+        memset(&params, 0, sizeof(params))
+        params.config = <ngl_config *>ptr
+        params.scene_str = scene_str
+        params.start = start
+        params.duration = duration
+        params.freq = freq
+        params.nb_workers = nb_workers
+        params.segment_size = segment_size
+        params.max_pending_frames = max_pending_frames
+        params.warmup_frames = warmup_frames
+        return ngl_render_farm_init(self.ctx, &params)
+
+    def get_nb_frames(self):
+        return ngl_render_farm_get_nb_frames(self.ctx)
+
+    def read_frame(self, capture_buffer):
+        cdef uint8_t *ptr = <uint8_t *>capture_buffer
+        cdef double t = 0
+        with nogil:
+            ret = ngl_render_farm_read_frame(self.ctx, ptr, &t)
+        return ret, t
+
+    def __dealloc__(self):
+        with nogil:
+            ngl_render_farm_freep(&self.ctx)
+
+
 def _wrap_func(func, *args):
     try:
         func(*args)
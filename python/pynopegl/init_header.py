@@ -105,6 +105,7 @@ class Error(IntEnum):
     GENERIC = _ngl.ERROR_GENERIC
     ACCESS = _ngl.ERROR_ACCESS
     BUG = _ngl.ERROR_BUG
+    BUSY = _ngl.ERROR_BUSY
     EXTERNAL = _ngl.ERROR_EXTERNAL
     INVALID_ARG = _ngl.ERROR_INVALID_ARG
     INVALID_DATA = _ngl.ERROR_INVALID_DATA
@@ -153,6 +154,10 @@ class Config(_ngl.Config):
         hud_scale: int = 0,
         debug: bool = False,
         shared_gpu_ctx: int = 0,
+        program_cache_dir: Optional[str] = None,
+        async_capture: bool = False,
+        nb_threads: int = 0,
+        trace_filename: Optional[str] = None,
     ):
         self.capture_buffer = capture_buffer
         super().__init__(
@@ -177,6 +182,10 @@ class Config(_ngl.Config):
             hud_scale,
             debug,
             shared_gpu_ctx,
+            program_cache_dir,
+            async_capture,
+            nb_threads,
+            trace_filename,
         )
 
 
@@ -359,6 +368,9 @@ class Context(_ngl.Context):
     def draw(self, t: float) -> int:
         return super().draw(t)
 
+    def draw_frame(self, t: float) -> Tuple[int, Optional[_ngl.Frame]]:
+        return super().draw_frame(t)
+
     def dot(self, t: float) -> Optional[str]:
         return super().dot(t)
 
@@ -366,6 +378,38 @@ class Context(_ngl.Context):
         return super().gl_wrap_framebuffer(framebuffer)
 
 
+class RenderFarm(_ngl.RenderFarm):
+    def init(
+        self,
+        config: Config,
+        scene: Scene,
+        start: float,
+        duration: float,
+        freq: int,
+        nb_workers: int = 0,
+        segment_size: int = 0,
+        max_pending_frames: int = 0,
+        warmup_frames: int = 0,
+    ) -> int:
+        return super().init(
+            config,
+            scene.serialize(),
+            start,
+            duration,
+            freq,
+            nb_workers,
+            segment_size,
+            max_pending_frames,
+            warmup_frames,
+        )
+
+    def get_nb_frames(self) -> int:
+        return super().get_nb_frames()
+
+    def read_frame(self, capture_buffer: bytearray) -> Tuple[int, float]:
+        return super().read_frame(capture_buffer)
+
+
 def easing_evaluate(
     name: str,
     t: float,
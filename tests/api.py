@@ -19,12 +19,15 @@
 # under the License.
 #
 
+import array
 import atexit
 import csv
 import hashlib
+import json
 import locale
 import math
 import os
+import platform
 import pprint
 import random
 import tempfile
@@ -347,6 +350,494 @@ def api_hud_csv(width=16, height=16):
     assert time_column == ["0.000000", "0.150000", "0.300000", "0.450000", "1.000000"], time_column
 
 
+def api_trace(width=16, height=16):
+    # We can't use NamedTemporaryFile because we may not be able to open it
+    # twice on some systems
+    fd, tracepath = tempfile.mkstemp(suffix=".json", prefix="ngl-test-trace-")
+    os.close(fd)
+    atexit.register(lambda: os.remove(tracepath))
+
+    ctx = ngl.Context()
+    ret = ctx.configure(
+        ngl.Config(offscreen=True, width=width, height=height, backend=_backend, trace_filename=tracepath)
+    )
+    assert ret == 0
+    # The label contains characters that must be escaped in the JSON output
+    draw = ngl.DrawColor(geometry=ngl.Quad(), label='draw "color"\t\x01')
+    assert ctx.set_scene(ngl.Scene.from_params(draw)) == 0
+    for t in [0.0, 0.5, 1.0]:
+        assert ctx.draw(t) == 0
+    # The OpenGL backend does not time the render passes on Darwin
+    has_pass_times = ctx.get_backend()["id"] == ngl.Backend.VULKAN or platform.system() != "Darwin"
+    del ctx
+
+    with open(tracepath) as fp:
+        events = json.load(fp)
+
+    spans = [e for e in events if e["ph"] == "X"]
+    node_spans = [e for e in spans if e.get("args", {}).get("type") == "DrawColor"]
+    assert len([e for e in node_spans if e["cat"] == "draw"]) == 3, node_spans
+    assert all(e["name"] == 'draw "color"\t\x01' for e in node_spans), node_spans
+    gpu_draws = [e for e in spans if e["cat"] == "gpu" and e["name"] == "draw"]
+    assert len(gpu_draws) == 3, gpu_draws
+    if has_pass_times:
+        render_passes = [e for e in spans if e["cat"] == "gpu" and e["name"].startswith("render pass")]
+        assert len(render_passes) >= 3, render_passes
+
+
+def api_program_cache(width=16, height=16):
+    cache_dir = tempfile.TemporaryDirectory(prefix="ngl-test-program-cache-")
+    atexit.register(cache_dir.cleanup)
+
+    def _render():
+        capture_buffer = bytearray(width * height * 4)
+        ctx = ngl.Context()
+        ret = ctx.configure(
+            ngl.Config(
+                offscreen=True,
+                width=width,
+                height=height,
+                backend=_backend,
+                capture_buffer=capture_buffer,
+                program_cache_dir=cache_dir.name,
+            )
+        )
+        assert ret == 0
+        assert ctx.set_scene(_get_scene()) == 0
+        assert ctx.draw(0) == 0
+        stats = ctx.get_program_cache_stats()
+        del ctx
+        return capture_buffer, stats
+
+    # The first context populates the cache, the second one reuses it
+    ref, stats = _render()
+    assert os.listdir(cache_dir.name)
+    assert stats["hits"] == 0 and stats["misses"] > 0, stats
+    out, stats = _render()
+    assert out == ref
+    assert stats["hits"] > 0, stats
+
+
+def api_capture_async(width=16, height=16):
+    times = [i / 4.0 for i in range(8)]
+
+    capture_buffer = bytearray(width * height * 4)
+    ctx = ngl.Context()
+    ret = ctx.configure(
+        ngl.Config(offscreen=True, width=width, height=height, backend=_backend, capture_buffer=capture_buffer)
+    )
+    assert ret == 0
+    assert ctx.set_scene(_get_scene()) == 0
+    refs = []
+    for t in times:
+        assert ctx.draw(t) == 0
+        refs.append(bytes(capture_buffer))
+    del ctx
+
+    ctx = ngl.Context()
+    ret = ctx.configure(ngl.Config(offscreen=True, width=width, height=height, backend=_backend, async_capture=True))
+    assert ret == 0
+    assert ctx.set_scene(_get_scene()) == 0
+
+    # Keep as many frames in flight as the context allows, and read back the
+    # oldest one whenever the next draw is refused
+    captures = []
+    frames = []
+    for t in times:
+        ret, frame = ctx.draw_frame(t)
+        if ret == ngl.Error.BUSY:
+            buf = bytearray(width * height * 4)
+            assert frames[0].read_capture(buf) == 0
+            frames.pop(0).release()
+            captures.append(bytes(buf))
+            ret, frame = ctx.draw_frame(t)
+        assert ret == 0
+        frames.append(frame)
+    for frame in frames:
+        buf = bytearray(width * height * 4)
+        assert frame.read_capture(buf) == 0
+        frame.release()
+        captures.append(bytes(buf))
+    del ctx
+
+    assert captures == refs
+
+
+def _get_render_farm_scene():
+    animkf = [
+        ngl.AnimKeyFrameColor(0, (1.0, 0.0, 0.0)),
+        ngl.AnimKeyFrameColor(1, (0.0, 1.0, 0.0)),
+        ngl.AnimKeyFrameColor(2, (0.0, 0.0, 1.0)),
+    ]
+    draw = ngl.DrawColor(color=ngl.AnimatedColor(animkf), geometry=ngl.Quad())
+    return ngl.Scene.from_params(draw, duration=2)
+
+
+def _render_farm_frames(scene, config, start, duration, freq, **params):
+    farm = ngl.RenderFarm()
+    assert farm.init(config, scene, start, duration, freq, **params) == 0
+    frames = []
+    for _ in range(farm.get_nb_frames()):
+        capture_buffer = bytearray(config.width * config.height * 4)
+        ret, t = farm.read_frame(capture_buffer)
+        assert ret == 0
+        frames.append((t, bytes(capture_buffer)))
+    del farm
+    return frames
+
+
+def api_render_farm(width=16, height=16):
+    start, duration, freq = 0.25, 1.5, 12
+    scene = _get_render_farm_scene()
+
+    times = [start + k / freq for k in range(int(duration * freq))]
+    refs = list(zip(times, _render_captures(lambda: scene, times, width, height)))
+
+    config = ngl.Config(offscreen=True, width=width, height=height, backend=_backend)
+    # Default segmentation, more segments than workers
+    frames = _render_farm_frames(scene, config, start, duration, freq, nb_workers=2)
+    assert frames == refs
+    # Fewer reorder slots than frames per segment, with warm-up frames
+    frames = _render_farm_frames(
+        scene, config, start, duration, freq, nb_workers=3, segment_size=4, max_pending_frames=2, warmup_frames=3
+    )
+    assert frames == refs
+
+
+def api_render_farm_fail(width=16, height=16):
+    draw = ngl.Draw(ngl.Quad(), ngl.Program(vertex="<bug>", fragment="<bug>"))
+    scene = ngl.Scene.from_params(draw, duration=1)
+
+    # The workers fail to set the scene: the error is reported to the reader
+    config = ngl.Config(offscreen=True, width=width, height=height, backend=_backend)
+    farm = ngl.RenderFarm()
+    assert farm.init(config, scene, 0, 1, 10, nb_workers=2, segment_size=2) == 0
+    ret, _ = farm.read_frame(bytearray(width * height * 4))
+    assert ret < 0
+    del farm
+
+
+def _get_drawrect2d_siblings(width, height, isolate):
+    rects = []
+    for i in range(12):
+        x, y = (i % 4) * width / 4, (i // 4) * height / 3
+        if i % 3 == 0:
+            fill = ngl.GradientFill(color0=(0.9, 0.2, 0.1), color1=(0.1, 0.3, 0.9), pos1=(1.0, 1.0))
+        else:
+            fill = ngl.ColorFill(color=(i / 12, 1.0 - i / 12, 0.5, 1.0))
+        rects.append(
+            ngl.DrawRect2D(
+                rect=(x, y, width / 3, height / 2),
+                fill=fill,
+                stroke=ngl.Stroke(color=(1.0, 1.0, 1.0, 1.0), width=2.0, mode="center") if i % 2 else None,
+                corner_radius=(i, i / 2),
+                rotation=i * 5.0,
+                opacity=0.4 + i / 20,
+                clip_rect=(x, y, width / 4, height / 4) if i % 5 == 0 else (0, 0, 0, 0),
+                visible=i != 7,
+            )
+        )
+    if isolate:
+        # A single child per Group2D prevents any batching
+        rects = [ngl.Group2D(children=[rect]) for rect in rects]
+    group = ngl.Group2D(children=rects, clip_rect=(4, 4, width - 8, height - 8), opacity=0.9)
+    return ngl.Scene.from_params(ngl.Canvas2D(width=width, height=height, children=[group]))
+
+
+def _render_captures(scene_func, times, width, height, pre_draw=None, **config):
+    """
+    Return the frames rendered at the given times from the scene created by
+    scene_func; pre_draw, if set, is called with the frame index before every
+    draw (to apply live changes for example)
+    """
+    capture_buffer = bytearray(width * height * 4)
+    ctx = ngl.Context()
+    ret = ctx.configure(
+        ngl.Config(
+            offscreen=True,
+            width=width,
+            height=height,
+            backend=_backend,
+            capture_buffer=capture_buffer,
+            **config,
+        )
+    )
+    assert ret == 0
+    assert ctx.set_scene(scene_func()) == 0
+    captures = []
+    for i, t in enumerate(times):
+        if pre_draw:
+            pre_draw(i)
+        assert ctx.draw(t) == 0
+        captures.append(bytes(capture_buffer))
+    del ctx
+    return captures
+
+
+def _get_hud_draws(scene, times, width, height):
+    """Return the number of draw calls of every frame, as reported by the HUD"""
+    fd, csvpath = tempfile.mkstemp(suffix=".csv", prefix="ngl-test-draws-")
+    os.close(fd)
+    atexit.register(lambda: os.remove(csvpath))
+
+    ctx = ngl.Context()
+    ret = ctx.configure(
+        ngl.Config(offscreen=True, width=width, height=height, backend=_backend, hud=True, hud_export_filename=csvpath)
+    )
+    assert ret == 0
+    assert ctx.set_scene(scene) == 0
+    for t in times:
+        assert ctx.draw(t) == 0
+    del ctx
+
+    with open(csvpath) as csvfile:
+        reader = csv.DictReader(csvfile)
+        return [int(row["Draws"]) for row in reader]
+
+
+def api_drawrect2d_batching(width=64, height=64):
+    # Batched sibling rects must render exactly like individually drawn ones
+    isolated = _render_captures(lambda: _get_drawrect2d_siblings(width, height, True), [0], width, height)
+    batched = _render_captures(lambda: _get_drawrect2d_siblings(width, height, False), [0], width, height)
+    assert isolated == batched
+
+    # The rects merged into the batch of a sibling issue no draw call of their own
+    draws = [
+        _get_hud_draws(_get_drawrect2d_siblings(width, height, isolate), [0], width, height)[0]
+        for isolate in (True, False)
+    ]
+    assert draws[0] == 12, draws
+    assert draws[1] < draws[0], draws
+
+
+_RTT_CACHE_COMPUTE = """
+void main()
+{
+    imageStore(dst, ivec2(gl_GlobalInvocationID.xy), vec4(value, 1.0 - value, 0.0, 1.0));
+}
+"""
+
+
+def _get_rtt_cache_scene(source):
+    size = 16
+    extra_children = []
+    if source == "static":
+        child = ngl.DrawColor(color=(1.0, 0.5, 0.0))
+    elif source == "animated":
+        animkf = [ngl.AnimKeyFrameVec3(0, (1.0, 0.0, 0.0)), ngl.AnimKeyFrameVec3(2, (0.0, 0.0, 1.0))]
+        child = ngl.DrawColor(color=ngl.AnimatedVec3(animkf))
+    elif source in ("compute", "diamond"):
+        # The compute lives outside of the RenderToTexture subtree, which only
+        # samples its output
+        texture = ngl.Texture2D(width=size, height=size, min_filter="nearest", mag_filter="nearest")
+        program = ngl.ComputeProgram(_RTT_CACHE_COMPUTE, workgroup_size=(size, size, 1))
+        program.update_properties(dst=ngl.ResourceProps(as_image=True, writable=True))
+        compute = ngl.Compute(workgroup_count=(1, 1, 1), program=program)
+        animkf = [ngl.AnimKeyFrameFloat(0, 0.0), ngl.AnimKeyFrameFloat(2, 1.0)]
+        compute.update_resources(value=ngl.AnimatedFloat(animkf), dst=texture)
+        if source == "diamond":
+            # The written texture reaches the RenderToTexture through two
+            # branches joining in the same Group
+            child = ngl.Group(children=[ngl.DrawTexture(texture=texture), ngl.DrawTexture(texture=texture)])
+        else:
+            child = ngl.DrawTexture(texture=texture)
+        extra_children = [compute]
+    else:
+        assert False
+
+    rtt_texture = ngl.Texture2D(width=size, height=size, min_filter="nearest", mag_filter="nearest")
+    rtt = ngl.RenderToTexture(child, color_textures=[rtt_texture])
+    draw = ngl.DrawTexture(texture=rtt_texture)
+    return ngl.Scene.from_params(ngl.Group(children=extra_children + [rtt, draw]))
+
+
+def _has_compute():
+    ctx = ngl.Context()
+    assert ctx.configure(ngl.Config(offscreen=True, width=16, height=16, backend=_backend)) == 0
+    return bool(ctx.get_backend()["caps"][ngl.Cap.COMPUTE])
+
+
+def _api_rtt_cache(source, expected_draws, width=16, height=16):
+    if source in ("compute", "diamond") and not _has_compute():
+        return
+
+    # The frames must match the ones rendered from scratch
+    times = [0, 1, 2]
+    captures = _render_captures(lambda: _get_rtt_cache_scene(source), times, width, height)
+    refs = [_render_captures(lambda: _get_rtt_cache_scene(source), [t], width, height)[0] for t in times]
+    assert captures == refs
+
+    # The subtree of the RenderToTexture is only drawn again when needed
+    draws = _get_hud_draws(_get_rtt_cache_scene(source), times, width, height)
+    assert draws == expected_draws, draws
+
+
+def api_rtt_cache_static():
+    _api_rtt_cache("static", [2, 1, 1])
+
+
+def api_rtt_cache_animated():
+    _api_rtt_cache("animated", [2, 2, 2])
+
+
+def api_rtt_cache_compute():
+    _api_rtt_cache("compute", [2, 2, 2])
+
+
+def api_rtt_cache_diamond():
+    _api_rtt_cache("diamond", [3, 3, 3])
+
+
+_ANIMATEDBUFFER_VERT = """
+void main()
+{
+    ngl_out_pos = ngl_projection_matrix * ngl_modelview_matrix * vec4(morph, 1.0);
+}
+"""
+
+_ANIMATEDBUFFER_FRAG = """
+void main()
+{
+    ngl_out_color = vec4(1.0, 0.5, 0.0, 1.0);
+}
+"""
+
+
+def _get_animatedbuffer_scene(direct_write, as_attribute):
+    # Morph a triangle into another, exercising both the mixing and the copy paths
+    keyframes = [
+        ngl.AnimKeyFrameBuffer(0, array.array("f", [-0.5, -0.5, 0.0, 0.5, -0.5, 0.0, 0.0, 0.5, 0.0])),
+        ngl.AnimKeyFrameBuffer(1, array.array("f", [-0.9, 0.2, 0.0, 0.7, -0.8, 0.0, 0.3, 0.9, 0.0])),
+    ]
+    vertices = ngl.AnimatedBufferVec3(keyframes=keyframes, direct_write=direct_write)
+    if as_attribute:
+        # The Draw follows the buffer of every in-flight frame
+        draw = ngl.Draw(ngl.Triangle(), ngl.Program(vertex=_ANIMATEDBUFFER_VERT, fragment=_ANIMATEDBUFFER_FRAG))
+        draw.update_attributes(morph=vertices)
+    else:
+        # Geometries keep their buffer, direct_write is ignored
+        draw = ngl.DrawColor(color=(1.0, 0.5, 0.0), geometry=ngl.Geometry(vertices=vertices))
+    return ngl.Scene.from_params(draw, duration=1)
+
+
+def api_animatedbuffer_direct_write(width=64, height=64):
+    # Interpolating in the mapped GPU buffers must render like the CPU path
+    times = [0.0, 0.3, 0.7, 1.2, 0.1]
+    for as_attribute in (False, True):
+        ref = _render_captures(lambda: _get_animatedbuffer_scene(False, as_attribute), times, width, height)
+        out = _render_captures(lambda: _get_animatedbuffer_scene(True, as_attribute), times, width, height)
+        assert out == ref
+
+
+def _get_parallel_update_scene(animated):
+    # Enough independent variables per dependency level to be dispatched on the update workers
+    nb_cells = 64
+    shared = ngl.AnimatedFloat([ngl.AnimKeyFrameFloat(0, 0), ngl.AnimKeyFrameFloat(1, 1)])
+    children = []
+    for i in range(nb_cells):
+        value = (i + 1) / nb_cells
+        if animated:
+            cell = ngl.AnimatedFloat([ngl.AnimKeyFrameFloat(0, 0), ngl.AnimKeyFrameFloat(1, value * 2)])
+            color = ngl.EvalVec3("a", "b", "a * b", resources=dict(a=shared, b=cell))
+        else:
+            color = (0.5, value, 0.5 * value)
+        children.append(ngl.DrawColor(color=color))
+    return ngl.Scene.from_params(ngl.GridLayout(children, size=(8, 8)), duration=1)
+
+
+def api_parallel_update(width=64, height=64):
+    # Variables evaluated from the update workers must match their static counterparts
+    ref = _render_captures(lambda: _get_parallel_update_scene(False), [0.5], width, height, nb_threads=1)
+    out_seq = _render_captures(lambda: _get_parallel_update_scene(True), [0.5], width, height, nb_threads=1)
+    out_par = _render_captures(lambda: _get_parallel_update_scene(True), [0.5], width, height, nb_threads=4)
+    assert ref == out_seq == out_par
+
+
+def _get_drawpath_scene(animated):
+    if animated:
+        control = ngl.AnimatedVec3(
+            [ngl.AnimKeyFrameVec3(0, (-0.5, 0.5, 0)), ngl.AnimKeyFrameVec3(1, (0.5, -0.5, 0))]
+        )
+    else:
+        control = (0, 0, 0)
+    keyframes = [
+        ngl.PathKeyMove(to=(-0.8, -0.8, 0)),
+        ngl.PathKeyBezier2(control=control, to=(0.8, -0.8, 0)),
+        ngl.PathKeyLine(to=(0, 0.8, 0)),
+        ngl.PathKeyClose(),
+    ]
+    return ngl.Scene.from_params(ngl.DrawPath(ngl.Path(keyframes)), duration=1)
+
+
+def api_drawpath_animated(width=64, height=64):
+    # The distance field of an animated path must match the one of its static
+    # counterpart, whether it is generated at this time or regenerated from
+    # another one
+    ref = _render_captures(lambda: _get_drawpath_scene(False), [0.5], width, height)
+    out = _render_captures(lambda: _get_drawpath_scene(True), [0.5], width, height)
+    out_regen = _render_captures(lambda: _get_drawpath_scene(True), [0, 0.5], width, height)[-1:]
+    assert ref == out == out_regen
+
+
+def _get_blur_scene(blur_cls, source, duration):
+    blurred_texture = ngl.Texture2D()
+    blur = blur_cls(
+        source=source,
+        destination=blurred_texture,
+        blurriness=ngl.AnimatedFloat([ngl.AnimKeyFrameFloat(0, 0), ngl.AnimKeyFrameFloat(duration, 1)]),
+    )
+    return ngl.Scene.from_params(ngl.Group(children=[blur, ngl.DrawTexture(blurred_texture)]), duration=duration)
+
+
+def _api_blur_linear(
+    ref_name, blur_cls, source_func, width, height, duration, nb_keyframes, tolerance=5, mean_tolerance=1.0
+):
+    from PIL import Image
+
+    # The references of the blur render tests were generated before the blur
+    # intermediates were kept in linear space (when each tap was converted
+    # from and to sRGB): the linear path must stay within a fixed tolerance of
+    # that previous output
+    refs_dir = Path(__file__).resolve().parent / "refs"
+    times = [i * duration / nb_keyframes for i in range(nb_keyframes)]
+    captures = _render_captures(
+        lambda: _get_blur_scene(blur_cls, source_func(), duration),
+        times,
+        width,
+        height,
+        clear_color=(0.0, 0.0, 0.0, 1.0),
+    )
+    for i, capture in enumerate(captures):
+        ref = Image.open(refs_dir / f"{ref_name}_{i}.png").convert("RGBA").tobytes()
+        assert len(ref) == len(capture)
+        diffs = [abs(a - b) for a, b in zip(capture, ref)]
+        max_diff = max(diffs)
+        mean_diff = sum(diffs) / len(diffs)
+        assert max_diff <= tolerance, f"{ref_name}_{i}: max diff {max_diff} > {tolerance}"
+        assert mean_diff <= mean_tolerance, f"{ref_name}_{i}: mean diff {mean_diff:.3f} > {mean_tolerance}"
+
+
+def _get_blur_noise_texture():
+    return ngl.Texture2D(data_src=ngl.DrawNoise(type="blocky", octaves=3, scale=(9, 9)))
+
+
+def api_blur_linear_gaussian():
+    _api_blur_linear("blur_gaussian", ngl.GaussianBlur, _get_blur_noise_texture, 256, 256, 10, 10)
+
+
+def api_blur_linear_fast_gaussian():
+    _api_blur_linear("blur_fast_gaussian", ngl.FastGaussianBlur, _get_blur_noise_texture, 256, 256, 10, 10)
+
+
+def api_blur_linear_hexagonal():
+    mi = load_media("city")
+
+    def _get_source():
+        return ngl.Texture2D(data_src=ngl.Media(mi.filename))
+
+    _api_blur_linear("blur_hexagonal", ngl.HexagonalBlur, _get_source, mi.width, mi.height, 5, 5)
+
+
 def _api_text_live_change(width=320, height=240, font_faces=None):
     import zlib
 
@@ -387,6 +878,176 @@ def api_text_live_change_with_font():
     return _api_text_live_change(font_faces=[ngl.FontFace(font_faces.as_posix())])
 
 
+def _api_text_partial_change(text_str, next_str, width=320, height=240, font_faces=None):
+    text = ngl.Text(text_str, font_faces=font_faces)
+
+    def _set_next_str(frame_index):
+        if frame_index == 1:
+            text.set_text(next_str)
+
+    # A live change only relayouts and uploads the modified range: it must
+    # render the same as a text created with the final string
+    out = _render_captures(lambda: ngl.Scene.from_params(text), [0, 1], width, height, pre_draw=_set_next_str)
+    ref = _render_captures(lambda: ngl.Scene.from_params(ngl.Text(next_str, font_faces=font_faces)), [1], width, height)
+    assert out[-1] == ref[0]
+
+
+def _get_test_font_faces():
+    font_path = Path(__file__).resolve().parent / "assets" / "fonts" / "Quicksand-Medium.ttf"
+    return [ngl.FontFace(font_path.as_posix())]
+
+
+def api_text_live_replace():
+    return _api_text_partial_change("hello\nworld\nfoo", "hello\nwOrld\nfoo")
+
+
+def api_text_live_insert():
+    return _api_text_partial_change("hello\nworld\nfoo", "hello\nwoXrld\nfoo")
+
+
+def api_text_live_replace_with_font():
+    return _api_text_partial_change("hello\nworld\nfoo", "hello\nwOrld\nfoo", font_faces=_get_test_font_faces())
+
+
+def api_text_live_insert_with_font():
+    return _api_text_partial_change("hello\nworld\nfoo", "hello\nwoXrld\nfoo", font_faces=_get_test_font_faces())
+
+
+def _get_texteffects_text(sampled_effects, font_faces):
+    scale_animkf = [
+        ngl.AnimKeyFrameVec3(0, (0.0, 0.0, 1.0)),
+        ngl.AnimKeyFrameVec3(1, (1.0, 1.0, 1.0), "bounce_out"),
+    ]
+    color_animkf = [
+        ngl.AnimKeyFrameColor(0, (1.0, 0.5, 0.0)),
+        ngl.AnimKeyFrameColor(1, (0.0, 0.5, 1.0), "exp_in_out"),
+    ]
+    opacity_animkf = [
+        ngl.AnimKeyFrameFloat(0, 0.2),
+        ngl.AnimKeyFrameFloat(1, 1.0, "quadratic_out"),
+    ]
+    effects = [
+        ngl.TextEffect(
+            target="char",
+            overlap=0.6,
+            transform=ngl.Scale(ngl.Identity(), factors=ngl.AnimatedVec3(scale_animkf)),
+            anchor=(-1, 1),
+        ),
+        ngl.TextEffect(
+            target="line",
+            overlap=0.3,
+            color=ngl.AnimatedColor(color_animkf),
+            opacity=ngl.AnimatedFloat(opacity_animkf),
+        ),
+    ]
+    return ngl.Text("Wide\nil text", font_faces=font_faces, effects=effects, sampled_effects=sampled_effects)
+
+
+def _api_texteffects_gpu_cpu(width=320, height=240, font_faces=None):
+    times = [i / 4 for i in range(9)]
+
+    captures = [
+        _render_captures(
+            lambda: ngl.Scene.from_params(_get_texteffects_text(sampled_effects, font_faces), duration=2),
+            times,
+            width,
+            height,
+        )
+        for sampled_effects in (True, False)
+    ]
+
+    # The sampled parameters are linearly interpolated on the GPU, so the
+    # rendering may slightly differ from the exact CPU evaluation, mostly on
+    # the edges of the glyphs
+    for t, gpu, cpu in zip(times, *captures):
+        nb_diffs = sum(1 for a, b in zip(gpu, cpu) if abs(a - b) > 8)
+        assert nb_diffs <= len(gpu) * 0.005, f"t={t}: {nb_diffs} components differ"
+
+
+def api_texteffects_gpu_cpu():
+    return _api_texteffects_gpu_cpu()
+
+
+def api_texteffects_gpu_cpu_with_font():
+    return _api_texteffects_gpu_cpu(font_faces=_get_test_font_faces())
+
+
+def _get_texteffect_char_anchor_text(nb_noop_effects):
+    # No-op effects only shift the index of the transform effect in the stack
+    effects = [ngl.TextEffect(opacity=1.0) for _ in range(nb_noop_effects)]
+    effects.append(
+        ngl.TextEffect(
+            target="char",
+            transform=ngl.Scale(ngl.Identity(), factors=(0.5, 0.5, 1.0)),
+            anchor=(1, 1),
+        )
+    )
+    return ngl.Text("Wil", font_faces=_get_test_font_faces(), effects=effects)
+
+
+def api_texteffect_char_anchor_with_font(width=320, height=240):
+    # The anchor of each character must be computed from its own dimensions,
+    # whatever the position of the effect in the stack (the characters have
+    # distinct dimensions with a proportional font)
+    captures = [
+        _render_captures(
+            lambda: ngl.Scene.from_params(_get_texteffect_char_anchor_text(nb_noop_effects), duration=1),
+            [0.5],
+            width,
+            height,
+        )
+        for nb_noop_effects in range(3)
+    ]
+    assert captures[0] == captures[1] == captures[2]
+
+
+def api_text_shared_font(width=320, height=240):
+    def _render(strings_seq):
+        # Distinct FontFace nodes referencing the same file share the same face and glyph atlas
+        texts = [ngl.Text(font_faces=_get_test_font_faces(), pt_size=pt_size) for pt_size in (54, 54, 36, 36)]
+
+        def _set_strings(frame_index):
+            for text, text_str in zip(texts, strings_seq[frame_index]):
+                text.set_text(text_str)
+
+        captures = _render_captures(
+            lambda: ngl.Scene.from_params(autogrid_simple(texts)),
+            [0] * len(strings_seq),
+            width,
+            height,
+            pre_draw=_set_strings,
+        )
+        return captures[-1]
+
+    final_strings = ["hello", "world", "hello", "World!"]
+    ref = _render([final_strings])
+
+    # Glyphs appended to the shared atlas by the other texts must not alter the rendering
+    out = _render(
+        [
+            ["", "", "", ""],
+            ["abc", "xyz", "0123456789", "ABCDEFGHIJKLMNOPQRSTUVWXYZ"],
+            final_strings,
+        ]
+    )
+    assert out == ref
+
+
+def _get_shared_font_release_scene():
+    # Two texts sharing the glyph atlas, alive over distinct time ranges
+    texts = [ngl.Text(text, font_faces=_get_test_font_faces()) for text in ("hello", "world")]
+    trfs = [_create_trf(texts[0], 0, 1, prefetch_time=0), _create_trf(texts[1], 2, 3, prefetch_time=0)]
+    return ngl.Scene.from_params(ngl.Group(children=trfs))
+
+
+def api_text_shared_font_release(width=320, height=240):
+    # Both texts are released at t=5, and the shared atlas along with the last
+    # one of them: it must be restored with the already packed glyphs once
+    # needed again
+    captures = _render_captures(_get_shared_font_release_scene, [0.5, 2.5, 5, 0.5], width, height)
+    assert captures[-1] == captures[0]
+
+
 def api_media_sharing_failure():
     ctx = ngl.Context()
     ret = ctx.configure(ngl.Config(offscreen=True, width=16, height=16, backend=_backend))
@@ -1176,6 +1837,67 @@ def api_bounding_box_intersection_rotated(width=256, height=256):
     ctx.set_scene(None)
 
 
+def api_bounding_box_batched_queries(width=256, height=256):
+    """Test the batched point and rectangle queries against the single point query"""
+    ctx = ngl.Context()
+    ret = ctx.configure(
+        ngl.Config(
+            offscreen=True,
+            width=width,
+            height=height,
+            backend=_backend,
+        )
+    )
+    assert ret == 0
+
+    # 8x8 grid of overlapping rects, plus a 45° rotated square covering the center
+    fill = ngl.ColorFill(color=(1.0, 0.5, 0.0, 1.0))
+    rects = []
+    for y in range(8):
+        for x in range(8):
+            rects.append(ngl.DrawRect2D(rect=(x * 30 + 8, y * 30 + 8, 40, 40), fill=fill))
+    diamond = ngl.DrawRect2D(rect=(78, 78, 100, 100), fill=fill, label="diamond")
+    group = ngl.Group2D(children=[diamond], rotation=45.0, anchor=(128, 128))
+    canvas = ngl.Canvas2D(children=rects + [group], width=width, height=height)
+
+    scene = ngl.Scene.from_params(canvas, width=width, height=height)
+    ret = ctx.set_scene(scene)
+    assert ret == 0
+
+    ret = ctx.draw(0.0)
+    assert ret == 0
+
+    points = [(x, y) for y in range(-8, width + 8, 7) for x in range(-8, height + 8, 7)]
+    results = ctx.get_nodes_at_points(points)
+    assert len(results) == len(points)
+    for point, nodes in zip(points, results):
+        assert nodes == ctx.get_nodes_at_point(point), f"mismatch at {point}"
+
+    assert ctx.get_nodes_at_points([]) == []
+
+    # Rect fully inside the first rect only
+    nodes = ctx.get_nodes_in_rect((10, 10, 10, 10))
+    assert nodes == [rects[0].cptr], "rect inside the first rect should only hit it"
+
+    # Inside the AABB of the diamond but outside the rotated square
+    nodes = ctx.get_nodes_in_rect((58, 75, 4, 4))
+    assert diamond.cptr not in nodes, "rect outside the rotated square should not hit it"
+
+    # Small rect at the center of the diamond
+    nodes = ctx.get_nodes_in_rect((126, 126, 4, 4))
+    assert diamond.cptr in nodes, "rect at the center of the diamond should hit it"
+
+    # Whole viewport, all the nodes in draw order
+    nodes = ctx.get_nodes_in_rect((0, 0, width, height))
+    assert nodes == [rect.cptr for rect in rects] + [diamond.cptr]
+
+    # Outside everything
+    nodes = ctx.get_nodes_in_rect((-50, -50, 10, 10))
+    assert nodes == []
+
+    ctx.set_scene(None)
+
+
 def _decompose_transform(matrix):
     """Decompose a 2D TRS 4x4 column-major matrix into position, rotation, scale"""
     # Column-major: m[0],m[1] = first column, m[4],m[5] = second column, m[12],m[13] = translation